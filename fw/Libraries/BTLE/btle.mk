@@ -240,6 +240,13 @@ PROJ_CFLAGS+=-DWDX_FTD_ATT_DEFAULT_PAYLOAD_LEN=256
 # Software AES will use 4.3kB of data and 1.4kB of code
 PROJ_CFLAGS+=-DENABLE_SOFT_AES=1
 
+# CRC-32 of long buffers on the TPU CRC engine, see PalCryptoCrc32(). Off until verified on the
+# target, build with ENABLE_CRC_HW=1 to try it. CalcCrc32() checks the engine against the CRC-32
+# check value first and stays in software if it fails.
+ifeq ($(ENABLE_CRC_HW),1)
+PROJ_CFLAGS+=-DWSF_CRC_HW=TRUE
+endif
+
 # Build libraries
 export TARGET
 export COMPILER
@@ -100,6 +100,7 @@ LINKLAYER_C_FILES += \
 	$(LINKLAYER_DIR)/platform/max32665/ll_tester.c \
 	$(LINKLAYER_DIR)/platform/max32665/lhci_vs.c \
 	$(LINKLAYER_DIR)/platform/max32665/ll_math_aes.c \
+	$(LINKLAYER_DIR)/platform/max32665/ll_math_ecc_maa.c \
 	$(LINKLAYER_DIR)/platform/common/sources/chci/chci_tr_serial.c \
 	$(LINKLAYER_DIR)/platform/common/sources/chci/chci_tr.c \
 	$(LINKLAYER_DIR)/platform/common/sources/bb/ble/bb_ble_pdufilt.c \
@@ -111,6 +112,7 @@ LINKLAYER_C_FILES += \
 	$(LINKLAYER_DIR)/controller/sources/common/bb/bb_main.c \
 	$(LINKLAYER_DIR)/controller/sources/common/sch/sch_main.c \
 	$(LINKLAYER_DIR)/controller/sources/common/sch/sch_list.c \
+	$(LINKLAYER_DIR)/controller/sources/common/sch/sch_stats.c \
 	$(LINKLAYER_DIR)/controller/sources/ble/lhci/lhci_evt_vs.c \
 	$(LINKLAYER_DIR)/controller/sources/ble/lhci/lhci_evt_phy.c \
 	$(LINKLAYER_DIR)/controller/sources/ble/lhci/lhci_init_adv_priv.c \
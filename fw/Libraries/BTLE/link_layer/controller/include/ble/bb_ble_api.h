@@ -156,6 +156,9 @@ typedef struct
   uint16_t  passLocalAddrResOpt;    /*!< Number of PDUs passing optional local address resolution. */
   uint16_t  peerResAddrPend;        /*!< Number of peer address resolutions pended. */
   uint16_t  localResAddrPend;       /*!< Number of local address resolutions pended. */
+  uint16_t  passPeerRpaCache;       /*!< Number of peer RPAs resolved from the RPA cache. */
+  uint16_t  failPeerRpaCache;       /*!< Number of peer RPAs known from the RPA cache not to resolve. */
+  uint16_t  peerRpaAesCalc;         /*!< Number of AES calculations resolving peer RPAs. */
 } BbBlePduFiltStats_t;
 
 /**************************************************************************************************
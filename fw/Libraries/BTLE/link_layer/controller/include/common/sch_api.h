@@ -31,6 +31,50 @@
 extern "C" {
 #endif
 
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+#ifndef SCH_STATS_ENABLED
+/*! \brief      Enable scheduler decision statistics. */
+#define SCH_STATS_ENABLED               FALSE
+#endif
+
+#ifndef SCH_STATS_NUM_TYPES
+/*! \brief      Number of BOD types counted, the last one counts all other types. */
+#define SCH_STATS_NUM_TYPES             11
+#endif
+
+#ifndef SCH_STATS_TRACE_LEN
+/*! \brief      Number of decisions kept in the trace ring, a power of 2. */
+#define SCH_STATS_TRACE_LEN             32
+#endif
+
+/**************************************************************************************************
+  Constants
+**************************************************************************************************/
+
+/*! \brief      Scheduler decisions. */
+enum
+{
+  SCH_STATS_EVT_INSERT,         /*!< BOD inserted, info is the insertion kind. */
+  SCH_STATS_EVT_INSERT_FAIL,    /*!< BOD not inserted, info is the insertion kind. */
+  SCH_STATS_EVT_CONFLICT_WIN,   /*!< BOD kept over a conflicting BOD, info is the type of the loser. */
+  SCH_STATS_EVT_CONFLICT_LOSE,  /*!< BOD dropped for a conflicting BOD, info is the type of the winner. */
+  SCH_STATS_EVT_CANCEL,         /*!< BOD removed before its execution. */
+  SCH_STATS_EVT_LATE_START,     /*!< BOD could not be started, info is 1 if terminated by the BB. */
+  SCH_STATS_EVT_NUM             /*!< Number of decisions. */
+};
+
+/*! \brief      Insertion kinds. */
+enum
+{
+  SCH_STATS_INSERT_DUE_TIME,    /*!< SchInsertAtDueTime(). */
+  SCH_STATS_INSERT_EARLY,       /*!< SchInsertEarlyAsPossible(). */
+  SCH_STATS_INSERT_LATE,        /*!< SchInsertLateAsPossible(). */
+  SCH_STATS_INSERT_NEXT         /*!< SchInsertNextAvailable(). */
+};
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -38,6 +82,25 @@ extern "C" {
 /*! \brief      Conflict action call signature. */
 typedef BbOpDesc_t*(*BbConflictAct_t)(BbOpDesc_t *pNewBod, BbOpDesc_t *pExistBod);
 
+/*! \brief      Scheduler decision counters of a BOD type, indexed by SCH_STATS_EVT_*. */
+typedef struct
+{
+  uint32_t  count[SCH_STATS_EVT_NUM];   /*!< Number of decisions. */
+} SchStatsCount_t;
+
+/*! \brief      Scheduler decision. */
+typedef struct
+{
+  uint32_t  time;               /*!< BB clock time of the decision. */
+  uint32_t  due;                /*!< BOD due time. */
+  uint16_t  durUsec;            /*!< BOD minimum duration in microseconds. */
+  uint16_t  bodId;              /*!< BOD identifier, derived from its address. */
+  uint8_t   event;              /*!< Decision, SCH_STATS_EVT_*. */
+  uint8_t   type;               /*!< BOD type. */
+  uint8_t   reschPolicy;        /*!< BOD rescheduling policy. */
+  uint8_t   info;               /*!< Decision specific information. */
+} SchStatsTrace_t;
+
 /**************************************************************************************************
   Function Declarations
 **************************************************************************************************/
@@ -48,6 +111,11 @@ void SchHandlerInit(wsfHandlerId_t handlerId);
 void SchReset(void);
 uint16_t SchStatsGetHandlerWatermarkUsec(void);
 
+/* Statistics */
+void SchStatsGetCount(uint8_t type, SchStatsCount_t *pCount);
+uint8_t SchStatsGetTrace(uint32_t *pSeq, uint8_t num, SchStatsTrace_t *pTrace);
+void SchStatsReset(void);
+
 /* Control */
 void SchHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg);
 
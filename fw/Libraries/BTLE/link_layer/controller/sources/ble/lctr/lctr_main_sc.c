@@ -27,9 +27,58 @@
 #include "lmgr_api_sc.h"
 #include "wsf_assert.h"
 #include "ll_math.h"
+#include "bb_api.h"
+#include "bb_drv.h"
 #include "wsf_trace.h"
 #include <string.h>
 
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief      Number of pre-generated P-256 key pairs. */
+#ifndef LCTR_SC_KEY_POOL_SIZE
+#define LCTR_SC_KEY_POOL_SIZE       2
+#endif
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief      ECC operation running on the math library. */
+enum
+{
+  LCTR_SC_OP_NONE,                      /*!< No operation. */
+  LCTR_SC_OP_KEY_PAIR,                  /*!< Key pair for the host. */
+  LCTR_SC_OP_REFILL,                    /*!< Key pair for the pool. */
+  LCTR_SC_OP_DH_KEY                     /*!< Diffie-Hellman key for the host. */
+};
+
+/*! \brief      Pre-generated P-256 key pair, least significant byte first. */
+typedef struct
+{
+  uint8_t   privKey[LL_ECC_KEY_LEN];        /*!< Private key. */
+  uint8_t   pubKey[LL_ECC_KEY_LEN * 2];     /*!< Public key, X then Y. */
+} lctrScKeyPair_t;
+
+/*! \brief      Secure connections control block. */
+typedef struct
+{
+  lctrScKeyPair_t pool[LCTR_SC_KEY_POOL_SIZE];  /*!< Pre-generated key pairs. */
+  uint8_t   numKeys;                    /*!< Number of key pairs in the pool. */
+  uint8_t   op;                         /*!< ECC operation running on the math library. */
+  bool_t    poolKeyPending;             /*!< Host key pair to be answered from the pool. */
+  uint32_t  startTime;                  /*!< Start of the operation, BB ticks. */
+  uint32_t  busyUsec;                   /*!< Time spent computing the operation. */
+} lctrScCtrlBlk_t;
+
+/**************************************************************************************************
+  Global Variables
+**************************************************************************************************/
+
+/*! \brief      Secure connections control block. */
+static lctrScCtrlBlk_t lctrScCb;
+
 /*************************************************************************************************/
 /*!
  *  \brief      Notify host of key generation.
@@ -78,6 +127,59 @@ static void lctrNotifyGenerateDhKeyInd(const uint8_t *pDhKey)
   LmgrSendEvent((LlEvt_t *)&evt);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief      Start an ECC operation on the math library.
+ *
+ *  \param      op      Operation.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void lctrScOpStart(uint8_t op)
+{
+  lctrScCb.op = op;
+  lctrScCb.startTime = BbDrvGetCurrentTime();
+  lctrScCb.busyUsec = 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Report the time taken by the ECC operation that completed.
+ *
+ *  \return     None.
+ *
+ *  The busy time measures the math backend, the elapsed time includes the other link layer work
+ *  interleaved with the operation.
+ */
+/*************************************************************************************************/
+static void lctrScOpComplete(void)
+{
+  LL_TRACE_INFO3("ECC op=%u busy=%u us elapsed=%u us", lctrScCb.op, lctrScCb.busyUsec,
+                 BB_TICKS_TO_US(BbDrvGetCurrentTime() - lctrScCb.startTime));
+
+  lctrScCb.op = LCTR_SC_OP_NONE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Refill the key pool if the math library is idle.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void lctrScRefillPool(void)
+{
+  if ((lctrScCb.op == LCTR_SC_OP_NONE) &&
+      (lctrScCb.numKeys < LCTR_SC_KEY_POOL_SIZE) &&
+      !lmgrScCb.privKeySet)
+  {
+    /* Runs in steps between other link layer work; a host request takes it over or aborts it. */
+    lctrScOpStart(LCTR_SC_OP_REFILL);
+    LlMathEccGenerateP256KeyPairStart();
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief      P-256 key pair generation.
@@ -87,18 +189,59 @@ static void lctrNotifyGenerateDhKeyInd(const uint8_t *pDhKey)
 /*************************************************************************************************/
 static void lctrScGenerateP256KeyPairContinue(void)
 {
-  if (LlMathEccGenerateP256KeyPairContinue())
+  uint32_t stepStart;
+  bool_t done;
+
+  if (lctrScCb.poolKeyPending)
   {
-    uint8_t pubKey[LL_ECC_KEY_LEN * 2];
+    lctrScKeyPair_t *pKeyPair = &lctrScCb.pool[--lctrScCb.numKeys];
 
-    /* Set the newly-generated private key as the local key. */
-    LlMathEccGenerateP256KeyPairComplete(pubKey, lmgrScCb.privKey);
+    /* Set the pre-generated private key as the local key. */
+    memcpy(lmgrScCb.privKey, pKeyPair->privKey, LL_ECC_KEY_LEN);
 
     /* Notify host that the key was generated. */
-    lctrNotifyReadLocalP256PubKeyInd(pubKey);
+    lctrNotifyReadLocalP256PubKeyInd(pKeyPair->pubKey);
 
+    memset(pKeyPair, 0, sizeof(*pKeyPair));
+    lctrScCb.poolKeyPending = FALSE;
     lmgrScCb.eccOpActive = FALSE;
   }
+
+  /* The event may be left over from an aborted refill. */
+  if ((lctrScCb.op != LCTR_SC_OP_KEY_PAIR) && (lctrScCb.op != LCTR_SC_OP_REFILL))
+  {
+    lctrScRefillPool();
+    return;
+  }
+
+  stepStart = BbDrvGetCurrentTime();
+  done = LlMathEccGenerateP256KeyPairContinue();
+  lctrScCb.busyUsec += BB_TICKS_TO_US(BbDrvGetCurrentTime() - stepStart);
+
+  if (done)
+  {
+    uint8_t pubKey[LL_ECC_KEY_LEN * 2];
+
+    if (lctrScCb.op == LCTR_SC_OP_KEY_PAIR)
+    {
+      /* Set the newly-generated private key as the local key. */
+      LlMathEccGenerateP256KeyPairComplete(pubKey, lmgrScCb.privKey);
+
+      /* Notify host that the key was generated. */
+      lctrNotifyReadLocalP256PubKeyInd(pubKey);
+
+      lmgrScCb.eccOpActive = FALSE;
+    }
+    else
+    {
+      lctrScKeyPair_t *pKeyPair = &lctrScCb.pool[lctrScCb.numKeys++];
+
+      LlMathEccGenerateP256KeyPairComplete(pKeyPair->pubKey, pKeyPair->privKey);
+    }
+
+    lctrScOpComplete();
+    lctrScRefillPool();
+  }
 }
 
 /*************************************************************************************************/
@@ -110,7 +253,19 @@ static void lctrScGenerateP256KeyPairContinue(void)
 /*************************************************************************************************/
 static void lctrScGenerateDhKeyContinue(void)
 {
-  if (LlMathEccGenerateDhKeyContinue())
+  uint32_t stepStart;
+  bool_t done;
+
+  if (lctrScCb.op != LCTR_SC_OP_DH_KEY)
+  {
+    return;
+  }
+
+  stepStart = BbDrvGetCurrentTime();
+  done = LlMathEccGenerateDhKeyContinue();
+  lctrScCb.busyUsec += BB_TICKS_TO_US(BbDrvGetCurrentTime() - stepStart);
+
+  if (done)
   {
     uint8_t dhKey[LL_ECC_KEY_LEN];
 
@@ -120,6 +275,9 @@ static void lctrScGenerateDhKeyContinue(void)
     lctrNotifyGenerateDhKeyInd(dhKey);
 
     lmgrScCb.eccOpActive = FALSE;
+
+    lctrScOpComplete();
+    lctrScRefillPool();
   }
 }
 
@@ -157,7 +315,8 @@ static void lctrScBbDrvEccServiceCback(uint8_t op)
  *  \return     Status error code.
  *
  *  Generate a P-256 public/private key pair.  If another ECC operation (P-256 key pair generation
- *  or Diffie-Hellman key generation) is ongoing, an error will be returned.
+ *  or Diffie-Hellman key generation) is ongoing, an error will be returned.  A key pair generated
+ *  in the background beforehand is returned when available, and the pool is refilled afterwards.
  */
 /*************************************************************************************************/
 uint8_t LctrGenerateP256KeyPair(void)
@@ -172,10 +331,24 @@ uint8_t LctrGenerateP256KeyPair(void)
   lmgrScCb.eccOpActive = TRUE;
   if (lmgrScCb.privKeySet)
   {
+    /* Aborts a refill in progress. */
+    lctrScOpStart(LCTR_SC_OP_KEY_PAIR);
     LlMathEccGenerateP256PublicKeyStart(lmgrScCb.privKey);
   }
+  else if (lctrScCb.numKeys > 0)
+  {
+    /* Answer from the pool in task context, after the command status. */
+    lctrScCb.poolKeyPending = TRUE;
+    lctrScBbDrvEccServiceCback(LL_MATH_ECC_OP_GENERATE_P256_KEY_PAIR);
+  }
+  else if (lctrScCb.op == LCTR_SC_OP_REFILL)
+  {
+    /* The key pair being generated goes to the host instead. */
+    lctrScCb.op = LCTR_SC_OP_KEY_PAIR;
+  }
   else
   {
+    lctrScOpStart(LCTR_SC_OP_KEY_PAIR);
     LlMathEccGenerateP256KeyPairStart();
   }
 
@@ -210,8 +383,9 @@ uint8_t LctrGenerateDhKey(const uint8_t *pPubKey, const uint8_t *pPrivKey)
     return LL_ERROR_CODE_INVALID_HCI_CMD_PARAMS;
   }
 
-  /* Start operation. */
+  /* Start operation, aborting a refill in progress. */
   lmgrScCb.eccOpActive = TRUE;
+  lctrScOpStart(LCTR_SC_OP_DH_KEY);
   LlMathEccGenerateDhKeyStart(pPubKey, pPrivKey);
 
   return LL_SUCCESS;
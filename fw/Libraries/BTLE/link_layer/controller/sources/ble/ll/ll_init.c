@@ -145,6 +145,7 @@ void LlHandlerInit(wsfHandlerId_t handlerId)
   LL_TRACE_INFO0("LlHandlerInit: LL initialization completed");
 
   lmgrPersistCb.handlerId = handlerId;
+  WsfOsSetHandlerPrio(handlerId, WSF_MSG_PRIO_HCI);
   LctrSetSupStates();
 
   /* Setup default public address. */
@@ -28,6 +28,9 @@
 #include "ll_defs.h"
 #include "wsf_assert.h"
 
+/*! \brief      Assert there is a statistics type per BLE operation, and one for all other BODs. */
+WSF_CT_ASSERT(SCH_STATS_NUM_TYPES > BB_BLE_OP_NUM);
+
 /*************************************************************************************************/
 /*!
  *  \brief      Compute the duration in microseconds of an data BLE packet.
@@ -434,3 +437,23 @@ bool_t SchBleGetNextDueTime(uint32_t *pDueTime)
   return FALSE;
 }
 
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Get the statistics type of a BOD.
+ *
+ *  \param      pBod    Target BOD.
+ *
+ *  \return     BLE operation type, BB_BLE_OP_NUM for other protocols.
+ */
+/*************************************************************************************************/
+uint8_t schStatsGetBodType(BbOpDesc_t *pBod)
+{
+  if ((pBod->protId == BB_PROT_BLE) &&
+      (pBod->prot.pBle != NULL))
+  {
+    return pBod->prot.pBle->chan.opType;
+  }
+
+  return BB_BLE_OP_NUM;
+}
@@ -24,6 +24,7 @@
 #include "bb_api.h"
 #include "bb_int.h"
 #include "bb_drv.h"
+#include "ll_math.h"
 
 /**************************************************************************************************
   Globals
@@ -76,6 +77,7 @@ void BbInit(void)
   WSF_ASSERT(pBbRtCfg);
 
   BbDrvInit();
+  LlMathAesInit();
 
   memset(&bbCb, 0, sizeof(bbCb));
 }
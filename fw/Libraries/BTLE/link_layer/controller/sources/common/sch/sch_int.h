@@ -38,6 +38,14 @@ extern "C" {
 /*! \brief      Maximum span of scheduler elements. */
 #define SCH_MAX_SPAN            0x80000000
 
+#if (SCH_STATS_ENABLED)
+/*! \brief      Record a scheduler decision. */
+#define SCH_STATS_RECORD(evt, pBod, info)   schStatsRecord(evt, pBod, info)
+#else
+/*! \brief      Record a scheduler decision. */
+#define SCH_STATS_RECORD(evt, pBod, info)
+#endif
+
 /**************************************************************************************************
   Constants
 **************************************************************************************************/
@@ -100,6 +108,22 @@ void schRemoveHead(void);
 /*************************************************************************************************/
 bool_t schDueTimeInFuture(BbOpDesc_t *pBod);
 
+/* Statistics */
+void schStatsRecord(uint8_t event, BbOpDesc_t *pBod, uint8_t info);
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Get the statistics type of a BOD.
+ *
+ *  \param      pBod    Target BOD.
+ *
+ *  \return     BOD type, below SCH_STATS_NUM_TYPES.
+ *
+ *  Implemented by the protocol scheduler.
+ */
+/*************************************************************************************************/
+uint8_t schStatsGetBodType(BbOpDesc_t *pBod);
+
 #ifdef __cplusplus
 };
 #endif
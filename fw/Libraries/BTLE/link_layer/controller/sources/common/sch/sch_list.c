@@ -428,6 +428,12 @@ static bool_t SchIsBodResolvable(BbOpDesc_t *pItem, BbOpDesc_t *pTgt, BbConflict
     LL_TRACE_WARN2("!!! Scheduling conflict: existing policy=%u prioritized over incoming policy=%u", pTgt->reschPolicy, pItem->reschPolicy);
   }
 
+  if (!result)
+  {
+    SCH_STATS_RECORD(SCH_STATS_EVT_CONFLICT_WIN, pTgt, schStatsGetBodType(pItem));
+    SCH_STATS_RECORD(SCH_STATS_EVT_CONFLICT_LOSE, pItem, schStatsGetBodType(pTgt));
+  }
+
   return result;
 }
 
@@ -468,6 +474,11 @@ static bool_t SchResolveConflict(BbOpDesc_t *pItem, BbOpDesc_t *pTgt)
       schInsertToEmptyList(pItem);
     }
 
+    /* Record before the abort callback, which may reschedule the removed BOD. */
+    SCH_STATS_RECORD(SCH_STATS_EVT_INSERT, pItem, SCH_STATS_INSERT_DUE_TIME);
+    SCH_STATS_RECORD(SCH_STATS_EVT_CONFLICT_WIN, pItem, schStatsGetBodType(pTgt));
+    SCH_STATS_RECORD(SCH_STATS_EVT_CONFLICT_LOSE, pTgt, schStatsGetBodType(pItem));
+
     if (pTgt->abortCback)
     {
       pTgt->abortCback(pTgt);
@@ -476,6 +487,8 @@ static bool_t SchResolveConflict(BbOpDesc_t *pItem, BbOpDesc_t *pTgt)
   else
   {
     LL_TRACE_WARN0("!!! Could not remove existing BOD");
+
+    SCH_STATS_RECORD(SCH_STATS_EVT_CONFLICT_LOSE, pItem, schStatsGetBodType(pTgt));
   }
 
   return result;
@@ -637,6 +650,8 @@ void SchInsertNextAvailable(BbOpDesc_t *pBod)
     }
   }
 
+  SCH_STATS_RECORD(SCH_STATS_EVT_INSERT, pBod, SCH_STATS_INSERT_NEXT);
+
   schLoadNext();
 }
 
@@ -667,6 +682,7 @@ bool_t SchInsertAtDueTime(BbOpDesc_t *pBod, BbConflictAct_t conflictCback)
 
   if (!schDueTimeInFuture(pBod))
   {
+    SCH_STATS_RECORD(SCH_STATS_EVT_INSERT_FAIL, pBod, SCH_STATS_INSERT_DUE_TIME);
     return FALSE;
   }
 
@@ -675,6 +691,7 @@ bool_t SchInsertAtDueTime(BbOpDesc_t *pBod, BbConflictAct_t conflictCback)
     /* No conflict when list is empty. */
     WSF_ASSERT(pBod != schCb.pHead);
     schInsertToEmptyList(pBod);
+    SCH_STATS_RECORD(SCH_STATS_EVT_INSERT, pBod, SCH_STATS_INSERT_DUE_TIME);
     result = TRUE;
   }
   else
@@ -692,6 +709,7 @@ bool_t SchInsertAtDueTime(BbOpDesc_t *pBod, BbConflictAct_t conflictCback)
             ((result = SchIsConflictResolvable(pBod, pCur, conflictCback)) == TRUE))    /* Check priority if due before but done after pCur. */
         {
           schInsertBefore(pBod, pCur);
+          SCH_STATS_RECORD(SCH_STATS_EVT_INSERT, pBod, SCH_STATS_INSERT_DUE_TIME);
           result = TRUE;
         }
         break;
@@ -708,6 +726,7 @@ bool_t SchInsertAtDueTime(BbOpDesc_t *pBod, BbConflictAct_t conflictCback)
       else if (pCur->pNext == NULL)                         /* BOD is due after pCur and pCur is tail, insert after. */
       {
         schInsertAfter(pBod, pCur);
+        SCH_STATS_RECORD(SCH_STATS_EVT_INSERT, pBod, SCH_STATS_INSERT_DUE_TIME);
         result = TRUE;
         break;
       }
@@ -717,6 +736,11 @@ bool_t SchInsertAtDueTime(BbOpDesc_t *pBod, BbConflictAct_t conflictCback)
     }
   }
 
+  if (!result)
+  {
+    SCH_STATS_RECORD(SCH_STATS_EVT_INSERT_FAIL, pBod, SCH_STATS_INSERT_DUE_TIME);
+  }
+
   if (result && (pBod == schCb.pHead))
   {
     result = schTryLoadHead();
@@ -821,6 +845,8 @@ bool_t SchInsertEarlyAsPossible(BbOpDesc_t *pBod, uint32_t min, uint32_t max)
     }
   }
 
+  SCH_STATS_RECORD(result ? SCH_STATS_EVT_INSERT : SCH_STATS_EVT_INSERT_FAIL, pBod, SCH_STATS_INSERT_EARLY);
+
   if (result && (pBod == schCb.pHead))
   {
     result = schTryLoadHead();
@@ -942,6 +968,8 @@ bool_t SchInsertLateAsPossible(BbOpDesc_t *pBod, uint32_t min, uint32_t max)
     }
   }
 
+  SCH_STATS_RECORD(result ? SCH_STATS_EVT_INSERT : SCH_STATS_EVT_INSERT_FAIL, pBod, SCH_STATS_INSERT_LATE);
+
   if (result && (pBod == schCb.pHead))
   {
     result = schTryLoadHead();
@@ -988,6 +1016,7 @@ bool_t SchRemove(BbOpDesc_t *pBod)
 
         /* Call callback after removing from list. */
         schRemoveHead();
+        SCH_STATS_RECORD(SCH_STATS_EVT_CANCEL, pBod, 0);
         schCb.state = SCH_STATE_LOAD;
         if (pBod->abortCback)
         {
@@ -1006,6 +1035,7 @@ bool_t SchRemove(BbOpDesc_t *pBod)
     {
       /* Call callback after removing from list. */
       schRemoveHead();
+      SCH_STATS_RECORD(SCH_STATS_EVT_CANCEL, pBod, 0);
       if (pBod->abortCback)
       {
         pBod->abortCback(pBod);
@@ -1027,6 +1057,7 @@ bool_t SchRemove(BbOpDesc_t *pBod)
 
     /* Call callback after removing from list. */
     schRemoveMiddle(pBod);
+    SCH_STATS_RECORD(SCH_STATS_EVT_CANCEL, pBod, 0);
     if (pBod->abortCback)
     {
       pBod->abortCback(pBod);
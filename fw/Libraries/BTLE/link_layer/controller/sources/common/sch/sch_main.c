@@ -97,6 +97,7 @@ void SchHandlerInit(wsfHandlerId_t handlerId)
   SchInit();
 
   schCb.handlerId = handlerId;
+  WsfOsSetHandlerPrio(handlerId, WSF_MSG_PRIO_HCI);
 
   BbRegister(schBodCompHandler);
 }
@@ -188,6 +189,7 @@ static bool_t schLoadHead(void)
     else
     {
       LL_TRACE_WARN1("!!! BOD terminated on startup, pBod=0x%08x", pBod);
+      SCH_STATS_RECORD(SCH_STATS_EVT_LATE_START, pBod, 1);
 
       if (schCb.eventSetFlag)
       {
@@ -202,6 +204,7 @@ static bool_t schLoadHead(void)
   {
     /* This might occur due to the delay of conflict resolution. */
     LL_TRACE_WARN1("!!! Head element in the past, pBod=0x%08x", pBod);
+    SCH_STATS_RECORD(SCH_STATS_EVT_LATE_START, pBod, 0);
   }
 
   return loaded;
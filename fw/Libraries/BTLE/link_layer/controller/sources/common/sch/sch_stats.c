@@ -0,0 +1,170 @@
+/* Copyright (c) 2009-2019 Arm Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*************************************************************************************************/
+/*!
+ *  \brief Scheduler decision statistics implementation file.
+ */
+/*************************************************************************************************/
+
+#include "sch_int.h"
+#include "wsf_assert.h"
+#include "wsf_cs.h"
+#include "wsf_math.h"
+#include <string.h>
+
+#if (SCH_STATS_ENABLED)
+
+/*! \brief      Assert the trace ring can be indexed with a mask. */
+WSF_CT_ASSERT((SCH_STATS_TRACE_LEN & (SCH_STATS_TRACE_LEN - 1)) == 0);
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief      Scheduler statistics control block. */
+typedef struct
+{
+  SchStatsCount_t count[SCH_STATS_NUM_TYPES];   /*!< Decision counters per BOD type. */
+  SchStatsTrace_t trace[SCH_STATS_TRACE_LEN];   /*!< Most recent decisions. */
+  uint32_t        seq;                          /*!< Sequence number of the next decision. */
+} schStatsCb_t;
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief      Scheduler statistics control block. */
+static schStatsCb_t schStatsCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Record a scheduler decision.
+ *
+ *  \param      event   Decision, SCH_STATS_EVT_*.
+ *  \param      pBod    BOD the decision applies to.
+ *  \param      info    Decision specific information.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void schStatsRecord(uint8_t event, BbOpDesc_t *pBod, uint8_t info)
+{
+  SchStatsTrace_t *pTrace;
+  uint8_t type = WSF_MIN(schStatsGetBodType(pBod), SCH_STATS_NUM_TYPES - 1);
+
+  WSF_ASSERT(event < SCH_STATS_EVT_NUM);
+
+  WSF_CS_INIT(cs);
+  WSF_CS_ENTER(cs);
+
+  schStatsCb.count[type].count[event]++;
+
+  pTrace = &schStatsCb.trace[schStatsCb.seq & (SCH_STATS_TRACE_LEN - 1)];
+  schStatsCb.seq++;
+
+  pTrace->time = BbDrvGetCurrentTime();
+  pTrace->due = pBod->due;
+  pTrace->durUsec = (uint16_t)WSF_MIN(pBod->minDurUsec, 0xFFFF);
+  pTrace->bodId = (uint16_t)((uintptr_t)pBod >> 2);
+  pTrace->event = event;
+  pTrace->type = type;
+  pTrace->reschPolicy = pBod->reschPolicy;
+  pTrace->info = info;
+
+  WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Get the scheduler decision counters of a BOD type.
+ *
+ *  \param      type    BOD type, the BLE operation type for BLE BODs.
+ *  \param      pCount  Decision counters return buffer.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void SchStatsGetCount(uint8_t type, SchStatsCount_t *pCount)
+{
+  type = WSF_MIN(type, SCH_STATS_NUM_TYPES - 1);
+
+  WSF_CS_INIT(cs);
+  WSF_CS_ENTER(cs);
+  *pCount = schStatsCb.count[type];
+  WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Get recorded scheduler decisions.
+ *
+ *  \param      pSeq    Sequence number of the first decision requested, returns the sequence
+ *                      number of the first decision copied.
+ *  \param      num     Maximum number of decisions to copy.
+ *  \param      pTrace  Decisions return buffer.
+ *
+ *  \return     Number of decisions copied.
+ *
+ *  Decisions are kept in a ring of SCH_STATS_TRACE_LEN entries. When the requested decisions
+ *  have been overwritten the oldest decisions kept are copied, the difference between the
+ *  requested and returned sequence numbers is the number of decisions lost. The sequence number
+ *  to request next is the returned one plus the number of decisions copied.
+ */
+/*************************************************************************************************/
+uint8_t SchStatsGetTrace(uint32_t *pSeq, uint8_t num, SchStatsTrace_t *pTrace)
+{
+  uint32_t seq = *pSeq;
+  uint8_t copied = 0;
+
+  WSF_CS_INIT(cs);
+  WSF_CS_ENTER(cs);
+
+  if ((schStatsCb.seq - seq) > SCH_STATS_TRACE_LEN)
+  {
+    /* Requested decisions overwritten, or not recorded yet. */
+    seq = (schStatsCb.seq > SCH_STATS_TRACE_LEN) ? (schStatsCb.seq - SCH_STATS_TRACE_LEN) : 0;
+  }
+
+  *pSeq = seq;
+
+  while ((copied < num) && (seq != schStatsCb.seq))
+  {
+    pTrace[copied++] = schStatsCb.trace[seq & (SCH_STATS_TRACE_LEN - 1)];
+    seq++;
+  }
+
+  WSF_CS_EXIT(cs);
+
+  return copied;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Clear the scheduler decision counters and trace.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void SchStatsReset(void)
+{
+  WSF_CS_INIT(cs);
+  WSF_CS_ENTER(cs);
+  memset(&schStatsCb, 0, sizeof(schStatsCb));
+  WSF_CS_EXIT(cs);
+}
+
+#endif
@@ -68,6 +68,10 @@ extern "C" {
 /*! \brief      Returns the floor of a divide. */
 #define LL_MATH_FLOOR(n,d)      ((n) / (d))
 
+/*! \brief      Hash of a 64-bit key into 1 to 32 bits, multiplicative hash of the folded key. */
+#define LL_MATH_HASH64(k,bits)  ((uint32_t)(((uint32_t)(k) ^ (uint32_t)((uint64_t)(k) >> 32)) * \
+                                            UINT32_C(0x9E3779B1)) >> (32 - (bits)))
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -108,6 +112,38 @@ uint32_t LlMathRandNum(void);
 /*************************************************************************************************/
 void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Detect the AES engine.
+ *
+ *  \return None.
+ *
+ *  Done once, LlMathAesEcb() calls it if it has not run yet.
+ */
+/*************************************************************************************************/
+void LlMathAesInit(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Begin a batch of AES ECB calculations.
+ *
+ *  \return None.
+ *
+ *  The engine stays clocked and keeps its key between the LlMathAesEcb() calls of a batch.
+ *  Batches may nest, each one must be closed with LlMathAesBatchEnd().
+ */
+/*************************************************************************************************/
+void LlMathAesBatchBegin(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  End a batch of AES ECB calculations.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void LlMathAesBatchEnd(void);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Set service callback for ECC generation.
@@ -23,10 +23,22 @@
 #include "bb_ble_api.h"
 #include "wsf_assert.h"
 #include "wsf_error.h"
+#include "ll_math.h"
 #include "util/bda.h"
 #include "util/bstream.h"
 #include <string.h>
 
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief      Empty hash index slot. */
+#define BB_BLE_PERIODICLIST_HASH_EMPTY  0xFF
+
+/*! \brief      Periodic list key of an address type, address and set ID. */
+#define BB_BLE_PERIODICLIST_KEY(addrType, addr, SID) \
+  ((addr) | ((uint64_t)(addrType) << 48) | ((uint64_t)(SID) << 56))
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -34,9 +46,7 @@
 /*! \brief      Periodic list filter table entry. */
 typedef struct
 {
-  uint64_t  addr;                           /*!< Address. */
-  uint8_t   addrType;                       /*!< Address type. */
-  uint8_t   SID;                            /*!< Set ID. */
+  uint64_t  key;                            /*!< Address, address type in bits 48-55, set ID in bits 56-63. */
 } bbBlePeriodicListEntry_t;
 
 /**************************************************************************************************
@@ -47,6 +57,85 @@ static bbBlePeriodicListEntry_t *pBbBlePeriodicListFilt;        /*!< Periodic li
 static uint8_t                  bbBlePeriodicListNumEntries;    /*!< Number of valid periodic list entries. */
 static uint8_t                  bbBlePeriodicListNumEntriesMax; /*!< Maximum number of periodic list entries. */
 
+/*! \brief      Hash index of a periodic list without memory. */
+static uint8_t bbBlePeriodicListHashNone[2] = { BB_BLE_PERIODICLIST_HASH_EMPTY, BB_BLE_PERIODICLIST_HASH_EMPTY };
+
+/*! \brief      Hash index, the periodic list entry in each slot. */
+static uint8_t *pBbBlePeriodicListHash = bbBlePeriodicListHashNone;
+
+/*! \brief      Number of hash index slots, log2. */
+static uint8_t bbBlePeriodicListHashBits = 1;
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Add a periodic list entry to the hash index.
+ *
+ *  \param      entry       Periodic list entry.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void bbBlePeriodicListHashAdd(uint8_t entry)
+{
+  const uint16_t mask = (1 << bbBlePeriodicListHashBits) - 1;
+  uint16_t slot = LL_MATH_HASH64(pBbBlePeriodicListFilt[entry].key, bbBlePeriodicListHashBits);
+
+  /* Linear probing, the index is at most half full. */
+  while (pBbBlePeriodicListHash[slot] != BB_BLE_PERIODICLIST_HASH_EMPTY)
+  {
+    slot = (slot + 1) & mask;
+  }
+
+  pBbBlePeriodicListHash[slot] = entry;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Rebuild the hash index from the periodic list entries.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void bbBlePeriodicListHashBuild(void)
+{
+  uint8_t i;
+
+  memset(pBbBlePeriodicListHash, BB_BLE_PERIODICLIST_HASH_EMPTY, 1 << bbBlePeriodicListHashBits);
+
+  for (i = 0; i < bbBlePeriodicListNumEntries; i++)
+  {
+    bbBlePeriodicListHashAdd(i);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Find a periodic list entry.
+ *
+ *  \param      key         Periodic list key.
+ *
+ *  \return     Periodic list entry or BB_BLE_PERIODICLIST_HASH_EMPTY if not listed.
+ */
+/*************************************************************************************************/
+static uint8_t bbBlePeriodicListFind(uint64_t key)
+{
+  const uint16_t mask = (1 << bbBlePeriodicListHashBits) - 1;
+  uint16_t slot = LL_MATH_HASH64(key, bbBlePeriodicListHashBits);
+  uint8_t entry;
+
+  while ((entry = pBbBlePeriodicListHash[slot]) != BB_BLE_PERIODICLIST_HASH_EMPTY)
+  {
+    if (pBbBlePeriodicListFilt[entry].key == key)
+    {
+      break;
+    }
+
+    slot = (slot + 1) & mask;
+  }
+
+  return entry;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief      Initialize periodic list.
@@ -68,6 +157,8 @@ uint16_t BbBleInitPeriodicList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t f
 
   bbBlePeriodicListNumEntries     = 0;
   bbBlePeriodicListNumEntriesMax  = 0;
+  pBbBlePeriodicListHash          = bbBlePeriodicListHashNone;
+  bbBlePeriodicListHashBits       = 1;
 
   /* Allocate memory. */
   if (((uint32_t)pAvailMem) & 3)
@@ -78,15 +169,26 @@ uint16_t BbBleInitPeriodicList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t f
   pBbBlePeriodicListFilt = (bbBlePeriodicListEntry_t *)pAvailMem;
   pAvailMem   += sizeof(bbBlePeriodicListEntry_t) * numEntries;
 
+  /* Hash index with at least twice as many slots as entries. */
+  bbBlePeriodicListHashBits = 1;
+  while ((1 << bbBlePeriodicListHashBits) < (2 * numEntries))
+  {
+    bbBlePeriodicListHashBits++;
+  }
+  pAvailMem   += 1 << bbBlePeriodicListHashBits;
+
   /* Check memory allocation. */
   if (((uint32_t)(pAvailMem - pFreeMem)) > freeMemSize)
   {
+    bbBlePeriodicListHashBits = 1;
     WSF_ERROR(WSF_ENOMEM);
     WSF_ASSERT(FALSE);
     return 0;
   }
 
+  pBbBlePeriodicListHash = pAvailMem - (1 << bbBlePeriodicListHashBits);
   bbBlePeriodicListNumEntriesMax = numEntries;
+  bbBlePeriodicListHashBuild();
   return (pAvailMem - pFreeMem);
 }
 
@@ -103,17 +205,10 @@ uint16_t BbBleInitPeriodicList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t f
 /*************************************************************************************************/
 bool_t BbBlePeriodicListCheckAddr(uint8_t addrType, uint64_t addr, uint8_t SID)
 {
-  uint8_t i;
-
-  for (i = 0; i < bbBlePeriodicListNumEntries; i++)
+  if (bbBlePeriodicListFind(BB_BLE_PERIODICLIST_KEY(addrType, addr, SID)) != BB_BLE_PERIODICLIST_HASH_EMPTY)
   {
-    if ((pBbBlePeriodicListFilt[i].addrType == addrType) &&
-        (pBbBlePeriodicListFilt[i].addr == addr) &&
-        (pBbBlePeriodicListFilt[i].SID == SID))
-    {
-      /* Peer is in periodic list, allow PDU to pass through the filter. */
-      return TRUE;
-    }
+    /* Peer is in periodic list, allow PDU to pass through the filter. */
+    return TRUE;
   }
 
   /* Peer is not in periodic list, filter out PDU. */
@@ -149,6 +244,7 @@ uint8_t BbBlePeriodicListGetSize(void)
 void BbBlePeriodicListClear(void)
 {
   bbBlePeriodicListNumEntries = 0;
+  bbBlePeriodicListHashBuild();
 }
 
 /*************************************************************************************************/
@@ -171,9 +267,8 @@ bool_t BbBlePeriodicListAdd(uint8_t addrType, uint64_t addr, uint8_t SID)
 {
   if (bbBlePeriodicListNumEntries < bbBlePeriodicListNumEntriesMax)
   {
-    pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries].addrType = addrType;
-    pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries].addr = addr;
-    pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries].SID  = SID;
+    pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries].key = BB_BLE_PERIODICLIST_KEY(addrType, addr, SID);
+    bbBlePeriodicListHashAdd(bbBlePeriodicListNumEntries);
 
     bbBlePeriodicListNumEntries++;
     return TRUE;
@@ -202,25 +297,21 @@ bool_t BbBlePeriodicListAdd(uint8_t addrType, uint64_t addr, uint8_t SID)
 /*************************************************************************************************/
 bool_t BbBlePeriodicListRemove(uint8_t addrType, uint64_t addr, uint8_t SID)
 {
-  uint8_t i;
+  uint8_t i = bbBlePeriodicListFind(BB_BLE_PERIODICLIST_KEY(addrType, addr, SID));
 
-  for (i = 0; i < bbBlePeriodicListNumEntries; i++)
+  if (i == BB_BLE_PERIODICLIST_HASH_EMPTY)
   {
-    if ((pBbBlePeriodicListFilt[i].addrType == addrType) &&
-        (pBbBlePeriodicListFilt[i].addr == addr) &&
-        (pBbBlePeriodicListFilt[i].SID == SID))
-    {
-      /* If there is more than one entry, move the last entry into this slot. */
-      if ((bbBlePeriodicListNumEntries > 1) && (i != bbBlePeriodicListNumEntries - 1))
-      {
-        pBbBlePeriodicListFilt[i].addrType = pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries - 1].addrType;
-        pBbBlePeriodicListFilt[i].addr = pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries - 1].addr;
-        pBbBlePeriodicListFilt[i].SID = pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries - 1].SID;
-      }
-      bbBlePeriodicListNumEntries--;
-      return TRUE;
-    }
+    return FALSE;
   }
 
-  return FALSE;
+  /* If there is more than one entry, move the last entry into this slot. */
+  if ((bbBlePeriodicListNumEntries > 1) && (i != bbBlePeriodicListNumEntries - 1))
+  {
+    pBbBlePeriodicListFilt[i].key = pBbBlePeriodicListFilt[bbBlePeriodicListNumEntries - 1].key;
+  }
+  bbBlePeriodicListNumEntries--;
+
+  /* Entries moved, rebuild rather than delete from the probe sequences. */
+  bbBlePeriodicListHashBuild();
+  return TRUE;
 }
@@ -27,6 +27,7 @@
 #include "bb_ble_drv.h"
 #include "wsf_assert.h"
 #include "wsf_error.h"
+#include "wsf_cs.h"
 #include "ll_math.h"
 #include "util/bda.h"
 #include "util/bstream.h"
@@ -43,6 +44,14 @@
 /*! \brief      Increment statistics counter. */
 #define BB_INC_STAT(s)              s++
 
+/*! \brief      Number of recently seen peer RPAs remembered, a power of 2. */
+#ifndef BB_BLE_RESLIST_RPA_CACHE_SIZE
+#define BB_BLE_RESLIST_RPA_CACHE_SIZE     32
+#endif
+
+/*! \brief      RPA cache resolution of a RPA no resolving list entry resolves. */
+#define BB_BLE_RESLIST_RPA_CACHE_UNKNOWN  0xFF
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -62,6 +71,15 @@ typedef struct
   uint8_t  privMode;                        /*!< Privacy mode. */
 } bbBleResListEntry_t;
 
+/*! \brief      Recently seen peer RPA and its resolution. */
+typedef struct
+{
+  uint32_t rpaLo;                           /*!< RPA bits 0-31. */
+  uint16_t rpaHi;                           /*!< RPA bits 32-47, zero if the entry is unused. */
+  uint8_t  entry;                           /*!< Resolving list index or BB_BLE_RESLIST_RPA_CACHE_UNKNOWN. */
+  uint8_t  epoch;                           /*!< RPA timeout period the RPA was resolved in. */
+} bbBleRpaCacheEntry_t;
+
 /**************************************************************************************************
   Global Variables
 **************************************************************************************************/
@@ -70,6 +88,10 @@ static bbBleResListEntry_t  *pBbBleResListTbl;          /*!< Resolving list. */
 static uint8_t              bbBleResListNumEntries;     /*!< Number of valid resolving list entries. */
 static uint8_t              bbBleResListNumEntriesMax;  /*!< Maximum number of resolving list entries. */
 
+/*! \brief      Recently seen peer RPAs, indexed by their hash. */
+static bbBleRpaCacheEntry_t bbBleRpaCache[BB_BLE_RESLIST_RPA_CACHE_SIZE];
+static uint8_t              bbBleRpaCacheEpoch;         /*!< Current RPA timeout period. */
+
 /*! \brief      Device filter statistics. */
 extern BbBlePduFiltStats_t  bbBlePduFiltStats;
 
@@ -244,6 +266,161 @@ static bool_t bbVerifyRpa(const uint8_t *pIrk, uint64_t rpa)
   return (hash == localHash);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief      Forget all resolved peer RPAs.
+ *
+ *  \return     None.
+ *
+ *  Resolving list indices and IRKs change when the list changes.
+ */
+/*************************************************************************************************/
+static void bbBleRpaCacheFlush(void)
+{
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+  memset(bbBleRpaCache, 0, sizeof(bbBleRpaCache));
+  WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Find the resolution of a recently seen peer RPA.
+ *
+ *  \param      rpa             Peer resolvable private address.
+ *
+ *  \return     Cache entry or NULL if the RPA was not seen recently.
+ */
+/*************************************************************************************************/
+static bbBleRpaCacheEntry_t *bbBleRpaCacheFind(uint64_t rpa)
+{
+  /* The low 24 bits of a RPA are an AES output, they spread RPAs evenly over the cache. */
+  bbBleRpaCacheEntry_t *pCache = &bbBleRpaCache[rpa & (BB_BLE_RESLIST_RPA_CACHE_SIZE - 1)];
+
+  if ((pCache->rpaLo == (uint32_t)rpa) && (pCache->rpaHi == (uint16_t)(rpa >> 32)))
+  {
+    return pCache;
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Remember the resolution of a peer RPA.
+ *
+ *  \param      rpa             Peer resolvable private address.
+ *  \param      entry           Resolving list index or BB_BLE_RESLIST_RPA_CACHE_UNKNOWN.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void bbBleRpaCacheAdd(uint64_t rpa, uint8_t entry)
+{
+  bbBleRpaCacheEntry_t *pCache = &bbBleRpaCache[rpa & (BB_BLE_RESLIST_RPA_CACHE_SIZE - 1)];
+
+  WSF_CS_INIT(cs);
+
+  /* The receive ISR reads the cache. */
+  WSF_CS_ENTER(cs);
+  pCache->rpaLo = (uint32_t)rpa;
+  pCache->rpaHi = (uint16_t)(rpa >> 32);
+  pCache->entry = entry;
+  pCache->epoch = bbBleRpaCacheEpoch;
+  WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Expire the peer RPAs resolved before the last RPA timeout.
+ *
+ *  \return     None.
+ *
+ *  A resolution is kept for one to two RPA timeout periods, about as long as a peer keeps its RPA.
+ */
+/*************************************************************************************************/
+static void bbBleRpaCacheExpire(void)
+{
+  uint8_t i;
+
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+  for (i = 0; i < BB_BLE_RESLIST_RPA_CACHE_SIZE; i++)
+  {
+    if (bbBleRpaCache[i].epoch != bbBleRpaCacheEpoch)
+    {
+      bbBleRpaCache[i].rpaHi = 0;
+    }
+  }
+  bbBleRpaCacheEpoch++;
+  WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Resolve a peer RPA against every peer IRK of the resolving list.
+ *
+ *  \param      rpa             Peer resolvable private address.
+ *
+ *  \return     Resolving list index or BB_BLE_RESLIST_RPA_CACHE_UNKNOWN.
+ */
+/*************************************************************************************************/
+static uint8_t bbBleResolvePeerRpa(uint64_t rpa)
+{
+  uint8_t rprime[LL_KEY_LEN];
+  uint8_t hash[LL_KEY_LEN];
+  uint8_t i;
+
+  /* Check the RPAs cached per entry before any AES. */
+  for (i = 0; i < bbBleResListNumEntries; i++)
+  {
+    if (!pBbBleResListTbl[i].peerIrkZero && (rpa == pBbBleResListTbl[i].peerRpa))
+    {
+      return i;
+    }
+  }
+
+  /* r' = padding | prand, the same for every IRK. */
+  memset(rprime, 0, sizeof(rprime));
+  rprime[0] = (rpa >> 24) & 0xFF;
+  rprime[1] = (rpa >> 32) & 0xFF;
+  rprime[2] = (rpa >> 40) & 0xFF;
+
+  /* Keep the AES engine set up while trying each IRK. */
+  LlMathAesBatchBegin();
+
+  for (i = 0; i < bbBleResListNumEntries; i++)
+  {
+    bbBleResListEntry_t *pEntry = &pBbBleResListTbl[i];
+
+    if (pEntry->peerIrkZero)
+    {
+      continue;
+    }
+
+    /* hash = e(k, r') mod 2^24 */
+    LlMathAesEcb(pEntry->peerIrk, hash, rprime);
+    BB_INC_STAT(bbBlePduFiltStats.peerRpaAesCalc);
+
+    if ((hash[0] == ((rpa >>  0) & 0xFF)) &&
+        (hash[1] == ((rpa >>  8) & 0xFF)) &&
+        (hash[2] == ((rpa >> 16) & 0xFF)))
+    {
+      /* Cache this RPA. */
+      pEntry->peerRpa = rpa;
+      pEntry->peerRpaGenerated = FALSE;
+      BB_INC_STAT(bbBlePduFiltStats.passPeerRpaVerify);
+      break;
+    }
+  }
+
+  LlMathAesBatchEnd();
+
+  return (i < bbBleResListNumEntries) ? i : BB_BLE_RESLIST_RPA_CACHE_UNKNOWN;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief      Get resolving list size.
@@ -270,6 +447,7 @@ uint8_t BbBleResListGetSize(void)
 void BbBleResListClear(void)
 {
   bbBleResListNumEntries = 0;
+  bbBleRpaCacheFlush();
 }
 
 /*************************************************************************************************/
@@ -345,6 +523,9 @@ bool_t BbBleResListAdd(uint8_t peerAddrType, uint64_t peerIdentityAddr, const ui
       pEntry->localRpa = bbGenerateRpa(pEntry->localIrk);
     }
 
+    /* RPAs cached as unknown may resolve with the new IRK. */
+    bbBleRpaCacheFlush();
+
     return TRUE;
   }
 
@@ -377,6 +558,9 @@ bool_t BbBleResListRemove(uint8_t peerAddrType, uint64_t peerIdentityAddr)
       memcpy(pEntry, &pBbBleResListTbl[bbBleResListNumEntries - 1], sizeof(*pEntry));
     }
     bbBleResListNumEntries--;
+
+    /* Cached resolutions refer to moved entries. */
+    bbBleRpaCacheFlush();
     return TRUE;
   }
 
@@ -582,9 +766,25 @@ bool_t BbBleResListGeneratePeer(uint8_t peerAddrType, uint64_t peerIdentityAddr,
 /*************************************************************************************************/
 bool_t BbBleResListCheckResolvePeer(uint64_t rpa, uint8_t *pPeerAddrType, uint64_t *pPeerIdentityAddr)
 {
+  bbBleRpaCacheEntry_t *pCache;
   uint8_t i;
   bool_t resCback = FALSE; /* Only call callback if we have a non-empty resolving list. */
 
+  /* A recently seen RPA needs no resolution. */
+  if ((pCache = bbBleRpaCacheFind(rpa)) != NULL)
+  {
+    if (pCache->entry == BB_BLE_RESLIST_RPA_CACHE_UNKNOWN)
+    {
+      BB_INC_STAT(bbBlePduFiltStats.failPeerRpaCache);
+      return FALSE;
+    }
+
+    *pPeerAddrType     = (pBbBleResListTbl[pCache->entry].peerIdentityAddr >> 48) & 0x1;
+    *pPeerIdentityAddr = pBbBleResListTbl[pCache->entry].peerIdentityAddr & UINT64_C(0xFFFFFFFFFFFF);
+    BB_INC_STAT(bbBlePduFiltStats.passPeerRpaCache);
+    return TRUE;
+  }
+
   for (i = 0; i < bbBleResListNumEntries; i++)
   {
     bbBleResListEntry_t *pEntry = &pBbBleResListTbl[i];
@@ -699,37 +899,33 @@ bool_t BbBleResListIsLocalResolved(uint64_t rpa, uint8_t peerAddrType, uint64_t
 /*************************************************************************************************/
 bool_t BbBleResListResolvePeer(uint64_t rpa, uint8_t *pPeerAddrType, uint64_t *pPeerIdentityAddr)
 {
-  uint8_t i;
+  bbBleRpaCacheEntry_t *pCache;
+  uint8_t entry;
 
-  for (i = 0; i < bbBleResListNumEntries; i++)
+  if ((pCache = bbBleRpaCacheFind(rpa)) != NULL)
   {
-    bbBleResListEntry_t *pEntry = &pBbBleResListTbl[i];
+    entry = pCache->entry;
 
-    if (!pEntry->peerIrkZero)
+    if (entry == BB_BLE_RESLIST_RPA_CACHE_UNKNOWN)
     {
-      bool_t found = FALSE;
-
-      /* Check whether this RPA is the identical to the cached value. */
-      if (rpa == pEntry->peerRpa)
-      {
-        found = TRUE;
-      }
-      else if (bbVerifyRpa(pEntry->peerIrk, rpa))
-      {
-        /* Cache this RPA. */
-        pEntry->peerRpa = rpa;
-        pEntry->peerRpaGenerated = FALSE;
-        found = TRUE;
-        BB_INC_STAT(bbBlePduFiltStats.passPeerRpaVerify);
-      }
-
-      if (found)
-      {
-        *pPeerAddrType     = (pEntry->peerIdentityAddr >> 48) & 0x1;
-        *pPeerIdentityAddr = pEntry->peerIdentityAddr & UINT64_C(0xFFFFFFFFFFFF);
-        return TRUE;
-      }
+      BB_INC_STAT(bbBlePduFiltStats.failPeerRpaCache);
     }
+    else
+    {
+      BB_INC_STAT(bbBlePduFiltStats.passPeerRpaCache);
+    }
+  }
+  else
+  {
+    entry = bbBleResolvePeerRpa(rpa);
+    bbBleRpaCacheAdd(rpa, entry);
+  }
+
+  if (entry != BB_BLE_RESLIST_RPA_CACHE_UNKNOWN)
+  {
+    *pPeerAddrType     = (pBbBleResListTbl[entry].peerIdentityAddr >> 48) & 0x1;
+    *pPeerIdentityAddr = pBbBleResListTbl[entry].peerIdentityAddr & UINT64_C(0xFFFFFFFFFFFF);
+    return TRUE;
   }
 
   BB_INC_STAT(bbBlePduFiltStats.failPeerRpaVerify);
@@ -860,6 +1056,8 @@ void BbBleResListHandleTimeout(void)
 {
   uint8_t i;
 
+  LlMathAesBatchBegin();
+
   for (i = 0; i < bbBleResListNumEntries; i++)
   {
     bbBleResListEntry_t *pEntry = &pBbBleResListTbl[i];
@@ -873,4 +1071,8 @@ void BbBleResListHandleTimeout(void)
       pEntry->peerRpa = bbGenerateRpa(pEntry->peerIrk);
     }
   }
+
+  LlMathAesBatchEnd();
+
+  bbBleRpaCacheExpire();
 }
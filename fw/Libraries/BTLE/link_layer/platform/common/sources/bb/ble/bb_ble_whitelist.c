@@ -23,10 +23,18 @@
 #include "bb_ble_api.h"
 #include "wsf_assert.h"
 #include "wsf_error.h"
+#include "ll_math.h"
 #include "util/bda.h"
 #include "util/bstream.h"
 #include <string.h>
 
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief      Empty hash index slot. */
+#define BB_BLE_WHITELIST_HASH_EMPTY     0xFF
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -46,6 +54,57 @@ static uint8_t                bbBleWhiteListNumEntries;     /*!< Number of valid
 static uint8_t                bbBleWhiteListNumEntriesMax;  /*!< Maximum number of white list entries. */
 static bool_t                 bbBleWhiteListAllowAnonymous; /*!< Allow anonymous peer address. */
 
+/*! \brief      Hash index of a white list without memory. */
+static uint8_t bbBleWhiteListHashNone[2] = { BB_BLE_WHITELIST_HASH_EMPTY, BB_BLE_WHITELIST_HASH_EMPTY };
+
+/*! \brief      Hash index, the white list entry in each slot. */
+static uint8_t *pBbBleWhiteListHash = bbBleWhiteListHashNone;
+
+/*! \brief      Number of hash index slots, log2. */
+static uint8_t bbBleWhiteListHashBits = 1;
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Add a white list entry to the hash index.
+ *
+ *  \param      entry       White list entry.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void bbBleWhiteListHashAdd(uint8_t entry)
+{
+  const uint16_t mask = (1 << bbBleWhiteListHashBits) - 1;
+  uint16_t slot = LL_MATH_HASH64(pBbBleWhiteListFilt[entry].addr, bbBleWhiteListHashBits);
+
+  /* Linear probing, the index is at most half full. */
+  while (pBbBleWhiteListHash[slot] != BB_BLE_WHITELIST_HASH_EMPTY)
+  {
+    slot = (slot + 1) & mask;
+  }
+
+  pBbBleWhiteListHash[slot] = entry;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Rebuild the hash index from the white list entries.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+static void bbBleWhiteListHashBuild(void)
+{
+  uint8_t i;
+
+  memset(pBbBleWhiteListHash, BB_BLE_WHITELIST_HASH_EMPTY, 1 << bbBleWhiteListHashBits);
+
+  for (i = 0; i < bbBleWhiteListNumEntries; i++)
+  {
+    bbBleWhiteListHashAdd(i);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief      Initialize white list.
@@ -68,6 +127,8 @@ uint16_t BbBleInitWhiteList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t free
   bbBleWhiteListNumEntries     = 0;
   bbBleWhiteListNumEntriesMax  = 0;
   bbBleWhiteListAllowAnonymous = FALSE;
+  pBbBleWhiteListHash          = bbBleWhiteListHashNone;
+  bbBleWhiteListHashBits       = 1;
 
   /* Allocate memory. */
   if (((uint32_t)pAvailMem) & 3)
@@ -78,15 +139,26 @@ uint16_t BbBleInitWhiteList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t free
   pBbBleWhiteListFilt = (bbBleWhiteListEntry_t *)pAvailMem;
   pAvailMem   += sizeof(bbBleWhiteListEntry_t) * numEntries;
 
+  /* Hash index with at least twice as many slots as entries. */
+  bbBleWhiteListHashBits = 1;
+  while ((1 << bbBleWhiteListHashBits) < (2 * numEntries))
+  {
+    bbBleWhiteListHashBits++;
+  }
+  pAvailMem   += 1 << bbBleWhiteListHashBits;
+
   /* Check memory allocation. */
   if (((uint32_t)(pAvailMem - pFreeMem)) > freeMemSize)
   {
+    bbBleWhiteListHashBits = 1;
     WSF_ERROR(WSF_ENOMEM);
     WSF_ASSERT(FALSE);
     return 0;
   }
 
+  pBbBleWhiteListHash = pAvailMem - (1 << bbBleWhiteListHashBits);
   bbBleWhiteListNumEntriesMax = numEntries;
+  bbBleWhiteListHashBuild();
   return (pAvailMem - pFreeMem);
 }
 
@@ -102,17 +174,23 @@ uint16_t BbBleInitWhiteList(uint8_t numEntries, uint8_t *pFreeMem, uint32_t free
 /*************************************************************************************************/
 bool_t BbBleWhiteListCheckAddr(bool_t randAddr, uint64_t addr)
 {
-  uint8_t i;
+  const uint16_t mask = (1 << bbBleWhiteListHashBits) - 1;
+  uint16_t slot;
+  uint8_t entry;
 
   addr |= (uint64_t)randAddr << 48;
 
-  for (i = 0; i < bbBleWhiteListNumEntries; i++)
+  slot = LL_MATH_HASH64(addr, bbBleWhiteListHashBits);
+
+  while ((entry = pBbBleWhiteListHash[slot]) != BB_BLE_WHITELIST_HASH_EMPTY)
   {
-    if (addr == pBbBleWhiteListFilt[i].addr)
+    if (addr == pBbBleWhiteListFilt[entry].addr)
     {
       /* Peer is in white list, allow PDU to pass through the filter. */
       return TRUE;
     }
+
+    slot = (slot + 1) & mask;
   }
 
   /* Peer is not in white list, filter out PDU. */
@@ -149,6 +227,7 @@ void BbBleWhiteListClear(void)
 {
   bbBleWhiteListNumEntries = 0;
   bbBleWhiteListAllowAnonymous = FALSE;
+  bbBleWhiteListHashBuild();
 }
 
 /*************************************************************************************************/
@@ -172,6 +251,7 @@ bool_t BbBleWhiteListAdd(bool_t randAddr, uint64_t addr)
   {
     addr |= (uint64_t)randAddr << 48;
     pBbBleWhiteListFilt[bbBleWhiteListNumEntries].addr = addr;
+    bbBleWhiteListHashAdd(bbBleWhiteListNumEntries);
 
     bbBleWhiteListNumEntries++;
     return TRUE;
@@ -212,6 +292,9 @@ bool_t BbBleWhiteListRemove(bool_t randAddr, uint64_t addr)
         pBbBleWhiteListFilt[i].addr = pBbBleWhiteListFilt[bbBleWhiteListNumEntries - 1].addr;
       }
       bbBleWhiteListNumEntries--;
+
+      /* Entries moved, rebuild rather than delete from the probe sequences. */
+      bbBleWhiteListHashBuild();
       return TRUE;
     }
   }
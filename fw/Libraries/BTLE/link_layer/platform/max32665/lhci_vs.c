@@ -43,12 +43,19 @@
 #include "lhci_int.h"
 #include "bb_ble_api.h"
 #include "bb_ble_drv_vs.h"
+#include "sch_api.h"
+#include "wsf_math.h"
 
 /**************************************************************************************************
   Macros
 **************************************************************************************************/
 #define LHCI_OPCODE_VS_SET_DEF_TX_POWER           HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DD)  /*!< Set default transmit power. */
 #define LHCI_OPCODE_VS_CALIBRATE                  HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DE)  /*!< Run AFE calibration. */
+#define LHCI_OPCODE_VS_GET_SCH_TRACE              HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3D9)  /*!< Get scheduler decision trace. */
+#define LHCI_OPCODE_VS_GET_SCH_STATS              HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DF)  /*!< Get scheduler decision counters. */
+
+#define LHCI_LEN_VS_SCH_TRACE_ENTRY               16  /*!< Length of a scheduler decision in the trace event. */
+#define LHCI_VS_SCH_TRACE_MAX                     14  /*!< Maximum number of scheduler decisions per event. */
 
 /**************************************************************************************************
   Data Types
@@ -162,6 +169,91 @@ static void lhciVsCommonSendCmdCmplEvt(LhciHdr_t *pCmdHdr, uint8_t status, uint8
   lhciSendCmdCmplEvt(pEvtBuf);
 }
 
+#if (SCH_STATS_ENABLED)
+/*************************************************************************************************/
+/*!
+ *  \brief  Send the scheduler decision counters of a BOD type.
+ *
+ *  \param  pCmdHdr     Command HCI header.
+ *  \param  type        BOD type.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void lhciVsSendSchStatsEvt(LhciHdr_t *pCmdHdr, uint8_t type)
+{
+  SchStatsCount_t count;
+  uint8_t *pEvtBuf;
+  uint8_t *pBuf;
+  uint8_t i;
+
+  if ((pEvtBuf = lhciAllocCmdCmplEvt(1 + sizeof(count) + sizeof(uint16_t), pCmdHdr->opCode)) == NULL)
+  {
+    return;
+  }
+
+  SchStatsGetCount(type, &count);
+
+  pBuf = pEvtBuf;
+  pBuf += lhciPackCmdCompleteEvtStatus(pEvtBuf, HCI_SUCCESS);
+
+  UINT8_TO_BSTREAM(pBuf, type);
+  for (i = 0; i < SCH_STATS_EVT_NUM; i++)
+  {
+    UINT32_TO_BSTREAM(pBuf, count.count[i]);
+  }
+  UINT16_TO_BSTREAM(pBuf, SchStatsGetHandlerWatermarkUsec());
+
+  lhciSendCmdCmplEvt(pEvtBuf);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send recorded scheduler decisions.
+ *
+ *  \param  pCmdHdr     Command HCI header.
+ *  \param  seq         Sequence number of the first decision requested.
+ *  \param  num         Maximum number of decisions requested.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void lhciVsSendSchTraceEvt(LhciHdr_t *pCmdHdr, uint32_t seq, uint8_t num)
+{
+  SchStatsTrace_t trace[LHCI_VS_SCH_TRACE_MAX];
+  uint8_t *pEvtBuf;
+  uint8_t *pBuf;
+  uint8_t i;
+
+  num = SchStatsGetTrace(&seq, WSF_MIN(num, LHCI_VS_SCH_TRACE_MAX), trace);
+
+  if ((pEvtBuf = lhciAllocCmdCmplEvt(sizeof(uint32_t) + 1 + num * LHCI_LEN_VS_SCH_TRACE_ENTRY,
+                                     pCmdHdr->opCode)) == NULL)
+  {
+    return;
+  }
+
+  pBuf = pEvtBuf;
+  pBuf += lhciPackCmdCompleteEvtStatus(pEvtBuf, HCI_SUCCESS);
+
+  UINT32_TO_BSTREAM(pBuf, seq);
+  UINT8_TO_BSTREAM(pBuf, num);
+  for (i = 0; i < num; i++)
+  {
+    UINT32_TO_BSTREAM(pBuf, trace[i].time);
+    UINT32_TO_BSTREAM(pBuf, trace[i].due);
+    UINT16_TO_BSTREAM(pBuf, trace[i].durUsec);
+    UINT16_TO_BSTREAM(pBuf, trace[i].bodId);
+    UINT8_TO_BSTREAM(pBuf, trace[i].event);
+    UINT8_TO_BSTREAM(pBuf, trace[i].type);
+    UINT8_TO_BSTREAM(pBuf, trace[i].reschPolicy);
+    UINT8_TO_BSTREAM(pBuf, trace[i].info);
+  }
+
+  lhciSendCmdCmplEvt(pEvtBuf);
+}
+#endif
+
 
 /*************************************************************************************************/
 bool_t lhciCommonVsStdDecodeCmdPkt(LhciHdr_t *pHdr, uint8_t *pBuf)
@@ -190,6 +282,24 @@ bool_t lhciCommonVsStdDecodeCmdPkt(LhciHdr_t *pHdr, uint8_t *pBuf)
       case LHCI_OPCODE_VS_CALIBRATE:
         BbBleDrvCalibrate();
         break;
+#if (SCH_STATS_ENABLED)
+      case LHCI_OPCODE_VS_GET_SCH_STATS:
+      {
+        uint8_t type;
+        BSTREAM_TO_UINT8(type, pBuf);
+        lhciVsSendSchStatsEvt(pHdr, type);
+        return TRUE;
+      }
+      case LHCI_OPCODE_VS_GET_SCH_TRACE:
+      {
+        uint32_t seq;
+        uint8_t num;
+        BSTREAM_TO_UINT32(seq, pBuf);
+        BSTREAM_TO_UINT8(num, pBuf);
+        lhciVsSendSchTraceEvt(pHdr, seq, num);
+        return TRUE;
+      }
+#endif
 
       default:
           return FALSE;
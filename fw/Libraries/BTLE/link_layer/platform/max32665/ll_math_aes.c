@@ -75,6 +75,7 @@
 #include <string.h>
 #include "ll_math.h"
 #include "wsf_assert.h"
+#include "wsf_cs.h"
 #include "max32665.h"
 #include "gcr_regs.h"
 #include "tpu_regs.h"
@@ -93,6 +94,15 @@
 #define HW_AES_DISABLE_OFFSET           0x198
 #define HW_AES_DISABLE_VALUE            0xAA00AA00
 
+#define LL_MATH_AES_CIPHER_CTRL         (MXC_S_TPU_CIPHER_CTRL_MODE_ECB | \
+                                        MXC_S_TPU_CIPHER_CTRL_CIPHER_AES128 | \
+                                        MXC_S_TPU_CIPHER_CTRL_SRC_CIPHERKEY)
+
+/* Number of software key schedules kept, one per IRK/LTK in use */
+#ifndef LL_MATH_AES_KEY_CACHE_SIZE
+#define LL_MATH_AES_KEY_CACHE_SIZE      4
+#endif
+
 /*
 * 32-bit integer manipulation macros (little endian)
 */
@@ -151,9 +161,37 @@ typedef struct {
     uint32_t buf[68]; /*!< unaligned data */
 } aes_context;
 
+/* AES engine in use */
+enum {
+    LL_MATH_AES_ENGINE_UNKNOWN,
+    LL_MATH_AES_ENGINE_HW,
+    LL_MATH_AES_ENGINE_SW
+};
+
+/* Cached software key schedule */
+typedef struct {
+    uint8_t key[AES_BLOCK_SIZE]; /*!< Key, LSB first */
+    bool_t valid; /*!< Entry in use */
+    aes_context ctx; /*!< Key schedule */
+} llMathAesSwKey_t;
+
 /**************************************************************************************************
   Variables
 **************************************************************************************************/
+
+/* AES control block */
+static struct {
+    uint8_t engine; /*!< Engine detected at init */
+    uint8_t batchDepth; /*!< Nested batches open */
+    bool_t hwKeyLoaded; /*!< TPU holds hwKey */
+    uint8_t hwKey[AES_BLOCK_SIZE]; /*!< Key loaded in the TPU */
+    uint32_t perckcn0; /*!< Clock state saved by the outermost batch */
+    uint32_t clkcn; /*!< HIRC state saved by the outermost batch */
+#ifdef ENABLE_SOFT_AES
+    uint8_t swKeyNext; /*!< Next key schedule entry to replace */
+    llMathAesSwKey_t swKey[LL_MATH_AES_KEY_CACHE_SIZE]; /*!< Key schedules */
+#endif
+} llMathAesCb;
 /*
 * Forward S-box & tables
 */
@@ -400,34 +438,58 @@ static int aes_crypt_ecb_enc( aes_context *ctx,
     return( 0 );
 }
 
+#ifdef ENABLE_SOFT_AES
 /* Software implementation of AES */
 /*************************************************************************************************/
-static void LlMathAesEcbSw(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+static aes_context *llMathAesSwKey(const uint8_t *pKey)
 {
     int i;
     uint8_t temp[AES_BLOCK_SIZE];
-    aes_context aesContext;
+    llMathAesSwKey_t *pEntry;
+
+    /* Reuse the key schedule of a recent key, RPA resolution cycles through the IRKs */
+    for(i = 0; i < LL_MATH_AES_KEY_CACHE_SIZE; i++) {
+        pEntry = &llMathAesCb.swKey[i];
+        if(pEntry->valid && (memcmp(pEntry->key, pKey, AES_BLOCK_SIZE) == 0)) {
+            return &pEntry->ctx;
+        }
+    }
+
+    /* Replace the oldest entry */
+    pEntry = &llMathAesCb.swKey[llMathAesCb.swKeyNext];
+    llMathAesCb.swKeyNext = (llMathAesCb.swKeyNext + 1) % LL_MATH_AES_KEY_CACHE_SIZE;
 
     /* Byte swap the key */
     for(i = 0; i < AES_BLOCK_SIZE; i++) {
         temp[i] = pKey[AES_BLOCK_SIZE-1-i];
     }
-    aes_setkey_enc(&aesContext, (const unsigned char *)temp, AES_KEY_SIZE_BITS);
+    aes_setkey_enc(&pEntry->ctx, (const unsigned char *)temp, AES_KEY_SIZE_BITS);
+
+    memcpy(pEntry->key, pKey, AES_BLOCK_SIZE);
+    pEntry->valid = TRUE;
+
+    return &pEntry->ctx;
+}
+
+/*************************************************************************************************/
+static void LlMathAesEcbSw(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+{
+    int i;
+    uint8_t temp[AES_BLOCK_SIZE];
+    aes_context *pAesContext = llMathAesSwKey(pKey);
 
     /* Byte swap the input */
     for(i = 0; i < AES_BLOCK_SIZE; i++) {
         temp[i] = pIn[AES_BLOCK_SIZE-1-i];
     }
-    aes_crypt_ecb_enc(&aesContext, (const unsigned char*)temp, (unsigned char*)pOut);
+    aes_crypt_ecb_enc(pAesContext, (const unsigned char*)temp, (unsigned char*)temp);
 
     /* Byte swap the output */
     for(i = 0; i < AES_BLOCK_SIZE; i++) {
-        temp[i] = pOut[AES_BLOCK_SIZE-1-i];
+        pOut[i] = temp[AES_BLOCK_SIZE-1-i];
     }
-
-    /* Copy the byte swapped output to the output buffer */
-    memcpy(pOut, temp, AES_BLOCK_SIZE);
 }
+#endif
 
 /*************************************************************************************************/
 static bool_t hwAesEnabled(void)
@@ -466,34 +528,13 @@ static bool_t hwAesEnabled(void)
 }
 
 /*************************************************************************************************/
-void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+static void llMathAesClockOn(uint32_t *pPerckcn0, uint32_t *pClkcn)
 {
-    uint32_t perckcn0, clkcn;
-
-    /* Use 32-bit array for alignment and easy data movement */
-    /* SDMA will not do a 32-bit copy with un-aligned pointers */
-    /* TPU requires 32-bit copy */
-    uint32_t temp_32[4];
-
-    /* Determine if harware AES is available */
-    if(!hwAesEnabled()) {
-
-#ifdef ENABLE_SOFT_AES
-        /* Use software AES if hardware is unavailable */
-        LlMathAesEcbSw(pKey, pOut, pIn);
-        return;
-#endif
-
-        /* Assert if software and hardware AES are unavailable */
-        WSF_ASSERT(0);
-        return;
-    }
-
     /* Save the state of the crypto clock enable bit */
-    perckcn0 = MXC_GCR->perckcn0;
+    *pPerckcn0 = MXC_GCR->perckcn0;
 
     /* Save the state of the HIRC EN */
-    clkcn = MXC_GCR->clkcn;
+    *pClkcn = MXC_GCR->clkcn;
 
     /* Enable CRYPTO clock */
     if ((MXC_GCR->clkcn & MXC_F_GCR_CLKCN_HIRC_EN) == 0) {
@@ -504,6 +545,24 @@ void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
     if (MXC_GCR->perckcn0 & MXC_F_GCR_PERCKCN0_CRYPTOD) {
         MXC_GCR->perckcn0 &= ~(MXC_F_GCR_PERCKCN0_CRYPTOD);
     }
+}
+
+/*************************************************************************************************/
+static void llMathAesClockRestore(uint32_t perckcn0, uint32_t clkcn)
+{
+    /* Restore clock settings */
+    MXC_GCR->perckcn0 = perckcn0;
+    MXC_GCR->clkcn = clkcn;
+
+    /* The engine may lose its state while gated */
+    llMathAesCb.hwKeyLoaded = FALSE;
+}
+
+/*************************************************************************************************/
+static void llMathAesHwSetKey(const uint8_t *pKey)
+{
+    /* Use 32-bit array for alignment and easy data movement */
+    uint32_t temp_32[4];
 
     /* Reset Crypto block and clear state */
     MXC_TPU->ctrl = MXC_F_TPU_CTRL_RST;
@@ -515,9 +574,7 @@ void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
     MXC_TPU->ctrl |= MXC_F_TPU_CTRL_BSO;
     MXC_TPU->ctrl |= MXC_F_TPU_CTRL_BSI;
 
-    MXC_TPU->cipher_ctrl = (MXC_S_TPU_CIPHER_CTRL_MODE_ECB |
-                            MXC_S_TPU_CIPHER_CTRL_CIPHER_AES128 | 
-                            MXC_S_TPU_CIPHER_CTRL_SRC_CIPHERKEY);
+    MXC_TPU->cipher_ctrl = LL_MATH_AES_CIPHER_CTRL;
 
     /* Clear all done flags */
     MXC_TPU->ctrl |= MXC_F_TPU_CTRL_DONE_FLAGS;
@@ -529,8 +586,28 @@ void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
     MXC_TPU->cipher_key[2] = temp_32[1];
     MXC_TPU->cipher_key[3] = temp_32[0];
 
+    memcpy(llMathAesCb.hwKey, pKey, AES_BLOCK_SIZE);
+    llMathAesCb.hwKeyLoaded = TRUE;
+
     /* Wait until ready for data */
     while (!(MXC_TPU->ctrl & MXC_F_TPU_CTRL_RDY));
+}
+
+/*************************************************************************************************/
+static bool_t llMathAesHwKeyValid(const uint8_t *pKey)
+{
+    /* Other TPU users reset the engine, which clears the cipher configuration */
+    return llMathAesCb.hwKeyLoaded &&
+           (MXC_TPU->cipher_ctrl == LL_MATH_AES_CIPHER_CTRL) &&
+           (memcmp(llMathAesCb.hwKey, pKey, AES_BLOCK_SIZE) == 0);
+}
+
+/*************************************************************************************************/
+static void llMathAesHwBlock(uint8_t *pOut, const uint8_t *pIn)
+{
+    /* SDMA will not do a 32-bit copy with un-aligned pointers */
+    /* TPU requires 32-bit copy */
+    uint32_t temp_32[4];
 
     /* Copy data to start the operation */
     memcpy(temp_32, pIn, AES_BLOCK_SIZE);
@@ -551,8 +628,94 @@ void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
     temp_32[1] = MXC_TPU->dout[2];
     temp_32[0] = MXC_TPU->dout[3];
     memcpy(pOut, temp_32, AES_BLOCK_SIZE);
+}
 
-    /* Restore clock settings */
-    MXC_GCR->perckcn0 = perckcn0;
-    MXC_GCR->clkcn = clkcn;
+/*************************************************************************************************/
+void LlMathAesInit(void)
+{
+    if(llMathAesCb.engine == LL_MATH_AES_ENGINE_UNKNOWN) {
+        /* Reading the info block may unlock it and flush the cache, do it only once */
+        llMathAesCb.engine = hwAesEnabled() ? LL_MATH_AES_ENGINE_HW : LL_MATH_AES_ENGINE_SW;
+    }
+}
+
+/*************************************************************************************************/
+void LlMathAesBatchBegin(void)
+{
+    WSF_CS_INIT(cs);
+
+    WSF_CS_ENTER(cs);
+
+    LlMathAesInit();
+
+    if((llMathAesCb.batchDepth++ == 0) && (llMathAesCb.engine == LL_MATH_AES_ENGINE_HW)) {
+        llMathAesClockOn(&llMathAesCb.perckcn0, &llMathAesCb.clkcn);
+    }
+
+    WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+void LlMathAesBatchEnd(void)
+{
+    WSF_CS_INIT(cs);
+
+    WSF_CS_ENTER(cs);
+
+    WSF_ASSERT(llMathAesCb.batchDepth > 0);
+
+    if((--llMathAesCb.batchDepth == 0) && (llMathAesCb.engine == LL_MATH_AES_ENGINE_HW)) {
+        llMathAesClockRestore(llMathAesCb.perckcn0, llMathAesCb.clkcn);
+    }
+
+    WSF_CS_EXIT(cs);
+}
+
+/*************************************************************************************************/
+void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+{
+    uint32_t perckcn0 = 0, clkcn = 0;
+    bool_t inBatch;
+
+    /* The link layer calls in from interrupts, each block runs to completion */
+    WSF_CS_INIT(cs);
+
+    WSF_CS_ENTER(cs);
+
+    LlMathAesInit();
+
+    /* Determine if harware AES is available */
+    if(llMathAesCb.engine != LL_MATH_AES_ENGINE_HW) {
+
+#ifdef ENABLE_SOFT_AES
+        /* Use software AES if hardware is unavailable */
+        LlMathAesEcbSw(pKey, pOut, pIn);
+        WSF_CS_EXIT(cs);
+        return;
+#endif
+
+        /* Assert if software and hardware AES are unavailable */
+        WSF_CS_EXIT(cs);
+        WSF_ASSERT(0);
+        return;
+    }
+
+    /* A batch keeps the engine clocked and its key loaded between blocks */
+    inBatch = (llMathAesCb.batchDepth > 0);
+
+    if(!inBatch) {
+        llMathAesClockOn(&perckcn0, &clkcn);
+    }
+
+    if(!llMathAesHwKeyValid(pKey)) {
+        llMathAesHwSetKey(pKey);
+    }
+
+    llMathAesHwBlock(pOut, pIn);
+
+    if(!inBatch) {
+        llMathAesClockRestore(perckcn0, clkcn);
+    }
+
+    WSF_CS_EXIT(cs);
 }
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * Copyright (C) 2019 Maxim Integrated Products, Inc., All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+ * OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the name of Maxim Integrated
+ * Products, Inc. shall not be used except as stated in the Maxim Integrated
+ * Products, Inc. Branding Policy.
+ *
+ * The mere transfer of this software does not imply any licenses
+ * of trade secrets, proprietary technology, copyrights, patents,
+ * trademarks, maskwork rights, or any other form of intellectual
+ * property whatsoever. Maxim Integrated Products, Inc. retains all
+ * ownership rights.
+ *
+ ******************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  P-256 field multiplications for uECC on the modular arithmetic accelerator (MAA).
+ */
+/*************************************************************************************************/
+
+#include "uECC_ll.h"
+
+#if uECC_MOD_MULT_ACCEL
+
+#ifdef ENABLE_SDMA
+#error "The MAA is not available to the link layer running on the SDMA"
+#endif
+
+#include "wsf_types.h"
+#include "wsf_cs.h"
+#include "max32665.h"
+#include "gcr_regs.h"
+#include "tpu_regs.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/* Operand size */
+#define LL_MATH_MAA_WORDS               (uECC_BYTES / 4)
+#define LL_MATH_MAA_BITS                (uECC_BYTES * 8)
+
+/* MAA memory segments, same layout as MAA_Init() */
+#define LL_MATH_MAA_A                   ((volatile uint32_t *)(MXC_BASE_TPU + 0x100))
+#define LL_MATH_MAA_B                   ((volatile uint32_t *)(MXC_BASE_TPU + 0x200))
+#define LL_MATH_MAA_R                   ((volatile uint32_t *)(MXC_BASE_TPU + 0x300))
+#define LL_MATH_MAA_M                   ((volatile uint32_t *)(MXC_BASE_TPU + 0x600))
+
+#define LL_MATH_MAA_CTRL_MEM            ((0x6 << MXC_F_TPU_MAA_CTRL_TMA_POS) | \
+                                        (0x4 << MXC_F_TPU_MAA_CTRL_RMA_POS) | \
+                                        (0x2 << MXC_F_TPU_MAA_CTRL_BMA_POS) | \
+                                        (0x0 << MXC_F_TPU_MAA_CTRL_AMA_POS))
+
+#define LL_MATH_MAA_CTRL_MEM_MASK       (MXC_F_TPU_MAA_CTRL_TMA | MXC_F_TPU_MAA_CTRL_RMA | \
+                                        MXC_F_TPU_MAA_CTRL_BMA | MXC_F_TPU_MAA_CTRL_AMA)
+
+/**************************************************************************************************
+  Variables
+**************************************************************************************************/
+
+/* Modulus loaded in the MAA */
+static const uint32_t *llMathMaaMod = NULL;
+
+/*************************************************************************************************/
+static void llMathMaaClockOn(uint32_t *pPerckcn0, uint32_t *pClkcn)
+{
+    /* Save the clock state, the AES code may be sharing the engine */
+    *pPerckcn0 = MXC_GCR->perckcn0;
+    *pClkcn = MXC_GCR->clkcn;
+
+    /* Enable CRYPTO clock */
+    if ((MXC_GCR->clkcn & MXC_F_GCR_CLKCN_HIRC_EN) == 0) {
+        MXC_GCR->clkcn |= MXC_F_GCR_CLKCN_HIRC_EN;
+    }
+
+    /* Disable CRYPTO clock gate */
+    if (MXC_GCR->perckcn0 & MXC_F_GCR_PERCKCN0_CRYPTOD) {
+        MXC_GCR->perckcn0 &= ~(MXC_F_GCR_PERCKCN0_CRYPTOD);
+    }
+}
+
+/*************************************************************************************************/
+static void llMathMaaClockRestore(uint32_t perckcn0, uint32_t clkcn)
+{
+    MXC_GCR->perckcn0 = perckcn0;
+    MXC_GCR->clkcn = clkcn;
+}
+
+/*************************************************************************************************/
+static bool_t llMathMaaSetupValid(const uint32_t *mod)
+{
+    /* The AES code resets the engine, which clears the MAA configuration */
+    return (llMathMaaMod == mod) &&
+           (MXC_TPU->maa_maws == LL_MATH_MAA_BITS) &&
+           ((MXC_TPU->maa_ctrl & LL_MATH_MAA_CTRL_MEM_MASK) == LL_MATH_MAA_CTRL_MEM);
+}
+
+/*************************************************************************************************/
+static void llMathMaaSetup(const uint32_t *mod)
+{
+    unsigned i;
+
+    /* Unlike MAA_Init(), do not reset the engine: the AES configuration survives */
+    MXC_TPU->ctrl |= MXC_F_TPU_CTRL_FLAG_MODE;
+    MXC_TPU->ctrl &= ~MXC_F_TPU_CTRL_INTR;
+
+    MXC_TPU->maa_maws = (LL_MATH_MAA_BITS << MXC_F_TPU_MAA_MAWS_MAWS_POS) & MXC_F_TPU_MAA_MAWS_MAWS;
+    MXC_TPU->maa_ctrl = LL_MATH_MAA_CTRL_MEM;
+
+    /* The modulus stays loaded between multiplications */
+    for(i = 0; i < LL_MATH_MAA_WORDS; i++) {
+        LL_MATH_MAA_M[i] = mod[i];
+    }
+
+    MXC_TPU->ctrl |= MXC_F_TPU_CTRL_MAA_DONE;
+
+    llMathMaaMod = mod;
+}
+
+/*************************************************************************************************/
+void uECC_mod_mult_accel(uint32_t *result, const uint32_t *left, const uint32_t *right,
+                         const uint32_t *mod)
+{
+    uint32_t perckcn0, clkcn;
+    unsigned i;
+
+    /* The AES code runs from interrupts and resets the engine, each multiplication is atomic */
+    WSF_CS_INIT(cs);
+
+    WSF_CS_ENTER(cs);
+
+    llMathMaaClockOn(&perckcn0, &clkcn);
+
+    if(!llMathMaaSetupValid(mod)) {
+        llMathMaaSetup(mod);
+    }
+
+    for(i = 0; i < LL_MATH_MAA_WORDS; i++) {
+        LL_MATH_MAA_A[i] = left[i];
+        LL_MATH_MAA_B[i] = right[i];
+    }
+
+    /* MAA_Compute() passes the unshifted operation value, use the field setting */
+    MXC_TPU->maa_ctrl = (MXC_TPU->maa_ctrl & ~MXC_F_TPU_MAA_CTRL_CLC) | MXC_S_TPU_MAA_CTRL_CLC_MUL;
+    MXC_TPU->maa_ctrl |= MXC_F_TPU_MAA_CTRL_STC;
+
+    /* Wait until operation is complete */
+    while (!(MXC_TPU->ctrl & MXC_F_TPU_CTRL_MAA_DONE));
+
+    MXC_TPU->ctrl |= MXC_F_TPU_CTRL_MAA_DONE;
+
+    for(i = 0; i < LL_MATH_MAA_WORDS; i++) {
+        result[i] = LL_MATH_MAA_R[i];
+    }
+
+    llMathMaaClockRestore(perckcn0, clkcn);
+
+    WSF_CS_EXIT(cs);
+}
+
+#endif /* uECC_MOD_MULT_ACCEL */
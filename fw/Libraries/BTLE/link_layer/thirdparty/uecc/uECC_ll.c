@@ -520,18 +520,26 @@ static void vli_mmod_fast(uint32_t *RESTRICT result, uint32_t *RESTRICT product)
 static void vli_modMult_fast(uECC_word_t *result,
                              const uECC_word_t *left,
                              const uECC_word_t *right) {
+#if uECC_MOD_MULT_ACCEL
+    uECC_mod_mult_accel(result, left, right, curve_p);
+#else
     uECC_word_t product[2 * uECC_WORDS];
     vli_mult(product, left, right);
     vli_mmod_fast(result, product);
+#endif
 }
 
 #if uECC_SQUARE_FUNC
 
 /* Computes result = left^2 % curve_p. */
 static void vli_modSquare_fast(uECC_word_t *result, const uECC_word_t *left) {
+#if uECC_MOD_MULT_ACCEL
+    uECC_mod_mult_accel(result, left, left, curve_p);
+#else
     uECC_word_t product[2 * uECC_WORDS];
     vli_square(product, left);
     vli_mmod_fast(result, product);
+#endif
 }
 
 #else /* uECC_SQUARE_FUNC */
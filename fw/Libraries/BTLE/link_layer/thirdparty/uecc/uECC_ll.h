@@ -53,6 +53,12 @@ faster by about 8% but increases the code size. */
     #define uECC_SQUARE_FUNC 1
 #endif
 
+/* uECC_MOD_MULT_ACCEL - If enabled (defined as nonzero), the modular multiplications and squarings
+are done by uECC_mod_mult_accel(), provided by the platform, instead of in software. */
+#ifndef uECC_MOD_MULT_ACCEL
+    #define uECC_MOD_MULT_ACCEL 0
+#endif
+
 #define uECC_CONCAT1(a, b) a##b
 #define uECC_CONCAT(a, b) uECC_CONCAT1(a, b)
 
@@ -145,6 +151,23 @@ void uECC_shared_secret_start(const uint8_t public_key[uECC_BYTES*2],
 int uECC_shared_secret_continue(void);
 void uECC_shared_secret_complete(uint8_t secret[uECC_BYTES]);
 
+#if uECC_MOD_MULT_ACCEL
+/* uECC_mod_mult_accel() function.
+Provided by the platform when uECC_MOD_MULT_ACCEL is enabled.
+
+Inputs:
+    left, right - The operands, reduced modulo mod, least significant word first.
+    mod         - The curve prime, least significant word first.
+
+Outputs:
+    result - Will be filled in with (left * right) % mod, fully reduced.
+
+All the values are uECC_BYTES long and 32-bit aligned. result may alias left or right.
+*/
+void uECC_mod_mult_accel(uint32_t *result, const uint32_t *left, const uint32_t *right,
+                         const uint32_t *mod);
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
@@ -157,6 +157,7 @@ typedef struct
  * \param handle        Attribute handle
  * \param continuing    TRUE if more response packets expected
  * \param mtu           Negotiated MTU value
+ * \param isMsg         TRUE if the event is a WSF message buffer
  */
 typedef struct
 {
@@ -166,6 +167,7 @@ typedef struct
   uint16_t              handle;       /*!< \brief Attribute handle */
   bool_t                continuing;   /*!< \brief TRUE if more response packets expected */
   uint16_t              mtu;          /*!< \brief Negotiated MTU value */
+  bool_t                isMsg;        /*!< \brief TRUE if the event is a WSF message buffer */
 } attEvt_t;
 
 /*! \brief ATT event callback type.
@@ -173,6 +175,10 @@ typedef struct
  *  This callback function sends ATT events to the client application.  A
  *  single callback function is used for both ATTS and ATTC.
  *
+ *  Events with isMsg set, such as ATTS_HANDLE_VALUE_CNF, are WSF message buffers.  The
+ *  callback may keep one with WsfMsgRetain() and pass it to WsfMsgSend() instead of copying
+ *  it.  Other events are owned by the stack and must be copied.
+ *
  *  \param pEvt Pointer to ATT event structure.
  *
  *  \return None.
@@ -312,6 +318,14 @@ typedef struct
   uint16_t              value;        /*!< \brief CCCD value */
   uint8_t               idx;          /*!< \brief CCCD settings index */
 } attsCccEvt_t;
+
+/*! \brief Attribute value sent in a multiple handle value notification */
+typedef struct
+{
+  uint16_t              handle;       /*!< \brief Attribute handle */
+  uint16_t              valueLen;     /*!< \brief Length of value data */
+  uint8_t               *pValue;      /*!< \brief Pointer to value data */
+} attsHandleValue_t;
 /**@}*/
 /*! \} */    /* STACK_ATTS_API */
 
@@ -547,6 +561,32 @@ void AttsRemoveGroup(uint16_t startHandle);
 /*************************************************************************************************/
 void AttsCalculateDbHash(void);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the database hash without calculating it, typically a hash stored by
+ *          the application for an unchanged database.
+ *
+ *  \param  pHash   Database hash of ATT_DATABASE_HASH_LEN bytes, in little endian.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsSetDbHash(const uint8_t *pHash);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get a key identifying the database for a given firmware version.
+ *
+ *  \param  version   Firmware version.
+ *
+ *  \return Key, a CRC-32 of the version and the handle range of every group.
+ *
+ *  A stored hash is valid while the key is unchanged.  Adding or removing groups changes the
+ *  key and the hash must then be calculated with AttsCalculateDbHash().
+ */
+/*************************************************************************************************/
+uint32_t AttsGetDbKey(uint32_t version);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Create hash from the database string.
@@ -652,6 +692,24 @@ void AttsHandleValueIndZeroCpy(dmConnId_t connId, uint16_t handle, uint16_t valu
 void AttsHandleValueNtfZeroCpy(dmConnId_t connId, uint16_t handle, uint16_t valueLen,
                                uint8_t *pValue);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Send attribute values in Multiple Handle Value Notifications.
+ *
+ *          Values are packed in order, up to ATTS_MULT_NTF_MAX per PDU and as many as fit in
+ *          the MTU.  If the client has not enabled multiple handle value notifications in its
+ *          client supported features, or a value is left alone in a PDU, the value is sent in
+ *          a Handle Value Notification.  An ATTS_HANDLE_VALUE_CNF event is sent for each handle.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  numValues   Number of values.
+ *  \param  pValues     Attribute values.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsHandleValueMultNtf(dmConnId_t connId, uint8_t numValues, const attsHandleValue_t *pValues);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Register the utility service for managing client characteristic
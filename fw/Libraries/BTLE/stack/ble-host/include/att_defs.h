@@ -157,6 +157,7 @@ extern "C" {
 #define ATT_PDU_VALUE_IND             0x1D      /*!< \brief Handle value indication */
 #define ATT_PDU_VALUE_CNF             0x1E      /*!< \brief Handle value confirmation */
 #define ATT_PDU_MAX                   0x1F      /*!< \brief PDU Maximum */
+#define ATT_PDU_MULT_VALUE_NTF        0x23      /*!< \brief Multiple handle value notification, sent by the server only */
 /**@}*/
 
 /** \name ATT PDU Length Fields
@@ -191,6 +192,8 @@ extern "C" {
 #define ATT_VALUE_NTF_LEN             3 /*!< \brief Value notification length. */
 #define ATT_VALUE_IND_LEN             3 /*!< \brief Value indication length. */
 #define ATT_VALUE_CNF_LEN             1 /*!< \brief Value confirmation length. */
+#define ATT_MULT_VALUE_NTF_LEN        1 /*!< \brief Multiple value notification length. */
+#define ATT_MULT_VALUE_TUPLE_LEN      4 /*!< \brief Multiple value notification handle and length of a value. */
 /**@}*/
 
 /** \name ATT Find Information Response Format
@@ -318,7 +321,8 @@ extern "C" {
 */
 /**@{*/
 #define ATTS_CSF_ROBUST_CACHING      1                       /*!< \brief Robust caching. */
-#define ATTS_CSF_OCT0_FEATURES       ATTS_CSF_ROBUST_CACHING /*!< \brief Mask of all client supported features. */
+#define ATTS_CSF_MULT_VALUE_NTF      4                       /*!< \brief Multiple handle value notifications. */
+#define ATTS_CSF_OCT0_FEATURES       (ATTS_CSF_ROBUST_CACHING | ATTS_CSF_MULT_VALUE_NTF) /*!< \brief Mask of all client supported features. */
 
 #define ATT_CSF_LEN                  1                       /*!< \brief Length of client supported features array. */
 /**@}*/
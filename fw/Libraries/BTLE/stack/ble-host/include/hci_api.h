@@ -824,6 +824,20 @@ typedef struct
   uint8_t             scanType;        /*!< \brief Scan type. */
 } hciExtScanParam_t;
 
+/*! \brief ACL data statistics of a connection */
+typedef struct
+{
+  uint32_t            txPkts;          /*!< \brief ACL packets started. */
+  uint32_t            txFrags;         /*!< \brief ACL fragments sent to the controller. */
+  uint32_t            txBytes;         /*!< \brief ACL payload bytes sent to the controller. */
+  uint32_t            rxPkts;          /*!< \brief Reassembled ACL packets received. */
+  uint32_t            rxBytes;         /*!< \brief Reassembled ACL payload bytes received. */
+  uint8_t             queuedPkts;      /*!< \brief ACL packets waiting to be started. */
+  uint8_t             maxQueuedPkts;   /*!< \brief Most ACL packets waiting to be started. */
+  uint8_t             queuedBufs;      /*!< \brief Controller buffers queued or outstanding. */
+  uint8_t             outBufs;         /*!< \brief Controller buffers outstanding. */
+} hciAclConnStats_t;
+
 /*! \} */    /* STACK_HCI_CMD_API */
 
 /**************************************************************************************************
@@ -992,6 +1006,18 @@ void HciSetMaxRxAclLen(uint16_t len);
 /*************************************************************************************************/
 void HciSetAclQueueWatermarks(uint8_t queueHi, uint8_t queueLo);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the ACL data statistics of a connection.
+ *
+ *  \param  handle    Connection handle.
+ *  \param  pStats    Statistics return buffer.
+ *
+ *  \return TRUE if the connection was found, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t HciGetAclConnStats(uint16_t handle, hciAclConnStats_t *pStats);
+
 /*************************************************************************************************/
 /*!
 *  \brief   Set LE supported features configuration mask.
@@ -50,9 +50,12 @@ typedef struct
   uint8_t           *pNextTxFrag;                 /*!< \brief Next TX ACL packet fragment */
   uint8_t           *pRxAclPkt;                   /*!< \brief RX ACL packet pointer */
   uint8_t           *pNextRxFrag;                 /*!< \brief Next RX ACL packet fragment */
+  wsfQueue_t        txQueue;                      /*!< \brief TX ACL packets waiting to be started */
+  hciAclConnStats_t stats;                        /*!< \brief ACL data statistics */
   uint16_t          handle;                       /*!< \brief Connection handle */
   uint16_t          txAclRemLen;                  /*!< \brief Fragmenting TX ACL packet remaining length */
   uint16_t          rxAclRemLen;                  /*!< \brief Fragmented RX ACL packet remaining length */
+  uint16_t          txDeficit;                    /*!< \brief TX bytes left in this round robin turn */
   bool_t            fragmenting;                  /*!< \brief TRUE if fragmenting a TX ACL packet */
   bool_t            flowDisabled;                 /*!< \brief TRUE if data flow disabled */
   uint8_t           queuedBufs;                   /*!< \brief Queued ACL buffers on this connection */
@@ -65,13 +68,13 @@ typedef struct
   hciCoreConn_t     conn[DM_CONN_MAX];            /*!< \brief Connection structures */
   uint8_t           leStates[HCI_LE_STATES_LEN];  /*!< \brief Controller LE supported states */
   bdAddr_t          bdAddr;                       /*!< \brief Bluetooth device address */
-  wsfQueue_t        aclQueue;                     /*!< \brief HCI ACL TX queue */
   hciCoreConn_t     *pConnRx;                     /*!< \brief Connection struct for current transport RX packet */
   uint16_t          maxRxAclLen;                  /*!< \brief Maximum reassembled RX ACL packet length */
   uint16_t          bufSize;                      /*!< \brief Controller ACL data buffer size */
   uint8_t           aclQueueHi;                   /*!< \brief Disable flow when this many ACL buffers queued */
   uint8_t           aclQueueLo;                   /*!< \brief Enable flow when this many ACL buffers queued */
   uint8_t           availBufs;                    /*!< \brief Current avail ACL data buffers */
+  uint8_t           txConnIdx;                    /*!< \brief Connection whose turn it is to send ACL data */
   uint8_t           numBufs;                      /*!< \brief Controller number of ACL data buffers */
   uint8_t           whiteListSize;                /*!< \brief Controller white list size */
   uint8_t           numCmdPkts;                   /*!< \brief Controller command packed count */
@@ -186,7 +189,8 @@ void hciCoreTxReady(uint8_t bufs);
 
 /*************************************************************************************************/
 /*!
- *  \brief  Send ACL packets, start of packet.
+ *  \brief  Send ACL packets, start of packet.  Only the first fragment is sent, the others
+ *          are sent by hciCoreTxAclContinue().
  *
  *  \param  pConn    Pointer to connection structure.
  *  \param  len      ACL packet length.
@@ -202,8 +206,9 @@ void hciCoreTxAclStart(hciCoreConn_t *pConn, uint16_t len, uint8_t *pData);
  *  \brief  Send ACL packets, continuation of fragmented packets.
  *
  *  \param  pConn    Pointer to connection structure.  If set non-NULL, then a fragment is
- *                   sent from this connection structure.  If NULL the function finds the next
- *                   connection structure with a fragment to be sent.
+ *                   sent from this connection structure.  If NULL the function picks the next
+ *                   connection structure to send by deficit round robin, and starts its next
+ *                   queued packet if it is not fragmenting one.
  *
  *  \return TRUE if packet sent, FALSE otherwise.
  */
@@ -401,10 +401,10 @@ void L2cCocDisconnectReq(uint16_t cid);
  *  \param  len        The length of the payload data in pPacket.
  *  \param  pPayload   Packet payload data.
  *
- *  \return None.
+ *  \return TRUE if the packet was queued, FALSE if buffers could not be allocated.
  */
 /*************************************************************************************************/
-void L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload);
+bool_t L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload);
 
 /*************************************************************************************************/
 /*!
@@ -25,6 +25,7 @@
 #include "wsf_msg.h"
 #include "wsf_trace.h"
 #include "wsf_assert.h"
+#include "wsf_math.h"
 #include "util/bda.h"
 #include "util/bstream.h"
 #include "hci_core.h"
@@ -46,6 +47,12 @@
 #define HCI_ACL_QUEUE_LO          1             /* Enable flow when this many buffers queued */
 #endif
 
+/* Minimum TX bytes, ACL headers included, a connection may send per round robin turn; at least
+ * one full controller buffer is always allowed */
+#ifndef HCI_TX_ACL_QUANTUM
+#define HCI_TX_ACL_QUANTUM        0
+#endif
+
 /* Default maximum ACL packet size for reassembly */
 #ifndef HCI_MAX_RX_ACL_LEN
 #define HCI_MAX_RX_ACL_LEN        HCI_ACL_DEFAULT_LEN
@@ -163,6 +170,9 @@ static void hciCoreConnAlloc(uint16_t handle)
       pConn->flowDisabled = FALSE;
       pConn->outBufs = 0;
       pConn->queuedBufs = 0;
+      pConn->txAclRemLen = 0;
+      pConn->txDeficit = 0;
+      memset(&pConn->stats, 0, sizeof(pConn->stats));
 
       return;
     }
@@ -184,6 +194,8 @@ static void hciCoreConnFree(uint16_t handle)
 {
   uint8_t         i;
   hciCoreConn_t   *pConn = hciCoreCb.conn;
+  uint8_t         *pData;
+  wsfHandlerId_t  handlerId;
 
   /* find connection struct */
   for (i = DM_CONN_MAX; i > 0; i--, pConn++)
@@ -204,11 +216,16 @@ static void hciCoreConnFree(uint16_t handle)
         pConn->pRxAclPkt = NULL;
       }
 
+      /* free any ACL packets waiting to be sent */
+      while ((pData = WsfMsgDeq(&pConn->txQueue, &handlerId)) != NULL)
+      {
+        WsfMsgFree(pData);
+      }
+      pConn->stats.queuedPkts = 0;
+
       /* free structure */
       pConn->handle = HCI_HANDLE_NONE;
 
-      /* optional: iterate through tx ACL queue and free any buffers with this handle */
-
       /* outstanding buffers are now available; service TX data path */
       hciCoreTxReady(pConn->outBufs);
 
@@ -245,25 +262,87 @@ hciCoreConn_t *hciCoreConnByHandle(uint16_t handle)
   return NULL;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the length of the next fragment a connection has to send.
+ *
+ *  \param  pConn    Pointer to connection structure.
+ *
+ *  \return Fragment length including the ACL header, or 0 if nothing to send.
+ */
+/*************************************************************************************************/
+static uint16_t hciCoreNextFragLen(hciCoreConn_t *pConn)
+{
+  uint8_t         *pData;
+  wsfHandlerId_t  handlerId;
+  uint16_t        len;
+
+  if (pConn->handle == HCI_HANDLE_NONE)
+  {
+    return 0;
+  }
+
+  if (pConn->fragmenting)
+  {
+    len = pConn->txAclRemLen;
+  }
+  else if ((pData = WsfMsgPeek(&pConn->txQueue, &handlerId)) != NULL)
+  {
+    BYTES_TO_UINT16(len, &pData[2]);
+  }
+  else
+  {
+    return 0;
+  }
+
+  return WSF_MIN(len, HciGetBufSize()) + HCI_ACL_HDR_LEN;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Get the next connection structure with a packet fragment to send.
  *
  *  \return Pointer to connection structure or NULL if not found.
+ *
+ *  Connections take turns by deficit round robin.  On its turn a connection is given a quantum
+ *  of bytes and sends fragments while their length, ACL header included, is covered by the
+ *  bytes it has left.  A connection streaming large packets therefore gets the same share of
+ *  controller buffers as the others and cannot starve them.
  */
 /*************************************************************************************************/
 static hciCoreConn_t *hciCoreNextConnFragment(void)
 {
   uint8_t         i;
-  hciCoreConn_t   *pConn = hciCoreCb.conn;
+  uint16_t        fragLen;
+  hciCoreConn_t   *pConn;
 
-  /* find connection struct */
-  for (i = DM_CONN_MAX; i > 0; i--, pConn++)
+  /* a quantum covers any fragment so each connection is visited at most once */
+  for (i = DM_CONN_MAX + 1; i > 0; i--)
   {
-    if (pConn->handle != HCI_HANDLE_NONE && pConn->fragmenting)
+    pConn = &hciCoreCb.conn[hciCoreCb.txConnIdx];
+
+    if ((fragLen = hciCoreNextFragLen(pConn)) == 0)
+    {
+      /* idle connections do not save up bytes */
+      pConn->txDeficit = 0;
+    }
+    else if (pConn->txDeficit >= fragLen)
     {
       return pConn;
     }
+
+    /* next connection's turn */
+    if (++hciCoreCb.txConnIdx == DM_CONN_MAX)
+    {
+      hciCoreCb.txConnIdx = 0;
+    }
+
+    pConn = &hciCoreCb.conn[hciCoreCb.txConnIdx];
+
+    if (hciCoreNextFragLen(pConn) > 0)
+    {
+      pConn->txDeficit += WSF_MAX(HCI_TX_ACL_QUANTUM, HciGetBufSize() + HCI_ACL_HDR_LEN);
+    }
   }
 
   return NULL;
@@ -312,6 +391,16 @@ void hciCoreConnClose(uint16_t handle)
 /*************************************************************************************************/
 void hciCoreSendAclData(hciCoreConn_t *pConn, uint8_t *pData)
 {
+  uint16_t len;
+
+  BYTES_TO_UINT16(len, &pData[2]);
+
+  /* charge the fragment to the connection's round robin turn */
+  pConn->txDeficit -= WSF_MIN(pConn->txDeficit, len + HCI_ACL_HDR_LEN);
+
+  pConn->stats.txFrags++;
+  pConn->stats.txBytes += len;
+
   /* increment outstanding buf count for handle */
   pConn->outBufs++;
 
@@ -340,12 +429,6 @@ void hciCoreSendAclData(hciCoreConn_t *pConn, uint8_t *pData)
 /*************************************************************************************************/
 void hciCoreTxReady(uint8_t bufs)
 {
-  uint8_t         *pData;
-  wsfHandlerId_t  handlerId;
-  uint16_t        handle;
-  uint16_t        len;
-  hciCoreConn_t   *pConn;
-
   /* increment available buffers, with ceiling */
   if (bufs > 0)
   {
@@ -356,40 +439,8 @@ void hciCoreTxReady(uint8_t bufs)
     }
   }
 
-  /* service ACL data queue and send as many buffers as we can */
-  while (hciCoreCb.availBufs > 0)
-  {
-    /* send continuation of any fragments first */
-    if (hciCoreTxAclContinue(NULL) == FALSE)
-    {
-      /* if no fragments then check for any queued ACL data */
-      if ((pData = WsfMsgDeq(&hciCoreCb.aclQueue, &handlerId)) != NULL)
-      {
-        /* parse handle and length */
-        BYTES_TO_UINT16(handle, pData);
-        BYTES_TO_UINT16(len, &pData[2]);
-
-        /* look up conn structure and send data */
-        if ((pConn = hciCoreConnByHandle(handle)) != NULL)
-        {
-          hciCoreTxAclStart(pConn, len, pData);
-        }
-        /* handle not found, connection must be closed */
-        else
-        {
-          /* discard buffer */
-          WsfMsgFree(pData);
-
-          HCI_TRACE_WARN1("hciCoreTxReady discarding buffer, handle=%u", handle);
-        }
-      }
-      else
-      {
-        /* no fragments or queued data to send; we're done */
-        break;
-      }
-    }
-  }
+  /* service the connections' ACL data and send as many buffers as we can */
+  while ((hciCoreCb.availBufs > 0) && hciCoreTxAclContinue(NULL));
 }
 
 /*************************************************************************************************/
@@ -414,6 +465,8 @@ void hciCoreTxAclStart(hciCoreConn_t *pConn, uint16_t len, uint8_t *pData)
 
   HCI_TRACE_INFO1("hciCoreTxAclStart len=%u", len);
 
+  pConn->stats.txPkts++;
+
   /* if acl len > controller acl buf len */
   if (len > hciLen)
   {
@@ -430,11 +483,8 @@ void hciCoreTxAclStart(hciCoreConn_t *pConn, uint16_t len, uint8_t *pData)
     /* set acl len in packet to hci acl buf len */
     UINT16_TO_BUF(&pData[2], hciLen);
 
-    /* send the packet */
+    /* send the first fragment; the others take their turns with the other connections */
     hciCoreSendAclData(pConn, pData);
-
-    /* send additional fragments while there are HCI buffers available */
-    while ((hciCoreCb.availBufs > 0) && hciCoreTxAclContinue(pConn));
   }
   else
   {
@@ -456,11 +506,25 @@ void hciCoreTxAclStart(hciCoreConn_t *pConn, uint16_t len, uint8_t *pData)
 /*************************************************************************************************/
 bool_t hciCoreTxAclContinue(hciCoreConn_t *pConn)
 {
-  uint16_t aclLen;
+  uint8_t         *pData;
+  wsfHandlerId_t  handlerId;
+  uint16_t        aclLen;
 
   if (pConn == NULL)
   {
     pConn = hciCoreNextConnFragment();
+
+    /* start the next queued packet if not fragmenting one */
+    if ((pConn != NULL) && !pConn->fragmenting)
+    {
+      pData = WsfMsgDeq(&pConn->txQueue, &handlerId);
+      pConn->stats.queuedPkts--;
+
+      BYTES_TO_UINT16(aclLen, &pData[2]);
+      hciCoreTxAclStart(pConn, aclLen, pData);
+
+      return TRUE;
+    }
   }
 
   if (pConn != NULL)
@@ -473,6 +537,9 @@ bool_t hciCoreTxAclContinue(hciCoreConn_t *pConn)
       /* decrement remaining length */
       pConn->txAclRemLen -= aclLen;
 
+      /* the fragment is sent from the original buffer; its ACL header goes over the last bytes
+       * of the previous fragment, which the transport has already taken */
+
       /* set handle in packet with continuation bit set */
       UINT16_TO_BUF(pConn->pNextTxFrag, (pConn->handle | HCI_PB_CONTINUE));
 
@@ -652,6 +719,13 @@ uint8_t *hciCoreAclReassembly(uint8_t *pData)
     {
       HCI_TRACE_WARN1("unknown pb flags=0x%04x", pbf);
     }
+
+    if (pDataRtn != NULL)
+    {
+      BYTES_TO_UINT16(aclLen, &pDataRtn[2]);
+      pConn->stats.rxPkts++;
+      pConn->stats.rxBytes += aclLen;
+    }
   }
   else
   {
@@ -692,13 +766,14 @@ void HciCoreInit(void)
 {
   uint8_t   i;
 
-  WSF_QUEUE_INIT(&hciCoreCb.aclQueue);
-
   for (i = 0; i < DM_CONN_MAX; i++)
   {
     hciCoreCb.conn[i].handle = HCI_HANDLE_NONE;
+    WSF_QUEUE_INIT(&hciCoreCb.conn[i].txQueue);
   }
 
+  hciCoreCb.txConnIdx = 0;
+
   hciCoreCb.maxRxAclLen = HCI_MAX_RX_ACL_LEN;
   hciCoreCb.aclQueueHi = HCI_ACL_QUEUE_HI;
   hciCoreCb.aclQueueLo = HCI_ACL_QUEUE_LO;
@@ -753,6 +828,32 @@ void HciSetAclQueueWatermarks(uint8_t queueHi, uint8_t queueLo)
   hciCoreCb.aclQueueLo = queueLo;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the ACL data statistics of a connection.
+ *
+ *  \param  handle    Connection handle.
+ *  \param  pStats    Statistics return buffer.
+ *
+ *  \return TRUE if the connection was found, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t HciGetAclConnStats(uint16_t handle, hciAclConnStats_t *pStats)
+{
+  hciCoreConn_t   *pConn;
+
+  if ((pConn = hciCoreConnByHandle(handle)) == NULL)
+  {
+    return FALSE;
+  }
+
+  *pStats = pConn->stats;
+  pStats->queuedBufs = pConn->queuedBufs;
+  pStats->outBufs = pConn->outBufs;
+
+  return TRUE;
+}
+
 /*************************************************************************************************/
 /*!
 *  \brief   Set LE supported features configuration mask.
@@ -800,17 +901,11 @@ void HciSendAclData(uint8_t *pData)
   /* look up connection structure */
   if ((pConn = hciCoreConnByHandle(handle)) != NULL)
   {
-    /* if queue empty and buffers available */
-    if (WsfQueueEmpty(&hciCoreCb.aclQueue) && hciCoreCb.availBufs > 0)
-    {
-      /* send data */
-      hciCoreTxAclStart(pConn, len, pData);
-    }
-    else
-    {
-      /* queue data - message handler ID 'handerId' not used */
-      WsfMsgEnq(&hciCoreCb.aclQueue, 0, pData);
-    }
+    /* queue data on the connection - message handler ID 'handerId' not used */
+    WsfMsgEnq(&pConn->txQueue, 0, pData);
+
+    pConn->stats.queuedPkts++;
+    pConn->stats.maxQueuedPkts = WSF_MAX(pConn->stats.maxQueuedPkts, pConn->stats.queuedPkts);
 
     /* increment buffer queue count for this connection with consideration for HCI fragmentation */
     pConn->queuedBufs += ((len - 1) / HciGetBufSize()) + 1;
@@ -821,6 +916,9 @@ void HciSendAclData(uint8_t *pData)
       pConn->flowDisabled = TRUE;
       (*hciCb.flowCback)(handle, TRUE);
     }
+
+    /* send data if buffers available, in turn with the other connections */
+    hciCoreTxReady(0);
   }
   /* connection not found, connection must be closed */
   else
@@ -16,7 +16,7 @@
 
 /*************************************************************************************************/
 /*!
- *  \brief AES and random number security service implemented using HCI.
+ *  \brief AES and random number security service implemented using HCI or the platform AES.
  */
 /*************************************************************************************************/
 
@@ -84,11 +84,19 @@ uint8_t SecAes(uint8_t *pKey, uint8_t *pPlaintext, wsfHandlerId_t handlerId,
 
     pBuf->type = SEC_TYPE_AES;
 
+#if SEC_AES_CFG == SEC_AES_CFG_PLATFORM
+    /* encrypt now, the result is still delivered as a message */
+    pBuf->msg.aes.pCiphertext = pBuf->ciphertext;
+    PalCryptoAesEcb(pKey, pBuf->ciphertext, pPlaintext);
+
+    WsfMsgSend(handlerId, pBuf);
+#else
     /* queue buffer */
     WsfMsgEnq(&secCb.aesEncQueue, handlerId, pBuf);
 
     /* call HCI encrypt function */
     HciLeEncryptCmd(pKey, pPlaintext);
+#endif
 
     return pBuf->msg.hdr.status;
   }
@@ -130,5 +138,11 @@ void SecAesHciCback(secQueueBuf_t *pBuf, hciEvt_t *pEvent, wsfHandlerId_t handle
 /*************************************************************************************************/
 void SecAesInit(void)
 {
+#if SEC_AES_CFG == SEC_AES_CFG_PLATFORM
+  PalCryptoInit();
+
+  secCb.hciCbackTbl[SEC_TYPE_AES] = NULL;
+#else
   secCb.hciCbackTbl[SEC_TYPE_AES] = SecAesHciCback;
+#endif
 }
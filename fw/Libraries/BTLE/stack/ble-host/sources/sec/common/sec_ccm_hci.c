@@ -33,10 +33,6 @@
 #include "util/calc128.h"
 #include "util/wstr.h"
 
-#ifndef SEC_CCM_CFG
-#define SEC_CCM_CFG SEC_CCM_CFG_HCI
-#endif
-
 #if SEC_CCM_CFG == SEC_CCM_CFG_HCI
 
 /**************************************************************************************************
@@ -32,10 +32,6 @@
 #include "util/calc128.h"
 #include "util/wstr.h"
 
-#ifndef SEC_CMAC_CFG
-#define SEC_CMAC_CFG SEC_CMAC_CFG_HCI
-#endif
-
 #if SEC_CMAC_CFG == SEC_CMAC_CFG_HCI
 
 enum
@@ -59,6 +59,32 @@ extern "C" {
 #define SEC_CCM_CFG_PLATFORM      0
 #define SEC_CCM_CFG_HCI           1
 
+/*! Compile time AES configuration */
+#define SEC_AES_CFG_PLATFORM      0
+#define SEC_AES_CFG_HCI           1
+
+/*! The host shares the AES engine with the controller unless the controller runs on the SDMA
+ *  core.  The platform configurations then encrypt blocks directly instead of sending an HCI
+ *  LE Encrypt command for each.
+ */
+#ifdef ENABLE_SDMA
+#define SEC_CFG_USE_HCI           TRUE
+#else
+#define SEC_CFG_USE_HCI           FALSE
+#endif
+
+#ifndef SEC_AES_CFG
+#define SEC_AES_CFG               ((SEC_CFG_USE_HCI == TRUE) ? SEC_AES_CFG_HCI : SEC_AES_CFG_PLATFORM)
+#endif
+
+#ifndef SEC_CMAC_CFG
+#define SEC_CMAC_CFG              ((SEC_CFG_USE_HCI == TRUE) ? SEC_CMAC_CFG_HCI : SEC_CMAC_CFG_PLATFORM)
+#endif
+
+#ifndef SEC_CCM_CFG
+#define SEC_CCM_CFG               ((SEC_CFG_USE_HCI == TRUE) ? SEC_CCM_CFG_HCI : SEC_CCM_CFG_PLATFORM)
+#endif
+
 /*! CCM Operation (Encryption or Decryption) */
 #define SEC_CCM_OP_ENCRYPT        0
 #define SEC_CCM_OP_DECRYPT        1
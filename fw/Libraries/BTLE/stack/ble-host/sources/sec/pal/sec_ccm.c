@@ -27,10 +27,6 @@
 #include "sec_api.h"
 #include "sec_main.h"
 
-#ifndef SEC_CCM_CFG
-#define SEC_CCM_CFG SEC_CCM_CFG_PLATFORM
-#endif
-
 #if SEC_CCM_CFG == SEC_CCM_CFG_PLATFORM
 
 /**************************************************************************************************
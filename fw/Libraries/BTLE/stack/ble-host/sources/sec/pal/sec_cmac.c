@@ -0,0 +1,202 @@
+/* Copyright (c) 2009-2019 Arm Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*************************************************************************************************/
+/*!
+ *  \brief AES based CMAC security - Native AES.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_msg.h"
+#include "sec_api.h"
+#include "sec_main.h"
+#include "util/wstr.h"
+
+#if SEC_CMAC_CFG == SEC_CMAC_CFG_PLATFORM
+
+/**************************************************************************************************
+  External Variables
+**************************************************************************************************/
+
+/* Global security control block */
+extern secCb_t secCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Double a most significant byte first subkey in GF(2^128).
+ *
+ *  \param  pKey    Subkey.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void secCmacDouble(uint8_t *pKey)
+{
+  uint8_t overflow = pKey[0] >> 7;
+  uint8_t i;
+
+  for (i = 0; i < SEC_BLOCK_LEN - 1; i++)
+  {
+    pKey[i] = (pKey[i] << 1) | (pKey[i + 1] >> 7);
+  }
+
+  pKey[SEC_BLOCK_LEN - 1] = (pKey[SEC_BLOCK_LEN - 1] << 1) ^ (overflow ? SEC_CMAC_RB : 0);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  XOR a most significant byte first block into a least significant byte first state.
+ *
+ *  \param  pState  State, least significant byte first.
+ *  \param  pBlock  Block, most significant byte first.
+ *  \param  len     Bytes of pBlock to XOR.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void secCmacXorRev(uint8_t *pState, const uint8_t *pBlock, uint8_t len)
+{
+  uint8_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    pState[SEC_BLOCK_LEN - 1 - i] ^= pBlock[i];
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Calculate the CMAC of a message.
+ *
+ *  \param  pKey        Key, most significant byte first.
+ *  \param  pText       Message.
+ *  \param  len         Length of pText in bytes.
+ *  \param  pMac        Returns the CMAC, most significant byte first.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void secCmacCalc(const uint8_t *pKey, const uint8_t *pText, uint16_t len, uint8_t *pMac)
+{
+  uint8_t revKey[SEC_BLOCK_LEN];
+  uint8_t subkey[SEC_BLOCK_LEN];
+  uint8_t state[SEC_BLOCK_LEN];
+
+  /* The engine takes least significant byte first blocks, so the chaining state is kept in that
+   * order and the message bytes are XORed into it reversed.
+   */
+  WStrReverseCpy(revKey, pKey, SEC_BLOCK_LEN);
+
+  PalCryptoAesBatchBegin();
+
+  /* Subkey K1, or K2 if the last block is partial */
+  memset(state, 0, SEC_BLOCK_LEN);
+  PalCryptoAesEcb(revKey, state, state);
+  WStrReverseCpy(subkey, state, SEC_BLOCK_LEN);
+  secCmacDouble(subkey);
+
+  if ((len == 0) || (len % SEC_BLOCK_LEN != 0))
+  {
+    secCmacDouble(subkey);
+  }
+
+  memset(state, 0, SEC_BLOCK_LEN);
+
+  /* All blocks but the last */
+  while (len > SEC_BLOCK_LEN)
+  {
+    secCmacXorRev(state, pText, SEC_BLOCK_LEN);
+    PalCryptoAesEcb(revKey, state, state);
+
+    pText += SEC_BLOCK_LEN;
+    len -= SEC_BLOCK_LEN;
+  }
+
+  /* Last block, padded if partial, and its subkey */
+  secCmacXorRev(state, pText, (uint8_t) len);
+
+  if (len < SEC_BLOCK_LEN)
+  {
+    state[SEC_BLOCK_LEN - 1 - len] ^= 0x80;
+  }
+
+  secCmacXorRev(state, subkey, SEC_BLOCK_LEN);
+  PalCryptoAesEcb(revKey, state, state);
+
+  PalCryptoAesBatchEnd();
+
+  WStrReverseCpy(pMac, state, SEC_BLOCK_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Execute the CMAC algorithm.
+ *
+ *  \param  pKey          Key used in CMAC operation.
+ *  \param  pPlainText    Data to perform CMAC operation over
+ *  \param  textLen       Size of pPlaintext in bytes.
+ *  \param  handlerId     WSF handler ID for client.
+ *  \param  param         Optional parameter sent to client's WSF handler.
+ *  \param  event         Event for client's WSF handler.
+ *
+ *  \return TRUE if successful, else FALSE.
+ */
+/*************************************************************************************************/
+bool_t SecCmac(const uint8_t *pKey, uint8_t *pPlainText, uint16_t textLen, wsfHandlerId_t handlerId,
+               uint16_t param, uint8_t event)
+{
+  secQueueBuf_t *pBuf;
+
+  if ((pBuf = WsfMsgAlloc(sizeof(secQueueBuf_t))) != NULL)
+  {
+    secCmacMsg_t *pMsg = (secCmacMsg_t *) &pBuf->msg;
+
+    /* Calculate the whole message now, the result is still delivered as a message. */
+    secCmacCalc(pKey, pPlainText, textLen, pBuf->ciphertext);
+
+    pMsg->hdr.status = secCb.token++;
+    pMsg->hdr.param = param;
+    pMsg->hdr.event = event;
+    pMsg->pCiphertext = pBuf->ciphertext;
+    pMsg->pPlainText = pPlainText;
+
+    WsfMsgSend(handlerId, pMsg);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Called to initialize CMAC security.
+ *
+ *  \param  None.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SecCmacInit(void)
+{
+  PalCryptoInit();
+
+  secCb.hciCbackTbl[SEC_TYPE_CMAC] = NULL;
+}
+
+#endif /* SEC_CMAC_CFG */
@@ -32,14 +32,6 @@
 #include "att_main.h"
 #include "dm_api.h"
 
-/**************************************************************************************************
-  Macros
-**************************************************************************************************/
-
-/* indexes into base UUID for 16-to-128 bit UUID conversion */
-#define ATT_BASE_UUID_POS_0      12
-#define ATT_BASE_UUID_POS_1      13
-
 /**************************************************************************************************
   Local Variables
 **************************************************************************************************/
@@ -336,19 +328,38 @@ void attSetMtu(attCcb_t *pCcb, uint16_t peerMtu, uint16_t localMtu)
 /*************************************************************************************************/
 void attExecCallback(dmConnId_t connId, uint8_t event, uint16_t handle, uint8_t status, uint16_t mtu)
 {
+  attEvt_t evt;
+  attEvt_t *pEvt;
+
   if (attCb.cback)
   {
-    attEvt_t evt;
+    /* event is a message so the application can forward it without copying, or on the stack
+     * when no buffer is available */
+    if ((pEvt = WsfMsgAlloc(sizeof(attEvt_t))) != NULL)
+    {
+      pEvt->isMsg = TRUE;
+    }
+    else
+    {
+      pEvt = &evt;
+      pEvt->isMsg = FALSE;
+    }
 
-    evt.hdr.param = connId;
-    evt.hdr.event = event;
-    evt.hdr.status = status;
-    evt.valueLen = 0;
-    evt.handle = handle;
-    evt.continuing = 0;
-    evt.mtu = mtu;
+    pEvt->hdr.param = connId;
+    pEvt->hdr.event = event;
+    pEvt->hdr.status = status;
+    pEvt->pValue = NULL;
+    pEvt->valueLen = 0;
+    pEvt->handle = handle;
+    pEvt->continuing = 0;
+    pEvt->mtu = mtu;
 
-    (*attCb.cback)(&evt);
+    (*attCb.cback)(pEvt);
+
+    if (pEvt->isMsg)
+    {
+      WsfMsgFree(pEvt);
+    }
   }
 }
 
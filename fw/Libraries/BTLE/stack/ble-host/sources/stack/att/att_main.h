@@ -36,6 +36,10 @@ extern "C" {
   Macros
 **************************************************************************************************/
 
+/* indexes into base UUID for 16-to-128 bit UUID conversion */
+#define ATT_BASE_UUID_POS_0      12
+#define ATT_BASE_UUID_POS_1      13
+
 /* ATT protocol methods */
 #define ATT_METHOD_ERR                0             /* Error response */
 #define ATT_METHOD_MTU                1             /* Exchange mtu */
@@ -321,6 +321,7 @@ void attcProcRsp(attcCcb_t *pCcb, uint16_t len, uint8_t *pPacket)
   evt.valueLen = len - ATT_HDR_LEN;
   evt.handle = pCcb->outReq.handle;
   evt.hdr.status = ATT_SUCCESS;
+  evt.isMsg = FALSE;
   (*attcProcRspTbl[evt.hdr.event])(pCcb, len, pPacket, &evt);
 
   /* if not continuing or status is not success */
@@ -388,6 +389,7 @@ void attcProcInd(attcCcb_t *pCcb, uint16_t len, uint8_t *pPacket)
   evt.hdr.param = pCcb->pMainCcb->connId;
   evt.hdr.status = ATT_SUCCESS;
   evt.continuing = FALSE;
+  evt.isMsg = FALSE;
 
   /* verify handle and call callback */
   if ((evt.handle != 0) && attCb.cback)
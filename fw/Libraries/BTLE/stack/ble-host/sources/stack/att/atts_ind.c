@@ -80,6 +80,34 @@ static attsIndCcb_t *attsIndCcbByConnId(dmConnId_t connId)
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the handles of a multiple handle value notification packet.
+ *
+ *  \param  pPkt      Pointer to packet.
+ *  \param  pHandles  Returned handles, ATTS_MULT_NTF_MAX entries.
+ *
+ *  \return Number of handles.
+ */
+/*************************************************************************************************/
+static uint8_t attsMultNtfHandles(attsPktParam_t *pPkt, uint16_t *pHandles)
+{
+  uint8_t   *p = ((uint8_t *) pPkt) + L2C_PAYLOAD_START + ATT_MULT_VALUE_NTF_LEN;
+  uint8_t   *pEnd = ((uint8_t *) pPkt) + L2C_PAYLOAD_START + pPkt->len;
+  uint16_t  valueLen;
+  uint8_t   num = 0;
+
+  while ((p < pEnd) && (num < ATTS_MULT_NTF_MAX))
+  {
+    BSTREAM_TO_UINT16(pHandles[num], p);
+    BSTREAM_TO_UINT16(valueLen, p);
+    p += valueLen;
+    num++;
+  }
+
+  return num;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Check if application callback is pending for indication or a given notification, or
@@ -108,6 +136,13 @@ static bool_t attsPendIndNtfHandle(attsIndCcb_t *pCcb, attsPktParam_t *pPkt)
     return (pCcb->pendIndHandle == ATT_HANDLE_NONE) ? FALSE : TRUE;
   }
 
+  /* if multiple value notification */
+  if (opcode == ATT_PDU_MULT_VALUE_NTF)
+  {
+    /* see if callbacks pending for a multiple value notification */
+    return (pCcb->pendMultNum == 0) ? FALSE : TRUE;
+  }
+
   /* initialize number of notification callbacks pending */
   pendNtfs = 0;
 
@@ -174,6 +209,38 @@ static void attsExecCallback(dmConnId_t connId, uint16_t handle, uint8_t status)
   attExecCallback(connId, ATTS_HANDLE_VALUE_CNF, handle, status, 0);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Execute application callback function for every handle of a notification packet.
+ *
+ *  \param  connId  DM connection ID.
+ *  \param  pPkt    Pointer to packet.
+ *  \param  status  Callback event status.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsExecPktCallback(dmConnId_t connId, attsPktParam_t *pPkt, uint8_t status)
+{
+  uint16_t    handles[ATTS_MULT_NTF_MAX];
+  uint8_t     num;
+  uint8_t     i;
+
+  if (*(((uint8_t *) pPkt) + L2C_PAYLOAD_START) == ATT_PDU_MULT_VALUE_NTF)
+  {
+    num = attsMultNtfHandles(pPkt, handles);
+
+    for (i = 0; i < num; i++)
+    {
+      attsExecCallback(connId, handles[i], status);
+    }
+  }
+  else
+  {
+    attsExecCallback(connId, pPkt->handle, status);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Call pending indication or/and notification(s) application callback.
@@ -207,6 +274,13 @@ static void attsIndNtfCallback(dmConnId_t connId, attsIndCcb_t *pCcb, uint8_t st
       pCcb->pendNtfHandle[i] = ATT_HANDLE_NONE;
     }
   }
+
+  /* if pending multiple value notification callbacks */
+  for (i = 0; i < pCcb->pendMultNum; i++)
+  {
+    attsExecCallback(connId, pCcb->pendMultHandle[i], status);
+  }
+  pCcb->pendMultNum = 0;
 }
 
 /*************************************************************************************************/
@@ -225,17 +299,43 @@ static void attsSetupMsg(attsIndCcb_t *pCcb, dmConnId_t connId, attsPktParam_t *
   uint8_t     opcode;
   uint16_t    handle;
 
+  uint16_t    multHandles[ATTS_MULT_NTF_MAX];
+  uint8_t     multNum = 0;
+  uint8_t     i;
+
   /* extract opcode */
   opcode = *(((uint8_t *) pPkt) + L2C_PAYLOAD_START);
 
   /* copy handle (it may be overwritten in pPkt) */
   handle = pPkt->handle;
 
+  /* copy handles of a multiple value notification */
+  if (opcode == ATT_PDU_MULT_VALUE_NTF)
+  {
+    multNum = attsMultNtfHandles(pPkt, multHandles);
+  }
+
   /* send pdu */
   L2cDataReq(L2C_CID_ATT, pCcb->pMainCcb->handle, pPkt->len, (uint8_t *) pPkt);
 
+  /* if multiple value notification call callbacks now or set them pending */
+  if (opcode == ATT_PDU_MULT_VALUE_NTF)
+  {
+    if (!(pCcb->pMainCcb->control & ATT_CCB_STATUS_FLOW_DISABLED))
+    {
+      for (i = 0; i < multNum; i++)
+      {
+        attsExecCallback(connId, multHandles[i], ATT_SUCCESS);
+      }
+    }
+    else
+    {
+      memcpy(pCcb->pendMultHandle, multHandles, multNum * sizeof(uint16_t));
+      pCcb->pendMultNum = multNum;
+    }
+  }
   /* if indication store handle and start timer */
-  if (opcode == ATT_PDU_VALUE_IND)
+  else if (opcode == ATT_PDU_VALUE_IND)
   {
     pCcb->outIndHandle = pCcb->pendIndHandle = handle;
     pCcb->outIndTimer.msg.event = ATTS_MSG_IND_TIMEOUT;
@@ -335,7 +435,7 @@ static void attsIndMsgCback(attsApiMsg_t *pMsg)
     if (attsPendIndNtfHandle(pCcb, pMsg->pPkt))
     {
       /* call callback with failure status and free packet buffer */
-      attsExecCallback((dmConnId_t) pMsg->hdr.param, pMsg->pPkt->handle, ATT_ERR_OVERFLOW);
+      attsExecPktCallback((dmConnId_t) pMsg->hdr.param, pMsg->pPkt, ATT_ERR_OVERFLOW);
       WsfMsgFree(pMsg->pPkt);
     }
     /* otherwise ready to send; set up request */
@@ -386,25 +486,18 @@ static void attsIndCtrlCback(wsfMsgHdr_t *pMsg)
 
 /*************************************************************************************************/
 /*!
- *  \brief  Send an attribute protocol Handle Value Indication or Notification.
+ *  \brief  Get the MTU and transaction state of a connection for sending a notification.
  *
- *  \param  connId      DM connection ID.
- *  \param  handle      Attribute handle.
- *  \param  valueLen    Length of value data.
- *  \param  pValue      Pointer to value data.
- *  \param  opcode      Opcode for notification or indication.
- *  \param  zeroCpy     Whether or not to copy attribute value data into new buffer.
+ *  \param  connId          DM connection ID.
+ *  \param  pTransTimedOut  Returns TRUE if a transaction has timed out.
  *
- *  \return None.
+ *  \return MTU size or 0 if connection not in use.
  */
 /*************************************************************************************************/
-static void attsHandleValueIndNtf(dmConnId_t connId, uint16_t handle, uint16_t valueLen,
-                                  uint8_t *pValue, uint8_t opcode, bool_t zeroCpy)
+static uint16_t attsIndNtfMtu(dmConnId_t connId, bool_t *pTransTimedOut)
 {
   attsIndCcb_t   *pCcb;
   uint16_t       mtu;
-  bool_t         transTimedOut;
-  bool_t         pktSent = FALSE;
 
   WsfTaskLock();
 
@@ -413,18 +506,44 @@ static void attsHandleValueIndNtf(dmConnId_t connId, uint16_t handle, uint16_t v
   {
     /* get MTU size */
     mtu = pCcb->pMainCcb->mtu;
-    transTimedOut = !!(pCcb->pMainCcb->control & ATT_CCB_STATUS_TX_TIMEOUT);
+    *pTransTimedOut = !!(pCcb->pMainCcb->control & ATT_CCB_STATUS_TX_TIMEOUT);
   }
   /* else connection not in use */
   else
   {
     /* MTU size unknown */
     mtu = 0;
-    transTimedOut = FALSE;
+    *pTransTimedOut = FALSE;
   }
 
   WsfTaskUnlock();
 
+  return mtu;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an attribute protocol Handle Value Indication or Notification.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  handle      Attribute handle.
+ *  \param  valueLen    Length of value data.
+ *  \param  pValue      Pointer to value data.
+ *  \param  opcode      Opcode for notification or indication.
+ *  \param  zeroCpy     Whether or not to copy attribute value data into new buffer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsHandleValueIndNtf(dmConnId_t connId, uint16_t handle, uint16_t valueLen,
+                                  uint8_t *pValue, uint8_t opcode, bool_t zeroCpy)
+{
+  uint16_t       mtu;
+  bool_t         transTimedOut;
+  bool_t         pktSent = FALSE;
+
+  mtu = attsIndNtfMtu(connId, &transTimedOut);
+
   /* if MTU size known for connection */
   if (mtu > 0)
   {
@@ -484,6 +603,12 @@ static void attsHandleValueIndNtf(dmConnId_t connId, uint16_t handle, uint16_t v
               WsfMsgFree(pMsg);
             }
           }
+
+          if (!pktSent)
+          {
+            /* call callback with failure status */
+            attsExecCallback(connId, handle, ATT_ERR_MEMORY);
+          }
         }
         /* packet length exceeds MTU size */
         else
@@ -509,6 +634,67 @@ static void attsHandleValueIndNtf(dmConnId_t connId, uint16_t handle, uint16_t v
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an attribute protocol Multiple Handle Value Notification.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  numValues   Number of values, 2 to ATTS_MULT_NTF_MAX.
+ *  \param  pValues     Values.
+ *  \param  pduLen      Length of the PDU.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsMultValueNtf(dmConnId_t connId, uint8_t numValues, const attsHandleValue_t *pValues,
+                             uint16_t pduLen)
+{
+  attsApiMsg_t  *pMsg;
+  uint8_t       *p;
+  uint8_t       i;
+
+  /* allocate message buffer */
+  if ((pMsg = WsfMsgAlloc(sizeof(attsApiMsg_t))) != NULL)
+  {
+    /* set parameters */
+    pMsg->hdr.param = connId;
+    pMsg->hdr.event = ATTS_MSG_API_VALUE_IND_NTF;
+
+    /* allocate packet buffer */
+    if ((pMsg->pPkt = attMsgAlloc(L2C_PAYLOAD_START + pduLen)) != NULL)
+    {
+      /* set data length and first handle */
+      pMsg->pPkt->len = pduLen;
+      pMsg->pPkt->handle = pValues->handle;
+
+      /* build packet */
+      p = (uint8_t *)pMsg->pPkt + L2C_PAYLOAD_START;
+      UINT8_TO_BSTREAM(p, ATT_PDU_MULT_VALUE_NTF);
+
+      for (i = 0; i < numValues; i++, pValues++)
+      {
+        UINT16_TO_BSTREAM(p, pValues->handle);
+        UINT16_TO_BSTREAM(p, pValues->valueLen);
+        memcpy(p, pValues->pValue, pValues->valueLen);
+        p += pValues->valueLen;
+      }
+
+      /* send message */
+      WsfMsgSend(attCb.handlerId, pMsg);
+      return;
+    }
+
+    /* free message buffer if packet buffer alloc failed */
+    WsfMsgFree(pMsg);
+  }
+
+  /* call callback with failure status for every value */
+  for (i = 0; i < numValues; i++, pValues++)
+  {
+    attsExecCallback(connId, pValues->handle, ATT_ERR_MEMORY);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Process received handle value confirm packet.
@@ -650,3 +836,64 @@ void AttsHandleValueNtfZeroCpy(dmConnId_t connId, uint16_t handle, uint16_t valu
 {
   attsHandleValueIndNtf(connId, handle, valueLen, pValue, ATT_PDU_VALUE_NTF, TRUE);
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send attribute values in Multiple Handle Value Notifications.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  numValues   Number of values.
+ *  \param  pValues     Values.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsHandleValueMultNtf(dmConnId_t connId, uint8_t numValues, const attsHandleValue_t *pValues)
+{
+  uint8_t   csf = 0;
+  uint16_t  mtu;
+  uint16_t  pduLen;
+  uint8_t   num;
+  bool_t    transTimedOut;
+
+  mtu = attsIndNtfMtu(connId, &transTimedOut);
+
+  if (mtu > 0)
+  {
+    AttsCsfGetFeatures(connId, &csf, sizeof(csf));
+  }
+
+  while (numValues > 0)
+  {
+    /* pack values while they fit */
+    pduLen = ATT_MULT_VALUE_NTF_LEN;
+    num = 0;
+
+    if ((csf & ATTS_CSF_MULT_VALUE_NTF) && !transTimedOut)
+    {
+      /* values the client may not receive are sent alone, and dropped there */
+      while ((num < numValues) && (num < ATTS_MULT_NTF_MAX) &&
+             ((pduLen + ATT_MULT_VALUE_TUPLE_LEN + pValues[num].valueLen) <= mtu) &&
+             attsCsfIsClientChangeAware(connId, pValues[num].handle))
+      {
+        pduLen += ATT_MULT_VALUE_TUPLE_LEN + pValues[num].valueLen;
+        num++;
+      }
+    }
+
+    if (num >= 2)
+    {
+      attsMultValueNtf(connId, num, pValues, pduLen);
+    }
+    else
+    {
+      /* send alone, failures are reported in the callback */
+      num = 1;
+      attsHandleValueIndNtf(connId, pValues->handle, pValues->valueLen, pValues->pValue,
+                            ATT_PDU_VALUE_NTF, FALSE);
+    }
+
+    numValues -= num;
+    pValues += num;
+  }
+}
@@ -28,6 +28,7 @@
 #include "wsf_msg.h"
 #include "util/bstream.h"
 #include "util/wstr.h"
+#include "util/crc32.h"
 #include "att_api.h"
 #include "att_main.h"
 #include "atts_main.h"
@@ -393,9 +394,6 @@ void attsDiscBusy(attCcb_t *pCcb)
 void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg)
 {
   attEvt_t evt;
-  attsAttr_t *pAttr;
-  attsGroup_t *pGroup;
-  uint16_t dbhCharHandle;
 
   /* send to application */
   evt.hdr.event = ATTS_DB_HASH_CALC_CMPL_IND;
@@ -406,6 +404,7 @@ void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg)
   evt.handle = ATT_HANDLE_NONE;
   evt.continuing = FALSE;
   evt.mtu = 0;
+  evt.isMsg = FALSE;
 
   /* free plain text buffer */
   if (pMsg->pPlainText != NULL)
@@ -417,18 +416,8 @@ void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg)
   /* copy in little endian */
   evt.pValue = pMsg->pCiphertext;
 
-  /* find GATT database handle */
-  dbhCharHandle = attsFindUuidInRange(ATT_HANDLE_START, ATT_HANDLE_MAX, ATT_16_UUID_LEN,
-                                      (uint8_t *) attGattDbhChUuid, &pAttr, &pGroup);
-
-  if (dbhCharHandle != ATT_HANDLE_NONE)
-  {
-    /* Set hash in service. */
-    AttsSetAttr(dbhCharHandle, SEC_CMAC_HASH_LEN, evt.pValue);
-  }
-
-  /* set hash update complete */
-  attsCsfSetHashUpdateStatus(FALSE);
+  /* set hash in service and complete the update */
+  AttsSetDbHash(evt.pValue);
 
   attCb.cback(&evt);
 }
@@ -571,6 +560,7 @@ void AttsInit(void)
 {
   /* Initialize control block */
   WSF_QUEUE_INIT(&attsCb.groupQueue);
+  attsIdxBuild();
   attsCb.pInd = &attFcnDefault;
   attsCb.signMsgCback = (attMsgHandler_t) attEmptyHandler;
 
@@ -697,6 +687,69 @@ void AttsCalculateDbHash(void)
   WSF_ASSERT(FALSE);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the database hash without calculating it, typically a hash stored by
+ *          the application for an unchanged database.
+ *
+ *  \param  pHash   Database hash of ATT_DATABASE_HASH_LEN bytes, in little endian.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsSetDbHash(const uint8_t *pHash)
+{
+  attsAttr_t *pAttr;
+  attsGroup_t *pGroup;
+  uint16_t dbhCharHandle;
+
+  /* find GATT database handle */
+  dbhCharHandle = attsFindUuidInRange(ATT_HANDLE_START, ATT_HANDLE_MAX, ATT_16_UUID_LEN,
+                                      (uint8_t *) attGattDbhChUuid, &pAttr, &pGroup);
+
+  if (dbhCharHandle != ATT_HANDLE_NONE)
+  {
+    /* Set hash in service. */
+    AttsSetAttr(dbhCharHandle, SEC_CMAC_HASH_LEN, (uint8_t *) pHash);
+  }
+
+  /* set hash update complete */
+  attsCsfSetHashUpdateStatus(FALSE);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get a key identifying the database for a given firmware version.
+ *
+ *  \param  version   Firmware version.
+ *
+ *  \return Key, a CRC-32 of the version and the handle range of every group.
+ *
+ *  The attribute tables of an image are static, so a hash stored with the key of the current
+ *  database is still valid and the CMAC over the database can be skipped.
+ */
+/*************************************************************************************************/
+uint32_t AttsGetDbKey(uint32_t version)
+{
+  attsGroup_t *pGroup;
+  uint8_t buf[4];
+  uint8_t *p = buf;
+  uint32_t key;
+
+  UINT32_TO_BSTREAM(p, version);
+  key = CalcCrc32(0xFFFFFFFF, sizeof(buf), buf);
+
+  for (pGroup = (attsGroup_t *) attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
+  {
+    p = buf;
+    UINT16_TO_BSTREAM(p, pGroup->startHandle);
+    UINT16_TO_BSTREAM(p, pGroup->endHandle);
+    key = CalcCrc32(key, sizeof(buf), buf);
+  }
+
+  return key;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Add an attribute group to the attribute server.
@@ -730,6 +783,9 @@ void AttsAddGroup(attsGroup_t *pGroup)
   /* insert new group */
   WsfQueueInsert(&attsCb.groupQueue, pGroup, pPrev);
 
+  /* rebuild lookup indexes */
+  attsIdxBuild();
+
   /* set database hash update status to true until a new hash is generated */
   attsCsfSetHashUpdateStatus(TRUE);
 
@@ -771,6 +827,9 @@ void AttsRemoveGroup(uint16_t startHandle)
   if (pElem != NULL)
   {
     WsfQueueRemove(&attsCb.groupQueue, pElem, pPrev);
+
+    /* rebuild lookup indexes */
+    attsIdxBuild();
   }
   else
   {
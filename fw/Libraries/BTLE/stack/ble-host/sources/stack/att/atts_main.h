@@ -76,6 +76,8 @@ typedef struct
   uint16_t          outIndHandle;                     /* Waiting for confirm from peer for this indication handle */
   uint16_t          pendIndHandle;                    /* Callback to application pending for this indication handle */
   uint16_t          pendNtfHandle[ATT_NUM_SIMUL_NTF]; /* Callback to application pending for this notification handle */
+  uint16_t          pendMultHandle[ATTS_MULT_NTF_MAX]; /* Callbacks to application pending for a multiple value notification */
+  uint8_t           pendMultNum;                      /* Number of handles in pendMultHandle */
 } attsIndCcb_t;
 
 /* Control block for indications/notifications */
@@ -95,10 +97,20 @@ typedef struct
  */
 typedef uint8_t (*attsCccFcn_t)(dmConnId_t connId, uint8_t method, uint16_t handle, uint8_t *pValue);
 
+/* UUID index entry */
+typedef struct
+{
+  uint16_t          uuid;             /* 16-bit UUID of the attribute */
+  uint16_t          handle;           /* Attribute handle */
+} attsUuidIdx_t;
+
 /* Main control block of the ATTS subsystem */
 typedef struct
 {
   wsfQueue_t        groupQueue;       /* Queue of attribute groups */
+  attsUuidIdx_t     uuidIdx[ATTS_UUID_IDX_MAX];     /* Attributes sorted by UUID then handle */
+  uint16_t          numUuidIdx;       /* Number of entries in uuidIdx */
+  bool_t            uuidIdxValid;     /* TRUE if uuidIdx holds all 16-bit UUID attributes */
   attFcnIf_t const  *pInd;            /* Indication callback interface */
   attMsgHandler_t   signMsgCback;     /* Signed data callback interface */
   attsAuthorCback_t authorCback;      /* Authorization callback */
@@ -137,6 +149,8 @@ void attsErrRsp(uint16_t handle, uint8_t opcode, uint16_t attHandle, uint8_t rea
 void attsClearPrepWrites(attCcb_t *pCcb);
 bool_t attsUuidCmp(attsAttr_t *pAttr, uint8_t uuidLen, uint8_t *pUuid);
 bool_t attsUuid16Cmp(uint8_t *pUuid16, uint8_t uuidLen, uint8_t *pUuid);
+void attsIdxBuild(void);
+uint16_t attsIdxFindUuid(uint16_t uuid, uint16_t startHandle, uint16_t endHandle);
 attsAttr_t *attsFindByHandle(uint16_t handle, attsGroup_t **pAttrGroup);
 uint16_t attsFindInRange(uint16_t startHandle, uint16_t endHandle, attsAttr_t **pAttr);
 uint16_t attsFindUuidInRange(uint16_t startHandle, uint16_t endHandle, uint8_t uuidLen,
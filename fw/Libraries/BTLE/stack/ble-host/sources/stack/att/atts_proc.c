@@ -85,6 +85,137 @@ bool_t attsUuid16Cmp(uint8_t *pUuid16, uint8_t uuidLen, uint8_t *pUuid)
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the 16-bit UUID an attribute matches, if any.
+ *
+ *  \param  pAttr   Pointer to attribute.
+ *  \param  pUuid16 Return value 16-bit UUID.
+ *
+ *  \return TRUE if the attribute UUID is a 16-bit UUID or a 128-bit UUID built on the Bluetooth
+ *          base UUID, FALSE otherwise.
+ */
+/*************************************************************************************************/
+static bool_t attsIdxAttrUuid16(attsAttr_t *pAttr, uint16_t *pUuid16)
+{
+  if ((pAttr->settings & ATTS_SET_UUID_128) == 0)
+  {
+    BYTES_TO_UINT16(*pUuid16, pAttr->pUuid);
+    return TRUE;
+  }
+
+  /* 128-bit UUIDs on the base UUID also match their 16-bit form */
+  if (attUuidCmp16to128(&pAttr->pUuid[ATT_BASE_UUID_POS_0], pAttr->pUuid))
+  {
+    BYTES_TO_UINT16(*pUuid16, &pAttr->pUuid[ATT_BASE_UUID_POS_0]);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Rebuild the UUID index from the group queue.  Called when a group is added or
+ *          removed.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void attsIdxBuild(void)
+{
+  attsGroup_t   *pGroup;
+  attsAttr_t    *pAttr;
+  attsUuidIdx_t *pIdx = attsCb.uuidIdx;
+  uint16_t      numAttr;
+  uint16_t      handle;
+  uint16_t      uuid;
+  uint16_t      i;
+
+  attsCb.numUuidIdx = 0;
+  attsCb.uuidIdxValid = TRUE;
+
+  /* group queue is sorted by increasing handle value */
+  for (pGroup = attsCb.groupQueue.pHead; (pGroup != NULL) && attsCb.uuidIdxValid; pGroup = pGroup->pNext)
+  {
+    pAttr = pGroup->pAttr;
+    handle = pGroup->startHandle;
+    numAttr = pGroup->endHandle - pGroup->startHandle + 1;
+
+    for (; numAttr > 0; numAttr--, handle++, pAttr++)
+    {
+      if (!attsIdxAttrUuid16(pAttr, &uuid))
+      {
+        continue;
+      }
+
+      if (attsCb.numUuidIdx == ATTS_UUID_IDX_MAX)
+      {
+        attsCb.uuidIdxValid = FALSE;
+        break;
+      }
+
+      /* insertion sort by UUID; handles arrive in increasing order and stay sorted per UUID */
+      for (i = attsCb.numUuidIdx; (i > 0) && (pIdx[i - 1].uuid > uuid); i--)
+      {
+        pIdx[i] = pIdx[i - 1];
+      }
+      pIdx[i].uuid = uuid;
+      pIdx[i].handle = handle;
+      attsCb.numUuidIdx++;
+    }
+  }
+
+  if (!attsCb.uuidIdxValid)
+  {
+    ATT_TRACE_WARN1("ATTS UUID index full, max:%u", ATTS_UUID_IDX_MAX);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the first attribute within the given handle range with the given 16-bit UUID
+ *          using the UUID index.
+ *
+ *  \param  uuid          16-bit UUID.
+ *  \param  startHandle   Starting attribute handle.
+ *  \param  endHandle     Ending attribute handle.
+ *
+ *  \return Attribute handle or ATT_HANDLE_NONE if not found.
+ */
+/*************************************************************************************************/
+uint16_t attsIdxFindUuid(uint16_t uuid, uint16_t startHandle, uint16_t endHandle)
+{
+  attsUuidIdx_t *pIdx = attsCb.uuidIdx;
+  uint16_t      lo = 0;
+  uint16_t      hi = attsCb.numUuidIdx;
+  uint16_t      mid;
+
+  WSF_ASSERT(attsCb.uuidIdxValid);
+
+  /* find first entry not less than (uuid, startHandle) */
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
+
+    if ((pIdx[mid].uuid < uuid) || ((pIdx[mid].uuid == uuid) && (pIdx[mid].handle < startHandle)))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  if ((lo < attsCb.numUuidIdx) && (pIdx[lo].uuid == uuid) && (pIdx[lo].handle <= endHandle))
+  {
+    return pIdx[lo].handle;
+  }
+
+  return ATT_HANDLE_NONE;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Find an attribute with the given handle.
@@ -49,6 +49,21 @@ uint16_t attsFindUuidInRange(uint16_t startHandle, uint16_t endHandle, uint8_t u
                              uint8_t *pUuid, attsAttr_t **pAttr, attsGroup_t **pAttrGroup)
 {
   attsGroup_t *pGroup;
+  uint16_t    uuid;
+
+  /* use the UUID index for 16-bit UUIDs and 128-bit UUIDs on the base UUID */
+  if (attsCb.uuidIdxValid &&
+      ((uuidLen == ATT_16_UUID_LEN) || attUuidCmp16to128(&pUuid[ATT_BASE_UUID_POS_0], pUuid)))
+  {
+    BYTES_TO_UINT16(uuid, (uuidLen == ATT_16_UUID_LEN) ? pUuid : &pUuid[ATT_BASE_UUID_POS_0]);
+
+    if ((startHandle = attsIdxFindUuid(uuid, startHandle, endHandle)) != ATT_HANDLE_NONE)
+    {
+      *pAttr = attsFindByHandle(startHandle, pAttrGroup);
+    }
+
+    return startHandle;
+  }
 
   /* iterate over attribute group list */
   for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
@@ -116,6 +131,44 @@ uint16_t attsFindServiceGroupEnd(uint16_t startHandle)
   prevHandle = startHandle;
   startHandle++;
 
+  if (attsCb.uuidIdxValid)
+  {
+    uint16_t  nextHandle;
+    uint16_t  secHandle;
+
+    /* find next primary or secondary service */
+    nextHandle = attsIdxFindUuid(ATT_UUID_PRIMARY_SERVICE, startHandle, ATT_HANDLE_MAX);
+    secHandle = attsIdxFindUuid(ATT_UUID_SECONDARY_SERVICE, startHandle, ATT_HANDLE_MAX);
+    if ((nextHandle == ATT_HANDLE_NONE) ||
+        ((secHandle != ATT_HANDLE_NONE) && (secHandle < nextHandle)))
+    {
+      nextHandle = secHandle;
+    }
+
+    /* next service not found; return 0xFFFF as the last handle in the database */
+    if (nextHandle == ATT_HANDLE_NONE)
+    {
+      return ATT_HANDLE_MAX;
+    }
+
+    /* return handle of the last attribute before it, never less than the given handle */
+    for (pGroup = attsCb.groupQueue.pHead;
+         (pGroup != NULL) && (pGroup->startHandle < nextHandle); pGroup = pGroup->pNext)
+    {
+      if (pGroup->endHandle >= nextHandle)
+      {
+        return nextHandle - 1;
+      }
+
+      if (pGroup->endHandle > prevHandle)
+      {
+        prevHandle = pGroup->endHandle;
+      }
+    }
+
+    return prevHandle;
+  }
+
   /* iterate over attribute group list */
   for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
   {
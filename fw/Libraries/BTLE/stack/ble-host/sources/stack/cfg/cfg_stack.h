@@ -132,6 +132,17 @@ extern "C" {
 #ifndef ATT_NUM_SIMUL_NTF
 #define ATT_NUM_SIMUL_NTF        1
 #endif
+
+/*! \brief Maximum number of values in a multiple handle value notification */
+#ifndef ATTS_MULT_NTF_MAX
+#define ATTS_MULT_NTF_MAX        4
+#endif
+
+/*! \brief Maximum number of ATT server attributes with a 16-bit UUID in the UUID index.
+ *  Lookups by UUID scan the attributes if the database holds more. */
+#ifndef ATTS_UUID_IDX_MAX
+#define ATTS_UUID_IDX_MAX        320
+#endif
 /**@}*/
 
 /**************************************************************************************************
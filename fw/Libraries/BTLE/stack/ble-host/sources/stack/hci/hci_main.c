@@ -90,6 +90,7 @@ void HciHandlerInit(wsfHandlerId_t handlerId)
 {
   /* store handler ID */
   hciCb.handlerId = handlerId;
+  WsfOsSetHandlerPrio(handlerId, WSF_MSG_PRIO_HCI);
 
   /* init rx queue */
   WSF_QUEUE_INIT(&hciCb.rxQueue);
@@ -37,6 +37,11 @@
   Macros
 **************************************************************************************************/
 
+/* Retry interval in ms of a transmission stalled on buffer exhaustion */
+#ifndef L2C_COC_TX_RETRY_MS
+#define L2C_COC_TX_RETRY_MS             10
+#endif
+
 /* Channel states */
 enum
 {
@@ -55,7 +60,8 @@ enum
   L2C_MSG_API_DISCONNECT_REQ,
 
   /* messages from timers */
-  L2C_MSG_COC_REQ_TIMEOUT
+  L2C_MSG_COC_REQ_TIMEOUT,
+  L2C_MSG_COC_TX_RETRY
 };
 
 /**************************************************************************************************
@@ -111,6 +117,7 @@ typedef struct
   l2cRegCb_t        *pRegCb;              /* Pointer to associated registration control block */
   l2cConnCb_t       *pConnCb;             /* Pointer to associated connection control block */
   wsfTimer_t        reqTimer;             /* Signaling request timeout timer */
+  wsfTimer_t        txTimer;              /* Transmission retry timer */
   uint8_t           *pTxPkt;              /* Pointer to tx packet in progress */
   uint8_t           *pRxPkt;              /* Pointer to rx packet in progress */
   uint16_t          txTotalLen;           /* Total length of tx data */
@@ -326,6 +333,9 @@ l2cChanCb_t *l2cChanCbAlloc(uint8_t state)
       pCb->state = state;
       pCb->reqTimer.msg.param = pCb->localCid = i + L2C_CID_DYN_MIN;
       pCb->reqTimer.msg.event = L2C_MSG_COC_REQ_TIMEOUT;
+      pCb->txTimer.handlerId = l2cCocCb.handlerId;
+      pCb->txTimer.msg.param = pCb->localCid;
+      pCb->txTimer.msg.event = L2C_MSG_COC_TX_RETRY;
       L2C_TRACE_INFO1("l2cChanCbAlloc cid=0x%04x", pCb->localCid);
 
       return pCb;
@@ -442,6 +452,7 @@ void l2cChanCbDealloc(l2cChanCb_t *pCb)
 
   pCb->state = L2C_CHAN_STATE_UNUSED;
   WsfTimerStop(&pCb->reqTimer);
+  WsfTimerStop(&pCb->txTimer);
   if (pCb->pRxPkt != NULL)
   {
     WsfMsgFree(pCb->pRxPkt);
@@ -945,6 +956,12 @@ static void l2cCocSendData(l2cChanCb_t *pChanCb)
         l2cDataCnf(pChanCb, L2C_COC_DATA_SUCCESS);
       }
     }
+    else
+    {
+      /* out of buffers; retry later, or sooner on the next credit or flow enable */
+      WsfTimerStartMs(&pChanCb->txTimer, L2C_COC_TX_RETRY_MS);
+      break;
+    }
   }
 }
 
@@ -1589,6 +1606,25 @@ static void l2cCocReqTimeout(wsfMsgHdr_t *pMsg)
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Retry a transmission stalled on buffer exhaustion.
+ *
+ *  \param  pMsg  Message buffer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void l2cCocTxRetry(wsfMsgHdr_t *pMsg)
+{
+  l2cChanCb_t *pChanCb = l2cChanCbByCid(pMsg->param);
+
+  if (pChanCb->state == L2C_CHAN_STATE_CONNECTED)
+  {
+    l2cCocSendData(pChanCb);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Initialize L2C connection oriented channel subsystem.
@@ -1653,6 +1689,10 @@ void L2cCocHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
         l2cCocReqTimeout(pMsg);
         break;
 
+      case L2C_MSG_COC_TX_RETRY:
+        l2cCocTxRetry(pMsg);
+        break;
+
       default:
         break;
     }
@@ -1801,10 +1841,10 @@ void L2cCocDisconnectReq(uint16_t cid)
  *  \param  len       The length of the payload data in pPacket.
  *  \param  pPacket   Packet payload data.
  *
- *  \return None.
+ *  \return TRUE if the packet was queued, FALSE if buffers could not be allocated.
  */
 /*************************************************************************************************/
-void L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload)
+bool_t L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload)
 {
   l2cApiDataReq_t *pMsg;
   uint8_t         *pPkt;
@@ -1829,6 +1869,8 @@ void L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload)
       /* send message */
       pMsg->hdr.event = L2C_MSG_API_DATA_REQ;
       WsfMsgSend(l2cCocCb.handlerId, pMsg);
+
+      return TRUE;
     }
     else
     {
@@ -1836,6 +1878,8 @@ void L2cCocDataReq(uint16_t cid, uint16_t len, uint8_t *pPayload)
       WsfMsgFree(pPkt);
     }
   }
+
+  return FALSE;
 }
 
 /*************************************************************************************************/
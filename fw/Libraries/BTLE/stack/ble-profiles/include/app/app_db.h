@@ -61,6 +61,16 @@ typedef void *appDbHdl_t;
 /*************************************************************************************************/
 void AppDbInit(void);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Write all modified records to NVM.  Records are otherwise written when bonding
+ *          completes and when the connection closes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AppDbNvmFlush(void);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Create a new device database record.
@@ -303,6 +313,30 @@ char *AppDbGetDevName(uint8_t *pLen);
 /*************************************************************************************************/
 void AppDbSetDevName(uint8_t len, char *pStr);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the GATT database hash stored with the device database.
+ *
+ *  \param  key       Key of the current database, see AttsGetDbKey().
+ *  \param  pHash     Returned database hash of ATT_DATABASE_HASH_LEN bytes.
+ *
+ *  \return TRUE if a hash of a database with the same key is stored, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t AppDbGetDbHash(uint32_t key, uint8_t *pHash);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the GATT database hash stored with the device database.
+ *
+ *  \param  key       Key of the database the hash was calculated on, see AttsGetDbKey().
+ *  \param  pHash     Database hash of ATT_DATABASE_HASH_LEN bytes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AppDbSetDbHash(uint32_t key, const uint8_t *pHash);
+
 /*************************************************************************************************/
 /*!
 *  \brief  Get address resolution attribute value read from a peer device.
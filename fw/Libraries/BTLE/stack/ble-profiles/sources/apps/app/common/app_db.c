@@ -2,7 +2,7 @@
 /*!
  *  \file
  *
- *  \brief  Application framework device database example, using simple RAM-based storage.
+ *  \brief  Application framework device database, using RAM-based storage backed by WSF NVM.
  *
  *  Copyright (c) 2011-2018 Arm Ltd. All Rights Reserved.
  *  ARM Ltd. confidential and proprietary.
@@ -20,12 +20,56 @@
 #include <string.h>
 #include "wsf_types.h"
 #include "wsf_assert.h"
+#include "wsf_nvm.h"
 #include "util/bda.h"
+#include "util/bstream.h"
 #include "app_api.h"
 #include "app_main.h"
 #include "app_db.h"
 #include "app_cfg.h"
 
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! NVM storage format version, stored records of another version are ignored */
+#define APP_DB_NVM_VERSION                1
+
+/*! NVM item IDs */
+#define APP_DB_NVM_BASE_ID                0x41444200
+#define APP_DB_NVM_DEV_NAME_ID            (APP_DB_NVM_BASE_ID + 0)
+#define APP_DB_NVM_DB_HASH_ID             (APP_DB_NVM_BASE_ID + 1)
+#define APP_DB_NVM_BOND_ID(idx)           (APP_DB_NVM_BASE_ID + 0x10 + (2 * (idx)))
+#define APP_DB_NVM_ATTR_ID(idx)           (APP_DB_NVM_BASE_ID + 0x11 + (2 * (idx)))
+
+/*! Packed LTK length */
+#define APP_DB_NVM_LTK_LEN                (SMP_KEY_LEN + SMP_RAND8_LEN + sizeof(uint16_t))
+
+/*! Bond item: version, flags, address type, address, key mask, LTK security levels and keys */
+#define APP_DB_NVM_BOND_LEN               (7 + BDA_ADDR_LEN + (2 * APP_DB_NVM_LTK_LEN) + \
+                                           (SMP_KEY_LEN + BDA_ADDR_LEN + 1) + SMP_KEY_LEN)
+
+/*! Attribute item: version, discovery status, sign counter, CCC table and handle list */
+#define APP_DB_NVM_ATTR_LEN               (6 + (2 * APP_DB_NUM_CCCD) + (2 * APP_DB_HDL_LIST_LEN))
+
+/*! Device name item: length and name */
+#define APP_DB_NVM_DEV_NAME_LEN           (1 + ATT_DEFAULT_PAYLOAD_LEN)
+
+/*! Database hash item: key and hash */
+#define APP_DB_NVM_DB_HASH_LEN            (4 + ATT_DATABASE_HASH_LEN)
+
+/*! Largest NVM item */
+#define APP_DB_NVM_MAX_LEN                sizeof(appDbNvmItem_t)
+
+/*! Bond item flags */
+#define APP_DB_NVM_FLAG_PEER_RPAO         (1 << 0)  /*! RPA Only attribute present on peer */
+#define APP_DB_NVM_FLAG_PEER_ADDR_RES     (1 << 1)  /*! Address resolution supported on peer */
+
+/*! Modified items not yet written to NVM */
+#define APP_DB_NVM_DIRTY_BOND             (1 << 0)  /*! Record bond item */
+#define APP_DB_NVM_DIRTY_ATTR             (1 << 1)  /*! Record attribute item */
+#define APP_DB_NVM_DIRTY_REC              (APP_DB_NVM_DIRTY_BOND | APP_DB_NVM_DIRTY_ATTR)
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -60,14 +104,30 @@ typedef struct
   /*! for ATT client */
   uint16_t    hdlList[APP_DB_HDL_LIST_LEN]; /*! Cached handle list */
   uint8_t     discStatus;                   /*! Service discovery and configuration status */
+
+  /*! NVM state */
+  uint8_t     nvmDirty;                     /*! Items modified since last written to NVM */
+  bool_t      nvmStored;                    /*! TRUE if record has items in NVM */
 } appDbRec_t;
 
+/*! NVM items packed from a record and the database, sized by the largest */
+typedef union
+{
+  uint8_t     bond[APP_DB_NVM_BOND_LEN];    /*! Record bond item */
+  uint8_t     attr[APP_DB_NVM_ATTR_LEN];    /*! Record attribute item */
+  uint8_t     devName[APP_DB_NVM_DEV_NAME_LEN]; /*! Device name item */
+  uint8_t     dbHash[APP_DB_NVM_DB_HASH_LEN];   /*! Database hash item */
+} appDbNvmItem_t;
+
 /*! Database type */
 typedef struct
 {
   appDbRec_t  rec[APP_DB_NUM_RECS];               /*! Device database records */
   char        devName[ATT_DEFAULT_PAYLOAD_LEN];   /*! Device name */
   uint8_t     devNameLen;                         /*! Device name length */
+  uint8_t     dbHash[ATT_DATABASE_HASH_LEN];      /*! GATT database hash */
+  uint32_t    dbHashKey;                          /*! Key of the database the hash was calculated on */
+  bool_t      dbHashValid;                        /*! TRUE if GATT database hash is set */
 } appDb_t;
 
 /**************************************************************************************************
@@ -80,6 +140,388 @@ static appDb_t appDb;
 /*! When all records are allocated use this index to determine which to overwrite */
 static appDbRec_t *pAppDbNewRec = appDb.rec;
 
+/*! NVM item read back buffer */
+static uint8_t appDbNvmBuf[APP_DB_NVM_MAX_LEN];
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Pack an LTK.
+ *
+ *  \param  p         Output buffer.
+ *  \param  pLtk      LTK.
+ *
+ *  \return Pointer past the packed LTK.
+ */
+/*************************************************************************************************/
+static uint8_t *appDbNvmPackLtk(uint8_t *p, const dmSecLtk_t *pLtk)
+{
+  memcpy(p, pLtk->key, SMP_KEY_LEN);
+  p += SMP_KEY_LEN;
+  memcpy(p, pLtk->rand, SMP_RAND8_LEN);
+  p += SMP_RAND8_LEN;
+  UINT16_TO_BSTREAM(p, pLtk->ediv);
+
+  return p;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Unpack an LTK.
+ *
+ *  \param  pLtk      LTK.
+ *  \param  p         Input buffer.
+ *
+ *  \return Pointer past the packed LTK.
+ */
+/*************************************************************************************************/
+static uint8_t *appDbNvmUnpackLtk(dmSecLtk_t *pLtk, uint8_t *p)
+{
+  memcpy(pLtk->key, p, SMP_KEY_LEN);
+  p += SMP_KEY_LEN;
+  memcpy(pLtk->rand, p, SMP_RAND8_LEN);
+  p += SMP_RAND8_LEN;
+  BSTREAM_TO_UINT16(pLtk->ediv, p);
+
+  return p;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Pack the bond item of a record.
+ *
+ *  \param  pBuf      Output buffer of APP_DB_NVM_BOND_LEN bytes.
+ *  \param  pRec      Database record.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void appDbNvmPackBond(uint8_t *pBuf, const appDbRec_t *pRec)
+{
+  uint8_t *p = pBuf;
+  uint8_t flags = 0;
+
+  if (pRec->peerRpao)
+  {
+    flags |= APP_DB_NVM_FLAG_PEER_RPAO;
+  }
+  if (pRec->peerAddrRes)
+  {
+    flags |= APP_DB_NVM_FLAG_PEER_ADDR_RES;
+  }
+
+  UINT8_TO_BSTREAM(p, APP_DB_NVM_VERSION);
+  UINT8_TO_BSTREAM(p, flags);
+  UINT8_TO_BSTREAM(p, pRec->addrType);
+  BDA_TO_BSTREAM(p, pRec->peerAddr);
+  UINT8_TO_BSTREAM(p, pRec->keyValidMask);
+  UINT8_TO_BSTREAM(p, pRec->localLtkSecLevel);
+  UINT8_TO_BSTREAM(p, pRec->peerLtkSecLevel);
+  p = appDbNvmPackLtk(p, &pRec->localLtk);
+  p = appDbNvmPackLtk(p, &pRec->peerLtk);
+  memcpy(p, pRec->peerIrk.key, SMP_KEY_LEN);
+  p += SMP_KEY_LEN;
+  BDA_TO_BSTREAM(p, pRec->peerIrk.bdAddr);
+  UINT8_TO_BSTREAM(p, pRec->peerIrk.addrType);
+  memcpy(p, pRec->peerCsrk.key, SMP_KEY_LEN);
+  p += SMP_KEY_LEN;
+
+  WSF_ASSERT((p - pBuf) == APP_DB_NVM_BOND_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Unpack the bond item of a record.
+ *
+ *  \param  pRec      Database record.
+ *  \param  pBuf      Input buffer of APP_DB_NVM_BOND_LEN bytes.
+ *
+ *  \return TRUE if the item is of the current format version.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmUnpackBond(appDbRec_t *pRec, uint8_t *pBuf)
+{
+  uint8_t *p = pBuf;
+  uint8_t version;
+  uint8_t flags;
+
+  BSTREAM_TO_UINT8(version, p);
+  if (version != APP_DB_NVM_VERSION)
+  {
+    return FALSE;
+  }
+
+  BSTREAM_TO_UINT8(flags, p);
+  pRec->peerRpao = (flags & APP_DB_NVM_FLAG_PEER_RPAO) ? TRUE : FALSE;
+  pRec->peerAddrRes = (flags & APP_DB_NVM_FLAG_PEER_ADDR_RES) ? TRUE : FALSE;
+
+  BSTREAM_TO_UINT8(pRec->addrType, p);
+  BSTREAM_TO_BDA(pRec->peerAddr, p);
+  BSTREAM_TO_UINT8(pRec->keyValidMask, p);
+  BSTREAM_TO_UINT8(pRec->localLtkSecLevel, p);
+  BSTREAM_TO_UINT8(pRec->peerLtkSecLevel, p);
+  p = appDbNvmUnpackLtk(&pRec->localLtk, p);
+  p = appDbNvmUnpackLtk(&pRec->peerLtk, p);
+  memcpy(pRec->peerIrk.key, p, SMP_KEY_LEN);
+  p += SMP_KEY_LEN;
+  BSTREAM_TO_BDA(pRec->peerIrk.bdAddr, p);
+  BSTREAM_TO_UINT8(pRec->peerIrk.addrType, p);
+  memcpy(pRec->peerCsrk.key, p, SMP_KEY_LEN);
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Pack the attribute item of a record.
+ *
+ *  \param  pBuf      Output buffer of APP_DB_NVM_ATTR_LEN bytes.
+ *  \param  pRec      Database record.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void appDbNvmPackAttr(uint8_t *pBuf, const appDbRec_t *pRec)
+{
+  uint8_t *p = pBuf;
+  uint8_t i;
+
+  UINT8_TO_BSTREAM(p, APP_DB_NVM_VERSION);
+  UINT8_TO_BSTREAM(p, pRec->discStatus);
+  UINT32_TO_BSTREAM(p, pRec->peerSignCounter);
+
+  for (i = 0; i < APP_DB_NUM_CCCD; i++)
+  {
+    UINT16_TO_BSTREAM(p, pRec->cccTbl[i]);
+  }
+
+  for (i = 0; i < APP_DB_HDL_LIST_LEN; i++)
+  {
+    UINT16_TO_BSTREAM(p, pRec->hdlList[i]);
+  }
+
+  WSF_ASSERT((p - pBuf) == APP_DB_NVM_ATTR_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Unpack the attribute item of a record.
+ *
+ *  \param  pRec      Database record.
+ *  \param  pBuf      Input buffer of APP_DB_NVM_ATTR_LEN bytes.
+ *
+ *  \return TRUE if the item is of the current format version.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmUnpackAttr(appDbRec_t *pRec, uint8_t *pBuf)
+{
+  uint8_t *p = pBuf;
+  uint8_t version;
+  uint8_t i;
+
+  BSTREAM_TO_UINT8(version, p);
+  if (version != APP_DB_NVM_VERSION)
+  {
+    return FALSE;
+  }
+
+  BSTREAM_TO_UINT8(pRec->discStatus, p);
+  BSTREAM_TO_UINT32(pRec->peerSignCounter, p);
+
+  for (i = 0; i < APP_DB_NUM_CCCD; i++)
+  {
+    BSTREAM_TO_UINT16(pRec->cccTbl[i], p);
+  }
+
+  for (i = 0; i < APP_DB_HDL_LIST_LEN; i++)
+  {
+    BSTREAM_TO_UINT16(pRec->hdlList[i], p);
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write an item to NVM.
+ *
+ *  \param  id        NVM item ID.
+ *  \param  pBuf      Item data.
+ *  \param  len       Item length.
+ *
+ *  \return TRUE if the item was stored, FALSE if NVM is full.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmWriteItem(uint32_t id, const uint8_t *pBuf, uint16_t len)
+{
+  WSF_ASSERT(len <= sizeof(appDbNvmBuf));
+
+  /* WSF NVM reclaims superseded items itself, it only fails when full of current ones */
+  return WsfNvmWriteData(id, pBuf, len, NULL);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write modified items of a record to NVM.
+ *
+ *  \param  pRec      Database record.
+ *  \param  dirty     Items to write.
+ *
+ *  \return TRUE if the items were stored, FALSE if NVM is full.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmWriteRec(appDbRec_t *pRec, uint8_t dirty)
+{
+  uint8_t buf[APP_DB_NVM_MAX_LEN];
+  uint8_t idx = (uint8_t) (pRec - appDb.rec);
+
+  if (dirty & APP_DB_NVM_DIRTY_BOND)
+  {
+    appDbNvmPackBond(buf, pRec);
+    if (!appDbNvmWriteItem(APP_DB_NVM_BOND_ID(idx), buf, APP_DB_NVM_BOND_LEN))
+    {
+      return FALSE;
+    }
+  }
+
+  if (dirty & APP_DB_NVM_DIRTY_ATTR)
+  {
+    appDbNvmPackAttr(buf, pRec);
+    if (!appDbNvmWriteItem(APP_DB_NVM_ATTR_ID(idx), buf, APP_DB_NVM_ATTR_LEN))
+    {
+      return FALSE;
+    }
+  }
+
+  pRec->nvmDirty = 0;
+  pRec->nvmStored = TRUE;
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write the device name to NVM.
+ *
+ *  \return TRUE if the device name was stored, FALSE if NVM is full.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmWriteDevName(void)
+{
+  uint8_t buf[APP_DB_NVM_DEV_NAME_LEN];
+
+  buf[0] = appDb.devNameLen;
+  memcpy(&buf[1], appDb.devName, sizeof(appDb.devName));
+
+  return appDbNvmWriteItem(APP_DB_NVM_DEV_NAME_ID, buf, APP_DB_NVM_DEV_NAME_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write the GATT database hash and its key to NVM.
+ *
+ *  \return TRUE if the hash was stored, FALSE if NVM is full.
+ */
+/*************************************************************************************************/
+static bool_t appDbNvmWriteDbHash(void)
+{
+  uint8_t buf[APP_DB_NVM_DB_HASH_LEN];
+  uint8_t *p = buf;
+
+  UINT32_TO_BSTREAM(p, appDb.dbHashKey);
+  memcpy(p, appDb.dbHash, ATT_DATABASE_HASH_LEN);
+
+  return appDbNvmWriteItem(APP_DB_NVM_DB_HASH_ID, buf, APP_DB_NVM_DB_HASH_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write modified items of a bonded record to NVM.
+ *
+ *  \param  pRec      Database record.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void appDbNvmFlushRec(appDbRec_t *pRec)
+{
+  if (pRec->inUse && pRec->valid && (pRec->nvmDirty != 0))
+  {
+    /* items left dirty are written again on the next flush */
+    (void)appDbNvmWriteRec(pRec, pRec->nvmDirty);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase the NVM items of a record.
+ *
+ *  \param  pRec      Database record.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void appDbNvmEraseRec(appDbRec_t *pRec)
+{
+  uint8_t idx = (uint8_t) (pRec - appDb.rec);
+
+  if (pRec->nvmStored)
+  {
+    WsfNvmEraseData(APP_DB_NVM_BOND_ID(idx), NULL);
+    WsfNvmEraseData(APP_DB_NVM_ATTR_ID(idx), NULL);
+    pRec->nvmStored = FALSE;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read the database from NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void appDbNvmReadAll(void)
+{
+  appDbRec_t  *pRec = appDb.rec;
+  uint8_t     i;
+
+  for (i = 0; i < APP_DB_NUM_RECS; i++, pRec++)
+  {
+    if (WsfNvmReadData(APP_DB_NVM_BOND_ID(i), appDbNvmBuf, APP_DB_NVM_BOND_LEN, NULL) &&
+        appDbNvmUnpackBond(pRec, appDbNvmBuf))
+    {
+      pRec->inUse = TRUE;
+      pRec->valid = TRUE;
+      pRec->nvmStored = TRUE;
+
+      /* the resolving list is empty after reset */
+      pRec->peerAddedToRl = FALSE;
+
+      if (!WsfNvmReadData(APP_DB_NVM_ATTR_ID(i), appDbNvmBuf, APP_DB_NVM_ATTR_LEN, NULL) ||
+          !appDbNvmUnpackAttr(pRec, appDbNvmBuf))
+      {
+        /* keep the bond, peer rewrites its configuration */
+        pRec->nvmDirty = APP_DB_NVM_DIRTY_ATTR;
+      }
+    }
+  }
+
+  if (WsfNvmReadData(APP_DB_NVM_DEV_NAME_ID, appDbNvmBuf, APP_DB_NVM_DEV_NAME_LEN, NULL) &&
+      (appDbNvmBuf[0] <= sizeof(appDb.devName)))
+  {
+    appDb.devNameLen = appDbNvmBuf[0];
+    memcpy(appDb.devName, &appDbNvmBuf[1], sizeof(appDb.devName));
+  }
+
+  if (WsfNvmReadData(APP_DB_NVM_DB_HASH_ID, appDbNvmBuf, APP_DB_NVM_DB_HASH_LEN, NULL))
+  {
+    uint8_t *p = appDbNvmBuf;
+
+    BSTREAM_TO_UINT32(appDb.dbHashKey, p);
+    memcpy(appDb.dbHash, p, ATT_DATABASE_HASH_LEN);
+    appDb.dbHashValid = TRUE;
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Initialize the device database.
@@ -89,7 +531,29 @@ static appDbRec_t *pAppDbNewRec = appDb.rec;
 /*************************************************************************************************/
 void AppDbInit(void)
 {
-  return;
+  WsfNvmInit();
+
+  appDbNvmReadAll();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write all modified records to NVM.  Records are otherwise written when bonding
+ *          completes and when the connection closes, so changes made during a connection are
+ *          coalesced into a single write.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AppDbNvmFlush(void)
+{
+  appDbRec_t  *pRec = appDb.rec;
+  uint8_t     i;
+
+  for (i = APP_DB_NUM_RECS; i > 0; i--, pRec++)
+  {
+    appDbNvmFlushRec(pRec);
+  }
 }
 
 /*************************************************************************************************/
@@ -130,6 +594,9 @@ appDbHdl_t AppDbNewRecord(uint8_t addrType, uint8_t *pAddr)
     }
   }
 
+  /* a record being overwritten must not come back after reset */
+  appDbNvmEraseRec(pRec);
+
   /* initialize record */
   memset(pRec, 0, sizeof(appDbRec_t));
   pRec->inUse = TRUE;
@@ -202,6 +669,8 @@ appDbHdl_t AppDbGetNextRecord(appDbHdl_t hdl)
 void AppDbDeleteRecord(appDbHdl_t hdl)
 {
   ((appDbRec_t *) hdl)->inUse = FALSE;
+
+  appDbNvmEraseRec((appDbRec_t *) hdl);
 }
 
 /*************************************************************************************************/
@@ -219,6 +688,10 @@ void AppDbValidateRecord(appDbHdl_t hdl, uint8_t keyMask)
 {
   ((appDbRec_t *) hdl)->valid = TRUE;
   ((appDbRec_t *) hdl)->keyValidMask = keyMask;
+
+  /* store the bond right away */
+  ((appDbRec_t *) hdl)->nvmDirty = APP_DB_NVM_DIRTY_REC;
+  appDbNvmFlushRec((appDbRec_t *) hdl);
 }
 
 /*************************************************************************************************/
@@ -237,6 +710,11 @@ void AppDbCheckValidRecord(appDbHdl_t hdl)
   {
     AppDbDeleteRecord(hdl);
   }
+  else
+  {
+    /* store changes made during the connection */
+    appDbNvmFlushRec((appDbRec_t *) hdl);
+  }
 }
 
 /*************************************************************************************************/
@@ -303,10 +781,11 @@ void AppDbDeleteAllRecords(void)
   appDbRec_t  *pRec = appDb.rec;
   uint8_t     i;
 
-  /* set in use to false for all records */
+  /* set in use to false for all records and erase their NVM items */
   for (i = APP_DB_NUM_RECS; i > 0; i--, pRec++)
   {
     pRec->inUse = FALSE;
+    appDbNvmEraseRec(pRec);
   }
 }
 
@@ -424,6 +903,8 @@ dmSecKey_t *AppDbGetKey(appDbHdl_t hdl, uint8_t type, uint8_t *pSecLevel)
 /*************************************************************************************************/
 void AppDbSetKey(appDbHdl_t hdl, dmSecKeyIndEvt_t *pKey)
 {
+  ((appDbRec_t *) hdl)->nvmDirty |= APP_DB_NVM_DIRTY_BOND;
+
   switch(pKey->type)
   {
     case DM_KEY_LOCAL_LTK:
@@ -449,6 +930,7 @@ void AppDbSetKey(appDbHdl_t hdl, dmSecKeyIndEvt_t *pKey)
 
       /* sign counter must be initialized to zero when CSRK is generated */
       ((appDbRec_t *)hdl)->peerSignCounter = 0;
+      ((appDbRec_t *)hdl)->nvmDirty |= APP_DB_NVM_DIRTY_ATTR;
       break;
 
     default:
@@ -485,7 +967,11 @@ void AppDbSetCccTblValue(appDbHdl_t hdl, uint16_t idx, uint16_t value)
 {
   WSF_ASSERT(idx < APP_DB_NUM_CCCD);
 
-  ((appDbRec_t *) hdl)->cccTbl[idx] = value;
+  if (((appDbRec_t *) hdl)->cccTbl[idx] != value)
+  {
+    ((appDbRec_t *) hdl)->cccTbl[idx] = value;
+    ((appDbRec_t *) hdl)->nvmDirty |= APP_DB_NVM_DIRTY_ATTR;
+  }
 }
 
 /*************************************************************************************************/
@@ -514,7 +1000,11 @@ uint8_t AppDbGetDiscStatus(appDbHdl_t hdl)
 /*************************************************************************************************/
 void AppDbSetDiscStatus(appDbHdl_t hdl, uint8_t status)
 {
-  ((appDbRec_t *) hdl)->discStatus = status;
+  if (((appDbRec_t *) hdl)->discStatus != status)
+  {
+    ((appDbRec_t *) hdl)->discStatus = status;
+    ((appDbRec_t *) hdl)->nvmDirty |= APP_DB_NVM_DIRTY_ATTR;
+  }
 }
 
 /*************************************************************************************************/
@@ -543,7 +1033,11 @@ uint16_t *AppDbGetHdlList(appDbHdl_t hdl)
 /*************************************************************************************************/
 void AppDbSetHdlList(appDbHdl_t hdl, uint16_t *pHdlList)
 {
-  memcpy(((appDbRec_t *) hdl)->hdlList, pHdlList, sizeof(((appDbRec_t *) hdl)->hdlList));
+  if (memcmp(((appDbRec_t *) hdl)->hdlList, pHdlList, sizeof(((appDbRec_t *) hdl)->hdlList)) != 0)
+  {
+    memcpy(((appDbRec_t *) hdl)->hdlList, pHdlList, sizeof(((appDbRec_t *) hdl)->hdlList));
+    ((appDbRec_t *) hdl)->nvmDirty |= APP_DB_NVM_DIRTY_ATTR;
+  }
 }
 
 /*************************************************************************************************/
@@ -585,7 +1079,62 @@ void AppDbSetDevName(uint8_t len, char *pStr)
   /* check for maximum device length */
   len = (len <= sizeof(appDb.devName)) ? len : sizeof(appDb.devName);
 
+  if ((len == appDb.devNameLen) && (memcmp(appDb.devName, pStr, len) == 0))
+  {
+    return;
+  }
+
+  memset(appDb.devName, 0, sizeof(appDb.devName));
   memcpy(appDb.devName, pStr, len);
+  appDb.devNameLen = len;
+
+  (void)appDbNvmWriteDevName();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the GATT database hash stored with the device database.
+ *
+ *  \param  key       Key of the current database, see AttsGetDbKey().
+ *  \param  pHash     Returned database hash of ATT_DATABASE_HASH_LEN bytes.
+ *
+ *  \return TRUE if a hash of a database with the same key is stored, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t AppDbGetDbHash(uint32_t key, uint8_t *pHash)
+{
+  if (appDb.dbHashValid && (appDb.dbHashKey == key))
+  {
+    memcpy(pHash, appDb.dbHash, ATT_DATABASE_HASH_LEN);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the GATT database hash stored with the device database.
+ *
+ *  \param  key       Key of the database the hash was calculated on, see AttsGetDbKey().
+ *  \param  pHash     Database hash of ATT_DATABASE_HASH_LEN bytes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AppDbSetDbHash(uint32_t key, const uint8_t *pHash)
+{
+  if (appDb.dbHashValid && (appDb.dbHashKey == key) &&
+      (memcmp(appDb.dbHash, pHash, ATT_DATABASE_HASH_LEN) == 0))
+  {
+    return;
+  }
+
+  memcpy(appDb.dbHash, pHash, ATT_DATABASE_HASH_LEN);
+  appDb.dbHashKey = key;
+  appDb.dbHashValid = TRUE;
+
+  (void)appDbNvmWriteDbHash();
 }
 
 /*************************************************************************************************/
@@ -614,7 +1163,11 @@ bool_t AppDbGetPeerAddrRes(appDbHdl_t hdl)
 /*************************************************************************************************/
 void AppDbSetPeerAddrRes(appDbHdl_t hdl, uint8_t addrRes)
 {
-  ((appDbRec_t *)hdl)->peerAddrRes = addrRes;
+  if (((appDbRec_t *)hdl)->peerAddrRes != addrRes)
+  {
+    ((appDbRec_t *)hdl)->peerAddrRes = addrRes;
+    ((appDbRec_t *)hdl)->nvmDirty |= APP_DB_NVM_DIRTY_BOND;
+  }
 }
 
 /*************************************************************************************************/
@@ -643,7 +1196,11 @@ uint32_t AppDbGetPeerSignCounter(appDbHdl_t hdl)
 /*************************************************************************************************/
 void AppDbSetPeerSignCounter(appDbHdl_t hdl, uint32_t signCounter)
 {
-  ((appDbRec_t *)hdl)->peerSignCounter = signCounter;
+  if (((appDbRec_t *)hdl)->peerSignCounter != signCounter)
+  {
+    ((appDbRec_t *)hdl)->peerSignCounter = signCounter;
+    ((appDbRec_t *)hdl)->nvmDirty |= APP_DB_NVM_DIRTY_ATTR;
+  }
 }
 
 /*************************************************************************************************/
@@ -701,5 +1258,9 @@ bool_t AppDbGetPeerRpao(appDbHdl_t hdl)
 /*************************************************************************************************/
 void AppDbSetPeerRpao(appDbHdl_t hdl, bool_t peerRpao)
 {
-  ((appDbRec_t *)hdl)->peerRpao = peerRpao;
+  if (((appDbRec_t *)hdl)->peerRpao != peerRpao)
+  {
+    ((appDbRec_t *)hdl)->peerRpao = peerRpao;
+    ((appDbRec_t *)hdl)->nvmDirty |= APP_DB_NVM_DIRTY_BOND;
+  }
 }
@@ -146,6 +146,8 @@ STACK_C_FILES = \
 	$(STACK_DIR)/platform/max32665/wsf_os.c \
 	$(STACK_DIR)/platform/max32665/wsf_cs.c \
 	$(STACK_DIR)/platform/max32665/pal_rtc.c \
+	$(STACK_DIR)/platform/max32665/pal_nvm.c \
+	$(STACK_DIR)/platform/max32665/pal_crypto.c \
 	$(STACK_DIR)/platform/max32665/pal_stubs.c \
 	$(STACK_DIR)/platform/max32665/pal_sys.c \
 	$(STACK_DIR)/ble-profiles/sources/apps/cycling/cycling_main.c \
@@ -251,6 +253,7 @@ STACK_C_FILES = \
 	$(STACK_DIR)/ble-profiles/sources/services/svc_dis.c \
 	$(STACK_DIR)/ble-profiles/sources/services/svc_wss.c \
 	$(STACK_DIR)/ble-host/sources/sec/pal/sec_ccm.c \
+	$(STACK_DIR)/ble-host/sources/sec/pal/sec_cmac.c \
 	$(STACK_DIR)/ble-host/sources/sec/common/sec_ccm_hci.c \
 	$(STACK_DIR)/ble-host/sources/sec/common/sec_aes.c \
 	$(STACK_DIR)/ble-host/sources/sec/common/sec_cmac_hci.c \
@@ -110,12 +110,17 @@ void PalCryptoCcmEnc(const uint8_t *pKey, uint8_t *pNonce, uint8_t *pPlainText,
 
 /* Crypto AES */
 void PalCryptoAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn);
+void PalCryptoAesBatchBegin(void);
+void PalCryptoAesBatchEnd(void);
 void PalCryptoAesSetupCipherBlock(PalCryptoEnc_t *pEnc, uint8_t id, uint8_t localDir);
 bool_t PalCryptoAesCcmEncrypt(PalCryptoEnc_t *pEnc, uint8_t *pHdr, uint8_t *pBuf, uint8_t *pMic);
 bool_t PalCryptoAesCcmDecrypt(PalCryptoEnc_t *pEnc, uint8_t *pBuf);
 void PalCryptoSetEncryptPacketCount(PalCryptoEnc_t *pEnc, uint64_t pktCnt);
 void PalCryptoSetDecryptPacketCount(PalCryptoEnc_t *pEnc, uint64_t pktCnt);
 
+/* CRC */
+uint32_t PalCryptoCrc32(uint32_t crc, uint32_t len, const uint8_t *pBuf);
+
 /*! \} */    /* PAL_CRYPTO */
 
 #ifdef __cplusplus
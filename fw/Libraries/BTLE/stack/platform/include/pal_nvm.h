@@ -36,8 +36,13 @@ extern "C" {
   Macros
 **************************************************************************************************/
 
-/*! NVM sector size. */
-#define PAL_NVM_SECTOR_SIZE 0x1000
+/*! NVM sector size, the flash page erased at once. */
+#define PAL_NVM_SECTOR_SIZE 0x2000
+
+/*! Number of NVM sectors. */
+#ifndef PAL_NVM_NUM_SECTORS
+#define PAL_NVM_NUM_SECTORS 2
+#endif
 
 /*! NVM word size. */
 #define PAL_NVM_WORD_SIZE   4
@@ -23,6 +23,7 @@
 #include "hci_core.h"
 #include "hci_vs.h"
 #include "bb_ble_api.h"
+#include "sch_api.h"
 #include "bstream.h"
 #include "hci_drv_sdma.h"
 
@@ -77,6 +78,13 @@
 
 #define HCI_OPCODE_VS_SET_DEF_TX_POWER         HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DD)  /*!< Set default transmit power. */
 #define HCI_OPCODE_VS_CALIBRATE                HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DE)  /*!< Run AFE calibration. */
+#define HCI_OPCODE_VS_GET_SCH_TRACE            HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3D9)  /*!< Get scheduler decision trace. */
+#define HCI_OPCODE_VS_GET_SCH_STATS            HCI_OPCODE(HCI_OGF_VENDOR_SPEC, 0x3DF)  /*!< Get scheduler decision counters. */
+
+#define HCI_VS_SCH_TRACE_MAX                   14      /*!< Maximum number of scheduler decisions per command. */
+
+/* Sequence number of the next scheduler decision to request */
+static uint32_t hciVsSchTraceSeq;
 
 /*************************************************************************************************/
 /*!
@@ -375,6 +383,75 @@ uint8_t hciCoreVsCmdCmplRcvd(uint16_t opcode, uint8_t *pMsg, uint8_t len)
 #endif  
       break;
     }
+    case HCI_OPCODE_VS_GET_SCH_STATS:
+    {
+#if WSF_TRACE_ENABLED
+      uint8_t status, type;
+      SchStatsCount_t stats;
+      uint16_t watermarkUsec;
+      uint8_t i;
+
+      BSTREAM_TO_UINT8(status, pMsg);
+      if(status != HCI_SUCCESS) {
+        HCI_TRACE_ERR0("Error with HCI_OPCODE_VS_GET_SCH_STATS");
+        break;
+      }
+
+      BSTREAM_TO_UINT8(type, pMsg);
+      for(i = 0; i < SCH_STATS_EVT_NUM; i++) {
+        BSTREAM_TO_UINT32(stats.count[i], pMsg);
+      }
+      BSTREAM_TO_UINT16(watermarkUsec, pMsg);
+
+      HCI_TRACE_INFO2("Scheduler stats type %u, handler watermark %u us:", type, watermarkUsec);
+      HCI_TRACE_INFO3("insert    = %u insertFail   = %u cancel    = %u", stats.count[SCH_STATS_EVT_INSERT],
+                      stats.count[SCH_STATS_EVT_INSERT_FAIL], stats.count[SCH_STATS_EVT_CANCEL]);
+      HCI_TRACE_INFO3("win       = %u lose         = %u lateStart = %u", stats.count[SCH_STATS_EVT_CONFLICT_WIN],
+                      stats.count[SCH_STATS_EVT_CONFLICT_LOSE], stats.count[SCH_STATS_EVT_LATE_START]);
+#endif
+      break;
+    }
+    case HCI_OPCODE_VS_GET_SCH_TRACE:
+    {
+      uint8_t status, num;
+      uint32_t seq;
+
+      BSTREAM_TO_UINT8(status, pMsg);
+      if(status != HCI_SUCCESS) {
+        HCI_TRACE_ERR0("Error with HCI_OPCODE_VS_GET_SCH_TRACE");
+        break;
+      }
+
+      BSTREAM_TO_UINT32(seq, pMsg);
+      BSTREAM_TO_UINT8(num, pMsg);
+
+      if(seq != hciVsSchTraceSeq) {
+        HCI_TRACE_WARN1("Scheduler trace lost %u decisions", seq - hciVsSchTraceSeq);
+      }
+      hciVsSchTraceSeq = seq + num;
+
+#if WSF_TRACE_ENABLED
+      /* One line per decision, the input of tools/sch_replay.c */
+      while(num--) {
+        uint32_t time, due;
+        uint16_t durUsec, bodId;
+        uint8_t event, type, reschPolicy, info;
+
+        BSTREAM_TO_UINT32(time, pMsg);
+        BSTREAM_TO_UINT32(due, pMsg);
+        BSTREAM_TO_UINT16(durUsec, pMsg);
+        BSTREAM_TO_UINT16(bodId, pMsg);
+        BSTREAM_TO_UINT8(event, pMsg);
+        BSTREAM_TO_UINT8(type, pMsg);
+        BSTREAM_TO_UINT8(reschPolicy, pMsg);
+        BSTREAM_TO_UINT8(info, pMsg);
+
+        WSF_TRACE8("HCI", "INFO", "SCH %u %u %u %u %u %u %u %u", time, due, durUsec, bodId, event, type,
+                   reschPolicy, info);
+      }
+#endif
+      break;
+    }
 
     default:
       break;
@@ -492,3 +569,21 @@ void HciVsGetTestStats(void)
 {
   HciVendorSpecificCmd(HCI_OPCODE_VS_GET_TEST_STATS, 0, NULL);
 }
+
+/*************************************************************************************************/
+void HciVsGetSchStats(uint8_t type)
+{
+  HciVendorSpecificCmd(HCI_OPCODE_VS_GET_SCH_STATS, sizeof(uint8_t), &type);
+}
+
+/*************************************************************************************************/
+void HciVsGetSchTrace(void)
+{
+  uint8_t params[5];
+  uint8_t *p = params;
+
+  UINT32_TO_BSTREAM(p, hciVsSchTraceSeq);
+  UINT8_TO_BSTREAM(p, HCI_VS_SCH_TRACE_MAX);
+
+  HciVendorSpecificCmd(HCI_OPCODE_VS_GET_SCH_TRACE, sizeof(params), params);
+}
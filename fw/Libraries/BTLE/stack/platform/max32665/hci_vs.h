@@ -159,3 +159,31 @@ void HciVsGetConnStats(void);
  */
 /*************************************************************************************************/
 void HciVsGetTestStats(void);
+
+/*************************************************************************************************/
+/*!
+ *  \fn         HciVsGetSchStats
+ *
+ *  \brief      Vendor-specific HCI command to get the scheduler decision counters of a BOD type.
+ *
+ *  \param      type        BLE operation type, or the number of BLE operation types for the
+ *                          other BODs.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void HciVsGetSchStats(uint8_t type);
+
+/*************************************************************************************************/
+/*!
+ *  \fn         HciVsGetSchTrace
+ *
+ *  \brief      Vendor-specific HCI command to get the scheduler decisions recorded since the last
+ *              call, printed one per line for tools/sch_replay.c. Call it often enough for the
+ *              controller trace ring not to wrap, lost decisions are reported.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void HciVsGetSchTrace(void);
+
@@ -0,0 +1,445 @@
+/* Copyright (c) 2009-2019 Arm Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*************************************************************************************************/
+/*!
+ *  \brief Crypto driver, AES and CCM-Mode on the AES engine of the link layer, CRC-32 on the
+ *         CRC engine.
+ *
+ *  The host calls the engine directly instead of sending an HCI LE Encrypt command per block.
+ *  LlMathAesEcb() runs each block in a critical section since the link layer also uses the
+ *  engine from interrupt context.  Both engines are in the TPU, the AES code reloads its setup
+ *  after the CRC resets it.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_math.h"
+#include "wsf_cs.h"
+#include "ll_math.h"
+#include "stack/platform/include/pal_crypto.h"
+#include "max32665.h"
+#include "gcr_regs.h"
+#include "tpu_regs.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief      CCM-Mode flags field, L-1 in bits 0-2, (M-2)/2 in bits 3-5, Adata in bit 6. */
+#define PAL_CRYPTO_CCM_FLAGS(micLen, clearLen)  ((SEC_CCM_L - 1) | ((((micLen) - 2) / 2) << 3) | \
+                                                 (((clearLen) > 0) << 6))
+
+/*! \brief      CRC-32 polynomial, bit reversed. */
+#define PAL_CRYPTO_CRC32_POLY_REV               0xEDB88320
+
+/*! \brief      Bytes fed to the CRC engine per critical section. */
+#ifndef PAL_CRYPTO_CRC_CHUNK_LEN
+#define PAL_CRYPTO_CRC_CHUNK_LEN                256
+#endif
+
+/*! \brief      TPU done flags. */
+#define PAL_CRYPTO_TPU_DONE_FLAGS               (MXC_F_TPU_CTRL_DMA_DONE | MXC_F_TPU_CTRL_GLS_DONE | \
+                                                 MXC_F_TPU_CTRL_HSH_DONE | MXC_F_TPU_CTRL_CPH_DONE | \
+                                                 MXC_F_TPU_CTRL_MAA_DONE)
+
+/**************************************************************************************************
+  Local Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Encrypt a most significant byte first block in place.
+ *
+ *  \param  pRevKey     Key, least significant byte first.
+ *  \param  pBlock      Block to encrypt, most significant byte first.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void palCryptoAesMsb(const uint8_t *pRevKey, uint8_t *pBlock)
+{
+  uint8_t rev[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t i;
+
+  for (i = 0; i < PAL_CRYPTO_AES_BLOCK_SIZE; i++)
+  {
+    rev[i] = pBlock[PAL_CRYPTO_AES_BLOCK_SIZE - 1 - i];
+  }
+
+  PalCryptoAesEcb(pRevKey, rev, rev);
+
+  for (i = 0; i < PAL_CRYPTO_AES_BLOCK_SIZE; i++)
+  {
+    pBlock[i] = rev[PAL_CRYPTO_AES_BLOCK_SIZE - 1 - i];
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  XOR a partial block into a block.
+ *
+ *  \param  pDst        Block.
+ *  \param  pSrc        Data to XOR.
+ *  \param  len         Length of pSrc, at most one block.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void palCryptoXor(uint8_t *pDst, const uint8_t *pSrc, uint16_t len)
+{
+  while (len--)
+  {
+    *pDst++ ^= *pSrc++;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Set a counter block A(i).
+ *
+ *  \param  pCtr        Counter block.
+ *  \param  pNonce      Nonce (SEC_CCM_NONCE_LEN bytes).
+ *  \param  i           Counter value.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void palCryptoCcmCtr(uint8_t *pCtr, const uint8_t *pNonce, uint16_t i)
+{
+  pCtr[0] = SEC_CCM_L - 1;
+  memcpy(pCtr + 1, pNonce, SEC_CCM_NONCE_LEN);
+  pCtr[PAL_CRYPTO_AES_BLOCK_SIZE - 2] = (uint8_t) (i >> 8);
+  pCtr[PAL_CRYPTO_AES_BLOCK_SIZE - 1] = (uint8_t) i;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start the CBC-MAC with B0 and the additional authentication data.
+ *
+ *  \param  pRevKey     Key, least significant byte first.
+ *  \param  pMac        Returns the CBC-MAC state.
+ *  \param  pNonce      Nonce (SEC_CCM_NONCE_LEN bytes).
+ *  \param  textLen     Length of the text.
+ *  \param  pClear      Additional authentication data.
+ *  \param  clearLen    Length of pClear.
+ *  \param  micLen      Size of MIC in bytes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void palCryptoCcmMacStart(const uint8_t *pRevKey, uint8_t *pMac, const uint8_t *pNonce,
+                                 uint16_t textLen, const uint8_t *pClear, uint16_t clearLen,
+                                 uint8_t micLen)
+{
+  uint16_t len;
+  uint8_t pos;
+
+  /* B0 */
+  pMac[0] = PAL_CRYPTO_CCM_FLAGS(micLen, clearLen);
+  memcpy(pMac + 1, pNonce, SEC_CCM_NONCE_LEN);
+  pMac[PAL_CRYPTO_AES_BLOCK_SIZE - 2] = (uint8_t) (textLen >> 8);
+  pMac[PAL_CRYPTO_AES_BLOCK_SIZE - 1] = (uint8_t) textLen;
+  palCryptoAesMsb(pRevKey, pMac);
+
+  if (clearLen == 0)
+  {
+    return;
+  }
+
+  /* Additional data, prefixed with its 2 byte length and zero padded */
+  pMac[0] ^= (uint8_t) (clearLen >> 8);
+  pMac[1] ^= (uint8_t) clearLen;
+  pos = 2;
+
+  while (clearLen > 0)
+  {
+    len = WSF_MIN(clearLen, PAL_CRYPTO_AES_BLOCK_SIZE - pos);
+    palCryptoXor(pMac + pos, pClear, len);
+    palCryptoAesMsb(pRevKey, pMac);
+
+    pClear += len;
+    clearLen -= len;
+    pos = 0;
+  }
+}
+
+/**************************************************************************************************
+  Global Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize crypto resources.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalCryptoInit(void)
+{
+  /* The link layer owns the AES engine setup. */
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Calculate AES ECB.
+ *
+ *  \param  pKey        Encryption key, least significant byte first.
+ *  \param  pOut        Output data, least significant byte first.
+ *  \param  pIn         Input data, least significant byte first.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalCryptoAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+{
+  LlMathAesEcb(pKey, pOut, pIn);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Begin a batch of AES ECB calculations, the engine stays set up between blocks.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalCryptoAesBatchBegin(void)
+{
+  LlMathAesBatchBegin();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  End a batch of AES ECB calculations.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalCryptoAesBatchEnd(void)
+{
+  LlMathAesBatchEnd();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Execute the CCM-Mode encryption algorithm.
+ *
+ *  \param  pKey          Pointer to encryption key (SEC_CCM_KEY_LEN bytes).
+ *  \param  pNonce        Pointer to nonce (SEC_CCM_NONCE_LEN bytes).
+ *  \param  pPlainText    Pointer to text to encrypt.
+ *  \param  textLen       Length of pPlainText in bytes.
+ *  \param  pClear        Pointer to additional, unencrypted authentication text.
+ *  \param  clearLen      Length of pClear in bytes.
+ *  \param  micLen        Size of MIC in bytes (4, 8 or 16).
+ *  \param  pResult       Buffer to hold result, the encrypted text then the MIC at pResult + clearLen.
+ *  \param  handlerId     Unused, the caller sends the complete event.
+ *  \param  param         Unused.
+ *  \param  event         Unused.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalCryptoCcmEnc(const uint8_t *pKey, uint8_t *pNonce, uint8_t *pPlainText, uint16_t textLen,
+                     uint8_t *pClear, uint16_t clearLen, uint8_t micLen, uint8_t *pResult,
+                     uint8_t handlerId, uint16_t param, uint8_t event)
+{
+  uint8_t revKey[SEC_CCM_KEY_LEN];
+  uint8_t mac[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t ctr[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t block[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t *pOut = pResult + clearLen;
+  uint16_t i = 1;
+  uint16_t len;
+  uint8_t k;
+
+  for (k = 0; k < SEC_CCM_KEY_LEN; k++)
+  {
+    revKey[k] = pKey[SEC_CCM_KEY_LEN - 1 - k];
+  }
+
+  LlMathAesBatchBegin();
+
+  palCryptoCcmMacStart(revKey, mac, pNonce, textLen, pClear, clearLen, micLen);
+
+  /* Authenticate and encrypt each block, the text is read before its result is written */
+  while (textLen > 0)
+  {
+    len = WSF_MIN(textLen, PAL_CRYPTO_AES_BLOCK_SIZE);
+    memcpy(block, pPlainText, len);
+
+    palCryptoXor(mac, block, len);
+    palCryptoAesMsb(revKey, mac);
+
+    palCryptoCcmCtr(ctr, pNonce, i++);
+    palCryptoAesMsb(revKey, ctr);
+    palCryptoXor(block, ctr, len);
+    memcpy(pOut, block, len);
+
+    pPlainText += len;
+    pOut += len;
+    textLen -= len;
+  }
+
+  /* MIC is the CBC-MAC encrypted with S0 */
+  palCryptoCcmCtr(ctr, pNonce, 0);
+  palCryptoAesMsb(revKey, ctr);
+  palCryptoXor(mac, ctr, micLen);
+  memcpy(pOut, mac, micLen);
+
+  LlMathAesBatchEnd();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Execute the CCM-Mode verify and decrypt algorithm.
+ *
+ *  \param  pKey          Pointer to encryption key (SEC_CCM_KEY_LEN bytes).
+ *  \param  pNonce        Pointer to nonce (SEC_CCM_NONCE_LEN bytes).
+ *  \param  pCypherText   Pointer to text to decrypt.
+ *  \param  textLen       Length of pCypherText in bytes.
+ *  \param  pClear        Pointer to additional, unencrypted authentication text.
+ *  \param  clearLen      Length of pClear in bytes.
+ *  \param  pMic          Pointer to authentication digest.
+ *  \param  micLen        Size of MIC in bytes (4, 8 or 16).
+ *  \param  pResult       Buffer to hold the decrypted text.
+ *  \param  handlerId     Unused, the caller sends the complete event.
+ *  \param  param         Unused.
+ *  \param  event         Unused.
+ *
+ *  \return Zero if the MIC is authentic, else nonzero.
+ */
+/*************************************************************************************************/
+uint32_t PalCryptoCcmDec(const uint8_t *pKey, uint8_t *pNonce, uint8_t *pCypherText, uint16_t textLen,
+                         uint8_t *pClear, uint16_t clearLen, uint8_t *pMic, uint8_t micLen,
+                         uint8_t *pResult, uint8_t handlerId, uint16_t param, uint8_t event)
+{
+  uint8_t revKey[SEC_CCM_KEY_LEN];
+  uint8_t mac[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t ctr[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint8_t block[PAL_CRYPTO_AES_BLOCK_SIZE];
+  uint32_t diff = 0;
+  uint16_t i = 1;
+  uint16_t len;
+  uint8_t k;
+
+  for (k = 0; k < SEC_CCM_KEY_LEN; k++)
+  {
+    revKey[k] = pKey[SEC_CCM_KEY_LEN - 1 - k];
+  }
+
+  LlMathAesBatchBegin();
+
+  palCryptoCcmMacStart(revKey, mac, pNonce, textLen, pClear, clearLen, micLen);
+
+  /* Decrypt and authenticate each block */
+  while (textLen > 0)
+  {
+    len = WSF_MIN(textLen, PAL_CRYPTO_AES_BLOCK_SIZE);
+    memcpy(block, pCypherText, len);
+
+    palCryptoCcmCtr(ctr, pNonce, i++);
+    palCryptoAesMsb(revKey, ctr);
+    palCryptoXor(block, ctr, len);
+    memcpy(pResult, block, len);
+
+    palCryptoXor(mac, block, len);
+    palCryptoAesMsb(revKey, mac);
+
+    pCypherText += len;
+    pResult += len;
+    textLen -= len;
+  }
+
+  palCryptoCcmCtr(ctr, pNonce, 0);
+  palCryptoAesMsb(revKey, ctr);
+  palCryptoXor(mac, ctr, micLen);
+
+  LlMathAesBatchEnd();
+
+  /* Compare without an early exit */
+  for (k = 0; k < micLen; k++)
+  {
+    diff |= mac[k] ^ pMic[k];
+  }
+
+  return diff;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Continue a CRC-32 on the CRC engine.
+ *
+ *  \param  crc         CRC so far, not inverted.
+ *  \param  len         Length of the buffer.
+ *  \param  pBuf        Buffer, read by the engine DMA.
+ *
+ *  \return CRC including the buffer, not inverted.
+ *
+ *  The buffer is fed in chunks of PAL_CRYPTO_CRC_CHUNK_LEN bytes, each in a critical section since
+ *  the link layer uses the TPU from interrupt context.
+ */
+/*************************************************************************************************/
+uint32_t PalCryptoCrc32(uint32_t crc, uint32_t len, const uint8_t *pBuf)
+{
+  uint32_t perckcn0, clkcn;
+  uint32_t chunk;
+
+  while (len > 0)
+  {
+    WSF_CS_INIT(cs);
+
+    chunk = WSF_MIN(len, PAL_CRYPTO_CRC_CHUNK_LEN);
+
+    WSF_CS_ENTER(cs);
+
+    /* Clock the engine. */
+    perckcn0 = MXC_GCR->perckcn0;
+    clkcn = MXC_GCR->clkcn;
+    MXC_GCR->clkcn |= MXC_F_GCR_CLKCN_HIRC_EN;
+    MXC_GCR->perckcn0 &= ~MXC_F_GCR_PERCKCN0_CRYPTOD;
+
+    /* Reset to CRC mode, seeded with the CRC so far. */
+    MXC_TPU->ctrl = MXC_F_TPU_CTRL_RST;
+    MXC_TPU->ctrl |= MXC_F_TPU_CTRL_FLAG_MODE | MXC_S_TPU_CTRL_RDSRC_DMAORAPB;
+    MXC_TPU->crc_ctrl = MXC_F_TPU_CRC_CTRL_CRC;
+    MXC_TPU->crc_poly = PAL_CRYPTO_CRC32_POLY_REV;
+    MXC_TPU->crc_val = crc;
+    MXC_TPU->ctrl |= PAL_CRYPTO_TPU_DONE_FLAGS;
+
+    /* Feed the chunk. */
+    MXC_TPU->dma_src = (uint32_t)pBuf;
+    MXC_TPU->dma_cnt = chunk;
+
+    while (!(MXC_TPU->ctrl & MXC_F_TPU_CTRL_DMA_DONE));
+    while (!(MXC_TPU->ctrl & MXC_F_TPU_CTRL_GLS_DONE));
+
+    crc = MXC_TPU->crc_val;
+
+    MXC_TPU->ctrl |= PAL_CRYPTO_TPU_DONE_FLAGS;
+    MXC_TPU->crc_ctrl = 0;
+
+    MXC_GCR->perckcn0 = perckcn0;
+    MXC_GCR->clkcn = clkcn;
+
+    WSF_CS_EXIT(cs);
+
+    pBuf += chunk;
+    len -= chunk;
+  }
+
+  return crc;
+}
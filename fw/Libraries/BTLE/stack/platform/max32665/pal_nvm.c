@@ -0,0 +1,216 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief      Internal flash NVM driver.
+ *
+ *  Copyright (c) 2018 Arm Ltd.
+ *
+ *  Copyright (c) 2019 Packetcraft, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "pal_nvm.h"
+#include "max32665.h"
+#include "flc.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief      NVM region size. */
+#define PAL_NVM_SIZE          (PAL_NVM_NUM_SECTORS * PAL_NVM_SECTOR_SIZE)
+
+#if (PAL_NVM_SECTOR_SIZE % MXC_FLASH_PAGE_SIZE) != 0
+#error "PAL_NVM_SECTOR_SIZE must be a whole number of flash pages"
+#endif
+
+/*! \brief      NVM region start address, at the end of flash bank 0 since bank 1 holds OTA images. */
+#ifndef PAL_NVM_BASE_ADDR
+#define PAL_NVM_BASE_ADDR     (MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE - PAL_NVM_SIZE)
+#endif
+
+/*! \brief      Erased flash byte value. */
+#define PAL_NVM_ERASED_BYTE   0xFF
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief      Driver control block. */
+static struct
+{
+  PalNvmState_t state;        /*!< Current state. */
+  PalNvmCback_t actCback;     /*!< Completion callback. */
+} palNvmCb;
+
+/**************************************************************************************************
+  Local Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Complete an operation.
+ *
+ *  \param  status      TRUE if the operation succeeded.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void palNvmComplete(bool_t status)
+{
+  palNvmCb.state = PAL_NVM_STATE_READY;
+
+  if (palNvmCb.actCback)
+  {
+    palNvmCb.actCback(status);
+  }
+}
+
+/**************************************************************************************************
+  Global Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the NVM.
+ *
+ *  \param  actCback    Callback function.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalNvmInit(PalNvmCback_t actCback)
+{
+  palNvmCb.actCback = actCback;
+  palNvmCb.state = PAL_NVM_STATE_READY;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  De-initialize the NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalNvmDeInit(void)
+{
+  palNvmCb.actCback = NULL;
+  palNvmCb.state = PAL_NVM_STATE_UNINIT;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the current state.
+ *
+ *  \return Current state.
+ */
+/*************************************************************************************************/
+PalNvmState_t PalNvmGetState(void)
+{
+  return palNvmCb.state;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read data.
+ *
+ *  \param  pBuf        Buffer to read to.
+ *  \param  size        Data length to read.
+ *  \param  srcAddr     Offset in the NVM region to read from.
+ *
+ *  \return None.
+ *
+ *  Bytes outside the NVM region read as erased, so a full region looks like its end.
+ */
+/*************************************************************************************************/
+void PalNvmRead(void *pBuf, uint32_t size, uint32_t srcAddr)
+{
+  uint32_t len = 0;
+
+  if (srcAddr < PAL_NVM_SIZE)
+  {
+    len = ((PAL_NVM_SIZE - srcAddr) < size) ? (PAL_NVM_SIZE - srcAddr) : size;
+
+    /* Flash is memory mapped. */
+    memcpy(pBuf, (void *)(PAL_NVM_BASE_ADDR + srcAddr), len);
+  }
+
+  memset((uint8_t *)pBuf + len, PAL_NVM_ERASED_BYTE, size - len);
+
+  palNvmComplete(TRUE);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write data.
+ *
+ *  \param  pBuf        Buffer to write.
+ *  \param  size        Data length to write.
+ *  \param  dstAddr     Offset in the NVM region to write to.
+ *
+ *  \return None.
+ *
+ *  Writes that do not fit in the NVM region are dropped.
+ */
+/*************************************************************************************************/
+void PalNvmWrite(void *pBuf, uint32_t size, uint32_t dstAddr)
+{
+  bool_t status = FALSE;
+
+  if ((dstAddr < PAL_NVM_SIZE) && (size <= (PAL_NVM_SIZE - dstAddr)))
+  {
+    palNvmCb.state = PAL_NVM_STATE_BUSY;
+    status = (FLC_Write(PAL_NVM_BASE_ADDR + dstAddr, size, (uint32_t *)pBuf) == E_NO_ERROR);
+  }
+
+  palNvmComplete(status);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase sectors.
+ *
+ *  \param  size        Number of bytes to erase, rounded up to whole flash pages.
+ *  \param  startAddr   Offset in the NVM region to start erasing from.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void PalNvmEraseSector(uint32_t size, uint32_t startAddr)
+{
+  uint32_t addr = startAddr & ~(MXC_FLASH_PAGE_SIZE - 1);
+  uint32_t end = startAddr + size;
+  bool_t status = TRUE;
+
+  if (end > PAL_NVM_SIZE)
+  {
+    end = PAL_NVM_SIZE;
+  }
+
+  palNvmCb.state = PAL_NVM_STATE_BUSY;
+
+  for (; addr < end; addr += MXC_FLASH_PAGE_SIZE)
+  {
+    if (FLC_PageErase(PAL_NVM_BASE_ADDR + addr) != E_NO_ERROR)
+    {
+      status = FALSE;
+      break;
+    }
+  }
+
+  palNvmComplete(status);
+}
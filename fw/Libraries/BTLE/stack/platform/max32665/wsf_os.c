@@ -46,6 +46,11 @@ WSF_CT_ASSERT(sizeof(uint32_t) == 4);
 #define WSF_MAX_HANDLERS      16
 #endif
 
+/* messages of higher lanes a waiting lane lets go first before it is dispatched ahead of them */
+#ifndef WSF_OS_LANE_AGE_MAX
+#define WSF_OS_LANE_AGE_MAX   8
+#endif
+
 #if WSF_OS_DIAG == TRUE
 #define WSF_OS_SET_ACTIVE_HANDLER_ID(id)          WsfActiveHandler = id;
 #else
@@ -56,12 +61,21 @@ WSF_CT_ASSERT(sizeof(uint32_t) == 4);
   Data Types
 **************************************************************************************************/
 
+/*! \brief  Message lane structure */
+typedef struct
+{
+  wsfQueue_t            msgQueue;
+  wsfOsLaneStat_t       stat;
+  uint8_t               skipped;
+} wsfOsLane_t;
+
 /*! \brief  Task structure */
 typedef struct
 {
   wsfEventHandler_t     handler[WSF_MAX_HANDLERS];
   wsfEventMask_t        handlerEventMask[WSF_MAX_HANDLERS];
-  wsfQueue_t            msgQueue;
+  uint8_t               handlerPrio[WSF_MAX_HANDLERS];
+  wsfOsLane_t           lane[WSF_MSG_NUM_PRIO];
   wsfTaskEvent_t        taskEventMask;
   uint8_t               numHandler;
 } wsfOsTask_t;
@@ -171,10 +185,84 @@ void WsfTaskSetReady(wsfHandlerId_t handlerId, wsfTaskEvent_t event)
 /*************************************************************************************************/
 wsfQueue_t *WsfTaskMsgQueue(wsfHandlerId_t handlerId)
 {
-  /* Unused parameter */
-  (void)handlerId;
+  return &(wsfOs.task.lane[wsfOs.task.handlerPrio[WSF_HANDLER_FROM_ID(handlerId)]].msgQueue);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Enqueue a message in a task message lane and set the task as ready to run.
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  pMsg        Pointer to message buffer.
+ *  \param  prio        Message priority, WSF_MSG_PRIO_HANDLER for the lane of the handler.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTaskMsgEnq(wsfHandlerId_t handlerId, void *pMsg, uint8_t prio)
+{
+  wsfOsLane_t *pLane;
 
-  return &(wsfOs.task.msgQueue);
+  WSF_CS_INIT(cs);
+
+  if (prio == WSF_MSG_PRIO_HANDLER)
+  {
+    prio = wsfOs.task.handlerPrio[WSF_HANDLER_FROM_ID(handlerId)];
+  }
+
+  WSF_ASSERT(prio < WSF_MSG_NUM_PRIO);
+
+  pLane = &wsfOs.task.lane[prio];
+
+  WSF_CS_ENTER(cs);
+  WsfMsgEnq(&pLane->msgQueue, handlerId, pMsg);
+  if (++pLane->stat.depth > pLane->stat.maxDepth)
+  {
+    pLane->stat.maxDepth = pLane->stat.depth;
+  }
+  WSF_CS_EXIT(cs);
+
+  /* set task for this handler as ready to run */
+  WsfTaskSetReady(handlerId, WSF_MSG_QUEUE_EVENT);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the message priority of a handler.
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  prio        Message priority.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfOsSetHandlerPrio(wsfHandlerId_t handlerId, uint8_t prio)
+{
+  WSF_ASSERT(WSF_HANDLER_FROM_ID(handlerId) < WSF_MAX_HANDLERS);
+  WSF_ASSERT(prio < WSF_MSG_NUM_PRIO);
+
+  wsfOs.task.handlerPrio[WSF_HANDLER_FROM_ID(handlerId)] = prio;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of a message lane.
+ *
+ *  \param  pStat       Returned lane statistics.
+ *  \param  prio        Message priority of the lane.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfOsGetLaneStats(wsfOsLaneStat_t *pStat, uint8_t prio)
+{
+  WSF_CS_INIT(cs);
+
+  WSF_ASSERT(prio < WSF_MSG_NUM_PRIO);
+
+  WSF_CS_ENTER(cs);
+  *pStat = wsfOs.task.lane[prio].stat;
+  WSF_CS_EXIT(cs);
 }
 
 /*************************************************************************************************/
@@ -194,6 +282,7 @@ wsfHandlerId_t WsfOsSetNextHandler(wsfEventHandler_t handler)
   WSF_ASSERT(handlerId < WSF_MAX_HANDLERS);
 
   wsfOs.task.handler[handlerId] = handler;
+  wsfOs.task.handlerPrio[handlerId] = WSF_MSG_PRIO_NORMAL;
 
   return handlerId;
 }
@@ -223,6 +312,143 @@ void WsfOsInit(void)
   memset(&wsfOs, 0, sizeof(wsfOs));
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Dequeue the next message of the lanes up to a priority.  The highest lane goes first
+ *          unless a lower one has been skipped WSF_OS_LANE_AGE_MAX times.
+ *
+ *  \param  pTask       Task.
+ *  \param  maxPrio     Lowest message priority dequeued.
+ *  \param  pHandlerId  Handler ID of returned message; this is a return parameter.
+ *
+ *  \return Pointer to message that has been dequeued or NULL if the lanes are empty.
+ */
+/*************************************************************************************************/
+static void *wsfOsMsgDeq(wsfOsTask_t *pTask, uint8_t maxPrio, wsfHandlerId_t *pHandlerId)
+{
+  wsfOsLane_t *pLane = NULL;
+  wsfOsLane_t *pAged = NULL;
+  void        *pMsg = NULL;
+  uint8_t     prio;
+
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+
+  for (prio = 0; prio <= maxPrio; prio++)
+  {
+    if (pTask->lane[prio].msgQueue.pHead == NULL)
+    {
+      continue;
+    }
+
+    if (pLane == NULL)
+    {
+      pLane = &pTask->lane[prio];
+    }
+    else if ((pAged == NULL) && (pTask->lane[prio].skipped >= WSF_OS_LANE_AGE_MAX))
+    {
+      pAged = &pTask->lane[prio];
+    }
+  }
+
+  if (pAged != NULL)
+  {
+    pAged->stat.numAged++;
+    pLane = pAged;
+  }
+
+  if (pLane != NULL)
+  {
+    /* the other waiting lanes age */
+    for (prio = 0; prio <= maxPrio; prio++)
+    {
+      if ((pTask->lane[prio].msgQueue.pHead != NULL) && (&pTask->lane[prio] != pLane))
+      {
+        pTask->lane[prio].skipped++;
+      }
+    }
+
+    pLane->skipped = 0;
+    if (pLane->stat.depth > 0)
+    {
+      pLane->stat.depth--;
+    }
+    pMsg = WsfMsgDeq(&pLane->msgQueue, pHandlerId);
+  }
+
+  WSF_CS_EXIT(cs);
+
+  return pMsg;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Dispatch the messages of the lanes up to a priority.  Below the realtime lane,
+ *          dispatch stops when a timer or handler event becomes ready so they go first.
+ *
+ *  \param  pTask       Task.
+ *  \param  maxPrio     Lowest message priority dispatched.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfOsServiceMsg(wsfOsTask_t *pTask, uint8_t maxPrio)
+{
+  void              *pMsg;
+  wsfHandlerId_t    handlerId;
+
+  while ((pMsg = wsfOsMsgDeq(pTask, maxPrio, &handlerId)) != NULL)
+  {
+    WSF_ASSERT(handlerId < WSF_MAX_HANDLERS);
+    WSF_OS_SET_ACTIVE_HANDLER_ID(handlerId);
+    (*pTask->handler[handlerId])(0, pMsg);
+    WsfMsgFree(pMsg);
+
+    if ((maxPrio > WSF_MSG_PRIO_REALTIME) &&
+        ((pTask->taskEventMask & (WSF_TIMER_EVENT | WSF_HANDLER_EVENT)) != 0))
+    {
+      /* remaining messages go on the next pass */
+      WsfTaskSetReady(0, WSF_MSG_QUEUE_EVENT);
+      break;
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Dispatch the handler events of the handlers in a range of lanes.
+ *
+ *  \param  pTask       Task.
+ *  \param  minPrio     Highest handler priority dispatched.
+ *  \param  maxPrio     Lowest handler priority dispatched.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfOsServiceHandlers(wsfOsTask_t *pTask, uint8_t minPrio, uint8_t maxPrio)
+{
+  wsfEventMask_t    eventMask;
+  uint8_t           i;
+
+  WSF_CS_INIT(cs);
+
+  for (i = 0; i < WSF_MAX_HANDLERS; i++)
+  {
+    if ((pTask->handlerEventMask[i] != 0) && (pTask->handler[i] != NULL) &&
+        (pTask->handlerPrio[i] >= minPrio) && (pTask->handlerPrio[i] <= maxPrio))
+    {
+      WSF_CS_ENTER(cs);
+      eventMask = pTask->handlerEventMask[i];
+      pTask->handlerEventMask[i] = 0;
+      WSF_OS_SET_ACTIVE_HANDLER_ID(i);
+      WSF_CS_EXIT(cs);
+
+      (*pTask->handler[i])(eventMask, NULL);
+    }
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Event dispatched.  Designed to be called repeatedly from infinite loop.
@@ -233,12 +459,8 @@ void WsfOsInit(void)
 void wsfOsDispatcher(void)
 {
   wsfOsTask_t       *pTask;
-  void              *pMsg;
   wsfTimer_t        *pTimer;
-  wsfEventMask_t    eventMask;
   wsfTaskEvent_t    taskEventMask;
-  wsfHandlerId_t    handlerId;
-  uint8_t           i;
 
   WSF_CS_INIT(cs);
 
@@ -250,16 +472,15 @@ void wsfOsDispatcher(void)
   pTask->taskEventMask = 0;
   WSF_CS_EXIT(cs);
 
+  /* HCI and realtime lanes */
+  if (taskEventMask & WSF_HANDLER_EVENT)
+  {
+    wsfOsServiceHandlers(pTask, WSF_MSG_PRIO_HCI, WSF_MSG_PRIO_REALTIME);
+  }
+
   if (taskEventMask & WSF_MSG_QUEUE_EVENT)
   {
-    /* handle msg queue */
-    while ((pMsg = WsfMsgDeq(&pTask->msgQueue, &handlerId)) != NULL)
-    {
-      WSF_ASSERT(handlerId < WSF_MAX_HANDLERS);
-      WSF_OS_SET_ACTIVE_HANDLER_ID(handlerId);
-      (*pTask->handler[handlerId])(0, pMsg);
-      WsfMsgFree(pMsg);
-    }
+    wsfOsServiceMsg(pTask, WSF_MSG_PRIO_REALTIME);
   }
 
   if (taskEventMask & WSF_TIMER_EVENT)
@@ -273,21 +494,14 @@ void wsfOsDispatcher(void)
     }
   }
 
+  /* normal and background lanes */
   if (taskEventMask & WSF_HANDLER_EVENT)
   {
-    /* service handlers */
-    for (i = 0; i < WSF_MAX_HANDLERS; i++)
-    {
-      if ((pTask->handlerEventMask[i] != 0) && (pTask->handler[i] != NULL))
-      {
-        WSF_CS_ENTER(cs);
-        eventMask = pTask->handlerEventMask[i];
-        pTask->handlerEventMask[i] = 0;
-        WSF_OS_SET_ACTIVE_HANDLER_ID(i);
-        WSF_CS_EXIT(cs);
+    wsfOsServiceHandlers(pTask, WSF_MSG_PRIO_NORMAL, WSF_MSG_PRIO_BACKGROUND);
+  }
 
-        (*pTask->handler[i])(eventMask, NULL);
-      }
-    }
+  if (taskEventMask & WSF_MSG_QUEUE_EVENT)
+  {
+    wsfOsServiceMsg(pTask, WSF_MSG_PRIO_BACKGROUND);
   }
 }
@@ -72,6 +72,7 @@ WSF_H_FILES += $(shell find $(WSF_INC_DIRS) -name '*.h')
 
 WSF_C_FILES = \
 	$(WSF_DIR)/sources/util/crc32.c \
+	$(WSF_DIR)/sources/util/sha256.c \
 	$(WSF_DIR)/sources/util/print.c \
 	$(WSF_DIR)/sources/util/bda.c \
 	$(WSF_DIR)/sources/util/bstream.c \
@@ -0,0 +1,109 @@
+/* Copyright (c) 2009-2019 Arm Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*************************************************************************************************/
+/*!
+ *  \brief SHA-256 utilities.
+ */
+/*************************************************************************************************/
+#ifndef SHA256_H
+#define SHA256_H
+
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup WSF_UTIL_API
+ *  \{ */
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief Length of a SHA-256 digest in bytes. */
+#define SHA256_DIGEST_LEN         32
+
+/*! \brief Length of a SHA-256 block in bytes. */
+#define SHA256_BLOCK_LEN          64
+
+/*! \brief Number of words of the SHA-256 chaining state. */
+#define SHA256_STATE_WORDS        8
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief SHA-256 streaming context.
+ *
+ *  When \a len is a multiple of SHA256_BLOCK_LEN the block buffer is empty, and \a state with
+ *  \a len is all that is needed to resume the digest later.
+ */
+typedef struct
+{
+  uint32_t  state[SHA256_STATE_WORDS];  /*!< \brief Chaining state. */
+  uint32_t  len;                        /*!< \brief Number of bytes digested so far. */
+  uint8_t   buf[SHA256_BLOCK_LEN];      /*!< \brief Partial block. */
+} sha256Ctx_t;
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start a SHA-256 digest.
+ *
+ *  \param  pCtx     Context.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Init(sha256Ctx_t *pCtx);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Add data to a SHA-256 digest.
+ *
+ *  \param  pCtx     Context.
+ *  \param  pBuf     Data.
+ *  \param  len      Length of the data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Update(sha256Ctx_t *pCtx, const uint8_t *pBuf, uint32_t len);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Finish a SHA-256 digest.
+ *
+ *  \param  pCtx     Context, must be started again before being reused.
+ *  \param  pDigest  Returns the SHA256_DIGEST_LEN bytes of the digest.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Final(sha256Ctx_t *pCtx, uint8_t *pDigest);
+
+/*! \} */    /* WSF_UTIL_API */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* SHA256_H */
@@ -35,21 +35,17 @@ extern "C" {
   Function Prototypes
 **************************************************************************************************/
 
-#if WSF_TOKEN_ENABLED == TRUE
 /*************************************************************************************************/
 /*!
  *  \brief  Perform an assert action.
  *
- *  \param  modId   Name of file originating assert.
+ *  \param  pFile   Name of file originating assert.
  *  \param  line    Line number of assert statement.
  *
  *  \return None.
  */
 /*************************************************************************************************/
-void WsfAssert(uint16_t modId, uint16_t line);
-#else
 void WsfAssert(const char *pFile, uint16_t line);
-#endif
 
 /*************************************************************************************************/
 /*!
@@ -95,11 +91,7 @@ void WsfAssertTrapEnable(bool_t enaAssertTrap);
  */
 /*************************************************************************************************/
 #if WSF_ASSERT_ENABLED == TRUE
-#if WSF_TOKEN_ENABLED == TRUE
-#define WSF_ASSERT(expr)      if (!(expr)) {WsfAssert(MODULE_ID, (uint16_t) __LINE__);}
-#else
 #define WSF_ASSERT(expr)      if (!(expr)) {WsfAssert(__FILE__, (uint16_t) __LINE__);}
-#endif
 #else
 #define WSF_ASSERT(expr)      (void)(expr);
 #endif
@@ -66,9 +66,14 @@ extern "C" {
 /*! \brief Failure Codes */
 #define WSF_BUF_ALLOC_FAILED        1
 
-#ifndef WSF_BUF_STATS
-/*! \brief Enable buffer allocation statistics. */
-#define WSF_BUF_STATS FALSE
+/*! \brief Width in bytes of a request size class, a power of two */
+#ifndef WSF_BUF_CLASS_SIZE
+#define WSF_BUF_CLASS_SIZE          16
+#endif
+
+/*! \brief Number of request size classes, longer requests share the last class */
+#ifndef WSF_BUF_CLASS_NUM
+#define WSF_BUF_CLASS_NUM           64
 #endif
 
 /**************************************************************************************************
@@ -90,6 +95,7 @@ typedef struct
   uint8_t    numAlloc;             /*!< \brief Number of outstanding allocations. */
   uint8_t    maxAlloc;             /*!< \brief High allocation watermark. */
   uint16_t   maxReqLen;            /*!< \brief Maximum requested buffer length. */
+  uint16_t   numFail;              /*!< \brief Allocations that found the pool empty. */
 } WsfBufPoolStat_t;
 
 /*! \brief WSF buffer diagnostics - buffer allocation failure */
@@ -144,7 +150,7 @@ uint32_t WsfBufCalcSize(uint8_t numPools, wsfBufPoolDesc_t *pDesc);
 /*************************************************************************************************/
 /*!
  *  \brief  Initialize the buffer pool service.  This function should only be called once
- *          upon system initialization.
+ *          upon system initialization.  Pools must be in ascending buffer length order.
  *
  *  \param  numPools  Number of buffer pools.
  *  \param  pDesc     Array of buffer pool descriptors, one for each pool.
@@ -215,6 +221,17 @@ uint8_t WsfBufGetNumPool(void);
 /*************************************************************************************************/
 void WsfBufGetPoolStats(WsfBufPoolStat_t *pStat, uint8_t numPool);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the request size histogram.  Entry n counts the allocation requests of
+ *          (n * WSF_BUF_CLASS_SIZE) + 1 to (n + 1) * WSF_BUF_CLASS_SIZE bytes, the last entry
+ *          also counts longer requests.
+ *
+ *  \return Array of WSF_BUF_CLASS_NUM request counts.
+ */
+/*************************************************************************************************/
+const uint32_t *WsfBufGetSizeHist(void);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Called to register the buffer diagnostics callback function.
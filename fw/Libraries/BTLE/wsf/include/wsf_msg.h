@@ -61,7 +61,21 @@ void *WsfMsgAlloc(uint16_t len);
 
 /*************************************************************************************************/
 /*!
- *  \brief  Free a message buffer allocated with WsfMsgAlloc().
+ *  \brief  Take a reference to a message buffer allocated with WsfMsgAlloc().  Each reference
+ *          is released by a call to WsfMsgFree(), so a message handed to a callback can be
+ *          sent to another handler without copying.
+ *
+ *  \param  pMsg  Pointer to message buffer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfMsgRetain(void *pMsg);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Free a message buffer allocated with WsfMsgAlloc().  The buffer is released when no
+ *          reference taken with WsfMsgRetain() remains.
  *
  *  \param  pMsg  Pointer to message buffer.
  *
@@ -82,6 +96,20 @@ void WsfMsgFree(void *pMsg);
 /*************************************************************************************************/
 void WsfMsgSend(wsfHandlerId_t handlerId, void *pMsg);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a message to an event handler with a priority rather than the one set for the
+ *          handler with WsfOsSetHandlerPrio().
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  pMsg        Pointer to message buffer.
+ *  \param  prio        Message priority, WSF_MSG_PRIO_HCI to WSF_MSG_PRIO_BACKGROUND.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfMsgSendPrio(wsfHandlerId_t handlerId, void *pMsg, uint8_t prio);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Enqueue a message.
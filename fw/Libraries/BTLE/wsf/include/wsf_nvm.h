@@ -97,6 +97,20 @@ bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback);
 /*************************************************************************************************/
 void WsfNvmEraseSector(uint32_t numOfSectors, WsfNvmCompEvent_t compCback);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Reclaim the oldest sector ahead of need.
+ *
+ *  \return TRUE if a sector was reclaimed.
+ *
+ *  Stored data is appended to a log of sectors written in turn and indexed in RAM.  The oldest
+ *  sector is reclaimed, its latest data moved and the sector erased, when the sector written to
+ *  is full.  Calling this routine when idle does it once the sector written to fills up, so
+ *  writes rarely wait for a flash erase.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmGc(void);
+
 /*! \} */    /* WSF_NVM_API */
 
 #ifdef __cplusplus
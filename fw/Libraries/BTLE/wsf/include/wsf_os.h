@@ -69,6 +69,19 @@ extern "C" {
 #define WSF_HANDLER_EVENT     0x04        /*!< \brief Event set for event handler */
 /**@}*/
 
+/** @name WSF Message Priorities
+ *  Message lanes of a task, dispatched highest first.  Handler events are dispatched in the lane
+ *  of their handler; expired timers rank below the realtime lane.
+ */
+/**@{*/
+#define WSF_MSG_PRIO_HCI          0       /*!< \brief HCI and link layer */
+#define WSF_MSG_PRIO_REALTIME     1       /*!< \brief Time-critical application events */
+#define WSF_MSG_PRIO_NORMAL       2       /*!< \brief Default for stack and application handlers */
+#define WSF_MSG_PRIO_BACKGROUND   3       /*!< \brief Deferrable work such as logging */
+#define WSF_MSG_NUM_PRIO          4       /*!< \brief Number of message lanes */
+#define WSF_MSG_PRIO_HANDLER      0xFF    /*!< \brief Lane set for the receiving handler */
+/**@}*/
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -85,6 +98,14 @@ typedef wsfHandlerId_t  wsfTaskId_t;
 /*! \brief Task event mask data type */
 typedef uint8_t wsfTaskEvent_t;
 
+/*! \brief Message lane statistics */
+typedef struct
+{
+  uint16_t        depth;          /*!< \brief Messages queued */
+  uint16_t        maxDepth;       /*!< \brief Maximum messages queued */
+  uint32_t        numAged;        /*!< \brief Messages dispatched ahead of a higher lane to avoid starvation */
+} wsfOsLaneStat_t;
+
 /**************************************************************************************************
   External Variables
 **************************************************************************************************/
@@ -168,7 +189,8 @@ void WsfTaskSetReady(wsfHandlerId_t handlerId, wsfTaskEvent_t event);
 
 /*************************************************************************************************/
 /*!
- *  \brief  Return the task message queue used by the given handler.
+ *  \brief  Return the task message queue used by the given handler, the lane of its priority.
+ *          Messages enqueued directly are not counted in the lane statistics.
  *
  *  \param  handlerId   Event handler ID.
  *
@@ -177,6 +199,44 @@ void WsfTaskSetReady(wsfHandlerId_t handlerId, wsfTaskEvent_t event);
 /*************************************************************************************************/
 wsfQueue_t *WsfTaskMsgQueue(wsfHandlerId_t handlerId);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Enqueue a message in a task message lane and set the task as ready to run.
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  pMsg        Pointer to message buffer.
+ *  \param  prio        Message priority, WSF_MSG_PRIO_HANDLER for the lane of the handler.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTaskMsgEnq(wsfHandlerId_t handlerId, void *pMsg, uint8_t prio);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Set the message priority of a handler, the lane of the messages sent to it with
+ *          WsfMsgSend() and of its handler events.  Handlers default to WSF_MSG_PRIO_NORMAL.
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  prio        Message priority.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfOsSetHandlerPrio(wsfHandlerId_t handlerId, uint8_t prio);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of a message lane.
+ *
+ *  \param  pStat       Returned lane statistics.
+ *  \param  prio        Message priority of the lane.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfOsGetLaneStats(wsfOsLaneStat_t *pStat, uint8_t prio);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Set the next WSF handler function in the WSF OS handler array.  This function
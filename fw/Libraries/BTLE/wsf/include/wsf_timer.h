@@ -47,12 +47,14 @@ extern "C" {
 /*! \brief Timer ticks data type */
 typedef uint32_t wsfTimerTicks_t;
 
-/*! \brief Timer structure */
+/*! \brief Timer structure, the fields are private to the timer service */
 typedef struct wsfTimer_tag
 {
-  struct wsfTimer_tag *pNext;             /*!< \brief pointer to next timer in queue */
+  struct wsfTimer_tag *pNext;             /*!< \brief pointer to next timer in wheel slot */
+  struct wsfTimer_tag *pPrev;             /*!< \brief pointer to previous timer in wheel slot */
   wsfMsgHdr_t         msg;                /*!< \brief application-defined timer event parameters */
-  wsfTimerTicks_t     ticks;              /*!< \brief number of ticks until expiration */
+  wsfTimerTicks_t     deadline;           /*!< \brief absolute tick of expiration */
+  uint16_t            slot;               /*!< \brief wheel slot holding the timer */
   wsfHandlerId_t      handlerId;          /*!< \brief event handler for this timer */
   bool_t              isStarted;          /*!< \brief TRUE if timer has been started */
 } wsfTimer_t;
@@ -108,6 +110,17 @@ void WsfTimerStartMs(wsfTimer_t *pTimer, wsfTimerTicks_t ms);
 /*************************************************************************************************/
 void WsfTimerStop(wsfTimer_t *pTimer);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the number of ticks until a timer expires.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return Ticks until expiration, zero if the timer is stopped or has expired.
+ */
+/*************************************************************************************************/
+wsfTimerTicks_t WsfTimerTicksLeft(const wsfTimer_t *pTimer);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Update the timer service with the number of elapsed ticks.  This function is
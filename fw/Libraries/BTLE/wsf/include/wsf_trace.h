@@ -46,6 +46,11 @@ extern "C" {
 #define WSF_TOKEN_ENABLED         FALSE
 #endif
 
+#ifndef WSF_TOKEN_RING_BUF_SIZE
+/*! \brief      Number of 8 byte records of the token ring buffer (power of 2). */
+#define WSF_TOKEN_RING_BUF_SIZE   64
+#endif
+
 #ifndef LL_TRACE_ENABLED
 /*! \brief     Trace enabled for controller */
 #define LL_TRACE_ENABLED          FALSE
@@ -77,6 +82,33 @@ typedef void (*WsfBt4TraceCback_t)(const char *pStr, va_list args);
 /*************************************************************************************************/
 void WsfToken(uint32_t tok, uint32_t var);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Output tokenized trace message.  The message is recorded as the address of its
+ *          format string followed by its variables, to be formatted on the host from the image.
+ *
+ *  \param  pMsg      Format string, a string constant of the image.
+ *  \param  numVars   Number of variables.
+ *  \param  pVars     Variables, one word each.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTokenTrace(const char *pMsg, uint8_t numVars, const uint32_t *pVars);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Output tokenized printf() message.  The variables are taken as the format string
+ *          converts them, 64 bit integers and doubles as two words.
+ *
+ *  \param  pFmt      Format string, a string constant of the image.
+ *  \param  args      Variable arguments of the format string.
+ *
+ *  \return Number of variable words recorded.
+ */
+/*************************************************************************************************/
+int WsfTokenVprintf(const char *pFmt, va_list args);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Enable trace messages.
@@ -154,21 +186,41 @@ bool_t WsfTokenService(void);
 #define WSF_TRACE3(subsys, stat, msg, var1, var2, var3) WSF_TOKEN(subsys, stat, msg)
 
 #elif WSF_TOKEN_ENABLED == TRUE
-
 /** \name Trace macros
  *
  */
 /**@{*/
 #define WSF_TRACE0(subsys, stat, msg)                   \
-  WsfToken(((__LINE__ & 0xFFF) << 16) | MODULE_ID, 0)
+  WsfTokenTrace(msg, 0, NULL)
 #define WSF_TRACE1(subsys, stat, msg, var1)             \
-  WsfToken(((__LINE__ & 0xFFF) << 16) | MODULE_ID, (uint32_t)(var1))
+  WsfTokenTrace(msg, 1, (const uint32_t []){(uint32_t)(var1)})
 #define WSF_TRACE2(subsys, stat, msg, var1, var2)       \
-  WsfToken(((__LINE__ & 0xFFF) << 16) | MODULE_ID, (uint32_t)(((var2) << 16) | ((var1) & 0xFFFF)))
+  WsfTokenTrace(msg, 2, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2)})
 #define WSF_TRACE3(subsys, stat, msg, var1, var2, var3) \
-  WsfToken(((__LINE__ & 0xFFF) << 16) | MODULE_ID, (uint32_t)((((var3) & 0xFFFF) << 16) | (((var2) & 0xFF) << 8) | ((var1) & 0xFF)))
+  WsfTokenTrace(msg, 3, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3)})
+#define WSF_TRACE4(subsys, stat, msg, var1, var2, var3, var4) \
+  WsfTokenTrace(msg, 4, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4)})
+#define WSF_TRACE5(subsys, stat, msg, var1, var2, var3, var4, var5) \
+  WsfTokenTrace(msg, 5, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                            (uint32_t)(var5)})
+#define WSF_TRACE6(subsys, stat, msg, var1, var2, var3, var4, var5, var6) \
+  WsfTokenTrace(msg, 6, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                            (uint32_t)(var5), (uint32_t)(var6)})
+#define WSF_TRACE7(subsys, stat, msg, var1, var2, var3, var4, var5, var6, var7) \
+  WsfTokenTrace(msg, 7, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                            (uint32_t)(var5), (uint32_t)(var6), (uint32_t)(var7)})
+#define WSF_TRACE8(subsys, stat, msg, var1, var2, var3, var4, var5, var6, var7, var8) \
+  WsfTokenTrace(msg, 8, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                            (uint32_t)(var5), (uint32_t)(var6), (uint32_t)(var7), (uint32_t)(var8)})
+#define WSF_TRACE9(subsys, stat, msg, var1, var2, var3, var4, var5, var6, var7, var8, var9) \
+  WsfTokenTrace(msg, 9, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                            (uint32_t)(var5), (uint32_t)(var6), (uint32_t)(var7), (uint32_t)(var8), \
+                                            (uint32_t)(var9)})
+#define WSF_TRACE12(subsys, stat, msg, var1, var2, var3, var4, var5, var6, var7, var8, var9, var10, var11, var12) \
+  WsfTokenTrace(msg, 12, (const uint32_t []){(uint32_t)(var1), (uint32_t)(var2), (uint32_t)(var3), (uint32_t)(var4), \
+                                             (uint32_t)(var5), (uint32_t)(var6), (uint32_t)(var7), (uint32_t)(var8), \
+                                             (uint32_t)(var9), (uint32_t)(var10), (uint32_t)(var11), (uint32_t)(var12)})
 /**@}*/
-
 #elif WSF_TRACE_ENABLED == TRUE
 
 /** \name Trace macros
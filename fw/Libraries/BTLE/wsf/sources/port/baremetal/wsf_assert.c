@@ -39,25 +39,14 @@
  *  \return None.
  */
 /*************************************************************************************************/
-#if WSF_TOKEN_ENABLED == TRUE
-void WsfAssert(uint16_t modId, uint16_t line)
-#else
 void WsfAssert(const char *pFile, uint16_t line)
-#endif
 {
   /* Possibly unused parameters */
-#if WSF_TOKEN_ENABLED == TRUE
-  (void)modId;
-#else
   (void)pFile;
-#endif
   (void)line;
 
-#if WSF_TOKEN_ENABLED == TRUE
-  WSF_TRACE_ERR2("Assertion detected on %s:%u", modId, line);
-#else
+  /* the file name is a string of the image, tokenized traces resolve it as well */
   WSF_TRACE_ERR2("Assertion detected on %s:%u", pFile, line);
-#endif
 
   PalSysAssertTrap();
 }
@@ -36,6 +36,21 @@
 /* Magic number used to check for free buffer. */
 #define WSF_BUF_FREE_NUM            0xFAABD00D
 
+/* Free lists are lock-free where exclusive access instructions exist.  Exception entry and
+ * return clear the exclusive monitor, so a pop preempted between its load and store retries. */
+#if defined(__GNUC__) && (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+#define WSF_BUF_LOCK_FREE           TRUE
+#else
+#define WSF_BUF_LOCK_FREE           FALSE
+#endif
+
+/* Size class of a request length. */
+#define WSF_BUF_CLASS(len)          WSF_MIN(((len) - 1) / WSF_BUF_CLASS_SIZE, WSF_BUF_CLASS_NUM - 1)
+
+/* Atomic counter update. */
+#define WSF_BUF_STAT_INC(x)         __atomic_fetch_add(&(x), 1, __ATOMIC_RELAXED)
+#define WSF_BUF_STAT_DEC(x)         __atomic_fetch_sub(&(x), 1, __ATOMIC_RELAXED)
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -55,11 +70,10 @@ typedef struct
   wsfBufPoolDesc_t  desc;           /* Number of buffers and length. */
   wsfBufMem_t       *pStart;        /* Start of pool. */
   wsfBufMem_t       *pFree;         /* First free buffer in pool. */
-#if WSF_BUF_STATS == TRUE
   uint8_t           numAlloc;       /* Number of buffers currently allocated from pool. */
   uint8_t           maxAlloc;       /* Maximum buffers ever allocated from pool. */
   uint16_t          maxReqLen;      /* Maximum request length from pool. */
-#endif
+  uint16_t          numFail;        /* Allocations that found the pool empty. */
 } wsfBufPool_t;
 
 /**************************************************************************************************
@@ -75,6 +89,12 @@ wsfBufMem_t *wsfBufMem = NULL;
 /* Currently use for debugging only. */
 uint32_t wsfBufMemLen;
 
+/* First pool able to hold each request size class. */
+static uint8_t wsfBufClassPool[WSF_BUF_CLASS_NUM];
+
+/* Request size histogram, by size class. */
+static uint32_t wsfBufSizeHist[WSF_BUF_CLASS_NUM];
+
 #if WSF_BUF_STATS_HIST == TRUE
 /* Buffer allocation counter. */
 uint8_t wsfBufAllocCount[WSF_BUF_STATS_MAX_LEN];
@@ -88,6 +108,137 @@ uint8_t wsfPoolOverFlowCount[WSF_BUF_STATS_MAX_POOL];
 static WsfBufDiagCback_t wsfBufDiagCback = NULL;
 #endif
 
+#if WSF_BUF_LOCK_FREE == TRUE
+/*************************************************************************************************/
+/*!
+ *  \brief  Load a free list head with exclusive access.
+ *
+ *  \param  ppHead  Free list head.
+ *
+ *  \return Head buffer.
+ */
+/*************************************************************************************************/
+static inline wsfBufMem_t *wsfBufLoadEx(wsfBufMem_t **ppHead)
+{
+  wsfBufMem_t *p;
+
+  __asm volatile ("ldrex %0, [%1]" : "=r" (p) : "r" (ppHead) : "memory");
+
+  return p;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Store a free list head with exclusive access.
+ *
+ *  \param  ppHead  Free list head.
+ *  \param  p       New head buffer.
+ *
+ *  \return TRUE if stored, FALSE if exclusive access was lost.
+ */
+/*************************************************************************************************/
+static inline bool_t wsfBufStoreEx(wsfBufMem_t **ppHead, wsfBufMem_t *p)
+{
+  uint32_t failed;
+
+  __asm volatile ("strex %0, %2, [%1]" : "=&r" (failed) : "r" (ppHead), "r" (p) : "memory");
+
+  return (failed == 0);
+}
+#endif
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Take a buffer from the free list of a pool.
+ *
+ *  \param  pPool   Buffer pool.
+ *
+ *  \return Buffer or NULL if the pool is empty.
+ */
+/*************************************************************************************************/
+static wsfBufMem_t *wsfBufPop(wsfBufPool_t *pPool)
+{
+  wsfBufMem_t *pBuf;
+
+#if WSF_BUF_LOCK_FREE == TRUE
+  do
+  {
+    if ((pBuf = wsfBufLoadEx(&pPool->pFree)) == NULL)
+    {
+      __asm volatile ("clrex" ::: "memory");
+      break;
+    }
+  } while (!wsfBufStoreEx(&pPool->pFree, pBuf->pNext));
+#else
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+  if ((pBuf = pPool->pFree) != NULL)
+  {
+    pPool->pFree = pBuf->pNext;
+  }
+  WSF_CS_EXIT(cs);
+#endif
+
+  return pBuf;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return a buffer to the free list of a pool.
+ *
+ *  \param  pPool   Buffer pool.
+ *  \param  pBuf    Buffer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfBufPush(wsfBufPool_t *pPool, wsfBufMem_t *pBuf)
+{
+#if WSF_BUF_LOCK_FREE == TRUE
+  do
+  {
+    pBuf->pNext = wsfBufLoadEx(&pPool->pFree);
+  } while (!wsfBufStoreEx(&pPool->pFree, pBuf));
+#else
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+  pBuf->pNext = pPool->pFree;
+  pPool->pFree = pBuf;
+  WSF_CS_EXIT(cs);
+#endif
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Update the statistics of a pool on allocation.
+ *
+ *  \param  pPool   Buffer pool.
+ *  \param  len     Requested length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfBufStatAlloc(wsfBufPool_t *pPool, uint16_t len)
+{
+  uint8_t   numAlloc = WSF_BUF_STAT_INC(pPool->numAlloc) + 1;
+  uint8_t   maxAlloc = pPool->maxAlloc;
+  uint16_t  maxReqLen = pPool->maxReqLen;
+
+  while ((numAlloc > maxAlloc) &&
+         !__atomic_compare_exchange_n(&pPool->maxAlloc, &maxAlloc, numAlloc, TRUE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+  {
+  }
+
+  while ((len > maxReqLen) &&
+         !__atomic_compare_exchange_n(&pPool->maxReqLen, &maxReqLen, len, TRUE,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+  {
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Calculate size required by the buffer pool.
@@ -150,7 +301,7 @@ uint32_t WsfBufCalcSize(uint8_t numPools, wsfBufPoolDesc_t *pDesc)
 /*************************************************************************************************/
 /*!
  *  \brief  Initialize the buffer pool service.  This function should only be called once
- *          upon system initialization.
+ *          upon system initialization.  Pools must be in ascending buffer length order.
  *
  *  \param  numPools  Number of buffer pools.
  *  \param  pDesc     Array of buffer pool descriptors, one for each pool.
@@ -163,6 +314,7 @@ uint32_t WsfBufInit(uint8_t numPools, wsfBufPoolDesc_t *pDesc)
   wsfBufPool_t  *pPool;
   wsfBufMem_t   *pStart;
   uint16_t      len;
+  uint8_t       cls;
   uint8_t       i;
 
   wsfBufMem = (wsfBufMem_t *) WsfHeapGetFreeStartAddress();
@@ -208,11 +360,13 @@ uint32_t WsfBufInit(uint8_t numPools, wsfBufPoolDesc_t *pDesc)
 
     pPool->pStart = pStart;
     pPool->pFree = pStart;
-#if WSF_BUF_STATS == TRUE
     pPool->numAlloc = 0;
     pPool->maxAlloc = 0;
     pPool->maxReqLen = 0;
-#endif
+    pPool->numFail = 0;
+
+    /* Size classes need pools in ascending length order. */
+    WSF_ASSERT((pPool == (wsfBufPool_t *) wsfBufMem) || (pPool->desc.len > (pPool - 1)->desc.len));
 
     WSF_TRACE_INFO2("Creating pool len=%u num=%u", pPool->desc.len, pPool->desc.num);
     WSF_TRACE_INFO1("              pStart=0x%x", (uint32_t)pPool->pStart);
@@ -249,6 +403,18 @@ uint32_t WsfBufInit(uint8_t numPools, wsfBufPoolDesc_t *pDesc)
   wsfBufMemLen = (uint8_t *) pStart - (uint8_t *) wsfBufMem;
   WSF_TRACE_INFO1("Created buffer pools; using %u bytes", wsfBufMemLen);
 
+  /* Map each size class to the first pool holding its shortest request. */
+  pPool = (wsfBufPool_t *) wsfBufMem;
+  for (cls = 0, i = 0; cls < WSF_BUF_CLASS_NUM; cls++)
+  {
+    while ((i < wsfBufNumPools) && (pPool[i].desc.len < ((cls * WSF_BUF_CLASS_SIZE) + 1)))
+    {
+      i++;
+    }
+    wsfBufClassPool[cls] = i;
+    wsfBufSizeHist[cls] = 0;
+  }
+
   return wsfBufMemLen;
 }
 
@@ -265,73 +431,51 @@ void *WsfBufAlloc(uint16_t len)
 {
   wsfBufPool_t  *pPool;
   wsfBufMem_t   *pBuf;
+  uint8_t       cls;
   uint8_t       i;
 
-  WSF_CS_INIT(cs);
-
   WSF_ASSERT(len > 0);
 
+  cls = WSF_BUF_CLASS(len);
+  WSF_BUF_STAT_INC(wsfBufSizeHist[cls]);
+
+#if WSF_BUF_STATS_HIST == TRUE
+  /* Increment count for buffers of this length. */
+  WSF_BUF_STAT_INC(wsfBufAllocCount[(len < WSF_BUF_STATS_MAX_LEN) ? len : 0]);
+#endif
+
   pPool = (wsfBufPool_t *) wsfBufMem;
 
-  for (i = wsfBufNumPools; i > 0; i--, pPool++)
+  /* Start at the first pool of the size class, the class may span a pool boundary. */
+  for (i = wsfBufClassPool[cls]; i < wsfBufNumPools; i++)
   {
     /* Check if buffer is big enough. */
-    if (len <= pPool->desc.len)
+    if (len > pPool[i].desc.len)
     {
-      /* Enter critical section. */
-      WSF_CS_ENTER(cs);
-
-      /* Check if buffers are available. */
-      if (pPool->pFree != NULL)
-      {
-        /* Allocation succeeded. */
-        pBuf = pPool->pFree;
-
-        /* Next free buffer is stored inside current free buffer. */
-        pPool->pFree = pBuf->pNext;
+      continue;
+    }
 
+    if ((pBuf = wsfBufPop(&pPool[i])) != NULL)
+    {
 #if WSF_BUF_FREE_CHECK == TRUE
-        pBuf->free = 0;
-#endif
-#if WSF_BUF_STATS_HIST == TRUE
-        /* Increment count for buffers of this length. */
-        if (len < WSF_BUF_STATS_MAX_LEN)
-        {
-          wsfBufAllocCount[len]++;
-        }
-          else
-        {
-          wsfBufAllocCount[0]++;
-        }
-#endif
-#if WSF_BUF_STATS == TRUE
-        if (++pPool->numAlloc > pPool->maxAlloc)
-        {
-          pPool->maxAlloc = pPool->numAlloc;
-        }
-        pPool->maxReqLen = WSF_MAX(pPool->maxReqLen, len);
+      pBuf->free = 0;
 #endif
-        /* Exit critical section. */
-        WSF_CS_EXIT(cs);
+      wsfBufStatAlloc(&pPool[i], len);
 
-        WSF_TRACE_ALLOC2("WsfBufAlloc len:%u pBuf:%08x", pPool->desc.len, pBuf);
+      WSF_TRACE_ALLOC2("WsfBufAlloc len:%u pBuf:%08x", pPool[i].desc.len, pBuf);
 
-        return pBuf;
-      }
+      return pBuf;
+    }
+
+    /* Pool empty; fall through to the next larger pool. */
+    WSF_BUF_STAT_INC(pPool[i].numFail);
 #if WSF_BUF_STATS_HIST == TRUE
-      else
-      {
-        /* Pool overflow: increment count of overflow for current pool. */
-        wsfPoolOverFlowCount[wsfBufNumPools-i]++;
-      }
+    WSF_BUF_STAT_INC(wsfPoolOverFlowCount[i]);
 #endif
-      /* Exit critical section. */
-      WSF_CS_EXIT(cs);
 
 #if WSF_BUF_ALLOC_BEST_FIT_FAIL_ASSERT == TRUE
-      WSF_ASSERT(FALSE);
+    WSF_ASSERT(FALSE);
 #endif
-    }
   }
 
   /* Allocation failed. */
@@ -375,8 +519,6 @@ void WsfBufFree(void *pBuf)
   wsfBufPool_t  *pPool;
   wsfBufMem_t   *p = pBuf;
 
-  WSF_CS_INIT(cs);
-
   /* Verify pointer is within range. */
 #if WSF_BUF_FREE_CHECK == TRUE
   WSF_ASSERT(p >= ((wsfBufPool_t *) wsfBufMem)->pStart);
@@ -390,23 +532,14 @@ void WsfBufFree(void *pBuf)
     /* Check if the buffer memory is located inside this pool. */
     if (p >= pPool->pStart)
     {
-      /* Enter critical section. */
-      WSF_CS_ENTER(cs);
-
 #if WSF_BUF_FREE_CHECK == TRUE
       WSF_ASSERT(p->free != WSF_BUF_FREE_NUM);
       p->free = WSF_BUF_FREE_NUM;
 #endif
-#if WSF_BUF_STATS == TRUE
-      pPool->numAlloc--;
-#endif
+      WSF_BUF_STAT_DEC(pPool->numAlloc);
 
       /* Pool found; put buffer back in free list. */
-      p->pNext = pPool->pFree;
-      pPool->pFree = p;
-
-      /* Exit critical section. */
-      WSF_CS_EXIT(cs);
+      wsfBufPush(pPool, p);
 
       WSF_TRACE_FREE2("WsfBufFree len:%u pBuf:%08x", pPool->desc.len, pBuf);
 
@@ -494,20 +627,27 @@ void WsfBufGetPoolStats(WsfBufPoolStat_t *pStat, uint8_t poolId)
 
   pStat->bufSize  = pPool[poolId].desc.len;
   pStat->numBuf   = pPool[poolId].desc.num;
-#if WSF_BUF_STATS == TRUE
   pStat->numAlloc = pPool[poolId].numAlloc;
   pStat->maxAlloc = pPool[poolId].maxAlloc;
   pStat->maxReqLen = pPool[poolId].maxReqLen;
-#else
-  pStat->numAlloc = 0;
-  pStat->maxAlloc = 0;
-  pStat->maxReqLen = 0;
-#endif
+  pStat->numFail  = pPool[poolId].numFail;
 
   /* Exit critical section. */
   WSF_CS_EXIT(cs);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the request size histogram.
+ *
+ *  \return Array of WSF_BUF_CLASS_NUM request counts, by size class.
+ */
+/*************************************************************************************************/
+const uint32_t *WsfBufGetSizeHist(void)
+{
+  return wsfBufSizeHist;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Called to register the buffer diagnostics callback function.
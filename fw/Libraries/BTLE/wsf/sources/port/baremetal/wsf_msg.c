@@ -27,6 +27,7 @@
 #include "wsf_queue.h"
 #include "wsf_trace.h"
 #include "wsf_os.h"
+#include "wsf_cs.h"
 
 /**************************************************************************************************
   Data Types
@@ -37,6 +38,7 @@ typedef struct wsfMsg_tag
 {
   struct wsfMsg_tag   *pNext;
   wsfHandlerId_t      handlerId;
+  uint8_t             refCount;     /* References held besides the owner's */
 } wsfMsg_t;
 
 /*************************************************************************************************/
@@ -72,12 +74,38 @@ void *WsfMsgAlloc(uint16_t len)
   /* hide header */
   if (pMsg != NULL)
   {
+    pMsg->refCount = 0;
     pMsg++;
   }
 
   return pMsg;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Take a reference to a message buffer allocated with WsfMsgAlloc().
+ *
+ *  \param  pMsg  Pointer to message buffer.
+ *
+ *  \return None.
+ *
+ *  Each reference is released by a call to WsfMsgFree().  This lets a message handed to a
+ *  callback be sent to another handler as is while its owner still frees it on return.
+ */
+/*************************************************************************************************/
+void WsfMsgRetain(void *pMsg)
+{
+  wsfMsg_t *p = ((wsfMsg_t *) pMsg) - 1;
+
+  WSF_CS_INIT(cs);
+
+  WSF_ASSERT(p->refCount < UINT8_MAX);
+
+  WSF_CS_ENTER(cs);
+  p->refCount++;
+  WSF_CS_EXIT(cs);
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Free a message buffer allocated with WsfMsgAlloc().
@@ -85,11 +113,29 @@ void *WsfMsgAlloc(uint16_t len)
  *  \param  pMsg  Pointer to message buffer.
  *
  *  \return None.
+ *
+ *  The buffer is released when no reference taken with WsfMsgRetain() remains.
  */
 /*************************************************************************************************/
 void WsfMsgFree(void *pMsg)
 {
-  WsfBufFree(((wsfMsg_t *) pMsg) - 1);
+  wsfMsg_t *p = ((wsfMsg_t *) pMsg) - 1;
+  bool_t   release;
+
+  WSF_CS_INIT(cs);
+
+  WSF_CS_ENTER(cs);
+  release = (p->refCount == 0);
+  if (!release)
+  {
+    p->refCount--;
+  }
+  WSF_CS_EXIT(cs);
+
+  if (release)
+  {
+    WsfBufFree(p);
+  }
 }
 
 /*************************************************************************************************/
@@ -106,11 +152,27 @@ void WsfMsgSend(wsfHandlerId_t handlerId, void *pMsg)
 {
   WSF_TRACE_MSG1("WsfMsgSend handlerId:%u", handlerId);
 
-  /* get queue for this handler and enqueue message */
-  WsfMsgEnq(WsfTaskMsgQueue(handlerId), handlerId, pMsg);
+  /* enqueue message in the lane of this handler and set its task as ready to run */
+  WsfTaskMsgEnq(handlerId, pMsg, WSF_MSG_PRIO_HANDLER);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a message to an event handler with a priority.
+ *
+ *  \param  handlerId   Event handler ID.
+ *  \param  pMsg        Pointer to message buffer.
+ *  \param  prio        Message priority.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfMsgSendPrio(wsfHandlerId_t handlerId, void *pMsg, uint8_t prio)
+{
+  WSF_TRACE_MSG2("WsfMsgSendPrio handlerId:%u prio:%u", handlerId, prio);
 
-  /* set task for this handler as ready to run */
-  WsfTaskSetReady(handlerId, WSF_MSG_QUEUE_EVENT);
+  /* enqueue message in the lane and set task for this handler as ready to run */
+  WsfTaskMsgEnq(handlerId, pMsg, prio);
 }
 
 /*************************************************************************************************/
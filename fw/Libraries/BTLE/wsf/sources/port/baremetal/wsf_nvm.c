@@ -20,6 +20,7 @@
  */
 /*************************************************************************************************/
 
+#include <string.h>
 #include "wsf_types.h"
 #include "wsf_assert.h"
 #include "wsf_nvm.h"
@@ -33,6 +34,21 @@
 /*! NVM data start address. */
 #define WSF_NVM_START_ADDR                        0x0000
 
+/*! Number of sectors the log rotates through. */
+#ifndef WSF_NVM_NUM_SECTORS
+#define WSF_NVM_NUM_SECTORS                       PAL_NVM_NUM_SECTORS
+#endif
+
+/*! Maximum number of stored data IDs. */
+#ifndef WSF_NVM_MAX_IDS
+#define WSF_NVM_MAX_IDS                           16
+#endif
+
+/*! Free bytes left in the write sector below which the next sector is reclaimed in background. */
+#ifndef WSF_NVM_GC_THRESHOLD
+#define WSF_NVM_GC_THRESHOLD                      (PAL_NVM_SECTOR_SIZE / 2)
+#endif
+
 /*! Reserved filecode. */
 #define WSF_NVM_RESERVED_FILECODE                 ((uint32_t)0)
 
@@ -40,12 +56,38 @@
 /* TODO: May depend on flash type */
 #define WSF_NVM_UNUSED_FILECODE                   ((uint32_t)0xFFFFFFFF)
 
+/*! Sector header magic, "WNVM". */
+#define WSF_NVM_SECTOR_MAGIC                      ((uint32_t)0x4D564E57)
+
 /*! Align value to word boundary. */
 #define WSF_NVM_WORD_ALIGN(x)                     (((x) + (PAL_NVM_WORD_SIZE - 1)) & \
                                                          ~(PAL_NVM_WORD_SIZE - 1))
 
 #define WSF_NVM_CRC_INIT_VALUE                    0xFEDCBA98
 
+/*! Start address of a sector. */
+#define WSF_NVM_SECTOR_ADDR(s)                    (WSF_NVM_START_ADDR + ((s) * PAL_NVM_SECTOR_SIZE))
+
+/*! Sector holding an address. */
+#define WSF_NVM_SECTOR_OF(addr)                   (((addr) - WSF_NVM_START_ADDR) / PAL_NVM_SECTOR_SIZE)
+
+/*! Bit of a sector in a sector mask. */
+#define WSF_NVM_SECTOR_BIT(s)                     ((uint32_t)1 << (s))
+
+/*! Sector written after a sector, the oldest one when written to. */
+#define WSF_NVM_NEXT_SECTOR(s)                    (((s) + 1) % WSF_NVM_NUM_SECTORS)
+
+/*! Record bytes a sector can hold. */
+#define WSF_NVM_SECTOR_CAPACITY                   (PAL_NVM_SECTOR_SIZE - sizeof(WsfNvmSectorHeader_t))
+
+/*! Size of a record. */
+#define WSF_NVM_RECORD_SIZE(len)                  (sizeof(WsfNvmHeader_t) + WSF_NVM_WORD_ALIGN(len))
+
+/*! Size of the record copy buffer. */
+#define WSF_NVM_COPY_BUF_SIZE                     64
+
+WSF_CT_ASSERT((WSF_NVM_NUM_SECTORS >= 2) && (WSF_NVM_NUM_SECTORS <= 32));
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -54,228 +96,645 @@
 typedef struct
 {
   uint32_t          id;         /*!< Stored data ID. */
-  uint32_t          len;        /*!< Stored data length. */
+  uint32_t          len;        /*!< Stored data length, 0 for an erased ID. */
   uint32_t          headerCrc;  /*!< CRC of this header. */
   uint32_t          dataCrc;    /*!< CRC of subsequent data. */
 } WsfNvmHeader_t;
 
+/*! \brief      Sector header. */
+typedef struct
+{
+  uint32_t          magic;      /*!< WSF_NVM_SECTOR_MAGIC once the sector is in the log. */
+  uint32_t          seq;        /*!< Sequence number of the sector in the log. */
+} WsfNvmSectorHeader_t;
+
+/*! \brief      Index entry. */
+typedef struct
+{
+  uint32_t          id;         /*!< Stored data ID. */
+  uint32_t          addr;       /*!< Address of the latest record. */
+  uint16_t          len;        /*!< Stored data length. */
+} wsfNvmIndex_t;
+
 /**************************************************************************************************
-  Global Functions
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief      Control block. */
+static struct
+{
+  wsfNvmIndex_t     index[WSF_NVM_MAX_IDS]; /*!< Latest record of each ID, sorted by ID. */
+  uint8_t           numIds;                 /*!< Number of stored IDs. */
+  uint8_t           head;                   /*!< Sector written to. */
+  uint32_t          headSeq;                /*!< Sequence number of the sector written to. */
+  uint32_t          writeAddr;              /*!< Address of the next record. */
+  uint32_t          usedMask;               /*!< Sectors not erased. */
+  bool_t            palStatus;              /*!< Status of the last PAL operation. */
+} wsfNvmCb;
+
+/**************************************************************************************************
+  Local Functions
 **************************************************************************************************/
 
 /*************************************************************************************************/
 /*!
- *  \brief  Initialize the WSF NVM.
+ *  \brief  PAL NVM operation completion.
+ *
+ *  \param  status    TRUE if the operation succeeded.
  *
  *  \return None.
  */
 /*************************************************************************************************/
-void WsfNvmInit(void)
+static void wsfNvmPalCback(bool_t status)
 {
-  PalNvmInit(NULL);
+  wsfNvmCb.palStatus = status;
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief  Read data.
+ *  \brief  Find the index position of an ID.
  *
  *  \param  id         Stored data ID.
- *  \param  pData      Buffer to read to.
- *  \param  len        Data length to read.
- *  \param  compCback  Read callback.
  *
- *  \return if Read NVM successfully.
+ *  \return Position of the ID, or where it would be inserted.
  */
 /*************************************************************************************************/
-bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+static uint8_t wsfNvmIndexPos(uint32_t id)
 {
-  WsfNvmHeader_t header;
-  uint32_t headerCrc, dataCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
-  bool_t findId = FALSE;
+  uint8_t lo = 0;
+  uint8_t hi = wsfNvmCb.numIds;
+  uint8_t mid;
 
-  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
 
-  /* Read first header. */
-  PalNvmRead(&header, sizeof(header), storageAddr);
+    if (wsfNvmCb.index[mid].id < id)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
 
-  do
+  return lo;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the index entry of an ID.
+ *
+ *  \param  id         Stored data ID.
+ *
+ *  \return Index entry or NULL if the ID is not stored.
+ */
+/*************************************************************************************************/
+static wsfNvmIndex_t *wsfNvmIndexFind(uint32_t id)
+{
+  uint8_t pos = wsfNvmIndexPos(id);
+
+  if ((pos < wsfNvmCb.numIds) && (wsfNvmCb.index[pos].id == id))
   {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
+    return &wsfNvmCb.index[pos];
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Point an ID to its latest record, or remove it from the index.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  addr       Address of the record.
+ *  \param  len        Stored data length, 0 to remove the ID.
+ *
+ *  \return FALSE if the index is full.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmIndexSet(uint32_t id, uint32_t addr, uint16_t len)
+{
+  uint8_t pos = wsfNvmIndexPos(id);
+  bool_t found = (pos < wsfNvmCb.numIds) && (wsfNvmCb.index[pos].id == id);
+
+  if (len == 0)
+  {
+    if (found)
     {
-      /* Found unused entry at end of used storage. */
-      break;
+      wsfNvmCb.numIds--;
+      memmove(&wsfNvmCb.index[pos], &wsfNvmCb.index[pos + 1],
+              (wsfNvmCb.numIds - pos) * sizeof(wsfNvmIndex_t));
     }
+    return TRUE;
+  }
 
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
+  if (!found)
+  {
+    if (wsfNvmCb.numIds == WSF_NVM_MAX_IDS)
     {
-      /* Calculate CRC of header itself. */
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
-
-      if (headerCrc != header.headerCrc)
-      {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
-        break;
-      }
-      else if ((header.id == id) && (header.len == len))
-      {
-        /* Valid header and matching ID - read data after header. */
-        storageAddr += sizeof(header);
-        PalNvmRead(pData, header.len, storageAddr);
-        dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, header.len, pData);
-        if (dataCrc == header.dataCrc)
-        {
-          findId = TRUE;
-        }
-        break;
-      }
+      return FALSE;
     }
 
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    PalNvmRead(&header, sizeof(header), storageAddr);
-  } while(1);
+    memmove(&wsfNvmCb.index[pos + 1], &wsfNvmCb.index[pos],
+            (wsfNvmCb.numIds - pos) * sizeof(wsfNvmIndex_t));
+    wsfNvmCb.numIds++;
+    wsfNvmCb.index[pos].id = id;
+  }
 
-  if (compCback)
+  wsfNvmCb.index[pos].addr = addr;
+  wsfNvmCb.index[pos].len = len;
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the bytes of the latest records in a sector.
+ *
+ *  \param  sector     Sector.
+ *
+ *  \return Live bytes.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmLiveBytes(uint8_t sector)
+{
+  uint32_t live = 0;
+  uint8_t i;
+
+  for (i = 0; i < wsfNvmCb.numIds; i++)
   {
-    compCback(findId);
+    if (WSF_NVM_SECTOR_OF(wsfNvmCb.index[i].addr) == sector)
+    {
+      live += WSF_NVM_RECORD_SIZE(wsfNvmCb.index[i].len);
+    }
   }
-  return findId;
+
+  return live;
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief  Write data.
+ *  \brief  Start writing to a sector.
  *
- *  \param  id         Stored data ID.
- *  \param  pData      Buffer to write.
- *  \param  len        Data length to write.
- *  \param  compCback  Write callback.
+ *  \param  sector     Erased sector.
  *
- *  \return if write NVM successfully.
+ *  \return None.
  */
 /*************************************************************************************************/
-bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+static void wsfNvmOpenSector(uint8_t sector)
 {
-  WsfNvmHeader_t header;
-  uint32_t headerCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
+  WsfNvmSectorHeader_t header;
 
-  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+  header.magic = WSF_NVM_SECTOR_MAGIC;
+  header.seq = ++wsfNvmCb.headSeq;
+  PalNvmWrite(&header, sizeof(header), WSF_NVM_SECTOR_ADDR(sector));
+
+  wsfNvmCb.head = sector;
+  wsfNvmCb.writeAddr = WSF_NVM_SECTOR_ADDR(sector) + sizeof(header);
+  wsfNvmCb.usedMask |= WSF_NVM_SECTOR_BIT(sector);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Move the latest records of the oldest sector to the write sector and erase it.
+ *
+ *  \return None.
+ *
+ *  The write sector always keeps room for the live bytes of the oldest sector. A copy torn by a
+ *  reset fails its data CRC at mount, and the original in the oldest sector is kept.
+ */
+/*************************************************************************************************/
+static void wsfNvmReclaim(void)
+{
+  uint32_t buf[WSF_NVM_COPY_BUF_SIZE / sizeof(uint32_t)];
+  uint8_t oldest = WSF_NVM_NEXT_SECTOR(wsfNvmCb.head);
+  wsfNvmIndex_t *pEntry = wsfNvmCb.index;
+  uint32_t size, chunk, offs;
+  uint8_t i;
+
+  if (!(wsfNvmCb.usedMask & WSF_NVM_SECTOR_BIT(oldest)))
+  {
+    return;
+  }
 
-  /* Read first header. */
-  PalNvmRead(&header, sizeof(header), storageAddr);
+  WSF_ASSERT((wsfNvmCb.writeAddr + wsfNvmLiveBytes(oldest)) <=
+             (WSF_NVM_SECTOR_ADDR(wsfNvmCb.head) + PAL_NVM_SECTOR_SIZE));
 
-  do
+  for (i = wsfNvmCb.numIds; i > 0; i--, pEntry++)
   {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
+    if (WSF_NVM_SECTOR_OF(pEntry->addr) != oldest)
     {
-      /* Found unused entry at end of used storage. */
-      break;
+      continue;
     }
 
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
+    /* Records are copied as they are, CRCs included. */
+    size = WSF_NVM_RECORD_SIZE(pEntry->len);
+    for (offs = 0; offs < size; offs += chunk)
     {
-      /* Calculate CRC of header itself. */
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
+      chunk = ((size - offs) < sizeof(buf)) ? (size - offs) : sizeof(buf);
+      PalNvmRead(buf, chunk, pEntry->addr + offs);
+      PalNvmWrite(buf, chunk, wsfNvmCb.writeAddr + offs);
+    }
 
-      if (headerCrc != header.headerCrc)
-      {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
-        break;
-      }
-      else if (header.id == id)
-      {
-        /* Valid header and matching ID - scratch header out. */
-        header.id = WSF_NVM_RESERVED_FILECODE;
-        header.headerCrc = 0;
-        header.dataCrc = 0;
-        PalNvmWrite(&header, sizeof(header), storageAddr);
-      }
+    pEntry->addr = wsfNvmCb.writeAddr;
+    wsfNvmCb.writeAddr += size;
+  }
+
+  PalNvmEraseSector(PAL_NVM_SECTOR_SIZE, WSF_NVM_SECTOR_ADDR(oldest));
+  wsfNvmCb.usedMask &= ~WSF_NVM_SECTOR_BIT(oldest);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Make room for a record in the write sector.
+ *
+ *  \param  size       Record size.
+ *
+ *  \return FALSE if NVM is full.
+ *
+ *  When the write sector is full, the oldest sector is reclaimed into it and written next, so
+ *  sectors are erased in turn.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmReserve(uint32_t size)
+{
+  uint32_t live = 0;
+  uint8_t next;
+  uint8_t i;
+
+  for (i = 0; i < wsfNvmCb.numIds; i++)
+  {
+    live += WSF_NVM_RECORD_SIZE(wsfNvmCb.index[i].len);
+  }
+
+  /* Leave a sector's worth of room for moving records, rather than rotating in vain. */
+  if ((size > WSF_NVM_SECTOR_CAPACITY) ||
+      ((live + size) > ((WSF_NVM_NUM_SECTORS - 1) * WSF_NVM_SECTOR_CAPACITY)))
+  {
+    return FALSE;
+  }
+
+  for (i = 0; i <= WSF_NVM_NUM_SECTORS; i++)
+  {
+    next = WSF_NVM_NEXT_SECTOR(wsfNvmCb.head);
+    live = (wsfNvmCb.usedMask & WSF_NVM_SECTOR_BIT(next)) ? wsfNvmLiveBytes(next) : 0;
+
+    if ((wsfNvmCb.writeAddr + live + size) <= (WSF_NVM_SECTOR_ADDR(wsfNvmCb.head) + PAL_NVM_SECTOR_SIZE))
+    {
+      return TRUE;
     }
 
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    PalNvmRead(&header, sizeof(header), storageAddr);
-  } while(1);
+    wsfNvmReclaim();
+    wsfNvmOpenSector(next);
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Append a record to the log.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  pData      Data.
+ *  \param  len        Data length, 0 to erase the ID.
+ *
+ *  \return if write NVM successfully.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmAppend(uint32_t id, const uint8_t *pData, uint16_t len)
+{
+  WsfNvmHeader_t header;
+  uint32_t addr;
+
+  if ((len != 0) && (wsfNvmIndexFind(id) == NULL) && (wsfNvmCb.numIds == WSF_NVM_MAX_IDS))
+  {
+    return FALSE;
+  }
+
+  if (!wsfNvmReserve(WSF_NVM_RECORD_SIZE(len)))
+  {
+    return FALSE;
+  }
 
-  /* After cycling through all headers, create a new stored data header and store data */
   header.id = id;
   header.len = len;
   header.headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
                                (uint8_t *)&header);
   header.dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, len, pData);
-  PalNvmWrite(&header, sizeof(header), storageAddr);
-  PalNvmWrite((void *)pData, len, storageAddr + sizeof(header));
-  if (compCback)
+
+  addr = wsfNvmCb.writeAddr;
+  wsfNvmCb.writeAddr += WSF_NVM_RECORD_SIZE(len);
+
+  PalNvmWrite(&header, sizeof(header), addr);
+  if (wsfNvmCb.palStatus && (len != 0))
   {
-    compCback(TRUE);
+    PalNvmWrite((void *)pData, len, addr + sizeof(header));
   }
-  return TRUE;
+
+  if (!wsfNvmCb.palStatus)
+  {
+    return FALSE;
+  }
+
+  return wsfNvmIndexSet(id, addr, len);
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief  Erase data.
+ *  \brief  Find the end of the programmed part of a sector.
  *
- *  \param  id         Erase ID.
- *  \param  compCback  Write callback.
+ *  \param  sector     Sector.
  *
- *  \return if erase NVM successfully.
+ *  \return Address following the last programmed word.
+ *
+ *  A write torn by a reset leaves a corrupt header as last record, writing resumes after it.
  */
 /*************************************************************************************************/
-bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
+static uint32_t wsfNvmWrittenEnd(uint8_t sector)
+{
+  uint32_t addr = WSF_NVM_SECTOR_ADDR(sector) + PAL_NVM_SECTOR_SIZE;
+  uint32_t word;
+
+  while (addr > WSF_NVM_SECTOR_ADDR(sector))
+  {
+    PalNvmRead(&word, sizeof(word), addr - sizeof(word));
+
+    if (word != WSF_NVM_UNUSED_FILECODE)
+    {
+      break;
+    }
+    addr -= sizeof(word);
+  }
+
+  return addr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the next record after a corrupt header.
+ *
+ *  \param  sector     Sector.
+ *  \param  addr       Address of the corrupt header.
+ *
+ *  \return Address of the next record with a valid header, or the end of the programmed part
+ *          of the sector.
+ *
+ *  Records written after a torn header on a later boot start at the end of the torn bytes, the
+ *  words following the corrupt header are searched for a header with a valid CRC.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmResync(uint8_t sector, uint32_t addr)
 {
   WsfNvmHeader_t header;
-  uint32_t headerCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
-  bool_t erased = FALSE;
+  uint32_t end = wsfNvmWrittenEnd(sector);
 
-  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+  for (addr += PAL_NVM_WORD_SIZE; (addr + sizeof(header)) <= end; addr += PAL_NVM_WORD_SIZE)
+  {
+    PalNvmRead(&header, sizeof(header), addr);
 
-  /* Read first header. */
-  PalNvmRead(&header, sizeof(header), storageAddr);
+    if ((header.id != WSF_NVM_UNUSED_FILECODE) &&
+        (header.headerCrc == CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
+                                       (uint8_t *)&header)) &&
+        ((addr + WSF_NVM_RECORD_SIZE(header.len)) <= (WSF_NVM_SECTOR_ADDR(sector) + PAL_NVM_SECTOR_SIZE)))
+    {
+      return addr;
+    }
+  }
 
-  do
+  return end;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check the data of a record against its CRC.
+ *
+ *  \param  addr       Address of the record.
+ *  \param  pHeader    Header of the record.
+ *
+ *  \return TRUE if the data is intact.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmDataValid(uint32_t addr, const WsfNvmHeader_t *pHeader)
+{
+  uint32_t buf[WSF_NVM_COPY_BUF_SIZE / sizeof(uint32_t)];
+  uint32_t crc = WSF_NVM_CRC_INIT_VALUE;
+  uint32_t chunk, offs;
+
+  addr += sizeof(WsfNvmHeader_t);
+
+  for (offs = 0; offs < pHeader->len; offs += chunk)
   {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
+    chunk = ((pHeader->len - offs) < sizeof(buf)) ? (pHeader->len - offs) : sizeof(buf);
+    PalNvmRead(buf, chunk, addr + offs);
+
+    /* The CRC is continued over chunks, undoing the final inversion of each one. */
+    crc = CalcCrc32(crc, chunk, (uint8_t *)buf) ^ 0xFFFFFFFFU;
+  }
+
+  return (crc ^ 0xFFFFFFFFU) == pHeader->dataCrc;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Rebuild the index from the log.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmMount(void)
+{
+  WsfNvmSectorHeader_t sectorHeader;
+  WsfNvmHeader_t header;
+  uint32_t validMask = 0;
+  uint32_t addr, end;
+  uint8_t sector;
+  uint8_t i;
+
+  wsfNvmCb.numIds = 0;
+  wsfNvmCb.usedMask = 0;
+
+  /* Nothing stored, the first write rotates to sector 0. */
+  wsfNvmCb.head = WSF_NVM_NUM_SECTORS - 1;
+  wsfNvmCb.headSeq = 0;
+  wsfNvmCb.writeAddr = WSF_NVM_SECTOR_ADDR(WSF_NVM_NUM_SECTORS);
+
+  for (sector = 0; sector < WSF_NVM_NUM_SECTORS; sector++)
+  {
+    PalNvmRead(&sectorHeader, sizeof(sectorHeader), WSF_NVM_SECTOR_ADDR(sector));
+
+    if (sectorHeader.magic == WSF_NVM_SECTOR_MAGIC)
     {
-      /* Found unused entry at end of used storage. */
-      break;
+      validMask |= WSF_NVM_SECTOR_BIT(sector);
+
+      if ((wsfNvmCb.headSeq == 0) || ((int32_t)(sectorHeader.seq - wsfNvmCb.headSeq) > 0))
+      {
+        wsfNvmCb.head = sector;
+        wsfNvmCb.headSeq = sectorHeader.seq;
+      }
+    }
+
+    /* Anything else than an erased sector is erased before use. */
+    if (sectorHeader.magic != WSF_NVM_UNUSED_FILECODE)
+    {
+      wsfNvmCb.usedMask |= WSF_NVM_SECTOR_BIT(sector);
     }
+  }
+
+  /* Replay the sectors from the oldest one, later records supersede earlier ones. */
+  sector = wsfNvmCb.head;
+  for (i = WSF_NVM_NUM_SECTORS; i > 0; i--)
+  {
+    sector = WSF_NVM_NEXT_SECTOR(sector);
+
+    if (!(validMask & WSF_NVM_SECTOR_BIT(sector)))
+    {
+      continue;
+    }
+
+    addr = WSF_NVM_SECTOR_ADDR(sector) + sizeof(sectorHeader);
+    end = WSF_NVM_SECTOR_ADDR(sector) + PAL_NVM_SECTOR_SIZE;
 
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
+    while ((addr + sizeof(header)) <= end)
     {
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
+      PalNvmRead(&header, sizeof(header), addr);
 
-      if (headerCrc != header.headerCrc)
+      if (header.id == WSF_NVM_UNUSED_FILECODE)
       {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
+        /* Found unused entry at end of used storage. */
         break;
       }
-      else if (header.id == id)
+
+      if ((header.headerCrc != CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
+                                         (uint8_t *)&header)) ||
+          ((addr + WSF_NVM_RECORD_SIZE(header.len)) > end))
+      {
+        /* Corrupt header, replay carries on with the records written after it. */
+        addr = wsfNvmResync(sector, addr);
+        continue;
+      }
+
+      /* A record torn after its header was written, or a torn copy of a reclaim, leaves the
+       * previous record of the ID indexed. IDs beyond the index are dropped. */
+      if (wsfNvmDataValid(addr, &header))
       {
-        header.id = WSF_NVM_RESERVED_FILECODE;
-        header.headerCrc = 0;
-        header.dataCrc = 0;
-        PalNvmWrite(&header, sizeof(header), storageAddr);
-        erased = TRUE;
+        (void)wsfNvmIndexSet(header.id, addr, (uint16_t) header.len);
       }
+
+      addr += WSF_NVM_RECORD_SIZE(header.len);
     }
 
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    PalNvmRead(&header, sizeof(header), storageAddr);
-  } while(1);
+    if (sector == wsfNvmCb.head)
+    {
+      wsfNvmCb.writeAddr = addr;
+    }
+  }
+}
+
+/**************************************************************************************************
+  Global Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the WSF NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfNvmInit(void)
+{
+  PalNvmInit(wsfNvmPalCback);
+
+  wsfNvmMount();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read data.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  pData      Buffer to read to.
+ *  \param  len        Data length to read.
+ *  \param  compCback  Read callback.
+ *
+ *  \return if Read NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+  WsfNvmHeader_t header;
+  wsfNvmIndex_t *pEntry;
+  bool_t findId = FALSE;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+
+  if (((pEntry = wsfNvmIndexFind(id)) != NULL) && (pEntry->len == len))
+  {
+    /* Header was checked when indexed, only the data CRC is needed. */
+    PalNvmRead(&header, sizeof(header), pEntry->addr);
+    PalNvmRead(pData, len, pEntry->addr + sizeof(header));
+    findId = (CalcCrc32(WSF_NVM_CRC_INIT_VALUE, len, pData) == header.dataCrc);
+  }
+
+  if (compCback)
+  {
+    compCback(findId);
+  }
+  return findId;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write data.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  pData      Buffer to write.
+ *  \param  len        Data length to write.
+ *  \param  compCback  Write callback.
+ *
+ *  \return if write NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+  bool_t status;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+  WSF_ASSERT(len != 0);
+
+  status = wsfNvmAppend(id, pData, len);
+
+  if (compCback)
+  {
+    compCback(status);
+  }
+  return status;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase data.
+ *
+ *  \param  id         Erase ID.
+ *  \param  compCback  Write callback.
+ *
+ *  \return if erase NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
+{
+  bool_t erased = FALSE;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+
+  if (wsfNvmIndexFind(id) != NULL)
+  {
+    /* A zero length record hides the earlier ones until their sectors are reclaimed. */
+    erased = wsfNvmAppend(id, NULL, 0);
+  }
 
   if (compCback)
   {
@@ -296,10 +755,39 @@ bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
 /*************************************************************************************************/
 void WsfNvmEraseSector(uint32_t numOfSectors, WsfNvmCompEvent_t compCback)
 {
+  bool_t status;
+
   PalNvmEraseSector(numOfSectors * PAL_NVM_SECTOR_SIZE, WSF_NVM_START_ADDR);
+  status = wsfNvmCb.palStatus;
+
+  wsfNvmMount();
 
   if (compCback)
   {
-    compCback(TRUE);
+    compCback(status);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Reclaim the oldest sector ahead of need.
+ *
+ *  \return TRUE if a sector was reclaimed.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmGc(void)
+{
+  uint8_t next = WSF_NVM_NEXT_SECTOR(wsfNvmCb.head);
+  uint32_t end = WSF_NVM_SECTOR_ADDR(wsfNvmCb.head) + PAL_NVM_SECTOR_SIZE;
+
+  /* Only once the write sector fills up, later writes may still supersede the oldest records. */
+  if (!(wsfNvmCb.usedMask & WSF_NVM_SECTOR_BIT(next)) || (wsfNvmCb.writeAddr > end) ||
+      ((end - wsfNvmCb.writeAddr) > WSF_NVM_GC_THRESHOLD))
+  {
+    return FALSE;
   }
+
+  wsfNvmReclaim();
+
+  return TRUE;
 }
@@ -20,8 +20,8 @@
  */
 /*************************************************************************************************/
 
+#include <string.h>
 #include "wsf_types.h"
-#include "wsf_queue.h"
 #include "wsf_timer.h"
 #include "wsf_assert.h"
 #include "wsf_cs.h"
@@ -86,11 +86,50 @@
 #define WSF_TIMER_RTC_ELAPSED_TICKS(x)    ((PAL_MAX_RTC_COUNTER_VAL + 1 + x - wsfTimerRtcLastTicks \
                                   + wsfTimerRtcRemainder) & PAL_MAX_RTC_COUNTER_VAL)
 
+/*! \brief  Number of bits of deadline resolved by each wheel level. */
+#define WSF_TIMER_WHEEL_BITS              6
+
+/*! \brief  Number of slots per wheel level. */
+#define WSF_TIMER_WHEEL_SLOTS             (1 << WSF_TIMER_WHEEL_BITS)
+
+/*! \brief  Slot index mask within a wheel level. */
+#define WSF_TIMER_WHEEL_MASK              (WSF_TIMER_WHEEL_SLOTS - 1)
+
+/*! \brief  Number of wheel levels, the top level spans 2^24 ticks. */
+#define WSF_TIMER_WHEEL_LEVELS            4
+
+/*! \brief  Slot of timers beyond the wheel span, after the wheel slots. */
+#define WSF_TIMER_SLOT_OVERFLOW           (WSF_TIMER_WHEEL_LEVELS * WSF_TIMER_WHEEL_SLOTS)
+
+/*! \brief  Slot of expired timers waiting to be serviced. */
+#define WSF_TIMER_SLOT_EXPIRED            (WSF_TIMER_SLOT_OVERFLOW + 1)
+
+/*! \brief  Index of the slot of a deadline at a wheel level. */
+#define WSF_TIMER_WHEEL_INDEX(t, level)   ((((t) >> ((level) * WSF_TIMER_WHEEL_BITS)) & WSF_TIMER_WHEEL_MASK) + \
+                                           ((level) * WSF_TIMER_WHEEL_SLOTS))
+
 /**************************************************************************************************
   Global Variables
 **************************************************************************************************/
 
-wsfQueue_t  wsfTimerTimerQueue;     /*!< Timer queue */
+/*!
+ * \brief  Timer wheel slots followed by the overflow and expired slots.
+ *
+ * Each slot is a doubly linked list headed by its newest timer.  Level 0 holds the timers due
+ * within WSF_TIMER_WHEEL_SLOTS ticks, one slot per tick; each higher level holds
+ * WSF_TIMER_WHEEL_SLOTS times longer spans and is cascaded down when the current time enters a
+ * slot.  The overflow slot is cascaded each turn of the top level.
+ */
+static wsfTimer_t *wsfTimerSlot[WSF_TIMER_SLOT_EXPIRED + 1];
+
+/*! \brief  Oldest expired timer, the next one serviced. */
+static wsfTimer_t *wsfTimerExpiredTail;
+
+/*! \brief  Current time in ticks. */
+static wsfTimerTicks_t wsfTimerNow;
+
+/*! \brief  Number of started timers. */
+static uint16_t wsfTimerNumStarted;
 
 /*! \brief  Last RTC value read. */
 static uint32_t wsfTimerRtcLastTicks = 0;
@@ -100,35 +139,181 @@ static uint32_t wsfTimerRtcRemainder = 0;
 
 /*************************************************************************************************/
 /*!
- *  \brief  Remove a timer from queue.  Note this function does not lock task scheduling.
+ *  \brief  Link a timer in a slot.  Note this function does not lock task scheduling.
  *
  *  \param  pTimer  Pointer to timer.
+ *  \param  slot    Slot index.
  *
  *  \return None.
  */
 /*************************************************************************************************/
-static void wsfTimerRemove(wsfTimer_t *pTimer)
+static void wsfTimerLink(wsfTimer_t *pTimer, uint16_t slot)
 {
-  wsfTimer_t  *pElem;
-  wsfTimer_t  *pPrev = NULL;
+  pTimer->slot = slot;
+  pTimer->pPrev = NULL;
+  pTimer->pNext = wsfTimerSlot[slot];
 
-  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+  if (pTimer->pNext != NULL)
+  {
+    pTimer->pNext->pPrev = pTimer;
+  }
+  else if (slot == WSF_TIMER_SLOT_EXPIRED)
+  {
+    wsfTimerExpiredTail = pTimer;
+  }
 
-  /* find timer in queue */
-  while (pElem != NULL)
+  wsfTimerSlot[slot] = pTimer;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Unlink a timer from its slot.  Note this function does not lock task scheduling.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerUnlink(wsfTimer_t *pTimer)
+{
+  if (pTimer->pPrev != NULL)
+  {
+    pTimer->pPrev->pNext = pTimer->pNext;
+  }
+  else
+  {
+    wsfTimerSlot[pTimer->slot] = pTimer->pNext;
+  }
+
+  if (pTimer->pNext != NULL)
+  {
+    pTimer->pNext->pPrev = pTimer->pPrev;
+  }
+  else if (pTimer->slot == WSF_TIMER_SLOT_EXPIRED)
   {
-    if (pElem == pTimer)
+    wsfTimerExpiredTail = pTimer->pPrev;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Place a started timer in the wheel slot of its deadline, or in the expired slot if
+ *          it is due.  Note this function does not lock task scheduling.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerPlace(wsfTimer_t *pTimer)
+{
+  wsfTimerTicks_t delta = pTimer->deadline - wsfTimerNow;
+  uint8_t level;
+
+  if (delta == 0)
+  {
+    /* timer expired; set task for this timer as ready */
+    wsfTimerLink(pTimer, WSF_TIMER_SLOT_EXPIRED);
+    WsfTaskSetReady(pTimer->handlerId, WSF_TIMER_EVENT);
+    return;
+  }
+
+  for (level = 0; level < WSF_TIMER_WHEEL_LEVELS - 1; level++)
+  {
+    if (delta < ((wsfTimerTicks_t) 1 << ((level + 1) * WSF_TIMER_WHEEL_BITS)))
     {
-      break;
+      wsfTimerLink(pTimer, WSF_TIMER_WHEEL_INDEX(pTimer->deadline, level));
+      return;
     }
-    pPrev = pElem;
+  }
+
+  if (delta < ((wsfTimerTicks_t) 1 << (WSF_TIMER_WHEEL_LEVELS * WSF_TIMER_WHEEL_BITS)))
+  {
+    wsfTimerLink(pTimer, WSF_TIMER_WHEEL_INDEX(pTimer->deadline, level));
+  }
+  else
+  {
+    wsfTimerLink(pTimer, WSF_TIMER_SLOT_OVERFLOW);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Place the timers of a slot again, oldest first, moving them to a lower level or to
+ *          the expired slot.  Note this function does not lock task scheduling.
+ *
+ *  \param  slot    Slot index.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerCascade(uint16_t slot)
+{
+  wsfTimer_t *pElem = wsfTimerSlot[slot];
+  wsfTimer_t *pPrev;
+
+  if (pElem == NULL)
+  {
+    return;
+  }
+
+  wsfTimerSlot[slot] = NULL;
+
+  /* walk back from the oldest so timers of equal deadline keep their start order */
+  while (pElem->pNext != NULL)
+  {
     pElem = pElem->pNext;
   }
 
-  /* if timer found remove from queue */
-  if (pElem != NULL)
+  while (pElem != NULL)
+  {
+    pPrev = pElem->pPrev;
+    wsfTimerPlace(pElem);
+    pElem = pPrev;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the earliest deadline in a slot.  Note this function does not lock task
+ *          scheduling.
+ *
+ *  \param  slot    Slot index.
+ *
+ *  \return Ticks from now until the earliest deadline.
+ */
+/*************************************************************************************************/
+static wsfTimerTicks_t wsfTimerSlotMin(uint16_t slot)
+{
+  wsfTimer_t      *pElem;
+  wsfTimerTicks_t ticks = 0xFFFFFFFF;
+
+  for (pElem = wsfTimerSlot[slot]; pElem != NULL; pElem = pElem->pNext)
+  {
+    if ((pElem->deadline - wsfTimerNow) < ticks)
+    {
+      ticks = pElem->deadline - wsfTimerNow;
+    }
+  }
+
+  return ticks;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Remove a timer from the wheel.  Note this function does not lock task scheduling.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerRemove(wsfTimer_t *pTimer)
+{
+  if (pTimer->isStarted)
   {
-    WsfQueueRemove(&wsfTimerTimerQueue, pTimer, pPrev);
+    wsfTimerUnlink(pTimer);
+    wsfTimerNumStarted--;
 
     pTimer->isStarted = FALSE;
   }
@@ -136,7 +321,7 @@ static void wsfTimerRemove(wsfTimer_t *pTimer)
 
 /*************************************************************************************************/
 /*!
- *  \brief  Insert a timer into the queue sorted by the timer expiration.
+ *  \brief  Insert a timer into the wheel.
  *
  *  \param  pTimer  Pointer to timer.
  *  \param  ticks   Timer ticks until expiration.
@@ -146,36 +331,17 @@ static void wsfTimerRemove(wsfTimer_t *pTimer)
 /*************************************************************************************************/
 static void wsfTimerInsert(wsfTimer_t *pTimer, wsfTimerTicks_t ticks)
 {
-  wsfTimer_t  *pElem;
-  wsfTimer_t  *pPrev = NULL;
-
   /* task schedule lock */
   WsfTaskLock();
 
   /* if timer is already running stop it first */
-  if (pTimer->isStarted)
-  {
-    wsfTimerRemove(pTimer);
-  }
+  wsfTimerRemove(pTimer);
 
   pTimer->isStarted = TRUE;
-  pTimer->ticks = ticks;
-
-  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+  pTimer->deadline = wsfTimerNow + ticks;
+  wsfTimerNumStarted++;
 
-  /* find insertion point in queue */
-  while (pElem != NULL)
-  {
-    if (pTimer->ticks < pElem->ticks)
-    {
-      break;
-    }
-    pPrev = pElem;
-    pElem = pElem->pNext;
-  }
-
-  /* insert timer into queue */
-  WsfQueueInsert(&wsfTimerTimerQueue, pTimer, pPrev);
+  wsfTimerPlace(pTimer);
 
   /* task schedule unlock */
   WsfTaskUnlock();
@@ -206,7 +372,10 @@ static uint32_t wsfTimerTicksToRtc(wsfTimerTicks_t wsfTicks)
 /*************************************************************************************************/
 void WsfTimerInit(void)
 {
-  WSF_QUEUE_INIT(&wsfTimerTimerQueue);
+  memset(wsfTimerSlot, 0, sizeof(wsfTimerSlot));
+  wsfTimerExpiredTail = NULL;
+  wsfTimerNow = 0;
+  wsfTimerNumStarted = 0;
 
   wsfTimerRtcLastTicks = 0;
   wsfTimerRtcRemainder = 0;
@@ -270,6 +439,33 @@ void WsfTimerStop(wsfTimer_t *pTimer)
   WsfTaskUnlock();
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the number of ticks until a timer expires.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return Ticks until expiration, zero if the timer is stopped or has expired.
+ */
+/*************************************************************************************************/
+wsfTimerTicks_t WsfTimerTicksLeft(const wsfTimer_t *pTimer)
+{
+  wsfTimerTicks_t ticks = 0;
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  if (pTimer->isStarted && (pTimer->slot != WSF_TIMER_SLOT_EXPIRED))
+  {
+    ticks = pTimer->deadline - wsfTimerNow;
+  }
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+
+  return ticks;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Update the timer service with the number of elapsed ticks.
@@ -281,30 +477,36 @@ void WsfTimerStop(wsfTimer_t *pTimer)
 /*************************************************************************************************/
 void WsfTimerUpdate(wsfTimerTicks_t ticks)
 {
-  wsfTimer_t  *pElem;
+  uint8_t level;
 
   /* task schedule lock */
   WsfTaskLock();
 
-  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+  /* nothing in the wheel to cascade or expire */
+  if (wsfTimerNumStarted == 0)
+  {
+    wsfTimerNow += ticks;
+    ticks = 0;
+  }
 
-  /* iterate over timer queue */
-  while (pElem != NULL)
+  while (ticks-- > 0)
   {
-    /* decrement ticks while preventing underflow */
-    if (pElem->ticks > ticks)
-    {
-      pElem->ticks -= ticks;
-    }
-    else
-    {
-      pElem->ticks = 0;
+    wsfTimerNow++;
 
-      /* timer expired; set task for this timer as ready */
-      WsfTaskSetReady(pElem->handlerId, WSF_TIMER_EVENT);
+    /* entering a slot of a higher level moves its timers down, a turn of the top level the
+     * overflow timers */
+    for (level = 1; level <= WSF_TIMER_WHEEL_LEVELS; level++)
+    {
+      if ((wsfTimerNow & (((wsfTimerTicks_t) 1 << (level * WSF_TIMER_WHEEL_BITS)) - 1)) != 0)
+      {
+        break;
+      }
+      wsfTimerCascade((level < WSF_TIMER_WHEEL_LEVELS) ? WSF_TIMER_WHEEL_INDEX(wsfTimerNow, level) :
+                                                         WSF_TIMER_SLOT_OVERFLOW);
     }
 
-    pElem = pElem->pNext;
+    /* timers of the level 0 slot are due now */
+    wsfTimerCascade(WSF_TIMER_WHEEL_INDEX(wsfTimerNow, 0));
   }
 
   /* task schedule unlock */
@@ -324,20 +526,40 @@ void WsfTimerUpdate(wsfTimerTicks_t ticks)
 /*************************************************************************************************/
 wsfTimerTicks_t WsfTimerNextExpiration(bool_t *pTimerRunning)
 {
-  wsfTimerTicks_t ticks;
+  wsfTimerTicks_t ticks = 0;
+  wsfTimerTicks_t levelTicks;
+  uint16_t        slot;
+  uint8_t         level;
+  uint8_t         i;
 
   /* task schedule lock */
   WsfTaskLock();
 
-  if (wsfTimerTimerQueue.pHead == NULL)
-  {
-    *pTimerRunning = FALSE;
-    ticks = 0;
-  }
-  else
+  *pTimerRunning = (wsfTimerNumStarted > 0);
+
+  if (*pTimerRunning && (wsfTimerSlot[WSF_TIMER_SLOT_EXPIRED] == NULL))
   {
-    *pTimerRunning = TRUE;
-    ticks = ((wsfTimer_t *) wsfTimerTimerQueue.pHead)->ticks;
+    ticks = 0xFFFFFFFF;
+
+    /* the first occupied slot after the current one of each level holds its earliest deadline;
+     * a higher level may still hold an earlier deadline than a lower one until it cascades */
+    for (level = 0; level < WSF_TIMER_WHEEL_LEVELS; level++)
+    {
+      for (i = 1; i <= WSF_TIMER_WHEEL_SLOTS; i++)
+      {
+        slot = WSF_TIMER_WHEEL_INDEX(wsfTimerNow + ((wsfTimerTicks_t) i << (level * WSF_TIMER_WHEEL_BITS)), level);
+
+        if (wsfTimerSlot[slot] != NULL)
+        {
+          levelTicks = wsfTimerSlotMin(slot);
+          ticks = (levelTicks < ticks) ? levelTicks : ticks;
+          break;
+        }
+      }
+    }
+
+    levelTicks = wsfTimerSlotMin(WSF_TIMER_SLOT_OVERFLOW);
+    ticks = (levelTicks < ticks) ? levelTicks : ticks;
   }
 
   /* task schedule unlock */
@@ -358,7 +580,6 @@ wsfTimerTicks_t WsfTimerNextExpiration(bool_t *pTimerRunning)
 wsfTimer_t *WsfTimerServiceExpired(wsfTaskId_t taskId)
 {
   wsfTimer_t  *pElem;
-  wsfTimer_t  *pPrev = NULL;
 
   /* Unused parameters */
   (void)taskId;
@@ -366,14 +587,10 @@ wsfTimer_t *WsfTimerServiceExpired(wsfTaskId_t taskId)
   /* task schedule lock */
   WsfTaskLock();
 
-  /* find expired timers in queue */
-  if (((pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead) != NULL) &&
-      (pElem->ticks == 0))
+  /* take the oldest expired timer */
+  if ((pElem = wsfTimerExpiredTail) != NULL)
   {
-    /* remove timer from queue */
-    WsfQueueRemove(&wsfTimerTimerQueue, pElem, pPrev);
-
-    pElem->isStarted = FALSE;
+    wsfTimerRemove(pElem);
 
     /* task schedule unlock */
     WsfTaskUnlock();
@@ -26,9 +26,11 @@
 #include "wsf_assert.h"
 #include "wsf_buf.h"
 #include "wsf_cs.h"
+#include "wsf_math.h"
 #include "util/print.h"
 #include "stack/platform/include/pal_sys.h"
 #include <stdarg.h>
+#include <string.h>
 
 /**************************************************************************************************
   Macros
@@ -42,14 +44,31 @@
 #define WSF_PRINTF_MAX_LEN             128
 #endif
 
-#ifndef WSF_TOKEN_RING_BUF_SIZE
-/*! \brief      Size of token ring buffer (multiple of 2^N). */
-#define WSF_TOKEN_RING_BUF_SIZE        32
+#ifndef WSF_TOKEN_ADDR_BASE
+/*! \brief      Base address of the format strings of tokenized messages, the flash. */
+#define WSF_TOKEN_ADDR_BASE            0x10000000
 #endif
 
+/*! \brief      Format string offset from WSF_TOKEN_ADDR_BASE in a token. */
+#define WSF_TOKEN_ADDR_MASK            0x00FFFFFF
+
+/*! \brief      Position of the number of variables in a token. */
+#define WSF_TOKEN_NUM_VARS_SHIFT       24
+
+/*! \brief      Maximum number of variables of a tokenized message. */
+#define WSF_TOKEN_MAX_VARS             15
+
 /*! \brief      Ring buffer flow control condition detected. */
 #define WSF_TOKEN_FLAG_FLOW_CTRL       (1 << 28)
 
+/*! \brief      Trace message, the host ends it with a new line. */
+#define WSF_TOKEN_FLAG_LINE            (1 << 29)
+
+/*! \brief      Sync pattern in the upper half of the second word of a message, the lower half
+ *              holds the check of the message.  The host finds the next message with them after
+ *              losing bytes. */
+#define WSF_TOKEN_SYNC                 0xA55A0000
+
 /*! UART TX buffer size. */
 #ifndef WSF_TRACE_BUFIO_BUFFER_SIZE
 #define WSF_TRACE_BUFIO_BUFFER_SIZE    2048U
@@ -79,47 +98,212 @@ struct
   } ringBuf[WSF_TOKEN_RING_BUF_SIZE];   /*!< Token message ring buffer. */
   uint32_t prodIdx;                     /*!< Ring buffer producer index. */
   uint32_t consIdx;                     /*!< Ring buffer consumer index. */
+  uint32_t flags;                       /*!< Flags of the next token. */
+  bool_t sending;                       /*!< Ring buffer service in progress. */
+  bool_t retry;                         /*!< Service requested while in progress. */
 #endif
 } wsfTraceCb;
 
 #if WSF_TOKEN_ENABLED == TRUE
 /*************************************************************************************************/
 /*!
- *  \brief  Store tokenized message.
+ *  \brief  Store tokenized message records and push them to the trace handler.
  *
  *  \param  tok      Message token.
- *  \param  param    Message parameter.
+ *  \param  numVars  Number of variables.
+ *  \param  pVars    Variables.
  *
  *  \return None.
+ *
+ *  The first record holds the token and the sync pattern with the check of the message, each
+ *  following one two variables.  A message that does not fit is dropped whole and flags the
+ *  next one.
  */
 /*************************************************************************************************/
-void WsfToken(uint32_t tok, uint32_t param)
+static void wsfTokenPut(uint32_t tok, uint8_t numVars, const uint32_t *pVars)
 {
-  static uint32_t flags = 0;
+  uint32_t numRec = 1 + ((numVars + 1) / 2);
+  uint32_t check = 0;
+  uint32_t prodIdx;
+  uint8_t  i;
 
   if (!wsfTraceCb.enabled)
   {
     return;
   }
 
+  for (i = 0; i < numVars; i++)
+  {
+    check = ((check << 5) | (check >> 27)) ^ pVars[i];
+  }
+
   WSF_CS_INIT(cs);
   WSF_CS_ENTER(cs);
 
-  uint32_t prodIdx = (wsfTraceCb.prodIdx + 1) & (WSF_TOKEN_RING_BUF_SIZE - 1);
+  prodIdx = wsfTraceCb.prodIdx;
 
-  if (prodIdx != wsfTraceCb.consIdx)
+  if (numRec <= ((wsfTraceCb.consIdx - prodIdx - 1) & (WSF_TOKEN_RING_BUF_SIZE - 1)))
   {
-    wsfTraceCb.ringBuf[wsfTraceCb.prodIdx].v.token = tok | flags;
-    wsfTraceCb.ringBuf[wsfTraceCb.prodIdx].v.param = param;
-    wsfTraceCb.prodIdx = prodIdx;
-    flags = 0;
+    tok |= wsfTraceCb.flags | ((uint32_t) numVars << WSF_TOKEN_NUM_VARS_SHIFT);
+    check ^= tok;
+
+    wsfTraceCb.ringBuf[prodIdx].v.token = tok;
+    wsfTraceCb.ringBuf[prodIdx].v.param = WSF_TOKEN_SYNC | ((check ^ (check >> 16)) & 0xFFFF);
+
+    for (i = 0; i < numVars; i += 2)
+    {
+      prodIdx = (prodIdx + 1) & (WSF_TOKEN_RING_BUF_SIZE - 1);
+      wsfTraceCb.ringBuf[prodIdx].v.token = pVars[i];
+      wsfTraceCb.ringBuf[prodIdx].v.param = (i + 1 < numVars) ? pVars[i + 1] : 0;
+    }
+
+    wsfTraceCb.prodIdx = (prodIdx + 1) & (WSF_TOKEN_RING_BUF_SIZE - 1);
+    wsfTraceCb.flags = 0;
   }
   else
   {
-    flags = WSF_TOKEN_FLAG_FLOW_CTRL;
+    wsfTraceCb.flags = WSF_TOKEN_FLAG_FLOW_CTRL;
   }
 
   WSF_CS_EXIT(cs);
+
+  if (wsfTraceCb.sendMsgCback != NULL)
+  {
+    (void)WsfTokenService();
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Store tokenized message.
+ *
+ *  \param  tok      Message token.
+ *  \param  param    Message parameter.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfToken(uint32_t tok, uint32_t param)
+{
+  wsfTokenPut(tok & WSF_TOKEN_ADDR_MASK, 1, &param);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Output tokenized trace message.
+ *
+ *  \param  pMsg      Format string, a string constant of the image.
+ *  \param  numVars   Number of variables.
+ *  \param  pVars     Variables, one word each.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTokenTrace(const char *pMsg, uint8_t numVars, const uint32_t *pVars)
+{
+  wsfTokenPut((((uint32_t) pMsg - WSF_TOKEN_ADDR_BASE) & WSF_TOKEN_ADDR_MASK) | WSF_TOKEN_FLAG_LINE,
+              WSF_MIN(numVars, WSF_TOKEN_MAX_VARS), pVars);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Output tokenized printf() message.
+ *
+ *  \param  pFmt      Format string, a string constant of the image.
+ *  \param  args      Variable arguments of the format string.
+ *
+ *  \return Number of variable words recorded.
+ */
+/*************************************************************************************************/
+int WsfTokenVprintf(const char *pFmt, va_list args)
+{
+  uint32_t    vars[WSF_TOKEN_MAX_VARS + 1];
+  uint8_t     numVars = 0;
+  const char  *p = pFmt;
+  bool_t      isLong64;
+  uint64_t    val64;
+  double      valDbl;
+  uint8_t     i;
+
+  while ((p = strchr(p, '%')) != NULL)
+  {
+    if (*++p == '%')
+    {
+      p++;
+      continue;
+    }
+
+    /* flags */
+    while ((*p != '\0') && (strchr("-+ #0", *p) != NULL))
+    {
+      p++;
+    }
+
+    /* width then precision, either may be taken from a variable */
+    for (i = 0; i < 2; i++)
+    {
+      if (*p == '*')
+      {
+        vars[numVars] = va_arg(args, uint32_t);
+        numVars += (numVars < WSF_TOKEN_MAX_VARS);
+        p++;
+      }
+      while ((*p >= '0') && (*p <= '9'))
+      {
+        p++;
+      }
+      if ((i == 0) && (*p == '.'))
+      {
+        p++;
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    /* length modifier, long and smaller are a word */
+    isLong64 = ((p[0] == 'l') && (p[1] == 'l')) || (p[0] == 'j');
+    while ((*p != '\0') && (strchr("hlLjzt", *p) != NULL))
+    {
+      p++;
+    }
+
+    if (*p == '\0')
+    {
+      break;
+    }
+
+    if (strchr("fFeEgGaA", *p) != NULL)
+    {
+      valDbl = va_arg(args, double);
+      memcpy(&val64, &valDbl, sizeof(val64));
+      isLong64 = TRUE;
+    }
+    else if (isLong64)
+    {
+      val64 = va_arg(args, uint64_t);
+    }
+    else
+    {
+      val64 = va_arg(args, uint32_t);
+    }
+
+    vars[numVars] = (uint32_t) val64;
+    numVars += (numVars < WSF_TOKEN_MAX_VARS);
+
+    if (isLong64)
+    {
+      vars[numVars] = (uint32_t) (val64 >> 32);
+      numVars += (numVars < WSF_TOKEN_MAX_VARS);
+    }
+
+    p++;
+  }
+
+  wsfTokenPut(((uint32_t) pFmt - WSF_TOKEN_ADDR_BASE) & WSF_TOKEN_ADDR_MASK, numVars, vars);
+
+  return numVars;
 }
 
 /*************************************************************************************************/
@@ -128,24 +312,64 @@ void WsfToken(uint32_t tok, uint32_t param)
  *
  *  \return TRUE if trace messages pending, FALSE otherwise.
  *
- *  This routine is called in the main loop for a "push" type trace systems.
+ *  This routine is called in the main loop for a "push" type trace systems, and by the
+ *  producers of tokens.  The records are handed to the trace handler in contiguous spans so
+ *  a handler may move each span with a single DMA or USB transfer; a handler refusing a span
+ *  calls this routine again once it can take the next one, e.g. from its transfer completion.
  */
 /*************************************************************************************************/
 bool_t WsfTokenService(void)
 {
+  uint32_t consIdx;
+  uint32_t numRec;
+  bool_t   sent;
+  bool_t   pending;
+
+  WSF_CS_INIT(cs);
+
   WSF_ASSERT(wsfTraceCb.sendMsgCback);
 
-  if (wsfTraceCb.consIdx != wsfTraceCb.prodIdx)
+  WSF_CS_ENTER(cs);
+
+  /* a service in progress takes the records on behalf of this one */
+  if (wsfTraceCb.sending)
+  {
+    wsfTraceCb.retry = TRUE;
+    WSF_CS_EXIT(cs);
+    return TRUE;
+  }
+  wsfTraceCb.sending = TRUE;
+
+  do
   {
+    wsfTraceCb.retry = FALSE;
+    consIdx = wsfTraceCb.consIdx;
+
+    if (consIdx == wsfTraceCb.prodIdx)
+    {
+      break;
+    }
+
+    /* records up to the producer or the end of the ring */
+    numRec = ((wsfTraceCb.prodIdx > consIdx) ? wsfTraceCb.prodIdx : WSF_TOKEN_RING_BUF_SIZE) - consIdx;
+
+    WSF_CS_EXIT(cs);
+    sent = wsfTraceCb.sendMsgCback((uint8_t *)&wsfTraceCb.ringBuf[consIdx], numRec * sizeof(wsfTraceCb.ringBuf[0]));
+    WSF_CS_ENTER(cs);
+
     /* Advance consumer counter only if write successful. */
-    if (wsfTraceCb.sendMsgCback((uint8_t *)&wsfTraceCb.ringBuf[wsfTraceCb.consIdx], sizeof(wsfTraceCb.ringBuf[0])))
+    if (sent)
     {
-      wsfTraceCb.consIdx = (wsfTraceCb.consIdx + 1) & (WSF_TOKEN_RING_BUF_SIZE - 1);
+      wsfTraceCb.consIdx = (consIdx + numRec) & (WSF_TOKEN_RING_BUF_SIZE - 1);
     }
-    return TRUE;
-  }
+  } while (sent || wsfTraceCb.retry);
+
+  wsfTraceCb.sending = FALSE;
+  pending = (wsfTraceCb.consIdx != wsfTraceCb.prodIdx);
+
+  WSF_CS_EXIT(cs);
 
-  return FALSE;
+  return pending;
 }
 #endif
 
@@ -0,0 +1,232 @@
+/* Copyright (c) 2009-2019 Arm Limited
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*************************************************************************************************/
+/*!
+ *  \brief SHA-256 utilities (FIPS 180-4).
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "util/sha256.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Rotate right. */
+#define SHA256_ROTR(x, n)       (((x) >> (n)) | ((x) << (32 - (n))))
+
+/*! \brief  Round functions. */
+#define SHA256_CH(x, y, z)      (((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x, y, z)     (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA256_BSIG0(x)         (SHA256_ROTR(x, 2) ^ SHA256_ROTR(x, 13) ^ SHA256_ROTR(x, 22))
+#define SHA256_BSIG1(x)         (SHA256_ROTR(x, 6) ^ SHA256_ROTR(x, 11) ^ SHA256_ROTR(x, 25))
+#define SHA256_SSIG0(x)         (SHA256_ROTR(x, 7) ^ SHA256_ROTR(x, 18) ^ ((x) >> 3))
+#define SHA256_SSIG1(x)         (SHA256_ROTR(x, 17) ^ SHA256_ROTR(x, 19) ^ ((x) >> 10))
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief  Round constants. */
+static const uint32_t sha256K[64] =
+{
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U, 0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+
+/*! \brief  Initial chaining state. */
+static const uint32_t sha256Init[SHA256_STATE_WORDS] =
+{
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Digest one block.
+ *
+ *  \param  pState   Chaining state.
+ *  \param  pBlock   SHA256_BLOCK_LEN bytes of data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void sha256Block(uint32_t *pState, const uint8_t *pBlock)
+{
+  uint32_t w[16];
+  uint32_t a, b, c, d, e, f, g, h;
+  uint32_t t1, t2;
+  uint8_t i;
+
+  a = pState[0];
+  b = pState[1];
+  c = pState[2];
+  d = pState[3];
+  e = pState[4];
+  f = pState[5];
+  g = pState[6];
+  h = pState[7];
+
+  for (i = 0; i < 64; i++)
+  {
+    /* The message schedule is kept as a 16 word ring */
+    if (i < 16)
+    {
+      w[i] = ((uint32_t) pBlock[0] << 24) | ((uint32_t) pBlock[1] << 16) |
+             ((uint32_t) pBlock[2] << 8) | (uint32_t) pBlock[3];
+      pBlock += 4;
+    }
+    else
+    {
+      w[i & 15] += SHA256_SSIG1(w[(i + 14) & 15]) + w[(i + 9) & 15] + SHA256_SSIG0(w[(i + 1) & 15]);
+    }
+
+    t1 = h + SHA256_BSIG1(e) + SHA256_CH(e, f, g) + sha256K[i] + w[i & 15];
+    t2 = SHA256_BSIG0(a) + SHA256_MAJ(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  pState[0] += a;
+  pState[1] += b;
+  pState[2] += c;
+  pState[3] += d;
+  pState[4] += e;
+  pState[5] += f;
+  pState[6] += g;
+  pState[7] += h;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start a SHA-256 digest.
+ *
+ *  \param  pCtx     Context.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Init(sha256Ctx_t *pCtx)
+{
+  memcpy(pCtx->state, sha256Init, sizeof(pCtx->state));
+  pCtx->len = 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Add data to a SHA-256 digest.
+ *
+ *  \param  pCtx     Context.
+ *  \param  pBuf     Data.
+ *  \param  len      Length of the data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Update(sha256Ctx_t *pCtx, const uint8_t *pBuf, uint32_t len)
+{
+  uint32_t used = pCtx->len % SHA256_BLOCK_LEN;
+  uint32_t fill;
+
+  pCtx->len += len;
+
+  /* Complete a partial block first */
+  if (used != 0)
+  {
+    fill = SHA256_BLOCK_LEN - used;
+
+    if (len < fill)
+    {
+      memcpy(&pCtx->buf[used], pBuf, len);
+      return;
+    }
+
+    memcpy(&pCtx->buf[used], pBuf, fill);
+    sha256Block(pCtx->state, pCtx->buf);
+    pBuf += fill;
+    len -= fill;
+  }
+
+  /* Whole blocks straight from the data */
+  while (len >= SHA256_BLOCK_LEN)
+  {
+    sha256Block(pCtx->state, pBuf);
+    pBuf += SHA256_BLOCK_LEN;
+    len -= SHA256_BLOCK_LEN;
+  }
+
+  memcpy(pCtx->buf, pBuf, len);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Finish a SHA-256 digest.
+ *
+ *  \param  pCtx     Context, must be started again before being reused.
+ *  \param  pDigest  Returns the SHA256_DIGEST_LEN bytes of the digest.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void Sha256Final(sha256Ctx_t *pCtx, uint8_t *pDigest)
+{
+  uint32_t used = pCtx->len % SHA256_BLOCK_LEN;
+  uint32_t bitLenHi = pCtx->len >> 29;
+  uint32_t bitLenLo = pCtx->len << 3;
+  uint8_t i;
+
+  /* Padding, then the message length in bits, most significant byte first */
+  pCtx->buf[used++] = 0x80;
+
+  if (used > SHA256_BLOCK_LEN - 8)
+  {
+    memset(&pCtx->buf[used], 0, SHA256_BLOCK_LEN - used);
+    sha256Block(pCtx->state, pCtx->buf);
+    used = 0;
+  }
+
+  memset(&pCtx->buf[used], 0, SHA256_BLOCK_LEN - 8 - used);
+
+  for (i = 0; i < 4; i++)
+  {
+    pCtx->buf[SHA256_BLOCK_LEN - 8 + i] = (uint8_t) (bitLenHi >> (24 - 8 * i));
+    pCtx->buf[SHA256_BLOCK_LEN - 4 + i] = (uint8_t) (bitLenLo >> (24 - 8 * i));
+  }
+
+  sha256Block(pCtx->state, pCtx->buf);
+
+  for (i = 0; i < SHA256_STATE_WORDS; i++)
+  {
+    pDigest[4 * i] = (uint8_t) (pCtx->state[i] >> 24);
+    pDigest[4 * i + 1] = (uint8_t) (pCtx->state[i] >> 16);
+    pDigest[4 * i + 2] = (uint8_t) (pCtx->state[i] >> 8);
+    pDigest[4 * i + 3] = (uint8_t) pCtx->state[i];
+  }
+}
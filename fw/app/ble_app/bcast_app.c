@@ -0,0 +1,241 @@
+/**
+ * @file       bcast_app.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Connectionless vitals broadcast over extended and periodic advertising
+ * @note       The periodic advertising data carries one service data AD structure per vital:
+ *             | 0x180D HR (1) | 0x1822 SpO2 (1) | 0x1809 temp 0.01 C (2, signed) | 0x180F batt (1) |
+ *             Updates are composed into the idle one of two buffers and handed over as a
+ *             complete payload, and the controller swaps it in at the end of an event.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_trace.h"
+#include "util/bstream.h"
+#include "dm_api.h"
+#include "att_api.h"
+#include "app_api.h"
+#include "app_hw.h"
+
+#include "bcast_app.h"
+#include "sensor_cache.h"
+#include "stdio.h"
+
+/* Private defines ---------------------------------------------------- */
+// Service data AD structure lengths (type + UUID + value)
+#define BCAST_AD_U8_LEN               (1 + 2 + 1)
+#define BCAST_AD_S16_LEN              (1 + 2 + 2)
+
+// Periodic advertising data length
+#define BCAST_APP_DATA_LEN            (3 * (1 + BCAST_AD_U8_LEN) + (1 + BCAST_AD_S16_LEN))
+
+// Value initialization value
+#define BCAST_VALUE_INIT              (0xFF)
+
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+// Control block
+static struct
+{
+  wsfTimer_t      update_timer;       // Periodic data update timer
+  bcast_app_cfg_t cfg;                // Configurable parameters
+  uint8_t         data[2][BCAST_APP_DATA_LEN];  // Periodic advertising data buffers
+  uint8_t         front;              // Buffer last handed to the stack
+  bool_t          started;            // True if periodic advertising is running
+  uint8_t         heart_rate;         // Heart rate in bpm
+  uint8_t         spo2;               // SpO2 in %
+  int16_t         temp;               // Temperature in 0.01 Celsius
+  uint8_t         batt_level;         // Battery level in %
+}
+bcast_cb;
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+// Extended advertising data of the broadcast set
+static const uint8_t m_bcast_adv_data[] =
+{
+  // Device name
+  4,                                      /*! length */
+  DM_ADV_TYPE_LOCAL_NAME,                 /*! AD type */
+  'F',
+  'i',
+  't'
+};
+
+/* Private function prototypes ---------------------------------------- */
+static void m_bcast_build(uint8_t *p_buf);
+static void m_bcast_update(void);
+static void m_bcast_sample(void);
+
+/* Function definitions ----------------------------------------------- */
+void bcast_app_init(wsfHandlerId_t handler_id, bcast_app_cfg_t *p_cfg)
+{
+  bcast_cb.update_timer.handlerId = handler_id;
+  bcast_cb.cfg        = *p_cfg;
+  bcast_cb.heart_rate = BCAST_VALUE_INIT;
+  bcast_cb.spo2       = BCAST_VALUE_INIT;
+  bcast_cb.batt_level = BCAST_VALUE_INIT;
+  bcast_cb.temp       = INT16_MIN;
+}
+
+void bcast_app_setup(void)
+{
+  // Periodic advertising requires a non-connectable, non-scannable extended set
+  AppExtSetAdvType(BCAST_APP_ADV_HANDLE, DM_ADV_NONCONN_UNDIRECT);
+
+  AppExtAdvSetData(BCAST_APP_ADV_HANDLE, APP_ADV_DATA_DISCOVERABLE,
+                   sizeof(m_bcast_adv_data), (uint8_t *) m_bcast_adv_data, sizeof(m_bcast_adv_data));
+  AppExtAdvSetData(BCAST_APP_ADV_HANDLE, APP_ADV_DATA_CONNECTABLE,
+                   sizeof(m_bcast_adv_data), (uint8_t *) m_bcast_adv_data, sizeof(m_bcast_adv_data));
+}
+
+void bcast_app_start(uint8_t timer_evt)
+{
+  // Initial payload
+  bcast_cb.front = 0;
+  m_bcast_build(bcast_cb.data[bcast_cb.front]);
+  AppPerAdvSetData(BCAST_APP_ADV_HANDLE, BCAST_APP_DATA_LEN, bcast_cb.data[bcast_cb.front], BCAST_APP_DATA_LEN);
+
+  AppPerAdvStart(BCAST_APP_ADV_HANDLE);
+  bcast_cb.started = TRUE;
+
+  // Start timer
+  bcast_cb.update_timer.msg.event = timer_evt;
+  WsfTimerStartSec(&bcast_cb.update_timer, bcast_cb.cfg.period);
+}
+
+void bcast_app_stop(void)
+{
+  WsfTimerStop(&bcast_cb.update_timer);
+
+  if (bcast_cb.started)
+  {
+    AppPerAdvStop(BCAST_APP_ADV_HANDLE);
+    bcast_cb.started = FALSE;
+  }
+}
+
+void bcast_app_process_msg(wsfMsgHdr_t *p_msg)
+{
+  if (p_msg->event == bcast_cb.update_timer.msg.event)
+  {
+    m_bcast_sample();
+    m_bcast_update();
+
+    // Restart timer
+    WsfTimerStartSec(&bcast_cb.update_timer, bcast_cb.cfg.period);
+  }
+}
+
+/* Private function definitions --------------------------------------- */
+/**
+ * @brief         Take the vitals and battery level from the sensor cache
+ *
+ * @param[in]     None
+ *
+ * @attention     A value never published is left as is
+ *
+ * @return        None
+ */
+static void m_bcast_sample(void)
+{
+  sensor_cache_value_t value;
+  float temp;
+
+  if (sensor_cache_get(SENSOR_CACHE_TEMP, &value))
+  {
+    memcpy(&temp, value.value, sizeof(temp));
+    bcast_cb.temp = (int16_t) (temp * 100);
+  }
+
+  if (sensor_cache_get(SENSOR_CACHE_SPO2, &value))
+  {
+    bcast_cb.spo2 = value.value[0];
+  }
+
+  if (sensor_cache_get(SENSOR_CACHE_HEART_RATE, &value))
+  {
+    bcast_cb.heart_rate = value.value[0];
+  }
+
+  if (sensor_cache_get(SENSOR_CACHE_BATT_LEVEL, &value))
+  {
+    bcast_cb.batt_level = value.value[0];
+  }
+}
+
+/**
+ * @brief         Build the periodic advertising data
+ *
+ * @param[in]     p_buf   Pointer to buffer of BCAST_APP_DATA_LEN bytes
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_bcast_build(uint8_t *p_buf)
+{
+  uint8_t *p = p_buf;
+
+  UINT8_TO_BSTREAM(p, BCAST_AD_U8_LEN);
+  UINT8_TO_BSTREAM(p, DM_ADV_TYPE_SERVICE_DATA);
+  UINT16_TO_BSTREAM(p, ATT_UUID_HEART_RATE_SERVICE);
+  UINT8_TO_BSTREAM(p, bcast_cb.heart_rate);
+
+  UINT8_TO_BSTREAM(p, BCAST_AD_U8_LEN);
+  UINT8_TO_BSTREAM(p, DM_ADV_TYPE_SERVICE_DATA);
+  UINT16_TO_BSTREAM(p, ATT_UUID_PULSE_OXIMITER_SERVICE);
+  UINT8_TO_BSTREAM(p, bcast_cb.spo2);
+
+  UINT8_TO_BSTREAM(p, BCAST_AD_S16_LEN);
+  UINT8_TO_BSTREAM(p, DM_ADV_TYPE_SERVICE_DATA);
+  UINT16_TO_BSTREAM(p, ATT_UUID_HEALTH_THERM_SERVICE);
+  UINT16_TO_BSTREAM(p, (uint16_t) bcast_cb.temp);
+
+  UINT8_TO_BSTREAM(p, BCAST_AD_U8_LEN);
+  UINT8_TO_BSTREAM(p, DM_ADV_TYPE_SERVICE_DATA);
+  UINT16_TO_BSTREAM(p, ATT_UUID_BATTERY_SERVICE);
+  UINT8_TO_BSTREAM(p, bcast_cb.batt_level);
+
+  WSF_ASSERT((p - p_buf) == BCAST_APP_DATA_LEN);
+}
+
+/**
+ * @brief         Compose the next payload into the idle buffer and hand it to the stack if the
+ *                content changed
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_bcast_update(void)
+{
+  uint8_t back = bcast_cb.front ^ 1;
+
+  if (!bcast_cb.started)
+  {
+    return;
+  }
+
+  m_bcast_build(bcast_cb.data[back]);
+
+  // Nothing to do if the vitals did not change this period
+  if (memcmp(bcast_cb.data[back], bcast_cb.data[bcast_cb.front], BCAST_APP_DATA_LEN) == 0)
+  {
+    return;
+  }
+
+  AppPerAdvSetData(BCAST_APP_ADV_HANDLE, BCAST_APP_DATA_LEN, bcast_cb.data[back], BCAST_APP_DATA_LEN);
+  bcast_cb.front = back;
+}
+
+/* End of file -------------------------------------------------------- */
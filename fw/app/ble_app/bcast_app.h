@@ -0,0 +1,103 @@
+/**
+ * @file       bcast_app.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Connectionless vitals broadcast over extended and periodic advertising
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __BCAST_APP_H
+#define __BCAST_APP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_os.h"
+#include "wsf_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define BCAST_APP_ADV_HANDLE          (1)       // Advertising set used for the broadcast
+
+/* Public enumerate/structure ----------------------------------------- */
+// Broadcast configurable parameters
+typedef struct
+{
+  wsfTimerTicks_t period;     // Periodic advertising data update period in seconds
+}
+bcast_app_cfg_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Initialize the broadcast application
+ *
+ * @param[in]     handler_id  WSF handler ID for App
+ * @param[in]     p_cfg       Broadcast configurable parameters
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bcast_app_init(wsfHandlerId_t handler_id, bcast_app_cfg_t *p_cfg);
+
+/**
+ * @brief         Set the advertising data of the broadcast set.  Call after the advertising data
+ *                of the other sets and before AppExtAdvStart().
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bcast_app_setup(void);
+
+/**
+ * @brief         Start periodic advertising and the periodic data update timer.  Call after
+ *                AppExtAdvStart() has been called for BCAST_APP_ADV_HANDLE.
+ *
+ * @param[in]     timer_evt   WSF event designated by the application for the timer
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bcast_app_start(uint8_t timer_evt);
+
+/**
+ * @brief         Stop periodic advertising and the update timer
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bcast_app_stop(void);
+
+/**
+ * @brief         Process received WSF message.
+ *
+ * @param[in]     p_msg     Event message.
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bcast_app_process_msg(wsfMsgHdr_t *p_msg);
+
+#endif // __BCAST_APP_H
+
+#ifdef __cplusplus
+};
+#endif
+
+/* End of file -------------------------------------------------------- */
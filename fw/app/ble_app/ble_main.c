@@ -49,6 +49,9 @@
 #include "ble_bts.h"
 #include "bas_app.h"
 #include "bts_app.h"
+#include "coc_app.h"
+#include "bcast_app.h"
+#include "ntf_app.h"
 #include "stdio.h"
 
 /**************************************************************************************************
@@ -63,7 +66,9 @@ enum
 {
   BLE_BATT_TIMER_IND = BLE_MSG_START,   // Battery measurement timer expired
   BLE_TEMPERARUE_TIMER_IND,             // Temperature measurement timer expired
-  BLE_SENSOR_HUB_TIMER_IND              // Sensor Hub measurement timer expired
+  BLE_SENSOR_HUB_TIMER_IND,             // Sensor Hub measurement timer expired
+  BLE_BCAST_TIMER_IND,                  // Broadcast data update timer expired
+  BLE_NTF_TIMER_IND                     // Notification period timer expired
 };
 
 /**************************************************************************************************
@@ -92,6 +97,21 @@ static const appAdvCfg_t m_ble_adv_cfg =
   {  200,   200,     0}                   // Advertising intervals in 0.625 ms units
 };
 
+#ifndef BTLE_APP_USE_LEGACY_API
+// Advertising sets: connectable set and vitals broadcast set
+static const uint8_t m_ble_adv_handles[] = {DM_ADV_HANDLE_DEFAULT, BCAST_APP_ADV_HANDLE};
+
+// Configurable parameters for extended and periodic advertising
+static const appExtAdvCfg_t m_ble_ext_adv_cfg =
+{
+  {    0,     0,     0},                  // Advertising durations in ms
+  {  200,   800,     0},                  // Advertising intervals in 0.625 ms units
+  {    0,     0,     0},                  // Maximum number of extended advertising events
+  { TRUE, FALSE, FALSE},                  // Whether to use legacy advertising PDUs
+  {    0,   800,     0}                   // Periodic advertising intervals in 1.25 ms units
+};
+#endif
+
 // Configurable parameters for slave
 static const appSlaveCfg_t m_ble_slave_cfg =
 {
@@ -134,6 +154,20 @@ static const bas_app_cfg_t m_ble_bts_cfg =
   5,                         
 };
 
+// Vitals broadcast configuration
+static const bcast_app_cfg_t m_ble_bcast_cfg =
+{
+  1,                          // Periodic advertising data update period in seconds
+};
+
+// Raw sample stream configuration
+static const coc_app_cfg_t m_ble_coc_cfg =
+{
+  L2C_MIN_MTU,                // Local receive MTU
+  L2C_MIN_MTU,                // Local receive MPS
+  2                           // Initial receive credits
+};
+
 // SMP security parameter configuration
 static const smpCfg_t m_ble_smp_cfg =
 {
@@ -190,10 +224,10 @@ static const uint8_t m_ble_scan_data_disc[] =
 /*! enumeration of client characteristic configuration descriptors */
 enum
 {
-  BLE_GATT_SC_CCC_IDX,      // GATT service, service changed characteristic
-  BLE_TEMP_CCC_IDX,         // Temperature service, temperature monitor characteristic
-  BLE_SENSOR_HUB_CCC_IDX,   // Sensor hub service, spo2 monitor characteristic
-  BLE_BATT_LVL_CCC_IDX,     // Battery service, battery level characteristic
+  BLE_GATT_SC_CCC_IDX,                        // GATT service, service changed characteristic
+  BLE_SVC_CCC_IDX_LIST(BTS_SVC_TABLE)         // Temperature service, temperature monitor characteristic
+  BLE_SVC_CCC_IDX_LIST(BOS_SVC_TABLE)         // Sensor hub service, spo2 monitor characteristic
+  BLE_SVC_CCC_IDX_LIST(BAS_SVC_TABLE)         // Battery service, battery level characteristic
   BLE_NUM_CCC_IDX
 };
 
@@ -202,9 +236,24 @@ static const attsCccSet_t m_ble_ccc_set[BLE_NUM_CCC_IDX] =
 {
   /* cccd handle          value range               security level */
   {GATT_SC_CH_CCC_HDL,    ATT_CLIENT_CFG_INDICATE,  DM_SEC_LEVEL_NONE},   // BLE_GATT_SC_CCC_IDX
-  {BTS_VALUE_CH_CCC_HDL,  ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},   // BLE_TEMP_CCC_IDX
-  {BOS_LVL_CH_CCC_HDL,    ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},   // BLE_SENSOR_HUB_CCC_IDX
-  {BATT_LVL_CH_CCC_HDL,   ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE}    // BLE_BATT_LVL_CCC_IDX
+  BLE_SVC_CCC_SET_LIST(BTS_SVC_TABLE)
+  BLE_SVC_CCC_SET_LIST(BOS_SVC_TABLE)
+  BLE_SVC_CCC_SET_LIST(BAS_SVC_TABLE)
+};
+
+// Characteristics notified together, values updated in the same period share a PDU
+static const ntf_app_char_t m_ble_ntf_char[] =
+{
+  {&ble_bts_svc, BTS_VALUE_HDL, BTS_VALUE_CCC_IDX},   // Temperature
+  {&ble_bas_svc, BAS_LVL_HDL,   BAS_LVL_CCC_IDX}      // Battery level
+};
+
+// Notification configuration
+static const ntf_app_cfg_t m_ble_ntf_cfg =
+{
+  1000,                                       // Notification period in ms
+  m_ble_ntf_char,                             // Notified characteristics
+  sizeof(m_ble_ntf_char) / sizeof(m_ble_ntf_char[0])
 };
 
 /**************************************************************************************************
@@ -217,13 +266,18 @@ static wsfHandlerId_t m_ble_handler_id;
 // LESC OOB configuration
 static dmSecLescOobCfg_t *BLE_oob_cfg;
 
+// The local ECC key was used by a pairing and is to be replaced
+static bool_t m_ble_ecc_key_used;
+
 /* Private function prototypes ---------------------------------------- */
 static void m_ble_dm_cb(dmEvt_t *p_dm_evt);
 static void m_ble_att_cb(attEvt_t *p_evt);
 static void m_ble_ccc_cb(attsCccEvt_t *p_evt);
 static void m_ble_close(ble_msg_t *p_msg);
+static void m_ble_buf_stats_print(void);
+static void m_ble_msg_stats_print(void);
 static void m_ble_setup(ble_msg_t *p_msg);
-static void m_ble_process_ccc_state(ble_msg_t *p_msg);
+static void m_ble_db_hash_restore(void);
 static void m_ble_process_msg(ble_msg_t *p_msg);
 
 /* Function definitions ----------------------------------------------- */
@@ -236,6 +290,9 @@ void ble_handler_init(wsfHandlerId_t handler_id)
 
   // Set configuration pointers
   pAppAdvCfg    = (appAdvCfg_t *) &m_ble_adv_cfg;
+#ifndef BTLE_APP_USE_LEGACY_API
+  pAppExtAdvCfg = (appExtAdvCfg_t *) &m_ble_ext_adv_cfg;
+#endif
   pAppSlaveCfg  = (appSlaveCfg_t *) &m_ble_slave_cfg;
   pAppSecCfg    = (appSecCfg_t *) &m_ble_sec_cfg;
   pAppUpdateCfg = (appUpdateCfg_t *) &m_ble_update_cfg;
@@ -247,8 +304,11 @@ void ble_handler_init(wsfHandlerId_t handler_id)
   pSmpCfg = (smpCfg_t *) &m_ble_smp_cfg;
 
   // Initialize user service application
-  bas_app_init(handler_id, (bas_app_cfg_t *) &m_ble_bas_cfg);
-  bts_app_init(handler_id, (bts_app_cfg_t *) &m_ble_bts_cfg);
+  bas_app_init(handler_id, BLE_BATT_TIMER_IND, (bas_app_cfg_t *) &m_ble_bas_cfg);
+  bts_app_init(handler_id, BLE_TEMPERARUE_TIMER_IND, (bts_app_cfg_t *) &m_ble_bts_cfg);
+  coc_app_init((coc_app_cfg_t *) &m_ble_coc_cfg);
+  bcast_app_init(handler_id, (bcast_app_cfg_t *) &m_ble_bcast_cfg);
+  ntf_app_init(handler_id, BLE_NTF_TIMER_IND, (ntf_app_cfg_t *) &m_ble_ntf_cfg);
 }
 
 void ble_handler(wsfEventMask_t event, wsfMsgHdr_t *p_msg)
@@ -286,8 +346,6 @@ void ble_start(void)
 
   // User service add
   ble_bts_init();
-
-  // ble_bos_init();
   ble_bas_init();
 
   // Reset the device
@@ -359,7 +417,13 @@ static void m_ble_att_cb(attEvt_t *p_evt)
 {
   attEvt_t *p_msg;
 
-  if ((p_msg = WsfMsgAlloc(sizeof(attEvt_t) + p_evt->valueLen)) != NULL)
+  // Events the stack built as messages are forwarded as is
+  if (p_evt->isMsg)
+  {
+    WsfMsgRetain(p_evt);
+    WsfMsgSend(m_ble_handler_id, p_evt);
+  }
+  else if ((p_msg = WsfMsgAlloc(sizeof(attEvt_t) + p_evt->valueLen)) != NULL)
   {
     memcpy(p_msg, p_evt, sizeof(attEvt_t));
     p_msg->pValue = (uint8_t *) (p_msg + 1);
@@ -408,83 +472,138 @@ static void m_ble_ccc_cb(attsCccEvt_t *p_evt)
  */
 static void m_ble_close(ble_msg_t *p_msg)
 {
-  // Stop temperature measurement
-  bts_app_measure_stop((dmConnId_t) p_msg->hdr.param);
+  (void) p_msg;
+
+  // Store bond changes deferred during the connection, and retry any write that found NVM full
+  AppDbNvmFlush();
 
-  // Stop battery measurement
-  bas_app_measure_stop((dmConnId_t) p_msg->hdr.param);
+  // Report buffer and message lane usage of the session
+  m_ble_buf_stats_print();
+  m_ble_msg_stats_print();
 }
 
 /**
- * @brief         Set up advertising and other procedures that need to be performed after
- *                device reset.
+ * @brief         Print the WSF buffer pool statistics, the input of tools/wsf_pool_tune.py
  *
- * @param[in]     p_msg    Pointer to message.
+ * @param[in]     None
  *
  * @attention     None
  *
  * @return        None
  */
-static void m_ble_setup(ble_msg_t *p_msg)
+static void m_ble_buf_stats_print(void)
 {
-  // Set advertising and scan response data for discoverable mode
-  AppAdvSetData(APP_ADV_DATA_DISCOVERABLE, sizeof(m_ble_adv_data_disc), (uint8_t *) m_ble_adv_data_disc);
-  AppAdvSetData(APP_SCAN_DATA_DISCOVERABLE, sizeof(m_ble_scan_data_disc), (uint8_t *) m_ble_scan_data_disc);
+  WsfBufPoolStat_t stat;
+  const uint32_t *p_hist;
+  uint8_t i;
 
-  // Set advertising and scan response data for connectable mode
-  AppAdvSetData(APP_ADV_DATA_CONNECTABLE, 0, NULL);
-  AppAdvSetData(APP_SCAN_DATA_CONNECTABLE, 0, NULL);
+  for (i = 0; i < WsfBufGetNumPool(); i++)
+  {
+    WsfBufGetPoolStats(&stat, i);
+    printf("WSFBUF pool %u %u %u %u %u\n", stat.bufSize, stat.numBuf, stat.maxAlloc, stat.numFail, stat.maxReqLen);
+  }
 
-  // Start advertising; automatically set connectable/discoverable mode and bondable mode
-  AppAdvStart(APP_MODE_AUTO_INIT);
+  p_hist = WsfBufGetSizeHist();
+  printf("WSFBUF hist %u", WSF_BUF_CLASS_SIZE);
+  for (i = 0; i < WSF_BUF_CLASS_NUM; i++)
+  {
+    printf(" %lu", (unsigned long) p_hist[i]);
+  }
+  printf("\n");
 }
 
 /**
- * @brief         Process CCC state change.
+ * @brief         Print the WSF message lane statistics
  *
- * @param[in]     p_msg    Pointer to message.
+ * @param[in]     None
  *
  * @attention     None
  *
  * @return        None
  */
-static void m_ble_process_ccc_state(ble_msg_t *p_msg)
+static void m_ble_msg_stats_print(void)
 {
-  printf("ccc state ind value: %d, handle: %d, idx: %d \n", p_msg->ccc.value, p_msg->ccc.handle, p_msg->ccc.idx);
+  wsfOsLaneStat_t stat;
+  uint8_t i;
 
-  // Handle battery level CCC
-  if (p_msg->ccc.idx == BLE_BATT_LVL_CCC_IDX)
+  for (i = 0; i < WSF_MSG_NUM_PRIO; i++)
   {
-    if (p_msg->ccc.value == ATT_CLIENT_CFG_NOTIFY)
-    {
-      bas_app_measure_start((dmConnId_t) p_msg->ccc.hdr.param, BLE_BATT_TIMER_IND, BLE_BATT_LVL_CCC_IDX);
-      printf("bas_app_measure_start\n");
-    }
-    else
-    {
-      bas_app_measure_stop((dmConnId_t) p_msg->ccc.hdr.param);
-      printf("bas_app_measure_stop\n");
-    }
-    return;
+    WsfOsGetLaneStats(&stat, i);
+    printf("WSFMSG lane %u %u %u %lu\n", i, stat.depth, stat.maxDepth, (unsigned long) stat.numAged);
   }
+}
 
-  // Handle temperature CCC
-  if (p_msg->ccc.idx == BLE_TEMP_CCC_IDX)
+/**
+ * @brief         Set the GATT database hash, from NVM when the database is unchanged.
+ *
+ * @param[in]     None
+ *
+ * @attention     The attribute tables are static per image, so the CMAC only runs after a
+ *                firmware update or a change of the groups.
+ *
+ * @return        None
+ */
+static void m_ble_db_hash_restore(void)
+{
+  uint8_t hash[ATT_DATABASE_HASH_LEN];
+
+  if (AppDbGetDbHash(AttsGetDbKey(FW_VERSION), hash))
   {
-    if (p_msg->ccc.value == ATT_CLIENT_CFG_NOTIFY)
-    {
-      bts_app_measure_start((dmConnId_t) p_msg->ccc.hdr.param, BLE_TEMPERARUE_TIMER_IND, BLE_TEMP_CCC_IDX);
-      printf("bts_app_measure_start\n");
-    }
-    else
-    {
-      bts_app_measure_stop((dmConnId_t) p_msg->ccc.hdr.param);
-      printf("bts_app_measure_stop\n");
-    }
-    return;
+    AttsSetDbHash(hash);
+  }
+  else
+  {
+    // Stored on ATTS_DB_HASH_CALC_CMPL_IND
+    AttsCalculateDbHash();
   }
 }
 
+/**
+ * @brief         Set up advertising and other procedures that need to be performed after
+ *                device reset.
+ *
+ * @param[in]     p_msg    Pointer to message.
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_ble_setup(ble_msg_t *p_msg)
+{
+#ifndef BTLE_APP_USE_LEGACY_API
+  // Set advertising and scan response data for discoverable mode
+  AppExtAdvSetData(DM_ADV_HANDLE_DEFAULT, APP_ADV_DATA_DISCOVERABLE, sizeof(m_ble_adv_data_disc),
+                   (uint8_t *) m_ble_adv_data_disc, sizeof(m_ble_adv_data_disc));
+  AppExtAdvSetData(DM_ADV_HANDLE_DEFAULT, APP_SCAN_DATA_DISCOVERABLE, sizeof(m_ble_scan_data_disc),
+                   (uint8_t *) m_ble_scan_data_disc, sizeof(m_ble_scan_data_disc));
+
+  // Set advertising and scan response data for connectable mode
+  AppExtAdvSetData(DM_ADV_HANDLE_DEFAULT, APP_ADV_DATA_CONNECTABLE, 0, NULL, 0);
+  AppExtAdvSetData(DM_ADV_HANDLE_DEFAULT, APP_SCAN_DATA_CONNECTABLE, 0, NULL, 0);
+
+  // Set advertising data of the vitals broadcast set, stopping the one of a previous reset
+  bcast_app_stop();
+  bcast_app_setup();
+
+  // Start advertising; automatically set connectable/discoverable mode and bondable mode
+  AppExtAdvStart(sizeof(m_ble_adv_handles), (uint8_t *) m_ble_adv_handles, APP_MODE_AUTO_INIT);
+
+  // Start periodic advertising of the vitals
+  bcast_app_start(BLE_BCAST_TIMER_IND);
+#else
+  // Set advertising and scan response data for discoverable mode
+  AppAdvSetData(APP_ADV_DATA_DISCOVERABLE, sizeof(m_ble_adv_data_disc), (uint8_t *) m_ble_adv_data_disc);
+  AppAdvSetData(APP_SCAN_DATA_DISCOVERABLE, sizeof(m_ble_scan_data_disc), (uint8_t *) m_ble_scan_data_disc);
+
+  // Set advertising and scan response data for connectable mode
+  AppAdvSetData(APP_ADV_DATA_CONNECTABLE, 0, NULL);
+  AppAdvSetData(APP_SCAN_DATA_CONNECTABLE, 0, NULL);
+
+  // Start advertising; automatically set connectable/discoverable mode and bondable mode
+  AppAdvStart(APP_MODE_AUTO_INIT);
+#endif
+}
+
 /**
  * @brief         Process messages from the event handler.
  *
@@ -515,19 +634,29 @@ static void m_ble_process_msg(ble_msg_t *p_msg)
       bas_app_process_msg(&p_msg->hdr);
       break;
 
+    case BLE_BCAST_TIMER_IND:
+      bcast_app_process_msg(&p_msg->hdr);
+      break;
+
+    case BLE_NTF_TIMER_IND:
     case ATTS_HANDLE_VALUE_CNF:
-      bas_app_process_msg(&p_msg->hdr);
-      bts_app_process_msg(&p_msg->hdr);
+      ntf_app_process_msg(&p_msg->hdr);
       break;
 
     case ATTS_CCC_STATE_IND:
-      printf("ATTS_CCC_STATE_IND\n");
-      m_ble_process_ccc_state(p_msg);
+      // Measurements run regardless, ntf_app checks the CCC of each notification
+      printf("ccc state ind value: %d, handle: %d, idx: %d \n", p_msg->ccc.value, p_msg->ccc.handle, p_msg->ccc.idx);
+      break;
+
+    case ATTS_DB_HASH_CALC_CMPL_IND:
+      // Keep the database hash with the bonds, keyed by firmware version and group layout
+      AppDbSetDbHash(AttsGetDbKey(FW_VERSION), p_msg->att.pValue);
       break;
 
     case DM_RESET_CMPL_IND:
       printf("DM_RESET_CMPL_IND\n");
       DmSecGenerateEccKeyReq();
+      m_ble_db_hash_restore();
       m_ble_setup(p_msg);
       uiEvent = APP_UI_RESET_CMPL;
       break;
@@ -544,22 +673,33 @@ static void m_ble_process_msg(ble_msg_t *p_msg)
 
     case DM_CONN_OPEN_IND:
       printf("DM_CONN_OPEN_IND\n");
-      bas_app_process_msg(&p_msg->hdr);
-      bts_app_process_msg(&p_msg->hdr);
+      ntf_app_process_msg(&p_msg->hdr);
       uiEvent = APP_UI_CONN_OPEN;
       break;
 
     case DM_CONN_CLOSE_IND:
       printf("DM_CONN_CLOSE_IND\n");
       m_ble_close(p_msg);
+      ntf_app_process_msg(&p_msg->hdr);
+
+      // The link layer keeps the private key of DH, replace it only when no pairing can be running.
+      // The controller answers from its pool of pre-generated keys.
+      if (m_ble_ecc_key_used && AppConnIsOpen() == DM_CONN_ID_NONE)
+      {
+        m_ble_ecc_key_used = FALSE;
+        DmSecGenerateEccKeyReq();
+      }
+
       uiEvent = APP_UI_CONN_CLOSE;
       break;
 
     case DM_SEC_PAIR_CMPL_IND:
+      m_ble_ecc_key_used = TRUE;
       uiEvent = APP_UI_SEC_PAIR_CMPL;
       break;
 
     case DM_SEC_PAIR_FAIL_IND:
+      m_ble_ecc_key_used = TRUE;
       uiEvent = APP_UI_SEC_PAIR_FAIL;
       break;
 
@@ -584,6 +724,8 @@ static void m_ble_process_msg(ble_msg_t *p_msg)
       break;
 
     case DM_HW_ERROR_IND:
+      // Store deferred bond changes before the controller is reset
+      AppDbNvmFlush();
       uiEvent = APP_UI_HW_ERROR;
       break;
 
@@ -32,6 +32,7 @@
 #include "hci_drv_sdma.h"
 
 #include "ble_main.h"
+#include "central_app.h"
 
 /* Private defines ---------------------------------------------------- */
 #define LL_IMPL_REV             (0x2303)
@@ -134,9 +135,21 @@ void ble_stack_init(void)
 
   handler_id = WsfOsSetNextHandler(DmHandler);
   DmDevVsInit(0);
+#ifndef BTLE_APP_USE_LEGACY_API
+  DmExtAdvInit();
+#else
   DmAdvInit();
+#endif
   DmConnInit();
+#ifndef BTLE_APP_USE_LEGACY_API
+  DmExtConnSlaveInit();
+#else
   DmConnSlaveInit();
+#endif
+#ifdef BLE_ROLE_CENTRAL
+  DmScanInit();
+  DmConnMasterInit();
+#endif
   DmSecInit();
   DmSecLescInit();
   DmPrivInit();
@@ -147,23 +160,42 @@ void ble_stack_init(void)
   L2cSlaveHandlerInit(handler_id);
   L2cInit();
   L2cSlaveInit();
+#ifdef BLE_ROLE_CENTRAL
+  L2cMasterInit();
+#endif
+
+  handler_id = WsfOsSetNextHandler(L2cCocHandler);
+  L2cCocHandlerInit(handler_id);
+  L2cCocInit();
 
   handler_id = WsfOsSetNextHandler(AttHandler);
   AttHandlerInit(handler_id);
   AttsInit();
   AttsIndInit();
+#ifdef BLE_ROLE_CENTRAL
+  AttcInit();
+#endif
 
   handler_id = WsfOsSetNextHandler(SmpHandler);
   SmpHandlerInit(handler_id);
   SmprInit();
   SmprScInit();
+#ifdef BLE_ROLE_CENTRAL
+  SmpiInit();
+  SmpiScInit();
+#endif
   HciSetMaxRxAclLen(100);
 
   handler_id = WsfOsSetNextHandler(AppHandler);
   AppHandlerInit(handler_id);
 
+#ifdef BLE_ROLE_CENTRAL
+  handler_id = WsfOsSetNextHandler(central_app_handler);
+  central_app_handler_init(handler_id);
+#else
   handler_id = WsfOsSetNextHandler(ble_handler);
   ble_handler_init(handler_id);
+#endif
 }
 
 /* End of file -------------------------------------------------------- */
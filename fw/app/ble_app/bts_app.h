@@ -40,39 +40,15 @@ bts_app_cfg_t;
  * @brief         Initialize the Body temperature service application
  *
  * @param[in]     handler_id  WSF handler ID for App
+ * @param[in]     timer_evt   WSF event designated by the application for the timer
  * @param[in]     p_cfg       Body Temperature service configurable parameters
  *
- * @attention     None
+ * @attention     Starts the periodic temperature measurement, which publishes to the sensor cache
+ *                whether or not a client is subscribed
  *
  * @return        None
  */
-
-void bts_app_init(wsfHandlerId_t handler_id, bts_app_cfg_t *p_cfg);
-
-/**
- * @brief         Start periodic Body temperature measurement.  This function starts a timer to perform
- *                periodic Body temperature measurements.
- *
- * @param[in]     conn_id       DM connection identifier
- * @param[in]     timer_evt     WSF event designated by the application for the timer
- * @param[in]     temp_ccc_idx  Index of Body temperature CCC descriptor in CCC descriptor handle table
- *
- * @attention     None
- *
- * @return        None
- */
-void bts_app_measure_start(dmConnId_t conn_id, uint8_t timer_evt, uint8_t temp_ccc_idx);
-
-/**
- * @brief         Stop periodic Body temperature measurement
- *
- * @param[in]     conn_id      DM connection identifier
- *
- * @attention     None
- *
- * @return        None
- */
-void bts_app_measure_stop(dmConnId_t conn_id);
+void bts_app_init(wsfHandlerId_t handler_id, uint8_t timer_evt, bts_app_cfg_t *p_cfg);
 
 /**
  * @brief         Process received WSF message.
@@ -85,23 +61,6 @@ void bts_app_measure_stop(dmConnId_t conn_id);
  */
 void bts_app_process_msg(wsfMsgHdr_t *p_msg);
 
-/**
- * @brief         ATTS read callback for Body temperature service used to read the Body temperature. Use this
- *                function as a parameter to SvcBattCbackRegister().
- *
- * @param[in]     conn_id    DM connection identifier.
- * @param[in]     handle     ATT handle.
- * @param[in]     operation  ATT operation.
- * @param[in]     offset     read offset.
- * @param[in]     p_attr     pointer to Attribute
- * 
- * @attention     None
- *
- * @return        None
- */
-uint8_t bts_app_read_cb(dmConnId_t conn_id, uint16_t handle, uint8_t operation,
-                        uint16_t offset, attsAttr_t *p_attr);
-
 #endif // __BTS_APP_H
 
 #ifdef __cplusplus
@@ -0,0 +1,1182 @@
+/**
+ * @file       central_app.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Central role aggregating the streams of several wearables
+ * @note       The central scans for our wearables, connects to up to CENTRAL_APP_PEER_MAX of them,
+ *             discovers the Body Temperature Service, enables its notifications and opens the
+ *             raw sample stream on COC_APP_PSM.  Samples are queued per wearable on the central
+ *             time base and merged into a single timestamp ordered output.
+ *             Raw sample timestamps are rebased with the smallest arrival delay seen so far,
+ *             which is the best estimate of the wearable clock offset.
+ *             Every CENTRAL_APP_BENCH_PERIOD seconds the aggregate notification, SDU and sample
+ *             rates are printed against the number of connected wearables.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_msg.h"
+#include "wsf_timer.h"
+#include "wsf_trace.h"
+#include "util/bstream.h"
+#include "hci_api.h"
+#include "dm_api.h"
+#include "att_api.h"
+#include "l2c_api.h"
+#include "smp_api.h"
+#include "app_api.h"
+#include "app_db.h"
+#include "app_ui.h"
+#include "svc_core.h"
+
+#include "ble_bts.h"
+#include "coc_app.h"
+#include "central_app.h"
+#include "bsp.h"
+#include "stdio.h"
+
+/* Private defines ---------------------------------------------------- */
+// WSF message event starting value
+#define CENTRAL_MSG_START             (0xA0)
+
+// WSF message event enumeration
+enum
+{
+  CENTRAL_BENCH_TIMER_IND = CENTRAL_MSG_START,  // Throughput report timer expired
+  CENTRAL_MERGE_TIMER_IND                       // Merge hold time expired
+};
+
+// Handle list indexes, order matches m_central_disc_char_list
+enum
+{
+  CENTRAL_BTS_VALUE_HDL_IDX,    // Body temperature value
+  CENTRAL_BTS_CCC_HDL_IDX,      // Body temperature CCC descriptor
+  CENTRAL_HDL_LIST_LEN
+};
+
+/* Private macros ----------------------------------------------------- */
+// Number of samples currently held in a wearable queue
+#define CENTRAL_QUEUE_COUNT(p)        ((uint8_t) ((p)->head - (p)->tail))
+
+// Oldest sample of a wearable queue
+#define CENTRAL_QUEUE_FRONT(p)        (&(p)->queue[(p)->tail & (CENTRAL_APP_QUEUE_LEN - 1)])
+
+/* Private enumerate/structure ---------------------------------------- */
+// Wearable control block
+typedef struct
+{
+  dmConnId_t            conn_id;        // Connection ID or DM_CONN_ID_NONE if the slot is free
+  bdAddr_t              addr;           // Wearable address
+  uint16_t              hdl_list[CENTRAL_HDL_LIST_LEN];  // Discovered handles
+  uint16_t              cid;            // Raw sample stream channel ID or L2C_COC_CID_NONE
+  uint16_t              seq;            // Next expected stream frame sequence number
+  int32_t               offset;         // Central time minus wearable time in ms
+  bool_t                offset_valid;   // True once a raw sample has been received
+  central_app_sample_t  queue[CENTRAL_APP_QUEUE_LEN];  // Samples waiting to be merged
+  uint8_t               head;           // Free running write index
+  uint8_t               tail;           // Free running read index
+}
+central_peer_t;
+
+// Control block
+static struct
+{
+  central_peer_t          peer[CENTRAL_APP_PEER_MAX];   // Wearables
+  wsfHandlerId_t          handler_id;     // WSF handler ID
+  wsfTimer_t              bench_timer;    // Throughput report timer
+  wsfTimer_t              merge_timer;    // Merge hold timer
+  central_app_output_cb_t output_cb;      // Merged output callback
+  l2cCocRegId_t           reg_id;         // Raw sample stream registration instance ID
+  bool_t                  scanning;       // True if scanning
+  bool_t                  connecting;     // True while a connection is being created
+  bool_t                  do_connect;     // True to connect on scan stop
+  uint8_t                 conn_addr_type; // Address type of the wearable to connect to
+  bdAddr_t                conn_addr;      // Address of the wearable to connect to
+  uint32_t                last_emit;      // Timestamp of the last merged sample
+  uint32_t                ntf_count;      // Notifications received this period
+  uint32_t                sdu_count;      // Stream SDUs received this period
+  uint32_t                sample_count;   // Samples received this period
+  uint32_t                ntf_rate_max[CENTRAL_APP_PEER_MAX + 1];     // Best notifications/s per wearable count
+  uint32_t                sample_rate_max[CENTRAL_APP_PEER_MAX + 1];  // Best samples/s per wearable count
+}
+central_cb;
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+// Configurable parameters for master
+static const appMasterCfg_t m_central_master_cfg =
+{
+  96,                                     // The scan interval, in 0.625 ms units
+  48,                                     // The scan window, in 0.625 ms units
+  4000,                                   // The scan duration in ms
+  DM_DISC_MODE_NONE,                      // The GAP discovery mode
+  DM_SCAN_TYPE_ACTIVE                     // The scan type (active or passive)
+};
+
+// Configurable parameters for security
+static const appSecCfg_t m_central_sec_cfg =
+{
+  DM_AUTH_BOND_FLAG | DM_AUTH_SC_FLAG,    // Authentication and bonding flags
+  0,                                      // Initiator key distribution flags
+  DM_KEY_DIST_LTK,                        // Responder key distribution flags
+  FALSE,                                  // TRUE if Out-of-band pairing data is present
+  FALSE                                   // TRUE to initiate security upon connection
+};
+
+// SMP security parameter configuration
+static const smpCfg_t m_central_smp_cfg =
+{
+  3000,                                   // 'Repeated attempts' timeout in msec
+  SMP_IO_NO_IN_NO_OUT,                    // I/O Capability
+  7,                                      // Minimum encryption key length
+  16,                                     // Maximum encryption key length
+  3,                                      // Attempts to trigger 'repeated attempts' timeout
+  0,                                      // Device authentication requirements
+};
+
+// Connection parameters, short enough to carry the raw stream of every wearable
+static const hciConnSpec_t m_central_conn_cfg =
+{
+  24,                                     // Minimum connection interval in 1.25ms units
+  24,                                     // Maximum connection interval in 1.25ms units
+  0,                                      // Connection latency
+  600,                                    // Supervision timeout in 10ms units
+  0,                                      // Unused
+  0                                       // Unused
+};
+
+// Configurable parameters for service and characteristic discovery
+static const appDiscCfg_t m_central_disc_cfg =
+{
+  FALSE                                   // TRUE to wait for a secure connection before initiating discovery
+};
+
+static const appCfg_t m_central_app_cfg =
+{
+  TRUE,                                   // TRUE to abort service discovery if service not found
+  TRUE                                    // TRUE to disconnect if ATT transaction times out
+};
+
+// Raw sample stream configuration
+static const coc_app_cfg_t m_central_coc_cfg =
+{
+  COC_APP_MAX_SDU_LEN,                    // Local receive MTU
+  L2C_MIN_MTU,                            // Local receive MPS
+  8                                       // Initial receive credits
+};
+
+// Name our wearables answer active scans with
+static const uint8_t m_central_peer_name[] = {'F', 'i', 't'};
+
+// Body temperature service and characteristic UUIDs
+static const uint8_t m_central_bts_svc_uuid[] = {ATT_UUID_BTS_SERVICE};
+static const uint8_t m_central_bts_value_uuid[] = {ATT_UUID_BTS_CHARACTERICSTIC};
+
+// Body temperature value
+static const attcDiscChar_t m_central_bts_value =
+{
+  m_central_bts_value_uuid,
+  ATTC_SET_REQUIRED | ATTC_SET_UUID_128
+};
+
+// Body temperature CCC descriptor
+static const attcDiscChar_t m_central_bts_ccc =
+{
+  attCliChCfgUuid,
+  ATTC_SET_REQUIRED | ATTC_SET_DESCRIPTOR
+};
+
+// List of characteristics to be discovered; order matches handle index enumeration
+static const attcDiscChar_t *m_central_disc_char_list[] =
+{
+  &m_central_bts_value,
+  &m_central_bts_ccc
+};
+
+// Default value for CCC notifications
+static const uint8_t m_central_ccc_ntf_val[] = {UINT16_TO_BYTES(ATT_CLIENT_CFG_NOTIFY)};
+
+// List of characteristics to configure after service discovery
+static const attcDiscCfg_t m_central_disc_cfg_list[] =
+{
+  {m_central_ccc_ntf_val, sizeof(m_central_ccc_ntf_val), CENTRAL_BTS_CCC_HDL_IDX}
+};
+
+/* Private function prototypes ---------------------------------------- */
+static void m_central_dm_cb(dmEvt_t *p_dm_evt);
+static void m_central_att_cb(attEvt_t *p_evt);
+static void m_central_coc_cb(l2cCocEvt_t *p_msg);
+static void m_central_disc_cb(dmConnId_t conn_id, uint8_t status);
+static void m_central_process_msg(dmEvt_t *p_msg);
+static void m_central_setup(void);
+static void m_central_scan_next(void);
+static void m_central_scan_report(dmEvt_t *p_msg);
+static void m_central_scan_stop(dmEvt_t *p_msg);
+static void m_central_conn_open(dmEvt_t *p_msg);
+static void m_central_conn_close(dmEvt_t *p_msg);
+static void m_central_value_ntf(attEvt_t *p_msg);
+static void m_central_stream_data(central_peer_t *p_peer, uint8_t *p_data, uint16_t len);
+static void m_central_enqueue(central_peer_t *p_peer, const central_app_sample_t *p_sample);
+static void m_central_emit(central_peer_t *p_peer);
+static void m_central_merge(void);
+static void m_central_bench(void);
+static void m_central_print(const central_app_sample_t *p_sample);
+static bool_t m_central_all_ready(void);
+static uint8_t m_central_peer_count(void);
+static central_peer_t *m_central_oldest(void);
+static central_peer_t *m_central_find_peer(dmConnId_t conn_id);
+static central_peer_t *m_central_find_peer_by_addr(const uint8_t *p_addr);
+
+/* Function definitions ----------------------------------------------- */
+void central_app_handler_init(wsfHandlerId_t handler_id)
+{
+  uint8_t i;
+
+  WSF_CT_ASSERT((CENTRAL_APP_QUEUE_LEN & (CENTRAL_APP_QUEUE_LEN - 1)) == 0);
+  WSF_CT_ASSERT(CENTRAL_HDL_LIST_LEN == (sizeof(m_central_disc_char_list) / sizeof(attcDiscChar_t *)));
+
+  printf("central_app_handler_init \n");
+
+  // Store handler ID
+  central_cb.handler_id = handler_id;
+  central_cb.output_cb  = m_central_print;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++)
+  {
+    central_cb.peer[i].conn_id = DM_CONN_ID_NONE;
+    central_cb.peer[i].cid     = L2C_COC_CID_NONE;
+  }
+
+  central_cb.bench_timer.handlerId = handler_id;
+  central_cb.bench_timer.msg.event = CENTRAL_BENCH_TIMER_IND;
+  central_cb.merge_timer.handlerId = handler_id;
+  central_cb.merge_timer.msg.event = CENTRAL_MERGE_TIMER_IND;
+
+  // Set configuration pointers
+  pAppMasterCfg = (appMasterCfg_t *) &m_central_master_cfg;
+  pAppSecCfg    = (appSecCfg_t *) &m_central_sec_cfg;
+  pAppDiscCfg   = (appDiscCfg_t *) &m_central_disc_cfg;
+  pAppCfg       = (appCfg_t *) &m_central_app_cfg;
+
+  // Initialize application framework
+  AppMasterInit();
+  AppDiscInit();
+
+  // Set stack configuration pointers
+  pSmpCfg = (smpCfg_t *) &m_central_smp_cfg;
+}
+
+void central_app_handler(wsfEventMask_t event, wsfMsgHdr_t *p_msg)
+{
+  if (p_msg != NULL)
+  {
+    // The wearable slot must exist before discovery asks for its handle list
+    if (p_msg->event == DM_CONN_OPEN_IND)
+    {
+      m_central_conn_open((dmEvt_t *) p_msg);
+    }
+
+    if (p_msg->event <= ATT_CBACK_END)
+    {
+      // Process discovery-related ATT messages
+      AppDiscProcAttMsg((attEvt_t *) p_msg);
+    }
+    else if (p_msg->event >= DM_CBACK_START && p_msg->event <= DM_CBACK_END)
+    {
+      // Process scanning and connection-related messages
+      AppMasterProcDmMsg((dmEvt_t *) p_msg);
+
+      // Process security-related messages
+      AppMasterSecProcDmMsg((dmEvt_t *) p_msg);
+
+      // Process discovery-related messages
+      AppDiscProcDmMsg((dmEvt_t *) p_msg);
+    }
+
+    // Perform profile and user interface-related operations
+    m_central_process_msg((dmEvt_t *) p_msg);
+  }
+}
+
+void central_app_start(void)
+{
+  l2cCocReg_t reg;
+
+  // Register for stack callbacks
+  DmRegister(m_central_dm_cb);
+  DmConnRegister(DM_CLIENT_ID_APP, m_central_dm_cb);
+  AttRegister(m_central_att_cb);
+
+  // Register for app framework discovery callbacks
+  AppDiscRegister(m_central_disc_cb);
+
+  // Register the raw sample stream initiator
+  reg.psm      = COC_APP_PSM;
+  reg.mps      = m_central_coc_cfg.mps;
+  reg.mtu      = m_central_coc_cfg.mtu;
+  reg.credits  = m_central_coc_cfg.credits;
+  reg.authoriz = FALSE;
+  reg.secLevel = DM_SEC_LEVEL_NONE;
+  reg.role     = L2C_COC_ROLE_INITIATOR;
+
+  central_cb.reg_id = L2cCocRegister(m_central_coc_cb, &reg);
+  WSF_ASSERT(central_cb.reg_id != L2C_COC_REG_ID_NONE);
+
+  // Initialize attribute server database
+  SvcCoreAddGroup();
+
+  // Reset the device
+  DmDevReset();
+}
+
+void central_app_output_register(central_app_output_cb_t output_cb)
+{
+  central_cb.output_cb = (output_cb != NULL) ? output_cb : m_central_print;
+}
+
+/* Private function definitions --------------------------------------- */
+/**
+ * @brief         Application DM callback
+ *
+ * @param[in]     p_dm_evt  DM callback event
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_dm_cb(dmEvt_t *p_dm_evt)
+{
+  dmEvt_t  *p_msg;
+  uint16_t len;
+  uint16_t report_len;
+
+  if (p_dm_evt->hdr.event == DM_SEC_ECC_KEY_IND)
+  {
+    DmSecSetEccKey(&p_dm_evt->eccMsg.data.key);
+    return;
+  }
+
+  len        = DmSizeOfEvt(p_dm_evt);
+  report_len = (p_dm_evt->hdr.event == DM_SCAN_REPORT_IND) ? p_dm_evt->scanReport.len : 0;
+
+  if ((p_msg = WsfMsgAlloc(len + report_len)) != NULL)
+  {
+    memcpy(p_msg, p_dm_evt, len);
+
+    // Advertising data is only valid during the callback, carry it after the event
+    if (p_dm_evt->hdr.event == DM_SCAN_REPORT_IND)
+    {
+      p_msg->scanReport.pData = (uint8_t *) p_msg + len;
+      memcpy(p_msg->scanReport.pData, p_dm_evt->scanReport.pData, report_len);
+    }
+
+    WsfMsgSend(central_cb.handler_id, p_msg);
+  }
+}
+
+/**
+ * @brief         Application ATT callback
+ *
+ * @param[in]     p_evt    ATT callback event
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_att_cb(attEvt_t *p_evt)
+{
+  attEvt_t *p_msg;
+
+  // Events the stack built as messages are forwarded as is
+  if (p_evt->isMsg)
+  {
+    WsfMsgRetain(p_evt);
+    WsfMsgSend(central_cb.handler_id, p_evt);
+  }
+  else if ((p_msg = WsfMsgAlloc(sizeof(attEvt_t) + p_evt->valueLen)) != NULL)
+  {
+    memcpy(p_msg, p_evt, sizeof(attEvt_t));
+    p_msg->pValue = (uint8_t *) (p_msg + 1);
+    memcpy(p_msg->pValue, p_evt->pValue, p_evt->valueLen);
+    WsfMsgSend(central_cb.handler_id, p_msg);
+  }
+}
+
+/**
+ * @brief         L2CAP connection oriented channel callback
+ *
+ * @param[in]     p_msg     L2C COC callback event
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_coc_cb(l2cCocEvt_t *p_msg)
+{
+  central_peer_t *p_peer = m_central_find_peer((dmConnId_t) p_msg->hdr.param);
+
+  if (p_peer == NULL)
+  {
+    return;
+  }
+
+  switch (p_msg->hdr.event)
+  {
+    case L2C_COC_CONNECT_IND:
+      printf("L2C_COC_CONNECT_IND conn: %d, cid: %d\n", p_peer->conn_id, p_msg->connectInd.cid);
+      p_peer->cid = p_msg->connectInd.cid;
+      break;
+
+    case L2C_COC_DISCONNECT_IND:
+      if (p_msg->disconnectInd.cid == p_peer->cid)
+      {
+        p_peer->cid = L2C_COC_CID_NONE;
+      }
+      break;
+
+    case L2C_COC_DATA_IND:
+      if (p_msg->dataInd.cid == p_peer->cid)
+      {
+        m_central_stream_data(p_peer, p_msg->dataInd.pData, p_msg->dataInd.dataLen);
+      }
+      break;
+
+    case L2C_COC_DATA_CNF:
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief         Discovery callback
+ *
+ * @param[in]     conn_id   Connection identifier
+ * @param[in]     status    Service or configuration status
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_disc_cb(dmConnId_t conn_id, uint8_t status)
+{
+  central_peer_t *p_peer = m_central_find_peer(conn_id);
+
+  if (p_peer == NULL)
+  {
+    return;
+  }
+
+  switch (status)
+  {
+    case APP_DISC_INIT:
+      // Set handle list when initialization requested
+      AppDiscSetHdlList(conn_id, CENTRAL_HDL_LIST_LEN, p_peer->hdl_list);
+      break;
+
+    case APP_DISC_SEC_REQUIRED:
+      AppMasterSecurityReq(conn_id);
+      break;
+
+    case APP_DISC_START:
+      AppDiscFindService(conn_id, ATT_128_UUID_LEN, (uint8_t *) m_central_bts_svc_uuid,
+                         CENTRAL_HDL_LIST_LEN, (attcDiscChar_t **) m_central_disc_char_list, p_peer->hdl_list);
+      break;
+
+    case APP_DISC_FAILED:
+      // Not one of our wearables
+      AppConnClose(conn_id);
+      break;
+
+    case APP_DISC_CMPL:
+      AppDiscComplete(conn_id, APP_DISC_CMPL);
+
+      // fall through
+    case APP_DISC_CFG_START:
+      AppDiscConfigure(conn_id, APP_DISC_CFG_START, sizeof(m_central_disc_cfg_list) / sizeof(attcDiscCfg_t),
+                       (attcDiscCfg_t *) m_central_disc_cfg_list, CENTRAL_HDL_LIST_LEN, p_peer->hdl_list);
+      break;
+
+    case APP_DISC_CFG_CMPL:
+      AppDiscComplete(conn_id, status);
+
+      // Notifications are enabled, open the raw sample stream
+      L2cCocConnectReq(conn_id, central_cb.reg_id, COC_APP_PSM);
+      break;
+
+    case APP_DISC_CFG_CONN_START:
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief         Set up scanning and the throughput report after device reset
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_setup(void)
+{
+  central_cb.scanning   = FALSE;
+  central_cb.connecting = FALSE;
+  central_cb.do_connect = FALSE;
+
+  DmConnSetConnSpec((hciConnSpec_t *) &m_central_conn_cfg);
+
+  WsfTimerStartSec(&central_cb.bench_timer, CENTRAL_APP_BENCH_PERIOD);
+
+  m_central_scan_next();
+}
+
+/**
+ * @brief         Start scanning if there is room for another wearable
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_scan_next(void)
+{
+  if (central_cb.scanning || central_cb.connecting || central_cb.do_connect)
+  {
+    return;
+  }
+
+  if (m_central_peer_count() < CENTRAL_APP_PEER_MAX)
+  {
+    AppScanStart(m_central_master_cfg.discMode, m_central_master_cfg.scanType,
+                 m_central_master_cfg.scanDuration);
+  }
+}
+
+/**
+ * @brief         Handle a scan report
+ *
+ * @param[in]     p_msg     Pointer to DM callback event message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_scan_report(dmEvt_t *p_msg)
+{
+  uint8_t *p_data;
+
+  if (!central_cb.scanning || central_cb.do_connect)
+  {
+    return;
+  }
+
+  // Our wearables answer active scans with their name
+  p_data = DmFindAdType(DM_ADV_TYPE_LOCAL_NAME, p_msg->scanReport.len, p_msg->scanReport.pData);
+  if (p_data == NULL || p_data[DM_AD_LEN_IDX] != (sizeof(m_central_peer_name) + 1) ||
+      memcmp(&p_data[DM_AD_DATA_IDX], m_central_peer_name, sizeof(m_central_peer_name)) != 0)
+  {
+    return;
+  }
+
+  if (m_central_find_peer_by_addr(p_msg->scanReport.addr) != NULL)
+  {
+    return;
+  }
+
+  // Stop scanning and connect on scan stop
+  central_cb.conn_addr_type = DmHostAddrType(p_msg->scanReport.addrType);
+  memcpy(central_cb.conn_addr, p_msg->scanReport.addr, sizeof(bdAddr_t));
+  central_cb.do_connect = TRUE;
+
+  AppScanStop();
+}
+
+/**
+ * @brief         Handle scan stop
+ *
+ * @param[in]     p_msg     Pointer to DM callback event message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_scan_stop(dmEvt_t *p_msg)
+{
+  if (p_msg->hdr.status != HCI_SUCCESS)
+  {
+    return;
+  }
+
+  central_cb.scanning = FALSE;
+
+  if (central_cb.do_connect)
+  {
+    central_cb.do_connect = FALSE;
+    central_cb.connecting = TRUE;
+    AppConnOpen(central_cb.conn_addr_type, central_cb.conn_addr,
+                AppDbFindByAddr(central_cb.conn_addr_type, central_cb.conn_addr));
+    return;
+  }
+
+  // Scan duration elapsed
+  m_central_scan_next();
+}
+
+/**
+ * @brief         Allocate the wearable slot of a new connection
+ *
+ * @param[in]     p_msg     Pointer to DM callback event message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_conn_open(dmEvt_t *p_msg)
+{
+  central_peer_t *p_peer = m_central_find_peer(DM_CONN_ID_NONE);
+
+  central_cb.connecting = FALSE;
+
+  if (p_peer == NULL)
+  {
+    AppConnClose((dmConnId_t) p_msg->hdr.param);
+    return;
+  }
+
+  memset(p_peer, 0, sizeof(central_peer_t));
+  p_peer->conn_id = (dmConnId_t) p_msg->hdr.param;
+  p_peer->cid     = L2C_COC_CID_NONE;
+  memcpy(p_peer->addr, p_msg->connOpen.peerAddr, sizeof(bdAddr_t));
+
+  printf("Wearable %d connected, conn: %d\n", (int) (p_peer - central_cb.peer), p_peer->conn_id);
+}
+
+/**
+ * @brief         Release the wearable slot of a closed connection
+ *
+ * @param[in]     p_msg     Pointer to DM callback event message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_conn_close(dmEvt_t *p_msg)
+{
+  central_peer_t *p_peer = m_central_find_peer((dmConnId_t) p_msg->hdr.param);
+
+  central_cb.connecting = FALSE;
+
+  if (p_peer != NULL)
+  {
+    // Drain what the wearable left behind without breaking the output order
+    while (CENTRAL_QUEUE_COUNT(p_peer) != 0)
+    {
+      m_central_emit(m_central_oldest());
+    }
+
+    p_peer->conn_id = DM_CONN_ID_NONE;
+    p_peer->cid     = L2C_COC_CID_NONE;
+
+    printf("Wearable %d disconnected\n", (int) (p_peer - central_cb.peer));
+  }
+
+  m_central_scan_next();
+}
+
+/**
+ * @brief         Handle a body temperature notification
+ *
+ * @param[in]     p_msg     Pointer to ATT callback event message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_value_ntf(attEvt_t *p_msg)
+{
+  central_peer_t       *p_peer = m_central_find_peer((dmConnId_t) p_msg->hdr.param);
+  central_app_sample_t sample;
+
+  if (p_peer == NULL || p_msg->handle != p_peer->hdl_list[CENTRAL_BTS_VALUE_HDL_IDX])
+  {
+    return;
+  }
+
+  central_cb.ntf_count++;
+
+  if (p_msg->valueLen < sizeof(float))
+  {
+    return;
+  }
+
+  // Notifications carry no timestamp, stamp them on arrival
+  memset(&sample, 0, sizeof(sample));
+  sample.timestamp = bsp_get_tick();
+  sample.peer      = (uint8_t) (p_peer - central_cb.peer);
+  sample.type      = CENTRAL_APP_SAMPLE_TEMP;
+  memcpy(&sample.temp, p_msg->pValue, sizeof(float));
+
+  m_central_enqueue(p_peer, &sample);
+  m_central_merge();
+}
+
+/**
+ * @brief         Handle a raw sample stream frame
+ *
+ * @param[in]     p_peer    Wearable control block
+ * @param[in]     p_data    Frame, see coc_app.c
+ * @param[in]     len       Frame length
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_stream_data(central_peer_t *p_peer, uint8_t *p_data, uint16_t len)
+{
+  central_app_sample_t sample;
+  uint32_t             now = bsp_get_tick();
+  uint32_t             timestamp;
+  uint16_t             seq;
+  uint8_t              count;
+  uint8_t              size;
+  uint8_t              *p;
+  uint8_t              i;
+  int32_t              delay;
+
+  if (len < COC_APP_FRAME_HDR_LEN)
+  {
+    return;
+  }
+
+  BSTREAM_TO_UINT16(seq, p_data);
+  BSTREAM_TO_UINT8(count, p_data);
+  BSTREAM_TO_UINT8(size, p_data);
+
+  if (size < COC_APP_SAMPLE_SIZE || ((uint16_t) count * size) > (len - COC_APP_FRAME_HDR_LEN))
+  {
+    return;
+  }
+
+  central_cb.sdu_count++;
+
+  if (p_peer->offset_valid && seq != p_peer->seq)
+  {
+    printf("Wearable %d lost %d frames\n", (int) (p_peer - central_cb.peer), (uint16_t) (seq - p_peer->seq));
+  }
+  p_peer->seq = seq + 1;
+
+  // The smallest arrival delay seen so far is the best estimate of the clock offset
+  for (i = 0, p = p_data; i < count; i++, p += size)
+  {
+    BYTES_TO_UINT32(timestamp, p);
+
+    delay = (int32_t) (now - timestamp);
+    if (!p_peer->offset_valid || delay < p_peer->offset)
+    {
+      p_peer->offset       = delay;
+      p_peer->offset_valid = TRUE;
+    }
+  }
+
+  memset(&sample, 0, sizeof(sample));
+  sample.peer = (uint8_t) (p_peer - central_cb.peer);
+  sample.type = CENTRAL_APP_SAMPLE_RAW;
+
+  for (i = 0; i < count; i++, p_data += size)
+  {
+    p = p_data;
+    BSTREAM_TO_UINT32(timestamp, p);
+    BSTREAM_TO_UINT32(sample.ir_led, p);
+    BSTREAM_TO_UINT32(sample.red_led, p);
+
+    sample.timestamp = timestamp + (uint32_t) p_peer->offset;
+    m_central_enqueue(p_peer, &sample);
+  }
+
+  m_central_merge();
+}
+
+/**
+ * @brief         Queue a sample of a wearable
+ *
+ * @param[in]     p_peer      Wearable control block
+ * @param[in]     p_sample    Sample
+ *
+ * @attention     A full queue makes room by emitting the oldest merged sample, so nothing is
+ *                dropped but a slow wearable may see its samples clamped to the output time.
+ *
+ * @return        None
+ */
+static void m_central_enqueue(central_peer_t *p_peer, const central_app_sample_t *p_sample)
+{
+  while (CENTRAL_QUEUE_COUNT(p_peer) >= CENTRAL_APP_QUEUE_LEN)
+  {
+    m_central_emit(m_central_oldest());
+  }
+
+  p_peer->queue[p_peer->head & (CENTRAL_APP_QUEUE_LEN - 1)] = *p_sample;
+  p_peer->head++;
+
+  central_cb.sample_count++;
+}
+
+/**
+ * @brief         Emit the oldest sample of a wearable queue
+ *
+ * @param[in]     p_peer    Wearable control block
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_emit(central_peer_t *p_peer)
+{
+  central_app_sample_t *p_sample = CENTRAL_QUEUE_FRONT(p_peer);
+
+  // Keep the output ordered when a clock offset estimate moves backwards
+  if ((int32_t) (p_sample->timestamp - central_cb.last_emit) < 0)
+  {
+    p_sample->timestamp = central_cb.last_emit;
+  }
+
+  central_cb.last_emit = p_sample->timestamp;
+  central_cb.output_cb(p_sample);
+
+  p_peer->tail++;
+}
+
+/**
+ * @brief         Emit queued samples in timestamp order
+ *
+ * @param[in]     None
+ *
+ * @attention     A sample is emitted once every streaming wearable has a sample queued, which
+ *                proves nothing older can still arrive, or once it has waited
+ *                CENTRAL_APP_MERGE_DELAY_MS for a wearable that went quiet.
+ *
+ * @return        None
+ */
+static void m_central_merge(void)
+{
+  central_peer_t *p_oldest;
+  uint32_t       now = bsp_get_tick();
+
+  while ((p_oldest = m_central_oldest()) != NULL)
+  {
+    if (!m_central_all_ready() &&
+        (int32_t) (now - CENTRAL_QUEUE_FRONT(p_oldest)->timestamp) < CENTRAL_APP_MERGE_DELAY_MS)
+    {
+      // Come back when the oldest sample has waited long enough
+      WsfTimerStartMs(&central_cb.merge_timer, CENTRAL_APP_MERGE_DELAY_MS);
+      return;
+    }
+
+    m_central_emit(p_oldest);
+  }
+}
+
+/**
+ * @brief         Report the aggregate throughput against the number of wearables
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_bench(void)
+{
+  uint8_t  peers       = m_central_peer_count();
+  uint32_t ntf_rate    = central_cb.ntf_count / CENTRAL_APP_BENCH_PERIOD;
+  uint32_t sdu_rate    = central_cb.sdu_count / CENTRAL_APP_BENCH_PERIOD;
+  uint32_t sample_rate = central_cb.sample_count / CENTRAL_APP_BENCH_PERIOD;
+  uint8_t  i;
+
+  if (ntf_rate > central_cb.ntf_rate_max[peers])
+  {
+    central_cb.ntf_rate_max[peers] = ntf_rate;
+  }
+
+  if (sample_rate > central_cb.sample_rate_max[peers])
+  {
+    central_cb.sample_rate_max[peers] = sample_rate;
+  }
+
+  printf("Bench wearables: %d, ntf/s: %u, sdu/s: %u, samples/s: %u\n", peers, ntf_rate, sdu_rate, sample_rate);
+
+  for (i = 1; i <= CENTRAL_APP_PEER_MAX; i++)
+  {
+    printf("  %d wearable(s): max ntf/s: %u, max samples/s: %u\n",
+           i, central_cb.ntf_rate_max[i], central_cb.sample_rate_max[i]);
+  }
+
+  central_cb.ntf_count    = 0;
+  central_cb.sdu_count    = 0;
+  central_cb.sample_count = 0;
+
+  WsfTimerStartSec(&central_cb.bench_timer, CENTRAL_APP_BENCH_PERIOD);
+}
+
+/**
+ * @brief         Default merged output, print the sample
+ *
+ * @param[in]     p_sample    Sample
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_print(const central_app_sample_t *p_sample)
+{
+  if (p_sample->type == CENTRAL_APP_SAMPLE_TEMP)
+  {
+    printf("%u wearable %d temp: %f\n", p_sample->timestamp, p_sample->peer, (double) p_sample->temp);
+  }
+  else
+  {
+    printf("%u wearable %d ir: %u, red: %u\n", p_sample->timestamp, p_sample->peer, p_sample->ir_led, p_sample->red_led);
+  }
+}
+
+/**
+ * @brief         Check that every streaming wearable has a sample queued
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        TRUE if the oldest queued sample can be emitted
+ */
+static bool_t m_central_all_ready(void)
+{
+  central_peer_t *p_peer = central_cb.peer;
+  uint8_t i;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++, p_peer++)
+  {
+    if (p_peer->cid != L2C_COC_CID_NONE && CENTRAL_QUEUE_COUNT(p_peer) == 0)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief         Count the connected wearables
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Number of connected wearables
+ */
+static uint8_t m_central_peer_count(void)
+{
+  uint8_t count = 0;
+  uint8_t i;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++)
+  {
+    if (central_cb.peer[i].conn_id != DM_CONN_ID_NONE)
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/**
+ * @brief         Find the wearable holding the oldest queued sample
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Wearable control block or NULL if every queue is empty
+ */
+static central_peer_t *m_central_oldest(void)
+{
+  central_peer_t *p_peer = central_cb.peer;
+  central_peer_t *p_oldest = NULL;
+  uint8_t i;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++, p_peer++)
+  {
+    if (CENTRAL_QUEUE_COUNT(p_peer) == 0)
+    {
+      continue;
+    }
+
+    if (p_oldest == NULL ||
+        (int32_t) (CENTRAL_QUEUE_FRONT(p_peer)->timestamp - CENTRAL_QUEUE_FRONT(p_oldest)->timestamp) < 0)
+    {
+      p_oldest = p_peer;
+    }
+  }
+
+  return p_oldest;
+}
+
+/**
+ * @brief         Find a wearable by connection ID
+ *
+ * @param[in]     conn_id   Connection ID, DM_CONN_ID_NONE to find a free slot
+ *
+ * @attention     None
+ *
+ * @return        Wearable control block or NULL if not found
+ */
+static central_peer_t *m_central_find_peer(dmConnId_t conn_id)
+{
+  central_peer_t *p_peer = central_cb.peer;
+  uint8_t i;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++, p_peer++)
+  {
+    if (p_peer->conn_id == conn_id)
+    {
+      return p_peer;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief         Find a connected wearable by address
+ *
+ * @param[in]     p_addr    Address
+ *
+ * @attention     None
+ *
+ * @return        Wearable control block or NULL if not connected
+ */
+static central_peer_t *m_central_find_peer_by_addr(const uint8_t *p_addr)
+{
+  central_peer_t *p_peer = central_cb.peer;
+  uint8_t i;
+
+  for (i = 0; i < CENTRAL_APP_PEER_MAX; i++, p_peer++)
+  {
+    if (p_peer->conn_id != DM_CONN_ID_NONE && BdaCmp(p_peer->addr, p_addr))
+    {
+      return p_peer;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief         Process messages from the event handler.
+ *
+ * @param[in]     p_msg    Pointer to message.
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_central_process_msg(dmEvt_t *p_msg)
+{
+  uint8_t uiEvent = APP_UI_NONE;
+
+  switch (p_msg->hdr.event)
+  {
+    case CENTRAL_BENCH_TIMER_IND:
+      m_central_bench();
+      break;
+
+    case CENTRAL_MERGE_TIMER_IND:
+      m_central_merge();
+      break;
+
+    case ATTC_HANDLE_VALUE_NTF:
+      m_central_value_ntf((attEvt_t *) p_msg);
+      break;
+
+    case DM_RESET_CMPL_IND:
+      printf("DM_RESET_CMPL_IND\n");
+      DmSecGenerateEccKeyReq();
+      m_central_setup();
+      uiEvent = APP_UI_RESET_CMPL;
+      break;
+
+    case DM_SCAN_START_IND:
+      if (p_msg->hdr.status == HCI_SUCCESS)
+      {
+        central_cb.scanning = TRUE;
+      }
+      uiEvent = APP_UI_SCAN_START;
+      break;
+
+    case DM_SCAN_STOP_IND:
+      m_central_scan_stop(p_msg);
+      uiEvent = APP_UI_SCAN_STOP;
+      break;
+
+    case DM_SCAN_REPORT_IND:
+      m_central_scan_report(p_msg);
+      break;
+
+    case DM_CONN_OPEN_IND:
+      printf("DM_CONN_OPEN_IND\n");
+      m_central_scan_next();
+      uiEvent = APP_UI_CONN_OPEN;
+      break;
+
+    case DM_CONN_CLOSE_IND:
+      printf("DM_CONN_CLOSE_IND\n");
+      m_central_conn_close(p_msg);
+      uiEvent = APP_UI_CONN_CLOSE;
+      break;
+
+    case DM_SEC_PAIR_CMPL_IND:
+      uiEvent = APP_UI_SEC_PAIR_CMPL;
+      break;
+
+    case DM_SEC_PAIR_FAIL_IND:
+      uiEvent = APP_UI_SEC_PAIR_FAIL;
+      break;
+
+    case DM_SEC_ENCRYPT_IND:
+      uiEvent = APP_UI_SEC_ENCRYPT;
+      break;
+
+    case DM_SEC_ENCRYPT_FAIL_IND:
+      uiEvent = APP_UI_SEC_ENCRYPT_FAIL;
+      break;
+
+    case DM_SEC_AUTH_REQ_IND:
+      AppHandlePasskey(&p_msg->authReq);
+      break;
+
+    case DM_SEC_COMPARE_IND:
+      AppHandleNumericComparison(&p_msg->cnfInd);
+      break;
+
+    case DM_HW_ERROR_IND:
+      uiEvent = APP_UI_HW_ERROR;
+      break;
+
+    default:
+      break;
+  }
+
+  if (uiEvent != APP_UI_NONE)
+  {
+    AppUiAction(uiEvent);
+  }
+}
+
+/* End of file -------------------------------------------------------- */
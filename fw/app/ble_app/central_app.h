@@ -0,0 +1,112 @@
+/**
+ * @file       central_app.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Central role aggregating the streams of several wearables
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __CENTRAL_APP_H
+#define __CENTRAL_APP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define CENTRAL_APP_PEER_MAX          (2)       // Wearables served at once, bounded by LL MaxConn
+#define CENTRAL_APP_QUEUE_LEN         (32)      // Samples held per wearable while merging
+#define CENTRAL_APP_MERGE_DELAY_MS    (200)     // Longest a sample waits for slower wearables
+#define CENTRAL_APP_BENCH_PERIOD      (1)       // Throughput report period in seconds
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Merged sample type
+ */
+typedef enum
+{
+  CENTRAL_APP_SAMPLE_RAW,     // Raw sensor sample from the L2CAP stream
+  CENTRAL_APP_SAMPLE_TEMP     // Body temperature notification
+}
+central_app_sample_type_t;
+
+/**
+ * @brief Merged sample
+ */
+typedef struct
+{
+  uint32_t timestamp;   // Sample time in ms on the central time base
+  uint8_t  peer;        // Index of the wearable the sample came from
+  uint8_t  type;        // Sample type, see central_app_sample_type_t
+  uint32_t ir_led;      // IR LED count, raw samples only
+  uint32_t red_led;     // Red LED count, raw samples only
+  float    temp;        // Temperature in Celsius, temperature samples only
+}
+central_app_sample_t;
+
+// Merged output callback, samples are delivered in timestamp order
+typedef void (*central_app_output_cb_t)(const central_app_sample_t *p_sample);
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief  Application handler init function called during system initialization.
+ *
+ * @param[in]     handler_id  WSF handler ID for App.
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void central_app_handler_init(wsfHandlerId_t handler_id);
+
+/**
+ * @brief  WSF event handler for the application.
+ *
+ * @param[in]     event     WSF event mask
+ * @param[in]     p_msg     WSF message
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void central_app_handler(wsfEventMask_t event, wsfMsgHdr_t *p_msg);
+
+/**
+ * @brief  Start the application
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void central_app_start(void);
+
+/**
+ * @brief         Register the merged output callback
+ *
+ * @param[in]     output_cb   Callback, NULL to print the samples
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void central_app_output_register(central_app_output_cb_t output_cb);
+
+#endif // __CENTRAL_APP_H
+
+#ifdef __cplusplus
+};
+#endif
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,234 @@
+/**
+ * @file       coc_app.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      L2CAP connection oriented channel raw sensor streaming application
+ * @note       Frames are SDUs of the form
+ *             | sequence (2) | sample count (1) | sample size (1) | samples ... |
+ *             The stack segments each SDU into as many K-frames as the peer MPS requires
+ *             and sends them as peer credits arrive.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_trace.h"
+#include "util/bstream.h"
+#include "dm_api.h"
+#include "l2c_api.h"
+
+#include "coc_app.h"
+#include "stdio.h"
+
+/* Private defines ---------------------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+// Number of samples currently held in the ring
+#define COC_APP_RING_COUNT()          ((uint16_t) (coc_cb.head - coc_cb.tail))
+
+/* Private enumerate/structure ---------------------------------------- */
+// Control block
+static struct
+{
+  uint8_t             ring[COC_APP_RING_SAMPLES][COC_APP_SAMPLE_SIZE];  // Sample ring
+  uint16_t            head;         // Free running write index
+  uint16_t            tail;         // Free running read index, advanced on data confirm
+  uint8_t             tx_buf[COC_APP_MAX_SDU_LEN];  // Frame under construction
+  uint16_t            tx_count;     // Number of samples in the frame in flight
+  bool_t              tx_busy;      // True while waiting for L2C_COC_DATA_CNF
+  uint16_t            seq;          // Frame sequence number
+  uint16_t            cid;          // Local channel ID or L2C_COC_CID_NONE
+  uint16_t            peer_mtu;     // SDU size the peer can receive
+  uint32_t            refused;      // Number of samples refused for a full ring
+  l2cCocRegId_t       reg_id;       // Registration instance ID
+}
+coc_cb;
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+static void m_coc_cb(l2cCocEvt_t *p_msg);
+static void m_coc_send_next(void);
+
+/* Function definitions ----------------------------------------------- */
+void coc_app_init(coc_app_cfg_t *p_cfg)
+{
+  l2cCocReg_t reg;
+
+  WSF_CT_ASSERT((COC_APP_RING_SAMPLES & (COC_APP_RING_SAMPLES - 1)) == 0);
+  WSF_CT_ASSERT(sizeof(coc_app_sample_t) == COC_APP_SAMPLE_SIZE);
+
+  coc_cb.cid = L2C_COC_CID_NONE;
+
+  reg.psm      = COC_APP_PSM;
+  reg.mps      = p_cfg->mps;
+  reg.mtu      = p_cfg->mtu;
+  reg.credits  = p_cfg->credits;
+  reg.authoriz = FALSE;
+  reg.secLevel = DM_SEC_LEVEL_NONE;
+  reg.role     = L2C_COC_ROLE_ACCEPTOR;
+
+  coc_cb.reg_id = L2cCocRegister(m_coc_cb, &reg);
+  WSF_ASSERT(coc_cb.reg_id != L2C_COC_REG_ID_NONE);
+}
+
+uint16_t coc_app_push(const coc_app_sample_t *p_sample, uint16_t count)
+{
+  uint16_t free_space = coc_app_free_space();
+  uint16_t i;
+  uint8_t  *p;
+
+  if (count > free_space)
+  {
+    coc_cb.refused += count - free_space;
+    count = free_space;
+  }
+
+  for (i = 0; i < count; i++, p_sample++)
+  {
+    p = coc_cb.ring[(uint16_t) (coc_cb.head + i) & (COC_APP_RING_SAMPLES - 1)];
+    UINT32_TO_BSTREAM(p, p_sample->timestamp);
+    UINT32_TO_BSTREAM(p, p_sample->ir_led);
+    UINT32_TO_BSTREAM(p, p_sample->red_led);
+  }
+
+  // Publish the samples only after they are completely written
+  coc_cb.head += count;
+
+  m_coc_send_next();
+
+  return count;
+}
+
+uint16_t coc_app_free_space(void)
+{
+  return COC_APP_RING_SAMPLES - COC_APP_RING_COUNT();
+}
+
+uint32_t coc_app_refused_count(void)
+{
+  return coc_cb.refused;
+}
+
+/* Private function definitions --------------------------------------- */
+/**
+ * @brief         Build the next frame from the ring and hand it to the stack
+ *
+ * @param[in]     None
+ *
+ * @attention     Samples stay in the ring until the frame is confirmed, so a failed request
+ *                is retried on the next push or confirm without losing data.
+ *
+ * @return        None
+ */
+static void m_coc_send_next(void)
+{
+  uint16_t max_samples;
+  uint16_t count;
+  uint16_t sdu_len;
+  uint16_t i;
+  uint8_t  *p;
+
+  if (coc_cb.cid == L2C_COC_CID_NONE || coc_cb.tx_busy || COC_APP_RING_COUNT() == 0)
+  {
+    return;
+  }
+
+  // Fill the SDU up to what the peer can reassemble
+  sdu_len = (coc_cb.peer_mtu < COC_APP_MAX_SDU_LEN) ? coc_cb.peer_mtu : COC_APP_MAX_SDU_LEN;
+  if (sdu_len < (COC_APP_FRAME_HDR_LEN + COC_APP_SAMPLE_SIZE))
+  {
+    return;
+  }
+
+  max_samples = (sdu_len - COC_APP_FRAME_HDR_LEN) / COC_APP_SAMPLE_SIZE;
+  count       = COC_APP_RING_COUNT();
+  if (count > max_samples)
+  {
+    count = max_samples;
+  }
+
+  p = coc_cb.tx_buf;
+  UINT16_TO_BSTREAM(p, coc_cb.seq);
+  UINT8_TO_BSTREAM(p, count);
+  UINT8_TO_BSTREAM(p, COC_APP_SAMPLE_SIZE);
+
+  for (i = 0; i < count; i++)
+  {
+    memcpy(p, coc_cb.ring[(uint16_t) (coc_cb.tail + i) & (COC_APP_RING_SAMPLES - 1)], COC_APP_SAMPLE_SIZE);
+    p += COC_APP_SAMPLE_SIZE;
+  }
+
+  if (L2cCocDataReq(coc_cb.cid, (uint16_t) (p - coc_cb.tx_buf), coc_cb.tx_buf))
+  {
+    coc_cb.tx_count = count;
+    coc_cb.tx_busy  = TRUE;
+  }
+}
+
+/**
+ * @brief         L2CAP connection oriented channel callback
+ *
+ * @param[in]     p_msg     L2C COC callback event
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_coc_cb(l2cCocEvt_t *p_msg)
+{
+  switch (p_msg->hdr.event)
+  {
+    case L2C_COC_CONNECT_IND:
+      printf("L2C_COC_CONNECT_IND cid: %d, mtu: %d\n", p_msg->connectInd.cid, p_msg->connectInd.peerMtu);
+
+      // Only one stream is served at a time
+      if (coc_cb.cid != L2C_COC_CID_NONE)
+      {
+        L2cCocDisconnectReq(p_msg->connectInd.cid);
+        break;
+      }
+
+      coc_cb.cid      = p_msg->connectInd.cid;
+      coc_cb.peer_mtu = p_msg->connectInd.peerMtu;
+      coc_cb.tx_busy  = FALSE;
+      m_coc_send_next();
+      break;
+
+    case L2C_COC_DISCONNECT_IND:
+      if (p_msg->disconnectInd.cid == coc_cb.cid)
+      {
+        // The frame in flight is dropped by the stack, its samples remain in the ring
+        coc_cb.cid     = L2C_COC_CID_NONE;
+        coc_cb.tx_busy = FALSE;
+
+        printf("L2C_COC_DISCONNECT_IND samples refused: %lu\n", (unsigned long) coc_cb.refused);
+      }
+      break;
+
+    case L2C_COC_DATA_CNF:
+      if (p_msg->dataCnf.cid == coc_cb.cid)
+      {
+        coc_cb.tx_busy = FALSE;
+
+        if (p_msg->hdr.status == L2C_COC_DATA_SUCCESS)
+        {
+          coc_cb.tail += coc_cb.tx_count;
+          coc_cb.seq++;
+        }
+
+        m_coc_send_next();
+      }
+      break;
+
+    case L2C_COC_DATA_IND:
+    default:
+      break;
+  }
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,110 @@
+/**
+ * @file       coc_app.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      L2CAP connection oriented channel raw sensor streaming application
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __COC_APP_H
+#define __COC_APP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_os.h"
+#include "l2c_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define COC_APP_PSM                   (0x0081)  // LE PSM of the raw sample stream (dynamic range)
+#define COC_APP_SAMPLE_SIZE           (12)      // Size of one sample record in bytes
+#define COC_APP_RING_SAMPLES          (128)     // Number of samples buffered in the sample ring
+#define COC_APP_FRAME_HDR_LEN         (4)       // Frame header: sequence (2), sample count (1), sample size (1)
+#define COC_APP_MAX_SDU_LEN           (244)     // Largest SDU built from the ring
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Raw sensor sample record, COC_APP_SAMPLE_SIZE bytes on air (little endian)
+ */
+typedef struct
+{
+  uint32_t timestamp;   // Sample timestamp in ms
+  uint32_t ir_led;      // IR LED count
+  uint32_t red_led;     // Red LED count
+}
+coc_app_sample_t;
+
+// Stream service configurable parameters
+typedef struct
+{
+  uint16_t mtu;         // Local receive MTU
+  uint16_t mps;         // Local receive MPS
+  uint16_t credits;     // Initial receive credits given to the peer
+}
+coc_app_cfg_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Initialize the stream application and register the acceptor on COC_APP_PSM
+ *
+ * @param[in]     p_cfg       Stream configurable parameters
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void coc_app_init(coc_app_cfg_t *p_cfg);
+
+/**
+ * @brief         Push samples into the sample ring.  Samples are only removed from the ring once
+ *                the stack has accepted the frame carrying them, so a short count means the
+ *                producer must hold the remaining samples and retry later.
+ *
+ * @param[in]     p_sample    Pointer to samples
+ * @param[in]     count       Number of samples
+ *
+ * @attention     None
+ *
+ * @return        Number of samples accepted
+ */
+uint16_t coc_app_push(const coc_app_sample_t *p_sample, uint16_t count);
+
+/**
+ * @brief         Get the free space of the sample ring
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Number of samples that can be pushed without backpressure
+ */
+uint16_t coc_app_free_space(void);
+
+/**
+ * @brief         Get the number of samples coc_app_push() refused because the ring was full
+ *
+ * @param[in]     None
+ *
+ * @attention     A sample refused again on each retry counts each time, so the count grows by
+ *                one for every push the producer had to hold back
+ *
+ * @return        Number of refused samples since init
+ */
+uint32_t coc_app_refused_count(void);
+
+#endif // __COC_APP_H
+
+#ifdef __cplusplus
+};
+#endif
+
+/* End of file -------------------------------------------------------- */
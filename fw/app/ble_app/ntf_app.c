@@ -0,0 +1,295 @@
+/**
+ * @file       ntf_app.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Coalesced notification of the vitals characteristics
+ * @note       The measurement apps only publish to the sensor cache.  This app compares each
+ *             stream version with the one last notified on a connection, so whatever changed
+ *             during a period goes out in one multiple handle value notification.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "dm_api.h"
+#include "att_api.h"
+
+#include "ntf_app.h"
+#include "sensor_cache.h"
+
+/* Private defines ---------------------------------------------------- */
+#define NTF_APP_PENDING_PERIODS       (2)       // Periods a connection waits for confirms before resending
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+// Connection control block
+typedef struct
+{
+  bool_t          active;                         // Connection open
+  uint8_t         pending;                        // Characteristics whose confirm is still expected, one bit each
+  uint8_t         wait;                           // Periods the pending confirms have been waited for
+  uint32_t        sent_version[NTF_APP_CHAR_MAX]; // Stream version last notified per characteristic
+}
+ntf_app_conn_t;
+
+// Control block
+static struct
+{
+  ntf_app_conn_t  conn[DM_CONN_MAX];  // Connection control block
+  wsfTimer_t      timer;              // Notification period timer
+  ntf_app_cfg_t   cfg;                // Configurable parameters
+}
+ntf_cb;
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+static void m_ntf_timer_exp(void);
+static void m_ntf_send(dmConnId_t conn_id, ntf_app_conn_t *p_conn);
+static void m_ntf_resend_pending(ntf_app_conn_t *p_conn);
+static void m_ntf_handle_value_confirm(attEvt_t *p_msg);
+static bool_t m_ntf_no_conn_active(void);
+static int8_t m_ntf_find_char(uint16_t handle);
+
+/* Function definitions ----------------------------------------------- */
+void ntf_app_init(wsfHandlerId_t handler_id, uint8_t timer_evt, ntf_app_cfg_t *p_cfg)
+{
+  WSF_ASSERT(p_cfg->num_char <= NTF_APP_CHAR_MAX);
+
+  ntf_cb.timer.handlerId = handler_id;
+  ntf_cb.timer.msg.event = timer_evt;
+  ntf_cb.cfg = *p_cfg;
+}
+
+void ntf_app_process_msg(wsfMsgHdr_t *p_msg)
+{
+  ntf_app_conn_t *p_conn;
+
+  if (p_msg->event == DM_CONN_OPEN_IND)
+  {
+    // Start timer on first connection
+    if (m_ntf_no_conn_active())
+    {
+      WsfTimerStartMs(&ntf_cb.timer, ntf_cb.cfg.period);
+    }
+
+    // Nothing notified yet, the first period sends every enabled value
+    p_conn = &ntf_cb.conn[p_msg->param - 1];
+    memset(p_conn, 0, sizeof(ntf_app_conn_t));
+    p_conn->active = TRUE;
+  }
+  else if (p_msg->event == DM_CONN_CLOSE_IND)
+  {
+    ntf_cb.conn[p_msg->param - 1].active = FALSE;
+
+    // Stop timer after last connection
+    if (m_ntf_no_conn_active())
+    {
+      WsfTimerStop(&ntf_cb.timer);
+    }
+  }
+  else if (p_msg->event == ATTS_HANDLE_VALUE_CNF)
+  {
+    m_ntf_handle_value_confirm((attEvt_t *) p_msg);
+  }
+  else if (p_msg->event == ntf_cb.timer.msg.event)
+  {
+    m_ntf_timer_exp();
+  }
+}
+
+/* Private function definitions --------------------------------------- */
+/**
+ * @brief         Send the values updated during the period on every connection
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_ntf_timer_exp(void)
+{
+  ntf_app_conn_t *p_conn = ntf_cb.conn;
+  uint8_t i;
+
+  for (i = 0; i < DM_CONN_MAX; i++, p_conn++)
+  {
+    if (!p_conn->active)
+    {
+      continue;
+    }
+
+    // Skip connections still sending the previous period, their values go out next period
+    if ((p_conn->pending != 0) && (++p_conn->wait < NTF_APP_PENDING_PERIODS))
+    {
+      continue;
+    }
+
+    // Confirms not received by now will not come, send those values again
+    m_ntf_resend_pending(p_conn);
+    m_ntf_send(i + 1, p_conn);
+  }
+
+  // Restart timer
+  WsfTimerStartMs(&ntf_cb.timer, ntf_cb.cfg.period);
+}
+
+/**
+ * @brief         Send the updated values of the enabled characteristics on a connection
+ *
+ * @param[in]     conn_id   DM connection identifier
+ * @param[in]     p_conn    Connection control block
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_ntf_send(dmConnId_t conn_id, ntf_app_conn_t *p_conn)
+{
+  attsHandleValue_t    values[NTF_APP_CHAR_MAX];
+  sensor_cache_value_t value;
+  const ntf_app_char_t *p_char;
+  attsGroup_t          *p_group;
+  attsAttr_t           *p_attr;
+  uint8_t              stream;
+  uint8_t              num = 0;
+  uint8_t              i;
+
+  for (i = 0; i < ntf_cb.cfg.num_char; i++)
+  {
+    p_char  = &ntf_cb.cfg.p_char[i];
+    p_group = p_char->p_svc->p_group;
+    stream  = p_char->p_svc->p_stream[p_char->handle - p_group->startHandle];
+
+    if (!AttsCccEnabled(conn_id, p_char->ccc_idx) ||
+        !sensor_cache_get((sensor_cache_id_t) stream, &value) ||
+        (value.version == p_conn->sent_version[i]))
+    {
+      continue;
+    }
+
+    // Refresh the characteristic value from its stream
+    p_attr = &p_group->pAttr[p_char->handle - p_group->startHandle];
+    ble_svc_read(p_char->p_svc, p_char->handle, p_attr);
+
+    values[num].handle   = p_char->handle;
+    values[num].valueLen = *p_attr->pLen;
+    values[num].pValue   = p_attr->pValue;
+    num++;
+
+    p_conn->sent_version[i] = value.version;
+    p_conn->pending |= (1 << i);
+  }
+
+  if (num > 0)
+  {
+    p_conn->wait = 0;
+    AttsHandleValueMultNtf(conn_id, num, values);
+  }
+}
+
+/**
+ * @brief         Send the values whose confirm is still expected again next time
+ *
+ * @param[in]     p_conn    Connection control block
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_ntf_resend_pending(ntf_app_conn_t *p_conn)
+{
+  uint8_t i;
+
+  for (i = 0; i < ntf_cb.cfg.num_char; i++)
+  {
+    if (p_conn->pending & (1 << i))
+    {
+      p_conn->sent_version[i] = 0;
+    }
+  }
+
+  p_conn->pending = 0;
+  p_conn->wait = 0;
+}
+
+/**
+ * @brief         Handle a received ATT handle value confirm
+ *
+ * @param[in]     p_msg     Event message.
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_ntf_handle_value_confirm(attEvt_t *p_msg)
+{
+  ntf_app_conn_t *p_conn = &ntf_cb.conn[p_msg->hdr.param - 1];
+  int8_t idx;
+
+  if (((idx = m_ntf_find_char(p_msg->handle)) < 0) || !(p_conn->pending & (1 << idx)))
+  {
+    return;
+  }
+
+  p_conn->pending &= ~(1 << idx);
+
+  // Send the value again next period
+  if (p_msg->hdr.status != ATT_SUCCESS)
+  {
+    p_conn->sent_version[idx] = 0;
+  }
+}
+
+/**
+ * @brief         Return TRUE if no connections active
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        TRUE if no connections active
+ */
+static bool_t m_ntf_no_conn_active(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < DM_CONN_MAX; i++)
+  {
+    if (ntf_cb.conn[i].active)
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+ * @brief         Find a notified characteristic by value handle
+ *
+ * @param[in]     handle    Characteristic value handle
+ *
+ * @attention     None
+ *
+ * @return        Index in the characteristic list, -1 if not notified by this app
+ */
+static int8_t m_ntf_find_char(uint16_t handle)
+{
+  uint8_t i;
+
+  for (i = 0; i < ntf_cb.cfg.num_char; i++)
+  {
+    if (ntf_cb.cfg.p_char[i].handle == handle)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,86 @@
+/**
+ * @file       ntf_app.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Coalesced notification of the vitals characteristics
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __NTF_APP_H
+#define __NTF_APP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_os.h"
+#include "wsf_timer.h"
+#include "att_api.h"
+#include "ble_svc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define NTF_APP_CHAR_MAX              (8)       // Maximum number of notified characteristics, one pending bit each
+
+/* Public enumerate/structure ----------------------------------------- */
+// Notified characteristic, its value must be bound to a sample stream
+typedef struct
+{
+  const ble_svc_t *p_svc;     // Service descriptor
+  uint16_t        handle;     // Characteristic value handle
+  uint8_t         ccc_idx;    // Index of its CCC descriptor in CCC descriptor handle table
+}
+ntf_app_char_t;
+
+// Notification configurable parameters
+typedef struct
+{
+  wsfTimerTicks_t       period;     // Notification period in ms, values updated within it share a PDU
+  const ntf_app_char_t  *p_char;    // Notified characteristics
+  uint8_t               num_char;   // Number of notified characteristics
+}
+ntf_app_cfg_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Initialize the notification application
+ *
+ * @param[in]     handler_id  WSF handler ID for App
+ * @param[in]     timer_evt   WSF event designated by the application for the timer
+ * @param[in]     p_cfg       Notification configurable parameters
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void ntf_app_init(wsfHandlerId_t handler_id, uint8_t timer_evt, ntf_app_cfg_t *p_cfg);
+
+/**
+ * @brief         Process received WSF message: connection open and close, handle value confirm
+ *                and the notification timer.
+ *
+ * @param[in]     p_msg     Event message.
+ *
+ * @attention     Each period, every connection gets one AttsHandleValueMultNtf() with the
+ *                characteristics whose CCC is enabled and whose stream was published since
+ *                their last notification.  Clients without multiple handle value notification
+ *                support get one notification per characteristic.
+ *
+ * @return        None
+ */
+void ntf_app_process_msg(wsfMsgHdr_t *p_msg);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // __NTF_APP_H
+
+/* End of file -------------------------------------------------------- */
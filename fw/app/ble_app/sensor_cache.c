@@ -0,0 +1,119 @@
+/**
+ * @file       sensor_cache.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Published sensor value cache served to the GATT read callbacks
+ * @note       Each value has two slots and a sequence number.  The producer fills the slot the
+ *             readers are not using and then bumps the sequence number, which selects the slot.
+ *             A reader copies the selected slot and retries only if the producer published
+ *             twice meanwhile, so a reader that preempts the producer never waits.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "max32665.h"
+#include "bsp.h"
+
+#include "sensor_cache.h"
+
+/* Private defines ---------------------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+// Value slot
+typedef struct
+{
+  uint32_t timestamp;                       // Publish time in ms
+  uint8_t  len;                             // Value length
+  uint8_t  value[SENSOR_CACHE_VALUE_MAX];   // Value
+}
+sensor_cache_slot_t;
+
+// Cache entry
+typedef struct
+{
+  volatile uint32_t   seq;                  // Publish count, slot[seq & 1] is the latest
+  sensor_cache_slot_t slot[2];              // Latest and previous value
+}
+sensor_cache_entry_t;
+
+/* Public variables --------------------------------------------------- */
+/* Private variables -------------------------------------------------- */
+static sensor_cache_entry_t m_sensor_cache[SENSOR_CACHE_ID_MAX];
+
+/* Private function prototypes ---------------------------------------- */
+/* Function definitions ----------------------------------------------- */
+void sensor_cache_publish(sensor_cache_id_t id, const void *p_value, uint8_t len)
+{
+  sensor_cache_entry_t *p_entry;
+  sensor_cache_slot_t  *p_slot;
+  uint32_t seq;
+
+  WSF_ASSERT(id < SENSOR_CACHE_ID_MAX);
+  WSF_ASSERT(len <= SENSOR_CACHE_VALUE_MAX);
+
+  p_entry = &m_sensor_cache[id];
+  seq     = p_entry->seq + 1;
+  p_slot  = &p_entry->slot[seq & 1];
+
+  // Fill the slot readers are not using
+  p_slot->timestamp = bsp_get_tick();
+  p_slot->len       = len;
+  memcpy(p_slot->value, p_value, len);
+
+  // Make the slot visible before selecting it
+  __DMB();
+  p_entry->seq = seq;
+}
+
+bool_t sensor_cache_get(sensor_cache_id_t id, sensor_cache_value_t *p_value)
+{
+  sensor_cache_entry_t *p_entry;
+  sensor_cache_slot_t  *p_slot;
+  uint32_t seq;
+
+  WSF_ASSERT(id < SENSOR_CACHE_ID_MAX);
+
+  p_entry = &m_sensor_cache[id];
+
+  do
+  {
+    seq = p_entry->seq;
+    if (seq == 0)
+    {
+      return FALSE;
+    }
+
+    __DMB();
+    p_slot = &p_entry->slot[seq & 1];
+    p_value->timestamp = p_slot->timestamp;
+    p_value->len       = p_slot->len;
+    memcpy(p_value->value, p_slot->value, p_slot->len);
+    __DMB();
+
+    // The slot is only rewritten after a second publish
+  } while ((p_entry->seq - seq) >= 2);
+
+  p_value->version = seq;
+
+  return TRUE;
+}
+
+uint32_t sensor_cache_age(sensor_cache_id_t id)
+{
+  sensor_cache_value_t value;
+
+  if (!sensor_cache_get(id, &value))
+  {
+    return SENSOR_CACHE_AGE_NONE;
+  }
+
+  return bsp_get_tick() - value.timestamp;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,99 @@
+/**
+ * @file       sensor_cache.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Published sensor value cache served to the GATT read callbacks
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SENSOR_CACHE_H
+#define __SENSOR_CACHE_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define SENSOR_CACHE_VALUE_MAX        (4)       // Largest value in bytes
+#define SENSOR_CACHE_AGE_NONE         (0xFFFFFFFF)  // Age of a value never published
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Cached sensor value ID
+ */
+typedef enum
+{
+  SENSOR_CACHE_TEMP,          // Body temperature, float in Celsius
+  SENSOR_CACHE_SPO2,          // SpO2, uint8_t in %
+  SENSOR_CACHE_HEART_RATE,    // Heart rate, uint8_t in bpm
+  SENSOR_CACHE_BATT_LEVEL,    // Battery level, uint8_t in %
+  SENSOR_CACHE_ID_MAX
+}
+sensor_cache_id_t;
+
+/**
+ * @brief Cached sensor value
+ */
+typedef struct
+{
+  uint32_t version;                         // Number of times the value was published
+  uint32_t timestamp;                       // bsp_get_tick() in ms when the value was published
+  uint8_t  len;                             // Value length in bytes
+  uint8_t  value[SENSOR_CACHE_VALUE_MAX];   // Value in its characteristic format
+}
+sensor_cache_value_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Publish a new sensor value
+ *
+ * @param[in]     id        Value ID
+ * @param[in]     p_value   Value in its characteristic format
+ * @param[in]     len       Value length, at most SENSOR_CACHE_VALUE_MAX
+ *
+ * @attention     One producer per value ID. May be called from interrupt context.
+ *
+ * @return        None
+ */
+void sensor_cache_publish(sensor_cache_id_t id, const void *p_value, uint8_t len);
+
+/**
+ * @brief         Get the latest published sensor value without touching the sensor
+ *
+ * @param[in]     id        Value ID
+ * @param[out]    p_value   Copy of the value, its version and timestamp
+ *
+ * @attention     None
+ *
+ * @return        TRUE if the value was ever published, FALSE otherwise
+ */
+bool_t sensor_cache_get(sensor_cache_id_t id, sensor_cache_value_t *p_value);
+
+/**
+ * @brief         Get the time since a sensor value was published
+ *
+ * @param[in]     id        Value ID
+ *
+ * @attention     None
+ *
+ * @return        Age in ms, SENSOR_CACHE_AGE_NONE if never published
+ */
+uint32_t sensor_cache_age(sensor_cache_id_t id);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // __SENSOR_CACHE_H
+
+/* End of file -------------------------------------------------------- */
@@ -32,16 +32,49 @@
 #include "dm_api.h"
 #include "att_api.h"
 #include "app_api.h"
+#include "wsf_nvm.h"
+#include "util/sha256.h"
 #include "flc.h"
-#include "hash.h"
 
 #define SHA256_BYTES            (256/8)
 
 #define FLASH_START_ADDR        MXC_FLASH1_MEM_BASE
 #define FLASH_END_ADDR          (MXC_FLASH1_MEM_BASE + MXC_FLASH_MEM_SIZE)
 
+/* NVM item holding the digest state of an interrupted transfer */
+#define WDXS_FILE_NVM_HASH_ID   0x57445800
+#define WDXS_FILE_NVM_HASH_LEN  (4 + (4 * SHA256_STATE_WORDS))
+
+/* Bytes digested between two saves of the digest state */
+#define WDXS_FILE_HASH_SAVE_LEN MXC_FLASH_PAGE_SIZE
+
+/* Flash write unit, FLC_Write128() */
+#define WDXS_FILE_LINE_LEN      16
+
+/* No line buffered, not a flash address */
+#define WDXS_FILE_LINE_NONE     0
+
 static uint32_t verifyLen;
 
+/* Line being written, combines the chunks of the file into whole flash lines */
+static uint32_t wdxsFileLine[WDXS_FILE_LINE_LEN / 4];
+
+/* Address of the buffered line */
+static uint32_t wdxsFileLineAddr = WDXS_FILE_LINE_NONE;
+
+/* Pages from wdxsFileEraseAddr to wdxsFileEraseEnd are erased as the writes reach them */
+static uint32_t wdxsFileEraseAddr;
+static uint32_t wdxsFileEraseEnd;
+
+/* Digest of the media from its start address, fed as the file is written */
+static sha256Ctx_t wdxsFileHash;
+
+/* Length of the digest state saved in NVM */
+static uint32_t wdxsFileHashSaved;
+
+/* TRUE if the digest state was restored from NVM */
+static bool_t wdxsFileHashResumed;
+
 /* Prototypes for file functions */
 static uint8_t wdxsFileInitMedia(void);
 static uint8_t wdxsFileErase(uint32_t address, uint32_t size);
@@ -62,6 +95,194 @@ static const wsfEfsMedia_t WDXS_FileMedia =
   /*   wsfMediaHandleCmdFunc_t *handleCmd;    Media command handler callback. */  wsfFileHandle
 };
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Restart the digest of the file and drop the saved digest state.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wdxsFileHashReset(void)
+{
+  Sha256Init(&wdxsFileHash);
+
+  if((wdxsFileHashSaved != 0) || wdxsFileHashResumed) {
+    WsfNvmEraseData(WDXS_FILE_NVM_HASH_ID, NULL);
+  }
+
+  wdxsFileHashSaved = 0;
+  wdxsFileHashResumed = FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Save the digest state so an interrupted transfer can resume it.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wdxsFileHashSave(void)
+{
+  uint8_t buf[WDXS_FILE_NVM_HASH_LEN];
+  uint8_t *p = buf;
+  uint8_t i;
+
+  /* Only whole blocks are digested while streaming, the partial block is always empty */
+  UINT32_TO_BSTREAM(p, wdxsFileHash.len);
+
+  for(i = 0; i < SHA256_STATE_WORDS; i++) {
+    UINT32_TO_BSTREAM(p, wdxsFileHash.state[i]);
+  }
+
+  if(WsfNvmWriteData(WDXS_FILE_NVM_HASH_ID, buf, WDXS_FILE_NVM_HASH_LEN, NULL)) {
+    wdxsFileHashSaved = wdxsFileHash.len;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Restore the digest state of an interrupted transfer.
+ *
+ *  \return TRUE if a digest state was restored.
+ */
+/*************************************************************************************************/
+static bool_t wdxsFileHashLoad(void)
+{
+  uint8_t buf[WDXS_FILE_NVM_HASH_LEN];
+  uint8_t *p = buf;
+  uint32_t len;
+  uint8_t i;
+
+  Sha256Init(&wdxsFileHash);
+  wdxsFileHashSaved = 0;
+  wdxsFileHashResumed = FALSE;
+
+  if(!WsfNvmReadData(WDXS_FILE_NVM_HASH_ID, buf, WDXS_FILE_NVM_HASH_LEN, NULL)) {
+    return FALSE;
+  }
+
+  BSTREAM_TO_UINT32(len, p);
+
+  if((len == 0) || (len % SHA256_BLOCK_LEN != 0) ||
+     (len > WDXS_FileMedia.endAddress - WDXS_FileMedia.startAddress)) {
+    return FALSE;
+  }
+
+  wdxsFileHash.len = len;
+
+  for(i = 0; i < SHA256_STATE_WORDS; i++) {
+    BSTREAM_TO_UINT32(wdxsFileHash.state[i], p);
+  }
+
+  wdxsFileHashSaved = len;
+  wdxsFileHashResumed = TRUE;
+
+  APP_TRACE_INFO1("WDXS resuming file digest at %u", len);
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Digest the media up to the given length of the file.
+ *
+ *  \param  len      Length of the file to digest.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wdxsFileHashTo(uint32_t len)
+{
+  /* Digested from flash, what a full pass over the media at validation would read */
+  if(len > wdxsFileHash.len) {
+    Sha256Update(&wdxsFileHash, (const uint8_t *)(WDXS_FileMedia.startAddress + wdxsFileHash.len),
+                 len - wdxsFileHash.len);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write the buffered line to flash.
+ *
+ *  \return Status of the operation.
+ */
+/*************************************************************************************************/
+static uint8_t wdxsFileFlush(void)
+{
+  uint32_t addr = wdxsFileLineAddr;
+
+  if(addr == WDXS_FILE_LINE_NONE) {
+    return WSF_EFS_SUCCESS;
+  }
+
+  wdxsFileLineAddr = WDXS_FILE_LINE_NONE;
+
+  /* The line was loaded from flash, reprogramming unchanged bytes is what FLC_Write32() does */
+  if(FLC_Write128(addr, wdxsFileLine) != E_NO_ERROR) {
+    return WSF_EFS_FAILURE;
+  }
+
+  return WSF_EFS_SUCCESS;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase the pending pages below the given address.
+ *
+ *  \param  address  End address of the region that must be erased.
+ *
+ *  \return Status of the operation.
+ */
+/*************************************************************************************************/
+static uint8_t wdxsFileEraseTo(uint32_t address)
+{
+  if(address > wdxsFileEraseEnd) {
+    address = wdxsFileEraseEnd;
+  }
+
+  while(wdxsFileEraseAddr < address) {
+    if(FLC_PageErase(wdxsFileEraseAddr) != E_NO_ERROR) {
+      return WSF_EFS_FAILURE;
+    }
+
+    wdxsFileEraseAddr += MXC_FLASH_PAGE_SIZE;
+  }
+
+  return WSF_EFS_SUCCESS;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the pending pages of an interrupted transfer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wdxsFileEraseResume(void)
+{
+  uint32_t addr = WDXS_FileMedia.startAddress + (wdxsFileHash.len & ~(MXC_FLASH_PAGE_SIZE - 1));
+  const uint32_t *p;
+
+  /* The pages were erased one ahead of the writes, the first blank page past the digested data
+   * is the last erased one.
+   */
+  for(; addr < WDXS_FileMedia.endAddress; addr += MXC_FLASH_PAGE_SIZE) {
+    for(p = (const uint32_t *)addr; p < (const uint32_t *)(addr + MXC_FLASH_PAGE_SIZE); p++) {
+      if(*p != 0xFFFFFFFF) {
+        break;
+      }
+    }
+
+    if(p == (const uint32_t *)(addr + MXC_FLASH_PAGE_SIZE)) {
+      addr += MXC_FLASH_PAGE_SIZE;
+      break;
+    }
+  }
+
+  wdxsFileEraseAddr = addr;
+  wdxsFileEraseEnd = WDXS_FileMedia.endAddress;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Media Init function, called when media is registered.
@@ -71,12 +292,20 @@ static const wsfEfsMedia_t WDXS_FileMedia =
 /*************************************************************************************************/
 static uint8_t wdxsFileInitMedia(void)
 {
+  /* Keep the data of an interrupted transfer, its digest resumes where it was saved */
+  if(wdxsFileHashLoad()) {
+    wdxsFileEraseResume();
+    return WSF_EFS_SUCCESS;
+  }
+
   return wdxsFileErase(WDXS_FileMedia.startAddress, WDXS_FileMedia.endAddress - WDXS_FileMedia.startAddress);
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief  File erase function. Must be page aligned.
+ *  \brief  File erase function. Must be page aligned. The pages are erased as the writes reach
+ *          them, the receive of the file overlaps with the erase of the region instead of waiting
+ *          for it.
  *
  *  \param  address  Address in media to start erasing.
  *  \param  size     Number of bytes to erase.
@@ -86,17 +315,32 @@ static uint8_t wdxsFileInitMedia(void)
 /*************************************************************************************************/
 static uint8_t wdxsFileErase(uint32_t address, uint32_t size)
 {
-  /* See if we can mass erase one of the flash arrays */
-  if((address == MXC_FLASH1_MEM_BASE) && (size = MXC_FLASH_MEM_SIZE)) {
-    if(FLC_MassEraseInst(1) == E_NO_ERROR) {
-      return WSF_EFS_SUCCESS;
-    }
+  /* Erasing digested data invalidates the digest */
+  if(address < WDXS_FileMedia.startAddress + wdxsFileHash.len) {
+    wdxsFileHashReset();
   }
-  /* Page erase the flash sections */
-  if(FLC_MultiPageErase(address, address+size) == E_NO_ERROR) {
-    return WSF_EFS_SUCCESS;
+
+  /* Drop a buffered line of the region, keep one outside it */
+  if((wdxsFileLineAddr >= address) && (wdxsFileLineAddr < address + size)) {
+    wdxsFileLineAddr = WDXS_FILE_LINE_NONE;
+  }
+  else if(wdxsFileFlush() != WSF_EFS_SUCCESS) {
+    return WSF_EFS_FAILURE;
+  }
+
+  /* Pages still pending from a previous erase outside this region are erased now */
+  if((wdxsFileEraseAddr < wdxsFileEraseEnd) &&
+     ((wdxsFileEraseAddr < address) || (wdxsFileEraseEnd > address + size))) {
+    if(wdxsFileEraseTo(wdxsFileEraseEnd) != WSF_EFS_SUCCESS) {
+      return WSF_EFS_FAILURE;
+    }
   }
-  return WSF_EFS_FAILURE;
+
+  wdxsFileEraseAddr = address;
+  wdxsFileEraseEnd = address + size;
+
+  /* Erase the first page now, the next ones follow the writes */
+  return wdxsFileEraseTo(address + MXC_FLASH_PAGE_SIZE);
 }
 
 /*************************************************************************************************/
@@ -112,7 +356,20 @@ static uint8_t wdxsFileErase(uint32_t address, uint32_t size)
 /*************************************************************************************************/
 static uint8_t wdxsFileRead(uint8_t *pBuf, uint32_t address, uint32_t len)
 {
-  memcpy(pBuf, (uint32_t*)address, len);
+  uint32_t erased = len;
+
+  if(wdxsFileFlush() != WSF_EFS_SUCCESS) {
+    return WSF_EFS_FAILURE;
+  }
+
+  /* Pages waiting to be erased read as erased */
+  if((address + len > wdxsFileEraseAddr) && (address < wdxsFileEraseEnd)) {
+    erased = (address > wdxsFileEraseAddr) ? 0 : (wdxsFileEraseAddr - address);
+  }
+
+  memcpy(pBuf, (uint32_t*)address, erased);
+  memset(pBuf + erased, 0xFF, len - erased);
+
   return WSF_EFS_SUCCESS;
 }
 
@@ -129,10 +386,69 @@ static uint8_t wdxsFileRead(uint8_t *pBuf, uint32_t address, uint32_t len)
 /*************************************************************************************************/
 static uint8_t wdxsFileWrite(const uint8_t *pBuf, uint32_t address, uint32_t size)
 {
-  if(FLC_Write(address, size, (uint32_t *)pBuf) == E_NO_ERROR) {
-    return WSF_EFS_SUCCESS;
+  uint32_t offset = address - WDXS_FileMedia.startAddress;
+  uint32_t end = offset + size;
+  uint32_t lineAddr;
+  uint32_t len;
+
+  /* Chunks are combined into whole lines, FLC_Write() would write unaligned words */
+  while(size > 0) {
+    lineAddr = address & ~(WDXS_FILE_LINE_LEN - 1);
+
+    if(lineAddr != wdxsFileLineAddr) {
+      if(wdxsFileFlush() != WSF_EFS_SUCCESS) {
+        return WSF_EFS_FAILURE;
+      }
+
+      /* Load the line once its page is erased, it may hold data of an earlier chunk */
+      if(wdxsFileEraseTo(lineAddr + WDXS_FILE_LINE_LEN) != WSF_EFS_SUCCESS) {
+        return WSF_EFS_FAILURE;
+      }
+
+      memcpy(wdxsFileLine, (const uint32_t *)lineAddr, WDXS_FILE_LINE_LEN);
+      wdxsFileLineAddr = lineAddr;
+    }
+
+    len = lineAddr + WDXS_FILE_LINE_LEN - address;
+    if(len > size) {
+      len = size;
+    }
+
+    memcpy((uint8_t *)wdxsFileLine + (address - lineAddr), pBuf, len);
+    address += len;
+    pBuf += len;
+    size -= len;
+
+    if(address == lineAddr + WDXS_FILE_LINE_LEN) {
+      if(wdxsFileFlush() != WSF_EFS_SUCCESS) {
+        return WSF_EFS_FAILURE;
+      }
+    }
   }
-  return WSF_EFS_FAILURE;
+
+  /* Keep the next page erased ahead of the writes */
+  if(wdxsFileEraseTo(address + MXC_FLASH_PAGE_SIZE) != WSF_EFS_SUCCESS) {
+    return WSF_EFS_FAILURE;
+  }
+
+  /* Rewriting digested data, start the digest over */
+  if(offset < wdxsFileHash.len) {
+    wdxsFileHashReset();
+  }
+
+  /* The file ends with its digest, keep the last SHA256_BYTES out until the length is known.
+   * Whole blocks only, so the state can be saved without the partial block. The buffered line
+   * is within the last SHA256_BYTES, the digested data is in flash.
+   */
+  if(end > SHA256_BYTES) {
+    wdxsFileHashTo((end - SHA256_BYTES) & ~(SHA256_BLOCK_LEN - 1));
+  }
+
+  if(wdxsFileHash.len - wdxsFileHashSaved >= WDXS_FILE_HASH_SAVE_LEN) {
+    wdxsFileHashSave();
+  }
+
+  return WSF_EFS_SUCCESS;
 }
 
 /*************************************************************************************************/
@@ -150,7 +466,10 @@ static uint8_t wsfFileHandle(uint8_t cmd, uint32_t param)
   switch(cmd) {
     case WSF_EFS_WDXS_PUT_COMPLETE_CMD:
     {
-      /* Currently unimplemented */
+      /* Write the last line of the file */
+      if(wdxsFileFlush() != WSF_EFS_SUCCESS) {
+        return WDX_FTC_ST_VERIFICATION;
+      }
       return WDX_FTC_ST_SUCCESS;
     }
     break;
@@ -160,16 +479,43 @@ static uint8_t wsfFileHandle(uint8_t cmd, uint32_t param)
       /* Validate the image with SHA256, digest is last 256 bits of the file */
       /* param holds the total file length */
 
-      char digest[SHA256_BYTES];
+      uint8_t digest[SHA256_BYTES];
+      const uint8_t *pFileDigest = (const uint8_t *)(WDXS_FileMedia.startAddress + param - SHA256_BYTES);
+      bool_t match;
+
+      if((param < SHA256_BYTES) || (param > WDXS_FileMedia.endAddress - WDXS_FileMedia.startAddress)) {
+        return WDX_FTC_ST_VERIFICATION;
+      }
+
+      /* The whole file must be in flash, parts never written read as erased */
+      if((wdxsFileFlush() != WSF_EFS_SUCCESS) ||
+         (wdxsFileEraseTo(WDXS_FileMedia.startAddress + param) != WSF_EFS_SUCCESS)) {
+        return WDX_FTC_ST_VERIFICATION;
+      }
+
+      /* Digested past the image, e.g. stale data after a shorter file, start over */
+      if(wdxsFileHash.len > param - SHA256_BYTES) {
+        wdxsFileHashReset();
+      }
+
+      /* Most of the file was digested as it was written, finish the tail */
+      wdxsFileHashTo(param - SHA256_BYTES);
+      Sha256Final(&wdxsFileHash, digest);
+      match = (memcmp(digest, pFileDigest, SHA256_BYTES) == 0);
+
+      /* A state restored from NVM may not match the flash, digest the whole image again */
+      if(!match && wdxsFileHashResumed) {
+        Sha256Init(&wdxsFileHash);
+        wdxsFileHashTo(param - SHA256_BYTES);
+        Sha256Final(&wdxsFileHash, digest);
+        match = (memcmp(digest, pFileDigest, SHA256_BYTES) == 0);
+      }
+
+      /* The context was finished, the next transfer digests from the start */
+      wdxsFileHashReset();
 
-      /* Calculate the digest */
-      TPU_Hash_Reset();
-      TPU_Hash_Config(TPU_HASH_SHA256);
-      TPU_SHA((const char *)WDXS_FileMedia.startAddress, TPU_HASH_SHA256, (param - SHA256_BYTES), digest);
-      TPU_Hash_Shutdown();
-      
       /* Check the calculated digest against what was received */
-      if(memcmp(digest, (const char *)(WDXS_FileMedia.startAddress + param - SHA256_BYTES), SHA256_BYTES) != 0) {
+      if(!match) {
         return WDX_FTC_ST_VERIFICATION;
       }
 
@@ -16,26 +16,32 @@
 
 /* Includes ----------------------------------------------------------- */
 #include "att_api.h"
+#include "ble_svc.h"
 
 /* Public defines ----------------------------------------------------- */
 #define BAS_START_HDL   0x60               // Service start handle
 #define BAS_END_HDL     (BAS_MAX_HDL - 1)  // Service end handle
 
+// Battery service table, see ble_svc.h
+#define BAS_SVC_TABLE(SVC, CHAR, CHAR_CCC)                                                        \
+  SVC     (BAS,     (UINT16_TO_BYTES(ATT_UUID_BATTERY_SERVICE)))                                  \
+  CHAR_CCC(BAS_LVL, (UINT16_TO_BYTES(ATT_UUID_BATTERY_LEVEL)), (ATT_PROP_READ | ATT_PROP_NOTIFY), \
+           BATT_SEC_PERMIT_READ, m_batt_level, SENSOR_CACHE_BATT_LEVEL, DM_SEC_LEVEL_NONE)
+
 /* Public enumerate/structure ----------------------------------------- */
 /**
- * @brief Battery Service event type
+ * @brief Battery Service handles
  */
 enum
 {
-  BAS_SVC_HDL = BAS_START_HDL,         //  BAS service declaration
-  BAS_LVL_CH_HDL,                      //  BAS level characteristic
-  BAS_LVL_HDL,                         //  BAS level
-  BAS_LVL_CH_CCC_HDL,                  //  BAS level CCCD
+  BLE_SVC_HDL_LIST(BAS_SVC_TABLE)
   BAS_MAX_HDL                          //  Maximum handle.
 };
 
 /* Public macros ------------------------------------------------------ */
 /* Public variables --------------------------------------------------- */
+BLE_SVC_DECLARE(bas);
+
 /* Public function prototypes ----------------------------------------- */
 /**
  * @brief         Function for initializing the Battery Service.
@@ -48,18 +54,6 @@ enum
  */
 void ble_bas_init();
 
-/**
- * @brief         Register callbacks for the service
- *
- * @param[in]     read_cb    Read callback function
- * @param[in]     write_cb   Write callback function
- * 
- * @attention     None
- *
- * @return        None
- */
-void ble_bas_callback_register(attsReadCback_t read_cb, attsWriteCback_t write_cb);
-
 #endif // __BLE_BAS_H
 
 /* End of file -------------------------------------------------------- */
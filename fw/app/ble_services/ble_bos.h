@@ -16,26 +16,43 @@
 
 /* Includes ----------------------------------------------------------- */
 #include "att_api.h"
+#include "ble_svc.h"
 
 /* Public defines ----------------------------------------------------- */
 #define BOS_START_HDL   0x25               /*!< Service start handle. */
 #define BOS_END_HDL     (BOS_MAX_HDL - 1)  /*!< Service end handle. */
 
+#define BLE_UUID_BOS_SERVICE              (0x1234) /**< The part UUID of the Blood Oxygen Service. */
+#define BLE_UUID_BOS_CHARATERISTIC        (0x1235) /**< The part UUID of the Blood Oxygen Charateristic. */
+
+/*! \brief Macro for building BOS UUIDs */
+#define ATT_UUID_BOS_BUILD(part)           0x41, 0xEE, 0x68, 0x3A, 0x99, 0x0F, 0x0E, 0x72, \
+                                           0x85, 0x49, 0x8D, 0xB3, UINT16_TO_BYTES(part),0x00, 0x00
+
+/**< The UUID of the Blood Oxygen Service. */
+#define ATT_UUID_BOS_SERVICE              ATT_UUID_BOS_BUILD(BLE_UUID_BOS_SERVICE)
+#define ATT_UUID_BOS_CHARACTERICSTIC      ATT_UUID_BOS_BUILD(BLE_UUID_BOS_CHARATERISTIC)
+
+/*! \brief Blood oxygen service table, see ble_svc.h */
+#define BOS_SVC_TABLE(SVC, CHAR, CHAR_CCC)                                                        \
+  SVC     (BOS,     (ATT_UUID_BOS_SERVICE))                                                       \
+  CHAR_CCC(BOS_LVL, (ATT_UUID_BOS_CHARACTERICSTIC), (ATT_PROP_READ | ATT_PROP_NOTIFY),            \
+           BOS_SEC_PERMIT_READ, m_spo2, SENSOR_CACHE_SPO2, DM_SEC_LEVEL_NONE)
+
 /* Public enumerate/structure ----------------------------------------- */
 /**
- * @brief Blood Oxygen Service event type
+ * @brief Blood Oxygen Service handles
  */
 enum
 {
-  BOS_SVC_HDL = BOS_START_HDL,         /*!< BOS service declaration */
-  BOS_LVL_CH_HDL,                      /*!< BOS level characteristic */
-  BOS_LVL_HDL,                         /*!< BOS level */
-  BOS_LVL_CH_CCC_HDL,                  /*!< BOS level CCCD */
+  BLE_SVC_HDL_LIST(BOS_SVC_TABLE)
   BOS_MAX_HDL                          /*!< Maximum handle. */
 };
 
 /* Public macros ------------------------------------------------------ */
 /* Public variables --------------------------------------------------- */
+BLE_SVC_DECLARE(bos);
+
 /* Public function prototypes ----------------------------------------- */
 /**
  * @brief         Function for initializing the Blood Oxygen Service.
@@ -48,18 +65,6 @@ enum
  */
 void ble_bos_init();
 
-/**
- * @brief         Register callbacks for the service
- *
- * @param[in]     read_cb    Read callback function
- * @param[in]     write_cb   Write callback function
- * 
- * @attention     None
- *
- * @return        None
- */
-void ble_bos_callback_register(attsReadCback_t read_cb, attsWriteCback_t write_cb);
-
 #endif // __BLE_BOS_H
 
 /* End of file -------------------------------------------------------- */
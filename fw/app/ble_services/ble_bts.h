@@ -16,26 +16,47 @@
 
 /* Includes ----------------------------------------------------------- */
 #include "att_api.h"
+#include "ble_svc.h"
 
 /* Public defines ----------------------------------------------------- */
 #define BTS_START_HDL   0x20                // Service start handle
 #define BTS_END_HDL     (BTS_MAX_HDL - 1)   // Service end handle
 
+#define BLE_UUID_BTS_SERVICE           (0x1231) // The part UUID of the Body Temperature Service
+#define BLE_UUID_BTS_CHARATERISTIC     (0x1232) // The part UUID of the Body Temperature Charateristic
+#define BLE_UUID_BTS_AGE               (0x1233) // The part UUID of the Body Temperature Age Charateristic
+
+// Macro for building BTS UUIDs
+#define ATT_UUID_BTS_BUILD(part)           0x41, 0xEE, 0x68, 0x3A, 0x99, 0x0F, 0x0E, 0x72, \
+                                           0x85, 0x49, 0x8D, 0xB3, UINT16_TO_BYTES(part),0x00, 0x00
+
+// The UUID of the Body Temperature Service
+#define ATT_UUID_BTS_SERVICE              ATT_UUID_BTS_BUILD(BLE_UUID_BTS_SERVICE)
+#define ATT_UUID_BTS_CHARACTERICSTIC      ATT_UUID_BTS_BUILD(BLE_UUID_BTS_CHARATERISTIC)
+#define ATT_UUID_BTS_AGE                  ATT_UUID_BTS_BUILD(BLE_UUID_BTS_AGE)
+
+// Body temperature service table, see ble_svc.h
+#define BTS_SVC_TABLE(SVC, CHAR, CHAR_CCC)                                                        \
+  SVC     (BTS,       (ATT_UUID_BTS_SERVICE))                                                     \
+  CHAR_CCC(BTS_VALUE, (ATT_UUID_BTS_CHARACTERICSTIC), (ATT_PROP_READ | ATT_PROP_NOTIFY),          \
+           BTS_SEC_PERMIT_READ, m_temp, SENSOR_CACHE_TEMP, DM_SEC_LEVEL_NONE)                     \
+  CHAR    (BTS_AGE,   (ATT_UUID_BTS_AGE), ATT_PROP_READ, BTS_SEC_PERMIT_READ, m_temp_age,           \
+           BLE_SVC_STREAM_AGE(SENSOR_CACHE_TEMP))
+
 /* Public enumerate/structure ----------------------------------------- */
 /**
- * @brief Body temperature service event type
+ * @brief Body temperature service handles
  */
 enum
 {
-  BTS_SVC_HDL = BTS_START_HDL,           // BTS service declaration
-  BTS_VALUE_CH_HDL,                      // BTS value characteristic
-  BTS_VALUE_HDL,                         // BTS value
-  BTS_VALUE_CH_CCC_HDL,                  // BTS value CCCD
+  BLE_SVC_HDL_LIST(BTS_SVC_TABLE)
   BTS_MAX_HDL                            // Maximum handle.
 };
 
 /* Public macros ------------------------------------------------------ */
 /* Public variables --------------------------------------------------- */
+BLE_SVC_DECLARE(bts);
+
 /* Public function prototypes ----------------------------------------- */
 /**
  * @brief         Function for initializing the Body temperature service.
@@ -48,18 +69,6 @@ enum
  */
 void ble_bts_init();
 
-/**
- * @brief         Register callbacks for the service
- *
- * @param[in]     read_cb    Read callback function
- * @param[in]     write_cb   Write callback function
- * 
- * @attention     None
- *
- * @return        None
- */
-void ble_bts_callback_register(attsReadCback_t read_cb, attsWriteCback_t write_cb);
-
 #endif // __BLE_BTS_H
 
 /* End of file -------------------------------------------------------- */
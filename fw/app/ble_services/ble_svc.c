@@ -0,0 +1,81 @@
+/**
+ * @file       ble_svc.c
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Declarative GATT service builder
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "util/bstream.h"
+#include "ble_svc.h"
+
+/* Private defines ---------------------------------------------------- */
+/* Private macros ----------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------- */
+/* Public variables --------------------------------------------------- */
+uint8_t ble_svc_ccc_value[sizeof(uint16_t)];
+
+/* Private variables -------------------------------------------------- */
+/* Private function prototypes ---------------------------------------- */
+/* Function definitions ----------------------------------------------- */
+void ble_svc_add(const ble_svc_t *p_svc)
+{
+  AttsAddGroup(p_svc->p_group);
+}
+
+void ble_svc_remove(const ble_svc_t *p_svc)
+{
+  AttsRemoveGroup(p_svc->p_group->startHandle);
+}
+
+uint8_t ble_svc_read(const ble_svc_t *p_svc, uint16_t handle, attsAttr_t *p_attr)
+{
+  sensor_cache_value_t value;
+  uint32_t age;
+  uint8_t stream;
+
+  WSF_ASSERT((handle >= p_svc->p_group->startHandle) && (handle <= p_svc->p_group->endHandle));
+
+  // The stream binding is laid out by handle
+  stream = p_svc->p_stream[handle - p_svc->p_group->startHandle];
+
+  if (stream == BLE_SVC_STREAM_NONE)
+  {
+    return ATT_SUCCESS;
+  }
+
+  if (stream & BLE_SVC_STREAM_AGE_FLAG)
+  {
+    stream &= ~BLE_SVC_STREAM_AGE_FLAG;
+
+    // Age of the value a read of the stream serves
+    age = sensor_cache_age((sensor_cache_id_t) stream);
+    UINT32_TO_BUF(p_attr->pValue, age);
+  }
+  else if (sensor_cache_get((sensor_cache_id_t) stream, &value))
+  {
+    memcpy(p_attr->pValue, value.value, (value.len < p_attr->maxLen) ? value.len : p_attr->maxLen);
+  }
+
+  return ATT_SUCCESS;
+}
+
+void ble_svc_notify(const ble_svc_t *p_svc, dmConnId_t conn_id, uint16_t handle)
+{
+  attsAttr_t *p_attr;
+
+  p_attr = &p_svc->p_group->pAttr[handle - p_svc->p_group->startHandle];
+
+  ble_svc_read(p_svc, handle, p_attr);
+  AttsHandleValueNtf(conn_id, handle, *p_attr->pLen, p_attr->pValue);
+}
+
+/* End of file -------------------------------------------------------- */
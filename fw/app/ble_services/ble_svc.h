@@ -0,0 +1,234 @@
+/**
+ * @file       ble_svc.h
+ * @copyright  Copyright (C) 2020 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2026-10-18
+ * @author     Thuan Le
+ * @brief      Declarative GATT service builder
+ * @note       A service is declared once as a table macro taking three entry macros:
+ *
+ *               #define XXX_SVC_TABLE(SVC, CHAR, CHAR_CCC)                              \
+ *                 SVC     (XXX,     (service uuid bytes))                               \
+ *                 CHAR    (XXX_ABC, (uuid bytes), props, permissions, variable, stream) \
+ *                 CHAR_CCC(XXX_DEF, (uuid bytes), props, permissions, variable, stream, sec level)
+ *
+ *             UUIDs are byte lists in parentheses, 2 or 16 bytes.  Each characteristic value
+ *             is bound to a variable, ATT reads and writes it in place.  When a sample stream
+ *             (sensor_cache_id_t) is given too, reads and notifications serve its latest
+ *             published value, BLE_SVC_STREAM_NONE binds the variable alone.  The sensor is never
+ *             touched from a read, producers keep the values fresh on their own timers.
+ *             BLE_SVC_STREAM_AGE(stream) serves the age of a stream instead, uint32 little
+ *             endian in ms, 0xFFFFFFFF if never published.
+ *
+ *             The same table then generates the handle enum (XXX_SVC_HDL, XXX_ABC_CH_HDL,
+ *             XXX_ABC_HDL, XXX_DEF_CH_CCC_HDL, ...), the const attribute list, the stream
+ *             binding indexed by handle and the CCC index and settings entries for the app.
+ *             Everything except the variables and the ATT group lives in flash.
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __BLE_SVC_H
+#define __BLE_SVC_H
+
+/* Includes ----------------------------------------------------------- */
+#include "wsf_types.h"
+#include "att_api.h"
+#include "att_uuid.h"
+#include "sensor_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Public defines ----------------------------------------------------- */
+#define BLE_SVC_STREAM_NONE           (0xFF)    // Characteristic bound to its variable only
+#define BLE_SVC_STREAM_AGE_FLAG       (0x80)    // Characteristic serves the age of its stream
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Service descriptor
+ */
+typedef struct
+{
+  attsGroup_t   *p_group;     // ATT group, in RAM since ATTS links it
+  const uint8_t *p_stream;    // Sample stream per handle, indexed by handle - start handle
+}
+ble_svc_t;
+
+/* Public macros ------------------------------------------------------ */
+// Byte list helpers, a list is passed around in parentheses so its commas survive
+#define BLE_SVC_EXPAND(...)           __VA_ARGS__
+#define BLE_SVC_BYTES(...)            ((uint8_t *) (const uint8_t []) {__VA_ARGS__})
+#define BLE_SVC_SIZE(...)             sizeof((const uint8_t []) {__VA_ARGS__})
+#define BLE_SVC_LEN(len)              ((uint16_t *) &(const uint16_t) {len})
+#define BLE_SVC_UUID_SET(uuid)        ((BLE_SVC_SIZE uuid == ATT_128_UUID_LEN) ? ATTS_SET_UUID_128 : 0)
+
+// CCC value range from the notify and indicate properties
+#define BLE_SVC_CCC_CFG(props)        (((props) & ATT_PROP_NOTIFY ? ATT_CLIENT_CFG_NOTIFY : 0) | \
+                                       ((props) & ATT_PROP_INDICATE ? ATT_CLIENT_CFG_INDICATE : 0))
+
+// Stream binding of a characteristic serving the age of a stream, bound to a uint32_t variable
+#define BLE_SVC_STREAM_AGE(stream)    (BLE_SVC_STREAM_AGE_FLAG | (stream))
+
+// Entry that generates nothing
+#define BLE_SVC_NONE(...)
+
+// Handle enum entries
+#define BLE_SVC_HDL_SVC(name, uuid)   name##_SVC_HDL = name##_START_HDL,
+#define BLE_SVC_HDL_CHAR(name, ...)   name##_CH_HDL, name##_HDL,
+#define BLE_SVC_HDL_CHAR_CCC(name, ...) \
+                                      name##_CH_HDL, name##_HDL, name##_CH_CCC_HDL,
+
+// Attribute list entries
+#define BLE_SVC_ATTR_SVC(name, uuid)                                                              \
+  {attPrimSvcUuid, BLE_SVC_BYTES uuid, BLE_SVC_LEN(BLE_SVC_SIZE uuid), BLE_SVC_SIZE uuid,         \
+   0, ATTS_PERMIT_READ},
+
+#define BLE_SVC_ATTR_CHAR(name, uuid, props, perm, var, stream)                                   \
+  {attChUuid, BLE_SVC_BYTES((props), UINT16_TO_BYTES(name##_HDL), BLE_SVC_EXPAND uuid),           \
+   BLE_SVC_LEN(3 + BLE_SVC_SIZE uuid), 3 + BLE_SVC_SIZE uuid, 0, ATTS_PERMIT_READ},               \
+  {BLE_SVC_BYTES uuid, (uint8_t *) &(var), BLE_SVC_LEN(sizeof(var)), sizeof(var),                 \
+   BLE_SVC_UUID_SET(uuid) | (((stream) != BLE_SVC_STREAM_NONE) ? ATTS_SET_READ_CBACK : 0),        \
+   (perm)},
+
+#define BLE_SVC_ATTR_CHAR_CCC(name, uuid, props, perm, var, stream, sec)                          \
+  BLE_SVC_ATTR_CHAR(name, uuid, props, perm, var, stream)                                         \
+  {attCliChCfgUuid, ble_svc_ccc_value, BLE_SVC_LEN(sizeof(uint16_t)), sizeof(uint16_t),           \
+   ATTS_SET_CCC, (ATTS_PERMIT_READ | ATTS_PERMIT_WRITE)},
+
+// Stream binding entries, one per handle
+#define BLE_SVC_STREAM_SVC(name, uuid) \
+                                      BLE_SVC_STREAM_NONE,
+#define BLE_SVC_STREAM_CHAR(name, uuid, props, perm, var, stream) \
+                                      BLE_SVC_STREAM_NONE, (stream),
+#define BLE_SVC_STREAM_CHAR_CCC(name, uuid, props, perm, var, stream, sec) \
+                                      BLE_SVC_STREAM_NONE, (stream), BLE_SVC_STREAM_NONE,
+
+// CCC index and settings entries
+#define BLE_SVC_CCC_IDX(name, ...)    name##_CCC_IDX,
+#define BLE_SVC_CCC_SET(name, uuid, props, perm, var, stream, sec) \
+                                      {name##_CH_CCC_HDL, BLE_SVC_CCC_CFG(props), (sec)},
+
+/**
+ * @brief         Generate the handle enum body of a service
+ */
+#define BLE_SVC_HDL_LIST(table)       table(BLE_SVC_HDL_SVC, BLE_SVC_HDL_CHAR, BLE_SVC_HDL_CHAR_CCC)
+
+/**
+ * @brief         Generate the CCC index enum body of a service
+ */
+#define BLE_SVC_CCC_IDX_LIST(table)   table(BLE_SVC_NONE, BLE_SVC_NONE, BLE_SVC_CCC_IDX)
+
+/**
+ * @brief         Generate the attsCccSet_t entries of a service, in CCC index order
+ */
+#define BLE_SVC_CCC_SET_LIST(table)   table(BLE_SVC_NONE, BLE_SVC_NONE, BLE_SVC_CCC_SET)
+
+/**
+ * @brief         Declare the descriptor of a service defined with BLE_SVC_DEFINE()
+ */
+#define BLE_SVC_DECLARE(name)         extern const ble_svc_t ble_##name##_svc
+
+/**
+ * @brief         Define a service: attribute list, stream binding, ATT group, read callback
+ *                and the descriptor ble_<name>_svc.  The bound variables must be declared first.
+ *
+ * @attention     The table must cover NAME##_START_HDL to NAME##_END_HDL exactly, checked at
+ *                compile time.
+ */
+#define BLE_SVC_DEFINE(name, NAME, table)                                                         \
+  static uint8_t m_##name##_read_cb(dmConnId_t conn_id, uint16_t handle, uint8_t operation,       \
+                                    uint16_t offset, attsAttr_t *p_attr);                         \
+  static const attsAttr_t m_##name##_list[] =                                                     \
+  {                                                                                               \
+    table(BLE_SVC_ATTR_SVC, BLE_SVC_ATTR_CHAR, BLE_SVC_ATTR_CHAR_CCC)                             \
+  };                                                                                              \
+  static const uint8_t m_##name##_stream[] =                                                      \
+  {                                                                                               \
+    table(BLE_SVC_STREAM_SVC, BLE_SVC_STREAM_CHAR, BLE_SVC_STREAM_CHAR_CCC)                       \
+  };                                                                                              \
+  typedef char m_##name##_size_check[(sizeof(m_##name##_list) / sizeof(attsAttr_t) ==            \
+                                      (NAME##_END_HDL - NAME##_START_HDL + 1)) ? 1 : -1];         \
+  static attsGroup_t m_##name##_group =                                                           \
+  {                                                                                               \
+    NULL,                                                                                         \
+    (attsAttr_t *) m_##name##_list,                                                               \
+    m_##name##_read_cb,                                                                           \
+    NULL,                                                                                         \
+    NAME##_START_HDL,                                                                             \
+    NAME##_END_HDL                                                                                \
+  };                                                                                              \
+  const ble_svc_t ble_##name##_svc = {&m_##name##_group, m_##name##_stream};                      \
+  static uint8_t m_##name##_read_cb(dmConnId_t conn_id, uint16_t handle, uint8_t operation,       \
+                                    uint16_t offset, attsAttr_t *p_attr)                          \
+  {                                                                                               \
+    (void) conn_id;                                                                               \
+    (void) operation;                                                                             \
+    (void) offset;                                                                                \
+                                                                                                  \
+    return ble_svc_read(&ble_##name##_svc, handle, p_attr);                                       \
+  }
+
+/* Public variables --------------------------------------------------- */
+// Scratch value of every CCC descriptor, ATTS fills it per connection on each read
+extern uint8_t ble_svc_ccc_value[sizeof(uint16_t)];
+
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Add a service to the ATT server database
+ *
+ * @param[in]     p_svc     Service descriptor
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void ble_svc_add(const ble_svc_t *p_svc);
+
+/**
+ * @brief         Remove a service from the ATT server database
+ *
+ * @param[in]     p_svc     Service descriptor
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void ble_svc_remove(const ble_svc_t *p_svc);
+
+/**
+ * @brief         Refresh an attribute from its bound sample stream
+ *
+ * @param[in]     p_svc     Service descriptor
+ * @param[in]     handle    Attribute handle
+ * @param[in]     p_attr    Attribute
+ *
+ * @attention     O(1), only copies from the sensor cache, the bound variable is left as is
+ *                until the stream is first published
+ *
+ * @return        ATT_SUCCESS
+ */
+uint8_t ble_svc_read(const ble_svc_t *p_svc, uint16_t handle, attsAttr_t *p_attr);
+
+/**
+ * @brief         Notify the current value of a characteristic
+ *
+ * @param[in]     p_svc     Service descriptor
+ * @param[in]     conn_id   DM connection identifier
+ * @param[in]     handle    Characteristic value handle
+ *
+ * @attention     The caller checks the CCC state
+ *
+ * @return        None
+ */
+void ble_svc_notify(const ble_svc_t *p_svc, dmConnId_t conn_id, uint16_t handle);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // __BLE_SVC_H
+
+/* End of file -------------------------------------------------------- */
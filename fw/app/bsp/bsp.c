@@ -24,6 +24,7 @@
 /* Private variables -------------------------------------------------- */
 static gpio_cfg_t m_gpio_reset_out = {PORT_0, PIN_0, GPIO_FUNC_OUT, GPIO_PAD_NONE};
 static gpio_cfg_t m_gpio_mfio_out  = {PORT_0, PIN_1, GPIO_FUNC_OUT, GPIO_PAD_NONE};
+static volatile uint32_t m_tick_ms;
 
 /* Private function prototypes ---------------------------------------- */
 static void bsp_i2c_init(void);
@@ -42,6 +43,16 @@ void bsp_delay(uint32_t ms)
   TMR_Delay(MXC_TMR0, MSEC(ms), 0);
 }
 
+void bsp_tick_inc(uint32_t ms)
+{
+  m_tick_ms += ms;
+}
+
+uint32_t bsp_get_tick(void)
+{
+  return m_tick_ms;
+}
+
 base_status_t bsp_i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t *data, uint32_t len)
 {
   int ret;
@@ -92,6 +92,28 @@ void bsp_init(void);
  */
 void bsp_delay(uint32_t ms);
 
+/**
+ * @brief         Advance the millisecond tick, called from the SysTick handler
+ *
+ * @param[in]     ms    Millisecond
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void bsp_tick_inc(uint32_t ms);
+
+/**
+ * @brief         Get the millisecond tick
+ *
+ * @param[in]     None
+ *
+ * @attention     Wraps around after 2^32 ms
+ *
+ * @return        Milliseconds since boot
+ */
+uint32_t bsp_get_tick(void);
+
 /**
  * @brief         I2C read memory
  *
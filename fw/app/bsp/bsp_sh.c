@@ -46,5 +46,13 @@ base_status_t bsp_sh_get_sensor_value(uint8_t *spo2, uint8_t *heart_rate)
   return BS_OK;
 }
 
+base_status_t bsp_sh_get_raw_value(uint32_t *ir_led, uint32_t *red_led)
+{
+  *ir_led  = m_max32664.bio_data.ir_led;
+  *red_led = m_max32664.bio_data.red_led;
+
+  return BS_OK;
+}
+
 /* Private function definitions ---------------------------------------- */
 /* End of file -------------------------------------------------------- */
@@ -52,6 +52,19 @@ base_status_t bsp_sh_init(void);
  */
 base_status_t bsp_sh_get_sensor_value(uint8_t *spo2, uint8_t *heart_rate);
 
+/**
+ * @brief         BSP sensor hub get the raw LED counts of the last sensor value read
+ *
+ * @param[in]     ir_led    Pointer to handler IR LED count
+ * @param[in]     red_led   Pointer to handler red LED count
+ *
+ * @attention     Call after bsp_sh_get_sensor_value()
+ *
+ * @return
+ * - BS_OK
+ */
+base_status_t bsp_sh_get_raw_value(uint32_t *ir_led, uint32_t *red_led);
+
 /* -------------------------------------------------------------------------- */
 #ifdef __cplusplus
 } // extern "C"
@@ -90,6 +90,10 @@ base_status_t max32664_read_bpm(max32664_t *me)
     printf("Value: 0x%2X\n", data[i]);
   }
 
+  // LED counts formatting, the first two 24 bit sensor words
+  me->bio_data.ir_led  = ((uint32_t)(data[1]) << 16) | ((uint32_t)(data[2]) << 8) | data[3];
+  me->bio_data.red_led = ((uint32_t)(data[4]) << 16) | ((uint32_t)(data[5]) << 8) | data[6];
+
   // Heart Rate formatting
   me->bio_data.heart_rate = ((uint16_t)(data[26]) << 8);
   me->bio_data.heart_rate |= (data[27]);
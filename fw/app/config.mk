@@ -17,3 +17,21 @@ FW_VERSION?=0x312E31
 # Enable file transfer profile
 ENABLE_WDX?=0
 
+# Run as the central aggregating the streams of several wearables
+# instead of as a wearable.
+BLE_ROLE_CENTRAL?=0
+
+
+# Send traces and printf() as tokens, the format string address and
+# the arguments, decode them with tools/wsf_detoken.py and the ELF.
+ENABLE_TOKEN_TRACE?=0
+
+# Run the P-256 field multiplications of LESC key generation and
+# Diffie-Hellman on the MAA. The link layer traces the time of each
+# ECC operation, compare builds with 0 and 1 to pick the faster one.
+ENABLE_ECC_MAA?=0
+
+# Count and trace the scheduling decisions of the link layer, get
+# them over vendor specific HCI commands and replay the trace through
+# the scheduler on a PC with tools/sch_replay.c.
+ENABLE_SCH_STATS?=0
@@ -14,12 +14,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdarg.h>
 #include "mxc_config.h"
 #include "wsf_types.h"
 #include "wsf_os.h"
 #include "wsf_buf.h"
 #include "wsf_timer.h"
 #include "wsf_trace.h"
+#include "wsf_nvm.h"
 #include "app_ui.h"
 #include "app_ui.h"
 #include "hci_vs.h"
@@ -29,16 +31,26 @@
 #include "board.h"
 #include "ipc_defs.h"
 #include "tmr_utils.h"
+#include "uart.h"
 
 #include "bsp.h"
 #include "bsp_temp.h"
 #include "bsp_sh.h"
+#include "sensor_cache.h"
 #include "ble_main.h"
+#include "central_app.h"
+#include "coc_app.h"
 
 /* Private defines ---------------------------------------------------- */
 #define WSF_BUF_SIZE      (0x1048)
 #define WSF_BUF_POOLS     (6)
 
+#if (WSF_TOKEN_ENABLED == TRUE)
+// Console UART interrupt handler, UARTn_IRQHandler
+#define M_UART_IRQ_HANDLER(n)   M_UART_IRQ_HANDLER_(n)
+#define M_UART_IRQ_HANDLER_(n)  UART ## n ## _IRQHandler
+#endif
+
 /* Private enumerate/structure ---------------------------------------- */
 /* Private macros ----------------------------------------------------- */
 /* Private variables -------------------------------------------------- */
@@ -46,7 +58,16 @@ uint32_t SystemHeapSize = WSF_BUF_SIZE;
 uint32_t SystemHeap[WSF_BUF_SIZE / 4];
 uint32_t SystemHeapStart;
 
-// Default pool descriptor
+#if (WSF_TOKEN_ENABLED == TRUE)
+extern mxc_uart_regs_t *ConsoleUart;
+
+// Tokens in flight, the ring buffer span is copied so the producers are never held off
+static uint8_t m_token_tx_buf[WSF_TOKEN_RING_BUF_SIZE * 8];
+static uart_req_t m_token_tx_req;
+static volatile bool_t m_token_tx_busy;
+#endif
+
+// Default pool descriptor, derive it from captured statistics with tools/wsf_pool_tune.py
 static wsfBufPoolDesc_t mainPoolDesc[WSF_BUF_POOLS] =
 {
   { 16,  8 },
@@ -66,8 +87,67 @@ extern void ble_stack_init(void);
 void SysTick_Handler(void)
 {
   WsfTimerUpdate(WSF_MS_PER_TICK);
+  bsp_tick_inc(WSF_MS_PER_TICK);
+}
+
+#if (WSF_TOKEN_ENABLED == TRUE)
+/*************************************************************************************************/
+void M_UART_IRQ_HANDLER(CONSOLE_UART)(void)
+{
+  UART_Handler(ConsoleUart);
+}
+
+/*************************************************************************************************/
+static void m_token_tx_cmpl(uart_req_t *req, int error)
+{
+  // A failed transfer loses its records, tools/wsf_detoken.py resyncs on the next message
+  (void) req;
+  (void) error;
+
+  m_token_tx_busy = FALSE;
+
+  // Send the tokens recorded during the transfer
+  WsfTokenService();
+}
+
+/*************************************************************************************************/
+static bool_t m_token_trace(const uint8_t *pBuf, uint32_t len)
+{
+  if (m_token_tx_busy)
+  {
+    return FALSE;
+  }
+
+  memcpy(m_token_tx_buf, pBuf, len);
+  m_token_tx_req.data = m_token_tx_buf;
+  m_token_tx_req.len = len;
+  m_token_tx_req.callback = m_token_tx_cmpl;
+
+  m_token_tx_busy = TRUE;
+  if (UART_WriteAsync(ConsoleUart, &m_token_tx_req) != E_NO_ERROR)
+  {
+    m_token_tx_busy = FALSE;
+    return FALSE;
+  }
+
+  return TRUE;
 }
 
+/*************************************************************************************************/
+// printf() of the whole image is linked here (-Wl,--wrap=printf), only the format string
+// address and the arguments go out, tools/wsf_detoken.py prints the message
+int __wrap_printf(const char *pFmt, ...)
+{
+  va_list args;
+  int num;
+
+  va_start(args, pFmt);
+  num = WsfTokenVprintf(pFmt, args);
+  va_end(args);
+
+  return num;
+}
+#else
 /*************************************************************************************************/
 static bool_t m_my_trace(const uint8_t *pBuf, uint32_t len)
 {
@@ -81,6 +161,7 @@ static bool_t m_my_trace(const uint8_t *pBuf, uint32_t len)
 
   return FALSE;
 }
+#endif
 
 /*************************************************************************************************/
 /*!
@@ -99,15 +180,20 @@ static void m_wsf_init(void)
 
   WsfTimerInit();
 
+#if (WSF_TOKEN_ENABLED == TRUE)
+  NVIC_EnableIRQ(MXC_UART_GET_IRQ(CONSOLE_UART));
+  WsfTraceRegisterHandler(m_token_trace);
+#else
+  WsfTraceRegisterHandler(m_my_trace);
+#endif
+  WsfTraceEnable(TRUE);
+
   SystemHeapStart = (uint32_t)&SystemHeap;
   memset(SystemHeap, 0, sizeof(SystemHeap));
   printf("SystemHeapStart = 0x%x\n", SystemHeapStart);
   printf("SystemHeapSize = 0x%x\n", SystemHeapSize);
   bytesUsed = WsfBufInit(WSF_BUF_POOLS, mainPoolDesc);
   printf("bytesUsed = 0x%x\n", bytesUsed);
-
-  WsfTraceRegisterHandler(m_my_trace);
-  WsfTraceEnable(TRUE);
 }
 
 /*
@@ -144,13 +230,17 @@ void m_set_address(uint8_t event)
 /*************************************************************************************************/
 int main(void)
 {
-  printf("\n\n***** MAX32665 BLE Data Server *****\n");
-
-  // Initialize Radio
+  // Initialize Radio, traces and printf() go out once its trace handler is registered
   m_wsf_init();
 
+  printf("\n\n***** MAX32665 BLE Data Server *****\n");
+
   ble_stack_init();
+#ifdef BLE_ROLE_CENTRAL
+  central_app_start();
+#else
   ble_start();
+#endif
 
   // Register a handler for Application events
   AppUiActionRegister(m_set_address);
@@ -163,6 +253,8 @@ int main(void)
   bsp_sh_init();
   uint8_t spo2 = 0;
   uint8_t heart_rate = 0;
+  coc_app_sample_t sample;
+  bool_t sample_held = FALSE;
 
   while (1)
   {
@@ -170,10 +262,32 @@ int main(void)
     // bsp_temp_get(&temp);
     // printf("Temmperature: %f \n", (double)temp);
 
-    bsp_sh_get_sensor_value(&spo2, &heart_rate);
+    // Push the sample the full ring refused on the last pass before taking a new one
+    if (sample_held && (coc_app_push(&sample, 1) == 1))
+    {
+      sample_held = FALSE;
+    }
+
+    if (bsp_sh_get_sensor_value(&spo2, &heart_rate) == BS_OK)
+    {
+      sensor_cache_publish(SENSOR_CACHE_SPO2, &spo2, sizeof(spo2));
+      sensor_cache_publish(SENSOR_CACHE_HEART_RATE, &heart_rate, sizeof(heart_rate));
+
+      // Stream the raw LED counts, while a sample is held no new one is taken and
+      // coc_app_refused_count() counts the held back pushes
+      if (!sample_held)
+      {
+        sample.timestamp = bsp_get_tick();
+        bsp_sh_get_raw_value(&sample.ir_led, &sample.red_led);
+        sample_held = (coc_app_push(&sample, 1) == 0);
+      }
+    }
     printf("Spo2: %d \n", (uint8_t)spo2);
     printf("Heart rate: %d \n", (uint8_t)heart_rate);
 
+    // Reclaim NVM while idle, so bond writes rarely wait for a flash erase
+    WsfNvmGc();
+
     bsp_delay(1000);
   }
 
@@ -0,0 +1,411 @@
+/*
+ * Test and time the ATT server attribute lookups of atts_proc.c and
+ * atts_read.c on a PC, over a 300 attribute database of 30 groups.
+ *
+ *     check     attsFindUuidInRange() and attsFindServiceGroupEnd() with the
+ *               UUID index give the same results as the group queue walk
+ *     bench     ns per lookup for the walk and the index, per lookup and
+ *               for a full primary service and characteristic discovery
+ *
+ * The walk is the lookup code without the index. It runs with
+ * attsCb.uuidIdxValid cleared, as it does on the target once the database
+ * outgrows ATTS_UUID_IDX_MAX. Lookups by handle always walk the group queue.
+ *
+ * Build from the fw directory:
+ *
+ *     B=Libraries/BTLE; H=$B/stack/ble-host; A=$H/sources/stack/att
+ *     gcc -O2 -std=gnu99 -ffunction-sections -Wl,--gc-sections \
+ *         -I$B/wsf/include -I$B/wsf/include/util -I$H/include -I$A -I$H/sources/stack/cfg \
+ *         tools/atts_idx_bench.c $A/atts_proc.c $A/atts_read.c -o atts_idx_bench
+ *
+ *     ./atts_idx_bench
+ *
+ * --gc-sections drops the request handlers, so only the lookups need to link.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_queue.h"
+#include "util/bstream.h"
+#include "att_api.h"
+#include "att_uuid.h"
+#include "att_main.h"
+#include "atts_main.h"
+
+/* Database shape, 30 groups of 10 attributes */
+#define DB_NUM_GROUPS       30
+#define DB_GROUP_ATTRS      10
+#define DB_NUM_CHARS        3
+
+/* Random lookups per timing run */
+#define BENCH_LOOKUPS       100000
+
+/* Lookups checked per function */
+#define CHECK_RANGES        20000
+
+attsCb_t attsCb;
+
+static uint8_t attBaseUuid[] = {0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+                                0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static attsGroup_t dbGroup[DB_NUM_GROUPS];
+static attsAttr_t dbAttr[DB_NUM_GROUPS][DB_GROUP_ATTRS];
+static uint8_t dbUuid16[DB_NUM_GROUPS][ATT_16_UUID_LEN];
+static uint8_t dbUuidVendor[DB_NUM_GROUPS][ATT_128_UUID_LEN];
+static uint8_t dbUuidBatt[ATT_128_UUID_LEN];
+static uint16_t dbMaxHandle;
+
+static const uint8_t uuidPrim[] = {UINT16_TO_BYTES(ATT_UUID_PRIMARY_SERVICE)};
+static const uint8_t uuidSec[] = {UINT16_TO_BYTES(ATT_UUID_SECONDARY_SERVICE)};
+static const uint8_t uuidChar[] = {UINT16_TO_BYTES(ATT_UUID_CHARACTERISTIC)};
+static const uint8_t uuidCcc[] = {UINT16_TO_BYTES(ATT_UUID_CLIENT_CHAR_CONFIG)};
+
+/* Query UUIDs, 16-bit ones first */
+#define QUERY_NUM_16        7
+#define QUERY_NUM           (QUERY_NUM_16 + 4)
+
+static uint8_t queryUuid[QUERY_NUM][ATT_128_UUID_LEN];
+
+/* Not in atts_main.h, only atts_read.c uses it */
+uint16_t attsFindServiceGroupEnd(uint16_t startHandle);
+
+/* From att_main.c, which needs the rest of the stack */
+bool_t attUuidCmp16to128(const uint8_t *pUuid16, const uint8_t *pUuid128)
+{
+  attBaseUuid[ATT_BASE_UUID_POS_0] = pUuid16[0];
+  attBaseUuid[ATT_BASE_UUID_POS_1] = pUuid16[1];
+
+  return (memcmp(attBaseUuid, pUuid128, ATT_128_UUID_LEN) == 0);
+}
+
+static uint32_t benchRandState = 0x2545F491;
+
+static uint32_t benchRand(void)
+{
+  benchRandState ^= benchRandState << 13;
+  benchRandState ^= benchRandState >> 17;
+  benchRandState ^= benchRandState << 5;
+  return benchRandState;
+}
+
+static double benchNow(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void benchUuid128(uint8_t *pUuid, uint16_t uuid16)
+{
+  memcpy(pUuid, attBaseUuid, ATT_128_UUID_LEN);
+  pUuid[ATT_BASE_UUID_POS_0] = UINT16_TO_BYTE0(uuid16);
+  pUuid[ATT_BASE_UUID_POS_1] = UINT16_TO_BYTE1(uuid16);
+}
+
+static void benchSetAttr(attsAttr_t *pAttr, const uint8_t *pUuid, bool_t uuid128)
+{
+  pAttr->pUuid = pUuid;
+  pAttr->settings = uuid128 ? ATTS_SET_UUID_128 : 0;
+  pAttr->permissions = ATTS_PERMIT_READ;
+}
+
+/*
+ * Each group is a service declaration and three characteristics: a 16-bit
+ * value UUID, the battery level UUID in 128-bit form and a vendor UUID. Every
+ * seventh group also declares a secondary service in the middle. There is a
+ * gap of two handles after every third group.
+ */
+static void benchBuildDb(void)
+{
+  attsGroup_t *pPrev = NULL;
+  uint16_t handle = 1;
+  int g, c;
+
+  benchUuid128(dbUuidBatt, ATT_UUID_BATTERY_LEVEL);
+
+  for (g = 0; g < DB_NUM_GROUPS; g++)
+  {
+    attsAttr_t *pAttr = dbAttr[g];
+
+    UINT16_TO_BUF(dbUuid16[g], ATT_UUID_DEVICE_NAME + g);
+    memcpy(dbUuidVendor[g], "\x01\x23\x45\x67\x89\xAB\xCD\xEF\x10\x32\x54\x76\x98\xBA\xDC", 15);
+    dbUuidVendor[g][15] = (uint8_t)g;
+
+    benchSetAttr(pAttr++, uuidPrim, FALSE);
+    for (c = 0; c < DB_NUM_CHARS; c++)
+    {
+      benchSetAttr(pAttr++, uuidChar, FALSE);
+      switch (c)
+      {
+        case 0:  benchSetAttr(pAttr++, dbUuid16[g], FALSE); break;
+        case 1:  benchSetAttr(pAttr++, dbUuidBatt, TRUE); break;
+        default: benchSetAttr(pAttr++, dbUuidVendor[g], TRUE); break;
+      }
+      benchSetAttr(pAttr++, uuidCcc, FALSE);
+    }
+
+    if (g % 7 == 3)
+    {
+      benchSetAttr(&dbAttr[g][7], uuidSec, FALSE);
+    }
+
+    dbGroup[g].pAttr = dbAttr[g];
+    dbGroup[g].startHandle = handle;
+    dbGroup[g].endHandle = handle + DB_GROUP_ATTRS - 1;
+    handle += DB_GROUP_ATTRS + ((g % 3 == 2) ? 2 : 0);
+
+    if (pPrev == NULL)
+    {
+      attsCb.groupQueue.pHead = &dbGroup[g];
+    }
+    else
+    {
+      pPrev->pNext = &dbGroup[g];
+    }
+    pPrev = &dbGroup[g];
+  }
+
+  attsCb.groupQueue.pTail = pPrev;
+  dbMaxHandle = pPrev->endHandle;
+
+  memcpy(queryUuid[0], uuidPrim, ATT_16_UUID_LEN);
+  memcpy(queryUuid[1], uuidSec, ATT_16_UUID_LEN);
+  memcpy(queryUuid[2], uuidChar, ATT_16_UUID_LEN);
+  memcpy(queryUuid[3], uuidCcc, ATT_16_UUID_LEN);
+  UINT16_TO_BUF(queryUuid[4], ATT_UUID_BATTERY_LEVEL);
+  UINT16_TO_BUF(queryUuid[5], ATT_UUID_DEVICE_NAME + DB_NUM_GROUPS / 2);
+  UINT16_TO_BUF(queryUuid[6], ATT_UUID_HR_MEAS);
+  benchUuid128(queryUuid[7], ATT_UUID_CHARACTERISTIC);
+  benchUuid128(queryUuid[8], ATT_UUID_BATTERY_LEVEL);
+  benchUuid128(queryUuid[9], ATT_UUID_DEVICE_NAME + 1);
+  memcpy(queryUuid[10], dbUuidVendor[DB_NUM_GROUPS - 1], ATT_128_UUID_LEN);
+}
+
+static void benchUseIdx(bool_t useIdx)
+{
+  if (useIdx)
+  {
+    attsIdxBuild();
+  }
+  else
+  {
+    attsCb.uuidIdxValid = FALSE;
+  }
+}
+
+static uint8_t benchUuidLen(int q)
+{
+  return (q < QUERY_NUM_16) ? ATT_16_UUID_LEN : ATT_128_UUID_LEN;
+}
+
+/* Random range, start never after end */
+static void benchRange(uint16_t *pStart, uint16_t *pEnd)
+{
+  uint16_t a = (uint16_t)(benchRand() % (dbMaxHandle + 4));
+  uint16_t b = (benchRand() & 3) ? (uint16_t)(a + benchRand() % 40) : ATT_HANDLE_MAX;
+
+  *pStart = a;
+  *pEnd = (b < a) ? ATT_HANDLE_MAX : b;
+}
+
+static int benchCheck(void)
+{
+  attsGroup_t *pGroup[2];
+  attsAttr_t *pAttr[2];
+  uint16_t handle[2];
+  uint16_t start, end;
+  int errors = 0;
+  int i, n, q;
+
+  /* every handle, and a few past the end */
+  for (i = 0; i <= dbMaxHandle + 4; i++)
+  {
+    for (n = 0; n < 2; n++)
+    {
+      benchUseIdx(n);
+      handle[n] = attsFindServiceGroupEnd((uint16_t)i);
+    }
+
+    if (handle[0] != handle[1])
+    {
+      printf("check: attsFindServiceGroupEnd(%d) %u, walk %u\n", i, handle[1], handle[0]);
+      errors++;
+    }
+  }
+
+  for (i = 0; i < CHECK_RANGES; i++)
+  {
+    benchRange(&start, &end);
+
+    q = benchRand() % QUERY_NUM;
+    for (n = 0; n < 2; n++)
+    {
+      benchUseIdx(n);
+      pAttr[n] = NULL;
+      pGroup[n] = NULL;
+      handle[n] = attsFindUuidInRange(start, end, benchUuidLen(q), queryUuid[q], &pAttr[n],
+                                      &pGroup[n]);
+    }
+
+    if ((handle[0] != handle[1]) ||
+        ((handle[0] != ATT_HANDLE_NONE) && ((pAttr[0] != pAttr[1]) || (pGroup[0] != pGroup[1]))))
+    {
+      printf("check: attsFindUuidInRange(%u, %u, query %d) %u, walk %u\n",
+             start, end, q, handle[1], handle[0]);
+      errors++;
+    }
+  }
+
+  /* the database fits, the index must be in use */
+  benchUseIdx(TRUE);
+  if (!attsCb.uuidIdxValid)
+  {
+    printf("check: index not valid, %u UUIDs\n", attsCb.numUuidIdx);
+    errors++;
+  }
+
+  return errors;
+}
+
+/* Read by group type for primary services over the whole database */
+static uint32_t benchDiscSvc(void)
+{
+  attsAttr_t *pAttr;
+  attsGroup_t *pGroup;
+  uint16_t handle = ATT_HANDLE_START;
+  uint32_t found = 0;
+
+  while ((handle = attsFindUuidInRange(handle, ATT_HANDLE_MAX, ATT_16_UUID_LEN,
+                                       (uint8_t *)uuidPrim, &pAttr, &pGroup)) != ATT_HANDLE_NONE)
+  {
+    found++;
+    handle = attsFindServiceGroupEnd(handle);
+    if (handle == ATT_HANDLE_MAX)
+    {
+      break;
+    }
+    handle++;
+  }
+
+  return found;
+}
+
+/* Read by type for characteristic declarations over the whole database */
+static uint32_t benchDiscChar(void)
+{
+  attsAttr_t *pAttr;
+  attsGroup_t *pGroup;
+  uint16_t handle = ATT_HANDLE_START;
+  uint32_t found = 0;
+
+  while ((handle = attsFindUuidInRange(handle, ATT_HANDLE_MAX, ATT_16_UUID_LEN,
+                                       (uint8_t *)uuidChar, &pAttr, &pGroup)) != ATT_HANDLE_NONE)
+  {
+    found++;
+    handle++;
+  }
+
+  return found;
+}
+
+static double benchRun(int test, bool_t useIdx)
+{
+  static uint16_t starts[BENCH_LOOKUPS], ends[BENCH_LOOKUPS];
+  volatile uintptr_t sink = 0;
+  attsAttr_t *pAttr = NULL;
+  attsGroup_t *pGroup = NULL;
+  double start;
+  int i, runs = BENCH_LOOKUPS;
+
+  benchRandState = 0x2545F491;
+  for (i = 0; i < BENCH_LOOKUPS; i++)
+  {
+    benchRange(&starts[i], &ends[i]);
+  }
+
+  benchUseIdx(useIdx);
+  if (test >= 3)
+  {
+    runs = BENCH_LOOKUPS / 100;
+  }
+
+  start = benchNow();
+  for (i = 0; i < runs; i++)
+  {
+    switch (test)
+    {
+      case 0:
+        sink += attsFindUuidInRange(starts[i], ends[i], ATT_16_UUID_LEN, queryUuid[i % 5],
+                                    &pAttr, &pGroup);
+        break;
+      case 1:
+        sink += attsFindUuidInRange(starts[i], ends[i], ATT_128_UUID_LEN, queryUuid[10],
+                                    &pAttr, &pGroup);
+        break;
+      case 2:
+        sink += attsFindServiceGroupEnd(starts[i]);
+        break;
+      case 3:
+        sink += benchDiscSvc();
+        break;
+      default:
+        sink += benchDiscChar();
+        break;
+    }
+  }
+
+  (void)sink;
+  return (benchNow() - start) / runs;
+}
+
+static void benchTime(void)
+{
+  static const char *names[] =
+  {
+    "FindUuidInRange 16", "FindUuidInRange 128",
+    "FindServiceGroupEnd", "service discovery", "char discovery"
+  };
+  double start, buildNs;
+  int i;
+
+  printf("%-20s %12s %12s\n", "ns per lookup", "walk", "index");
+
+  for (i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+  {
+    double walkNs = benchRun(i, FALSE);
+    double idxNs = benchRun(i, TRUE);
+
+    printf("%-20s %12.1f %12.1f\n", names[i], walkNs, idxNs);
+  }
+
+  start = benchNow();
+  for (i = 0; i < 10000; i++)
+  {
+    attsIdxBuild();
+  }
+  buildNs = (benchNow() - start) / 10000;
+
+  printf("attsIdxBuild %.0f ns, %u UUIDs indexed\n", buildNs, attsCb.numUuidIdx);
+}
+
+int main(void)
+{
+  int errors;
+
+  benchBuildDb();
+
+  printf("database: %d attributes in %d groups, handles 1-%u\n",
+         DB_NUM_GROUPS * DB_GROUP_ATTRS, DB_NUM_GROUPS, dbMaxHandle);
+
+  errors = benchCheck();
+  printf("check: %d errors\n", errors);
+
+  benchTime();
+
+  return errors != 0;
+}
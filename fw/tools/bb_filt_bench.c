@@ -0,0 +1,214 @@
+/*
+ * Time the white list and periodic list lookups of the receive ISR on a PC.
+ *
+ * The lists of bb_ble_whitelist.c and bb_ble_periodiclist.c are filled with
+ * random addresses and looked up with listed and unlisted ones. A linear scan
+ * of the same entries, the lookup the lists used to do, is timed next to them.
+ * Lookups are also checked against the linear scan while entries are added and
+ * removed at random.
+ *
+ * Host times only compare the two lookups, the probe counts carry over to the
+ * Cortex-M4: a linear scan compares every entry for an unlisted address, the
+ * hash index about 1.5 entries for a listed one and 2.5 for an unlisted one at
+ * its maximum load of one half.
+ *
+ * Build from the fw directory:
+ *
+ *     B=Libraries/BTLE/link_layer/platform/common
+ *     gcc -O2 -std=gnu99 -ILibraries/BTLE/link_layer/controller/include/ble \
+ *         -ILibraries/BTLE/link_layer/controller/include/common -I$B/include \
+ *         -ILibraries/BTLE/wsf/include -ILibraries/BTLE/wsf/include/util \
+ *         -ILibraries/BTLE/stack/platform/max32665 \
+ *         tools/bb_filt_bench.c $B/sources/bb/ble/bb_ble_whitelist.c \
+ *         $B/sources/bb/ble/bb_ble_periodiclist.c -o bb_filt_bench
+ *
+ *     ./bb_filt_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bb_ble_api.h"
+#include "bb_ble_api_whitelist.h"
+#include "bb_ble_api_periodiclist.h"
+
+/* Lookups timed per list size */
+#define BENCH_LOOKUPS       2000000
+
+/* Keys looked up, half of them listed */
+#define BENCH_KEYS          1024
+
+static uint64_t benchMem[1024];
+static uint64_t benchListed[255];
+static uint64_t benchKeys[BENCH_KEYS];
+static uint8_t benchNumListed;
+static volatile uint32_t benchSink;
+
+void WsfSetError(uint16_t error)
+{
+}
+
+static uint64_t benchRand(void)
+{
+  static uint64_t x = 0x2545F4914F6CDD1DULL;
+
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+static double benchNow(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The lookup the lists used to do */
+static bool_t benchLinear(uint64_t key)
+{
+  uint8_t i;
+
+  for (i = 0; i < benchNumListed; i++)
+  {
+    if (benchListed[i] == key)
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static bool_t benchWhiteList(uint64_t key)
+{
+  return BbBleWhiteListCheckAddr((bool_t)(key >> 48), key & 0xFFFFFFFFFFFFULL);
+}
+
+static bool_t benchPeriodicList(uint64_t key)
+{
+  return BbBlePeriodicListCheckAddr(1, key & 0xFFFFFFFFFFFFULL, (uint8_t)(key >> 48));
+}
+
+static double benchTime(bool_t (*lookup)(uint64_t), bool_t listed)
+{
+  uint32_t found = 0;
+  double start = benchNow();
+  uint32_t i;
+
+  for (i = 0; i < BENCH_LOOKUPS; i++)
+  {
+    uint64_t key = benchKeys[i & (BENCH_KEYS - 1)];
+
+    if (listed)
+    {
+      key = benchListed[i % benchNumListed];
+    }
+    found += lookup(key);
+  }
+
+  benchSink = found;
+  return (benchNow() - start) / BENCH_LOOKUPS;
+}
+
+/* Address with the type or set ID in bits 48-51 */
+static uint64_t benchAddr(void)
+{
+  return benchRand() & 0xFFFFFFFFFFFFFULL;
+}
+
+static void benchFill(uint8_t numEntries)
+{
+  uint16_t i;
+
+  BbBleInitWhiteList(numEntries, (uint8_t *)benchMem, sizeof(benchMem) / 2);
+  BbBleInitPeriodicList(numEntries, (uint8_t *)&benchMem[512], sizeof(benchMem) / 2);
+  benchNumListed = 0;
+
+  for (i = 0; i < numEntries; i++)
+  {
+    uint64_t key = benchAddr() & 0x1FFFFFFFFFFFFULL;
+
+    benchListed[benchNumListed++] = key;
+    BbBleWhiteListAdd((bool_t)(key >> 48), key & 0xFFFFFFFFFFFFULL);
+    BbBlePeriodicListAdd(1, key & 0xFFFFFFFFFFFFULL, (uint8_t)(key >> 48));
+  }
+
+  /* Unlisted keys, the listed ones are looked up from benchListed[] */
+  for (i = 0; i < BENCH_KEYS / 4; i++)
+  {
+    benchKeys[4 * i] = benchAddr() & 0x1FFFFFFFFFFFFULL;
+    benchKeys[4 * i + 1] = benchKeys[4 * i] ^ 1;
+    benchKeys[4 * i + 2] = benchKeys[4 * i] ^ (1ULL << 47);
+    benchKeys[4 * i + 3] = benchKeys[4 * i] ^ (1ULL << 48);
+  }
+}
+
+/* Random adds and removes, every lookup checked against the linear scan */
+static int benchCheck(void)
+{
+  uint32_t n, i, errors = 0;
+
+  benchFill(32);
+
+  for (n = 0; n < 100000; n++)
+  {
+    uint64_t key = benchAddr() & 0x1FFFFFFFFFFFFULL;
+
+    if ((benchRand() & 1) && (benchNumListed > 0))
+    {
+      i = benchRand() % benchNumListed;
+      key = benchListed[i];
+      if (!BbBleWhiteListRemove((bool_t)(key >> 48), key & 0xFFFFFFFFFFFFULL) ||
+          !BbBlePeriodicListRemove(1, key & 0xFFFFFFFFFFFFULL, (uint8_t)(key >> 48)))
+      {
+        errors++;
+      }
+      benchListed[i] = benchListed[--benchNumListed];
+    }
+    else if (benchNumListed < 32)
+    {
+      if (!BbBleWhiteListAdd((bool_t)(key >> 48), key & 0xFFFFFFFFFFFFULL) ||
+          !BbBlePeriodicListAdd(1, key & 0xFFFFFFFFFFFFULL, (uint8_t)(key >> 48)))
+      {
+        errors++;
+      }
+      benchListed[benchNumListed++] = key;
+    }
+
+    for (i = 0; i < benchNumListed; i++)
+    {
+      errors += !benchWhiteList(benchListed[i]) || !benchPeriodicList(benchListed[i]);
+    }
+    key = benchAddr() & 0x1FFFFFFFFFFFFULL;
+    errors += (benchWhiteList(key) != benchLinear(key)) || (benchPeriodicList(key) != benchLinear(key));
+  }
+
+  return errors;
+}
+
+int main(void)
+{
+  static const uint8_t sizes[] = { 4, 8, 16, 32, 64, 128, 255 };
+  uint8_t i;
+  int errors = benchCheck();
+
+  printf("check: %d errors\n", errors);
+  printf("%7s  %-24s %-24s %-24s\n", "", "linear ns", "white list ns", "periodic list ns");
+  printf("%7s  %11s %11s  %11s %11s  %11s %11s\n", "entries", "listed", "unlisted", "listed", "unlisted",
+         "listed", "unlisted");
+
+  for (i = 0; i < sizeof(sizes); i++)
+  {
+    benchFill(sizes[i]);
+    printf("%7u  %11.1f %11.1f  %11.1f %11.1f  %11.1f %11.1f\n", sizes[i],
+           benchTime(benchLinear, TRUE), benchTime(benchLinear, FALSE),
+           benchTime(benchWhiteList, TRUE), benchTime(benchWhiteList, FALSE),
+           benchTime(benchPeriodicList, TRUE), benchTime(benchPeriodicList, FALSE));
+  }
+
+  return errors != 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Test and time CalcCrc32() of crc32.c on a PC.
+ *
+ *     check     every alignment 0-7 and length 0-1099 against a bitwise
+ *               reference, whole and split in two chained calls
+ *     bench     ns per buffer over buffer size, the byte table loop the
+ *               function used to run next to the slicing-by-8 one
+ *
+ * Built with -DWSF_CRC_HW=TRUE, PalCryptoCrc32() is a bitwise stand-in for
+ * the CRC engine and the check also covers the engine path and its known
+ * answer check. With -b the stand-in gives wrong results, CalcCrc32() must
+ * stay in software after the known answer check and the check still pass.
+ * The timings then include the stand-in.
+ *
+ * Build from the fw directory:
+ *
+ *     W=Libraries/BTLE/wsf
+ *     gcc -O2 -std=gnu99 -I$W/include -I$W/include/util -ILibraries/BTLE \
+ *         tools/crc32_bench.c $W/sources/util/crc32.c -o crc32_bench
+ *
+ *     ./crc32_bench [-b]
+ *
+ * Add -DWSF_CRC_SIZE_OPTIMIZE=TRUE to check the size optimized build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "wsf_types.h"
+#include "util/crc32.h"
+
+#ifndef WSF_CRC_HW
+#define WSF_CRC_HW FALSE
+#endif
+
+/* Longest buffer checked */
+#define CHECK_MAX_LEN       1099
+
+/* Buffer sizes timed */
+static const uint32_t benchLens[] = { 8, 64, 256, 1024, 4096 };
+
+static uint32_t byteTable[256];
+static int engineBroken;
+static uint32_t engineCalls;
+
+/* Bitwise reference, crc not inverted */
+static uint32_t refCrc(uint32_t crc, uint32_t len, const uint8_t *pBuf)
+{
+  int j;
+
+  while (len--)
+  {
+    crc ^= *pBuf++;
+    for (j = 0; j < 8; j++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+    }
+  }
+
+  return crc;
+}
+
+#if WSF_CRC_HW == TRUE
+/* CRC engine stand-in, crc not inverted */
+uint32_t PalCryptoCrc32(uint32_t crc, uint32_t len, const uint8_t *pBuf)
+{
+  engineCalls++;
+
+  return refCrc(crc, len, pBuf) ^ (engineBroken ? 1 : 0);
+}
+#endif
+
+/* The byte table loop CalcCrc32() used to run */
+static uint32_t byteCrc(uint32_t crc, uint32_t len, const uint8_t *pBuf)
+{
+  while (len--)
+  {
+    crc = byteTable[(crc ^ *pBuf++) & 0xFF] ^ (crc >> 8);
+  }
+
+  return crc ^ 0xFFFFFFFFU;
+}
+
+static int benchCheck(void)
+{
+  static uint8_t buf[CHECK_MAX_LEN + 8];
+  uint32_t len, split, ref, crc;
+  int align;
+  int errors = 0;
+
+  for (len = 0; len < sizeof(buf); len++)
+  {
+    buf[len] = (uint8_t)(rand() >> 4);
+  }
+
+  for (align = 0; align < 8; align++)
+  {
+    for (len = 0; len <= CHECK_MAX_LEN; len++)
+    {
+      ref = refCrc(0xFFFFFFFFU, len, buf + align) ^ 0xFFFFFFFFU;
+
+      if (CalcCrc32(0xFFFFFFFFU, len, buf + align) != ref)
+      {
+        printf("check: mismatch at alignment %d, length %u\n", align, len);
+        errors++;
+      }
+
+      /* Chained, the result of a call is inverted back to continue */
+      split = len / 3;
+      crc = CalcCrc32(0xFFFFFFFFU, split, buf + align) ^ 0xFFFFFFFFU;
+      if (CalcCrc32(crc, len - split, buf + align + split) != ref)
+      {
+        printf("check: chained mismatch at alignment %d, length %u\n", align, len);
+        errors++;
+      }
+    }
+  }
+
+  return errors;
+}
+
+static double benchNow(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void benchTime(void)
+{
+  static uint8_t buf[4096];
+  volatile uint32_t sink = 0;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(buf); i++)
+  {
+    buf[i] = (uint8_t)i;
+  }
+
+  printf("%8s %12s %12s\n", "bytes", "byte table", "CalcCrc32");
+
+  for (i = 0; i < sizeof(benchLens) / sizeof(benchLens[0]); i++)
+  {
+    uint32_t len = benchLens[i];
+    uint32_t runs = 50000000 / (len + 16);
+    double start, oldNs, newNs;
+    uint32_t n;
+
+    start = benchNow();
+    for (n = 0; n < runs; n++)
+    {
+      sink += byteCrc(0xFFFFFFFFU ^ n, len, buf);
+    }
+    oldNs = (benchNow() - start) / runs;
+
+    start = benchNow();
+    for (n = 0; n < runs; n++)
+    {
+      sink += CalcCrc32(0xFFFFFFFFU ^ n, len, buf);
+    }
+    newNs = (benchNow() - start) / runs;
+
+    printf("%8u %12.1f %12.1f\n", len, oldNs, newNs);
+  }
+
+  (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+  static const uint8_t zero = 0;
+  uint32_t i;
+  int errors;
+
+  engineBroken = (argc > 1) && (strcmp(argv[1], "-b") == 0);
+
+  /* Entry i is the CRC register i shifted through eight zero bits */
+  for (i = 0; i < 256; i++)
+  {
+    byteTable[i] = refCrc(i, 1, &zero);
+  }
+
+  errors = benchCheck();
+  printf("check: %d errors", errors);
+  if (WSF_CRC_HW == TRUE)
+  {
+    printf(", %u engine calls%s", engineCalls, engineBroken ? " with a broken engine" : "");
+  }
+  printf("\n");
+
+  benchTime();
+
+  return errors != 0;
+}
@@ -0,0 +1,365 @@
+/*
+ * Replay a recorded link layer scheduler trace through the scheduler on a PC.
+ *
+ * Build the firmware with ENABLE_SCH_STATS=1 and call HciVsGetSchTrace()
+ * often enough for the trace ring not to wrap, each scheduler decision is
+ * traced as
+ *
+ *     SCH <time> <due> <durUsec> <bodId> <event> <type> <reschPolicy> <info>
+ *
+ * The insertions and cancels of the capture are fed through the scheduler
+ * list code of the tree, sch_list.c and sch_main.c, against a simulated BB
+ * clock. Conflicts, late starts and the resulting cancels are left for the
+ * scheduler to decide again, and the decision counters of the replay are
+ * printed next to the recorded ones. Edit the scheduler, rebuild this tool
+ * and replay the same capture to see how the decisions change.
+ *
+ * Limits of the replay: BODs run for their minimum duration and the link
+ * layer does not react to the new decisions, the insertions are those of the
+ * capture. SchInsertEarlyAsPossible() and SchInsertLateAsPossible() are
+ * replayed at the due time they were given, their failures are counted but
+ * not replayed, as the interval they were tried over is not traced.
+ *
+ * Build from the fw directory:
+ *
+ *     S=Libraries/BTLE/link_layer/controller/sources/common/sch
+ *     gcc -O2 -std=gnu99 -DSCH_STATS_ENABLED=TRUE \
+ *         -ILibraries/BTLE/link_layer/controller/include/common \
+ *         -ILibraries/BTLE/link_layer/platform/common/include \
+ *         -ILibraries/BTLE/wsf/include -I$S \
+ *         tools/sch_replay.c $S/sch_main.c $S/sch_list.c $S/sch_stats.c -o sch_replay
+ *
+ *     ./sch_replay [-c old|new|due] [-s setupDelayUsec] capture.log
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sch_int.h"
+#include "bb_api.h"
+#include "wsf_os.h"
+
+/* Maximum number of BODs alive at once */
+#define REPLAY_MAX_BOD      256
+
+/* Replayed BOD, the BOD descriptor first */
+typedef struct
+{
+  BbOpDesc_t  bod;
+  uint16_t    bodId;
+  uint8_t     type;
+  bool_t      used;
+} replayBod_t;
+
+static replayBod_t replayBod[REPLAY_MAX_BOD];
+static uint32_t replayTime;
+static uint16_t replaySetupDelayUsec = BB_SCH_SETUP_DELAY_US;
+static BbConflictAct_t replayConflictCback;
+
+/* Recorded decision counters */
+static uint32_t replayRecorded[SCH_STATS_NUM_TYPES][SCH_STATS_EVT_NUM];
+static uint32_t replaySkipped;
+static uint32_t replayDiverged;
+
+static const char *replayEvtName[SCH_STATS_EVT_NUM] =
+{
+  "insert", "insertFail", "win", "lose", "cancel", "lateStart"
+};
+
+/* Conflict resolution between BODs of the same rescheduling policy */
+static BbOpDesc_t *replayNewWins(BbOpDesc_t *pNewBod, BbOpDesc_t *pExistBod)
+{
+  return pNewBod;
+}
+
+static BbOpDesc_t *replayEarlierWins(BbOpDesc_t *pNewBod, BbOpDesc_t *pExistBod)
+{
+  return ((int32_t)(pNewBod->due - pExistBod->due) < 0) ? pNewBod : pExistBod;
+}
+
+/**************************************************************************************************
+  Platform stubs
+**************************************************************************************************/
+
+uint32_t BbDrvGetCurrentTime(void)
+{
+  return replayTime;
+}
+
+uint16_t BbGetSchSetupDelayUs(void)
+{
+  return replaySetupDelayUsec;
+}
+
+void BbExecuteBod(BbOpDesc_t *pBod)
+{
+}
+
+void BbCancelBod(void)
+{
+}
+
+bool_t BbGetBodTerminateFlag(void)
+{
+  return FALSE;
+}
+
+void BbSetBodTerminateFlag(void)
+{
+}
+
+void BbRegister(BbBodCompCback_t bodCompCback)
+{
+}
+
+void WsfSetEvent(wsfHandlerId_t handlerId, wsfEventMask_t event)
+{
+}
+
+void WsfOsSetHandlerPrio(wsfHandlerId_t handlerId, uint8_t prio)
+{
+}
+
+void WsfCsEnter(void)
+{
+}
+
+void WsfCsExit(void)
+{
+}
+
+uint8_t schStatsGetBodType(BbOpDesc_t *pBod)
+{
+  return ((replayBod_t *)pBod)->type;
+}
+
+/**************************************************************************************************
+  Replay
+**************************************************************************************************/
+
+static replayBod_t *replayGetBod(uint16_t bodId)
+{
+  replayBod_t *pFree = NULL;
+  int i;
+
+  for (i = 0; i < REPLAY_MAX_BOD; i++)
+  {
+    if (replayBod[i].used && (replayBod[i].bodId == bodId))
+    {
+      return &replayBod[i];
+    }
+    if (!replayBod[i].used && (pFree == NULL))
+    {
+      pFree = &replayBod[i];
+    }
+  }
+
+  if (pFree == NULL)
+  {
+    fprintf(stderr, "more than %d BODs\n", REPLAY_MAX_BOD);
+    exit(1);
+  }
+
+  memset(pFree, 0, sizeof(*pFree));
+  pFree->bodId = bodId;
+  pFree->used = TRUE;
+  return pFree;
+}
+
+static bool_t replayIsListed(BbOpDesc_t *pBod)
+{
+  BbOpDesc_t *pCur;
+
+  for (pCur = schCb.pHead; pCur != NULL; pCur = pCur->pNext)
+  {
+    if (pCur == pBod)
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Complete the BODs which end before the given time */
+static void replayRunTo(uint32_t time)
+{
+  BbOpDesc_t *pHead;
+  uint32_t end;
+
+  while (((pHead = schCb.pHead) != NULL) && (schCb.state == SCH_STATE_EXEC))
+  {
+    end = pHead->due + BB_US_TO_BB_TICKS(pHead->minDurUsec);
+
+    if ((int32_t)(time - end) < 0)
+    {
+      break;
+    }
+
+    if ((int32_t)(end - replayTime) > 0)
+    {
+      replayTime = end;
+    }
+    SchHandler(0, NULL);
+  }
+
+  replayTime = time;
+}
+
+static void replayInsert(replayBod_t *pRb, uint32_t due, uint8_t kind)
+{
+  if (replayIsListed(&pRb->bod))
+  {
+    /* The replay kept a BOD the capture did not */
+    SchRemove(&pRb->bod);
+    replayDiverged++;
+  }
+
+  pRb->bod.due = due;
+
+  switch (kind)
+  {
+    case SCH_STATS_INSERT_NEXT:
+      SchInsertNextAvailable(&pRb->bod);
+      break;
+    default:
+      SchInsertAtDueTime(&pRb->bod, replayConflictCback);
+      break;
+  }
+}
+
+static void replayLine(const char *pLine)
+{
+  static uint16_t lateBodId;
+  static bool_t lateStart;
+  unsigned int time, due, durUsec, bodId, event, type, reschPolicy, info;
+  const char *p = strstr(pLine, "SCH ");
+  replayBod_t *pRb;
+
+  if ((p == NULL) ||
+      (sscanf(p, "SCH %u %u %u %u %u %u %u %u", &time, &due, &durUsec, &bodId, &event, &type,
+              &reschPolicy, &info) != 8) ||
+      (event >= SCH_STATS_EVT_NUM) || (type >= SCH_STATS_NUM_TYPES))
+  {
+    return;
+  }
+
+  replayRecorded[type][event]++;
+  replayRunTo(time);
+
+  pRb = replayGetBod((uint16_t)bodId);
+  pRb->type = (uint8_t)type;
+  pRb->bod.minDurUsec = durUsec;
+  pRb->bod.reschPolicy = (uint8_t)reschPolicy;
+
+  switch (event)
+  {
+    case SCH_STATS_EVT_INSERT:
+      replayInsert(pRb, due, (uint8_t)info);
+      break;
+
+    case SCH_STATS_EVT_INSERT_FAIL:
+      if ((info == SCH_STATS_INSERT_DUE_TIME) || (info == SCH_STATS_INSERT_NEXT))
+      {
+        replayInsert(pRb, due, (uint8_t)info);
+      }
+      else
+      {
+        replaySkipped++;
+      }
+      break;
+
+    case SCH_STATS_EVT_CANCEL:
+      /* The scheduler drops the BODs it could not start itself */
+      if (!(lateStart && (lateBodId == bodId)) && replayIsListed(&pRb->bod))
+      {
+        SchRemove(&pRb->bod);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  lateStart = (event == SCH_STATS_EVT_LATE_START);
+  lateBodId = (uint16_t)bodId;
+}
+
+static void replayReport(void)
+{
+  SchStatsCount_t count;
+  uint8_t type, evt;
+  uint32_t recorded;
+
+  printf("%-5s %-10s %10s %10s\n", "type", "decision", "recorded", "replayed");
+
+  for (type = 0; type < SCH_STATS_NUM_TYPES; type++)
+  {
+    SchStatsGetCount(type, &count);
+
+    for (evt = 0, recorded = 0; evt < SCH_STATS_EVT_NUM; evt++)
+    {
+      recorded += replayRecorded[type][evt] + count.count[evt];
+    }
+    if (recorded == 0)
+    {
+      continue;
+    }
+
+    for (evt = 0; evt < SCH_STATS_EVT_NUM; evt++)
+    {
+      printf("%-5u %-10s %10u %10u\n", type, replayEvtName[evt], replayRecorded[type][evt],
+             count.count[evt]);
+    }
+  }
+
+  printf("early/late failures not replayed %u, BODs the replay had to remove %u\n",
+         replaySkipped, replayDiverged);
+}
+
+int main(int argc, char **argv)
+{
+  char line[256];
+  FILE *pFile = stdin;
+  int i;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-c") && (i + 1 < argc))
+    {
+      i++;
+      if (!strcmp(argv[i], "new"))
+      {
+        replayConflictCback = replayNewWins;
+      }
+      else if (!strcmp(argv[i], "due"))
+      {
+        replayConflictCback = replayEarlierWins;
+      }
+      else
+      {
+        replayConflictCback = NULL;
+      }
+    }
+    else if (!strcmp(argv[i], "-s") && (i + 1 < argc))
+    {
+      replaySetupDelayUsec = (uint16_t)atoi(argv[++i]);
+    }
+    else if ((pFile = fopen(argv[i], "r")) == NULL)
+    {
+      perror(argv[i]);
+      return 1;
+    }
+  }
+
+  SchInit();
+
+  while (fgets(line, sizeof(line), pFile) != NULL)
+  {
+    replayLine(line);
+  }
+
+  replayReport();
+
+  return 0;
+}
@@ -0,0 +1,385 @@
+/*
+ * Test and time the AES engine backends of sec_cmac.c and pal_crypto.c on a PC.
+ *
+ * LlMathAesEcb() is replaced by OpenSSL, keeping its least significant byte
+ * first block and key order, and everything above it is the code of the tree.
+ *
+ *     vectors   AES against FIPS-197, CMAC against the RFC 4493 examples
+ *     random    CMAC and CCM against OpenSSL over random keys and lengths,
+ *               and CCM decryption rejecting a corrupted MIC
+ *     bench     CMAC throughput over message length: engine calls per
+ *               message, host time per message and per byte
+ *
+ * Host times include OpenSSL standing in for the engine, they only compare
+ * lengths. The engine call count is what carries over to the target, where
+ * the HCI backend took the same number of LE Encrypt command and event round
+ * trips. To time the target, build the firmware with DWT enabled and wrap a
+ * SecCmac() call, which computes the whole CMAC before it returns:
+ *
+ *     CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+ *     DWT->CYCCNT = 0;
+ *     DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+ *     SecCmac(key, buf, len, handlerId, 0, event);
+ *     printf("%u %u\n", len, DWT->CYCCNT);
+ *
+ * Build from the fw directory:
+ *
+ *     B=Libraries/BTLE
+ *     gcc -O2 -std=gnu99 -Wno-pointer-to-int-cast -DTARGET=MAX32665 \
+ *         -I$B/wsf/include -I$B/wsf/include/util -I$B \
+ *         -I$B/stack/ble-host/include -I$B/stack/ble-host/sources/sec/common \
+ *         -I$B/stack/ble-host/sources/hci/dual_chip \
+ *         -I$B/link_layer/platform/common/include -ILibraries/CMSIS/Include \
+ *         -ILibraries/CMSIS/Device/Maxim/MAX32665/Include \
+ *         tools/sec_cmac_bench.c $B/stack/ble-host/sources/sec/pal/sec_cmac.c \
+ *         $B/stack/platform/max32665/pal_crypto.c $B/wsf/sources/util/wstr.c \
+ *         -lcrypto -o sec_cmac_bench
+ *
+ *     ./sec_cmac_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <openssl/evp.h>
+#include <openssl/core_names.h>
+#include "wsf_types.h"
+#include "wsf_msg.h"
+#include "wsf_os.h"
+#include "sec_api.h"
+#include "sec_main.h"
+#include "stack/platform/include/pal_crypto.h"
+
+/* Random messages checked against OpenSSL */
+#define RANDOM_RUNS         2000
+
+/* Longest random message */
+#define RANDOM_MAX_LEN      600
+
+/* CMAC lengths timed */
+static const uint16_t benchLens[] = { 0, 16, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+/* Global security control block */
+secCb_t secCb;
+
+static EVP_CIPHER_CTX *benchCtx;
+static uint32_t benchEngineCalls;
+static uint8_t benchMsg[sizeof(secQueueBuf_t)];
+static uint8_t benchMac[SEC_BLOCK_LEN];
+
+/**************************************************************************************************
+  Stand-ins
+**************************************************************************************************/
+
+static void benchReverse(uint8_t *pDst, const uint8_t *pSrc)
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+  {
+    pDst[i] = pSrc[15 - i];
+  }
+}
+
+void LlMathAesEcb(const uint8_t *pKey, uint8_t *pOut, const uint8_t *pIn)
+{
+  uint8_t key[16], in[16], out[16];
+  int len;
+
+  benchEngineCalls++;
+
+  benchReverse(key, pKey);
+  benchReverse(in, pIn);
+  EVP_EncryptInit_ex(benchCtx, EVP_aes_128_ecb(), NULL, key, NULL);
+  EVP_CIPHER_CTX_set_padding(benchCtx, 0);
+  EVP_EncryptUpdate(benchCtx, out, &len, in, sizeof(in));
+  benchReverse(pOut, out);
+}
+
+void LlMathAesBatchBegin(void)
+{
+}
+
+void LlMathAesBatchEnd(void)
+{
+}
+
+void WsfCsEnter(void)
+{
+}
+
+void WsfCsExit(void)
+{
+}
+
+void *WsfMsgAlloc(uint16_t len)
+{
+  return (len <= sizeof(benchMsg)) ? benchMsg : NULL;
+}
+
+void WsfMsgSend(wsfHandlerId_t handlerId, void *pMsg)
+{
+  secCmacMsg_t *pCmac = pMsg;
+
+  (void)handlerId;
+  memcpy(benchMac, pCmac->pCiphertext, SEC_BLOCK_LEN);
+}
+
+/**************************************************************************************************
+  References
+**************************************************************************************************/
+
+static void refCmac(const uint8_t *pKey, const uint8_t *pText, size_t len, uint8_t *pMac)
+{
+  static EVP_MAC *pMacAlg;
+  EVP_MAC_CTX *pCtx;
+  OSSL_PARAM params[2];
+  size_t macLen;
+
+  if (pMacAlg == NULL)
+  {
+    pMacAlg = EVP_MAC_fetch(NULL, "CMAC", NULL);
+  }
+
+  params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_CIPHER, "AES-128-CBC", 0);
+  params[1] = OSSL_PARAM_construct_end();
+
+  pCtx = EVP_MAC_CTX_new(pMacAlg);
+  EVP_MAC_init(pCtx, pKey, 16, params);
+  EVP_MAC_update(pCtx, pText, len);
+  EVP_MAC_final(pCtx, pMac, &macLen, 16);
+  EVP_MAC_CTX_free(pCtx);
+}
+
+static void refCcm(const uint8_t *pKey, const uint8_t *pNonce, const uint8_t *pText, int textLen,
+                   const uint8_t *pClear, int clearLen, int micLen, uint8_t *pOut, uint8_t *pMic)
+{
+  EVP_CIPHER_CTX *pCtx = EVP_CIPHER_CTX_new();
+  int len;
+
+  EVP_EncryptInit_ex(pCtx, EVP_aes_128_ccm(), NULL, NULL, NULL);
+  EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_AEAD_SET_IVLEN, SEC_CCM_NONCE_LEN, NULL);
+  EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_AEAD_SET_TAG, micLen, NULL);
+  EVP_EncryptInit_ex(pCtx, NULL, NULL, pKey, pNonce);
+  EVP_EncryptUpdate(pCtx, NULL, &len, NULL, textLen);
+  if (clearLen > 0)
+  {
+    EVP_EncryptUpdate(pCtx, NULL, &len, pClear, clearLen);
+  }
+  EVP_EncryptUpdate(pCtx, pOut, &len, pText, textLen);
+  EVP_EncryptFinal_ex(pCtx, pOut + len, &len);
+  EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_AEAD_GET_TAG, micLen, pMic);
+  EVP_CIPHER_CTX_free(pCtx);
+}
+
+/**************************************************************************************************
+  Tests
+**************************************************************************************************/
+
+static uint32_t benchRand(void)
+{
+  static uint32_t x = 0x9E3779B9;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+static void benchFill(uint8_t *pBuf, int len)
+{
+  int i;
+
+  for (i = 0; i < len; i++)
+  {
+    pBuf[i] = (uint8_t)benchRand();
+  }
+}
+
+static void benchCmac(const uint8_t *pKey, uint8_t *pText, uint16_t len, uint8_t *pMac)
+{
+  memset(benchMac, 0, sizeof(benchMac));
+  SecCmac(pKey, pText, len, 0, 0, 0);
+  memcpy(pMac, benchMac, SEC_BLOCK_LEN);
+}
+
+static int benchVectors(void)
+{
+  /* FIPS-197 appendix C.1 */
+  static const uint8_t aesKey[16] =
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+  static const uint8_t aesIn[16] =
+    { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+  static const uint8_t aesOut[16] =
+    { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+  /* RFC 4493 section 4 */
+  static const uint8_t cmacKey[16] =
+    { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+  static uint8_t cmacMsg[64] =
+  {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+  };
+  static const struct
+  {
+    uint16_t len;
+    uint8_t  mac[16];
+  } cmacVec[] =
+  {
+    { 0,  { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 } },
+    { 16, { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c } },
+    { 40, { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 } },
+    { 64, { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe } }
+  };
+
+  uint8_t key[16], in[16], out[16], mac[16];
+  int errors = 0;
+  unsigned int i;
+
+  /* The engine takes least significant byte first blocks */
+  benchReverse(key, aesKey);
+  benchReverse(in, aesIn);
+  PalCryptoAesEcb(key, out, in);
+  benchReverse(in, out);
+  if (memcmp(in, aesOut, 16) != 0)
+  {
+    printf("vectors: AES FIPS-197 mismatch\n");
+    errors++;
+  }
+
+  for (i = 0; i < sizeof(cmacVec) / sizeof(cmacVec[0]); i++)
+  {
+    benchCmac(cmacKey, cmacMsg, cmacVec[i].len, mac);
+    if (memcmp(mac, cmacVec[i].mac, 16) != 0)
+    {
+      printf("vectors: CMAC RFC 4493 mismatch at length %u\n", cmacVec[i].len);
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+static int benchRandom(void)
+{
+  static const uint8_t micLens[] = { 4, 8, 16 };
+  uint8_t key[16], nonce[SEC_CCM_NONCE_LEN];
+  uint8_t text[RANDOM_MAX_LEN], clear[32];
+  uint8_t mac[16], refMac[16];
+  uint8_t result[32 + RANDOM_MAX_LEN + 16], refOut[RANDOM_MAX_LEN], plain[RANDOM_MAX_LEN];
+  int errors = 0;
+  int n;
+
+  for (n = 0; n < RANDOM_RUNS; n++)
+  {
+    uint16_t len = benchRand() % RANDOM_MAX_LEN;
+    uint16_t clearLen = benchRand() % sizeof(clear);
+    uint8_t micLen = micLens[benchRand() % sizeof(micLens)];
+
+    benchFill(key, sizeof(key));
+    benchFill(nonce, sizeof(nonce));
+    benchFill(text, len);
+    benchFill(clear, clearLen);
+
+    /* CMAC */
+    benchCmac(key, text, len, mac);
+    refCmac(key, text, len, refMac);
+    if (memcmp(mac, refMac, 16) != 0)
+    {
+      printf("random: CMAC mismatch at length %u\n", len);
+      errors++;
+    }
+
+    /* CCM, the result holds the clear text space, the encrypted text and the MIC */
+    PalCryptoCcmEnc(key, nonce, text, len, clear, clearLen, micLen, result, 0, 0, 0);
+    refCcm(key, nonce, text, len, clear, clearLen, micLen, refOut, refMac);
+    if ((memcmp(result + clearLen, refOut, len) != 0) ||
+        (memcmp(result + clearLen + len, refMac, micLen) != 0))
+    {
+      printf("random: CCM encryption mismatch at length %u, clear %u, MIC %u\n", len, clearLen, micLen);
+      errors++;
+    }
+
+    if ((PalCryptoCcmDec(key, nonce, refOut, len, clear, clearLen, refMac, micLen, plain, 0, 0, 0) != 0) ||
+        (memcmp(plain, text, len) != 0))
+    {
+      printf("random: CCM decryption failed at length %u, clear %u, MIC %u\n", len, clearLen, micLen);
+      errors++;
+    }
+
+    refMac[benchRand() % micLen] ^= 1 << (benchRand() % 8);
+    if (PalCryptoCcmDec(key, nonce, refOut, len, clear, clearLen, refMac, micLen, plain, 0, 0, 0) == 0)
+    {
+      printf("random: CCM accepted a corrupted MIC at length %u\n", len);
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+static double benchNow(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void benchThroughput(void)
+{
+  static uint8_t text[4096];
+  uint8_t key[16], mac[16];
+  unsigned int i;
+
+  benchFill(key, sizeof(key));
+  benchFill(text, sizeof(text));
+
+  printf("%8s %8s %12s %10s\n", "length", "engine", "ns/message", "ns/byte");
+
+  for (i = 0; i < sizeof(benchLens) / sizeof(benchLens[0]); i++)
+  {
+    uint16_t len = benchLens[i];
+    uint32_t runs = 2000000 / (len + 64);
+    uint32_t calls;
+    double start, ns;
+    uint32_t n;
+
+    benchEngineCalls = 0;
+    benchCmac(key, text, len, mac);
+    calls = benchEngineCalls;
+
+    start = benchNow();
+    for (n = 0; n < runs; n++)
+    {
+      benchCmac(key, text, len, mac);
+    }
+    ns = (benchNow() - start) / runs;
+
+    printf("%8u %8u %12.0f %10.1f\n", len, calls, ns, (len > 0) ? ns / len : 0.0);
+  }
+}
+
+int main(void)
+{
+  int vectors, random;
+
+  benchCtx = EVP_CIPHER_CTX_new();
+  SecCmacInit();
+
+  vectors = benchVectors();
+  random = benchRandom();
+
+  printf("vectors: %d errors\n", vectors);
+  printf("random: %d errors over %d messages\n", random, RANDOM_RUNS);
+
+  benchThroughput();
+
+  EVP_CIPHER_CTX_free(benchCtx);
+
+  return (vectors + random) != 0;
+}
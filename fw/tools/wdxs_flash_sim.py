@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Estimate the end-to-end throughput of a WDXS file transfer to flash.
+
+The transfer is simulated twice, with the flash accesses of the two writers of
+app/ble_app/wdxs_file.c:
+
+    direct    FLC_Write() per chunk after a mass erase of the file region
+    combined  chunks combined into 128-bit lines for FLC_Write128(), pages
+              erased one ahead of the writes
+
+Both digest the file as it is written, Sha256Update() up to the last
+SHA256_BYTES, and finish the digest at validation.
+
+The link delivers chunks at --link-rate while the controller has a free
+receive buffer, the WSF task writes them one at a time.  The peer sends the
+data once the put request is answered, and asks for validation after the
+last chunk.  Flash and hash timings are assumptions, pass the figures of the
+part and clock in use.
+
+    python3 wdxs_flash_sim.py --size 262144 --chunk 244 --link-rate 90000
+"""
+
+import argparse
+
+LINE_LEN = 16
+PAGE_LEN = 0x2000
+DIGEST_LEN = 32
+SHA_BLOCK_LEN = 64
+
+
+def direct_programs(offset, length):
+    """Flash line programs of FLC_Write(), each FLC_Write32() reprograms a whole line."""
+    programs = 0
+
+    if offset & 0x3:
+        done = 4 - (offset & 0x3)
+        programs += 1
+        offset += done
+        length -= done
+
+    while length >= 4 and offset & 0xF:
+        programs += 1
+        offset += 4
+        length -= 4
+
+    programs += length // 16
+    offset += length // 16 * 16
+    length %= 16
+
+    programs += length // 4
+    if length % 4:
+        programs += 1
+
+    return programs
+
+
+class Writer:
+    def __init__(self, args):
+        self.args = args
+        self.hashed = 0
+
+    def hash_to(self, length):
+        if length <= self.hashed:
+            return 0.0
+        cost = (length - self.hashed) / self.args.sha_rate
+        self.hashed = length
+        return cost
+
+    def hash_write(self, end):
+        if end <= DIGEST_LEN:
+            return 0.0
+        return self.hash_to((end - DIGEST_LEN) & ~(SHA_BLOCK_LEN - 1))
+
+    def hash_validate(self, size):
+        return self.hash_to(size - DIGEST_LEN) + SHA_BLOCK_LEN / self.args.sha_rate
+
+
+class Direct(Writer):
+    def start(self):
+        return self.args.mass_erase_ms * 1e-3
+
+    def write(self, offset, length):
+        cost = direct_programs(offset, length) * self.args.program_us * 1e-6
+        return cost + self.hash_write(offset + length)
+
+    def validate(self, size):
+        return self.hash_validate(size)
+
+
+class Combined(Writer):
+    def __init__(self, args):
+        super().__init__(args)
+        self.line = None
+        self.erased = 0
+
+    def erase_to(self, end):
+        pages = 0
+        while self.erased < end:
+            self.erased += PAGE_LEN
+            pages += 1
+        return pages * self.args.page_erase_ms * 1e-3
+
+    def flush(self):
+        if self.line is None:
+            return 0.0
+        self.line = None
+        return self.args.program_us * 1e-6
+
+    def start(self):
+        return self.erase_to(PAGE_LEN)
+
+    def write(self, offset, length):
+        cost = 0.0
+        end = offset + length
+
+        while offset < end:
+            line = offset & ~(LINE_LEN - 1)
+            if line != self.line:
+                cost += self.flush()
+                cost += self.erase_to(line + LINE_LEN)
+                self.line = line
+            offset = min(line + LINE_LEN, end)
+            if offset == line + LINE_LEN:
+                cost += self.flush()
+
+        cost += self.erase_to(end + PAGE_LEN)
+
+        return cost + self.hash_write(end)
+
+    def validate(self, size):
+        return self.flush() + self.hash_validate(size)
+
+
+def simulate(writer, args):
+    """Return the time from the put request to the validation response, and the stall time."""
+    slot = args.chunk / args.link_rate
+    done = []
+    stalled = 0.0
+
+    ready = writer.start()
+    link = ready
+
+    for i, offset in enumerate(range(0, args.size, args.chunk)):
+        length = min(args.chunk, args.size - offset)
+
+        # The peer waits for a free receive buffer
+        arrive = link + slot
+        if i >= args.buffers and done[i - args.buffers] > arrive:
+            stalled += done[i - args.buffers] - arrive
+            arrive = done[i - args.buffers]
+        link = arrive
+
+        ready = max(ready, arrive) + writer.write(offset, length)
+        done.append(ready)
+
+    return ready + writer.validate(args.size), stalled
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--size", type=int, default=256 * 1024, help="file length, with its digest")
+    parser.add_argument("--chunk", type=int, default=244, help="bytes of file data per WDXS write")
+    parser.add_argument("--link-rate", type=float, default=90e3, help="bytes per second the link delivers")
+    parser.add_argument("--buffers", type=int, default=16, help="receive buffers of the controller, NumRxBufs")
+    parser.add_argument("--program-us", type=float, default=42.0, help="time to program a 128-bit line")
+    parser.add_argument("--page-erase-ms", type=float, default=30.0, help="time to erase a page")
+    parser.add_argument("--mass-erase-ms", type=float, default=60.0, help="time to mass erase the file flash")
+    parser.add_argument("--sha-rate", type=float, default=2.5e6, help="bytes per second of Sha256Update()")
+    args = parser.parse_args()
+
+    ideal = args.size / args.link_rate
+    print("link only        %8.3f s  %8.1f kB/s" % (ideal, args.size / ideal / 1e3))
+
+    for name, writer in (("direct", Direct(args)), ("combined", Combined(args))):
+        total, stalled = simulate(writer, args)
+        print("%-16s %8.3f s  %8.1f kB/s  link stalled %.3f s" %
+              (name, total, args.size / total / 1e3, stalled))
+
+
+if __name__ == "__main__":
+    main()
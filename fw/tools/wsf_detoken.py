@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""
+Print the tokenized traces of a firmware built with ENABLE_TOKEN_TRACE=1.
+
+The firmware sends 8-byte records, two little-endian words each.  A message
+starts with a head record:
+
+    word 0  bits 0-23   format string address - base (0x10000000)
+            bits 24-27  number of variable words
+            bit 28      messages were lost before this one
+            bit 29      trace message, ends with a new line
+    word 1  bits 0-15   check of the message
+            bits 16-31  sync pattern 0xA55A
+
+and the variable words follow, two per record.  The check is the variable
+words folded with a rotate left by 5 and XOR, XORed with word 0, then its two
+halves XORed.  After lost or corrupted bytes the decoder skips ahead to the
+next head record with a matching sync pattern and check.  The format strings stay
+in the image, they are read back from the ELF of the build, or from a table
+saved with --dump-table so released builds can be decoded without their ELF.
+
+    stty -F /dev/ttyUSB0 115200 raw
+    python3 wsf_detoken.py --elf build/max32665.elf /dev/ttyUSB0
+    python3 wsf_detoken.py --elf build/max32665.elf --dump-table fw.json
+    python3 wsf_detoken.py --table fw.json capture.bin
+"""
+
+import argparse
+import bisect
+import json
+import re
+import struct
+import sys
+
+ADDR_MASK = 0x00FFFFFF
+NUM_VARS_SHIFT = 24
+NUM_VARS_MASK = 0xF
+FLAG_FLOW_CTRL = 1 << 28
+FLAG_LINE = 1 << 29
+
+SYNC = 0xA55A
+SYNC_SHIFT = 16
+CHECK_MASK = 0xFFFF
+
+RECORD_LEN = 8
+
+# Sections loaded in the image, SHF_ALLOC, holding data, not SHT_NOBITS
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# C conversion specification, same parsing as WsfTokenVprintf()
+CONV_RE = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                     r"(?P<len>hh|h|ll|l|L|j|z|t)?(?P<conv>[diouxXcspfFeEgGaAn%])")
+
+
+class Strings:
+    """NUL terminated strings of the image by offset from the base address."""
+
+    def __init__(self, strings):
+        self.offsets = sorted(strings)
+        self.strings = strings
+
+    @classmethod
+    def from_elf(cls, path, base):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            sys.exit("%s: not a 32-bit little-endian ELF" % path)
+
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+
+        strings = {}
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+            if not (flags & SHF_ALLOC) or sh_type == SHT_NOBITS or not (base <= addr < base + ADDR_MASK + 1):
+                continue
+            for match in re.finditer(rb"[\t\n\r\x20-\x7e]*\x00", data[offset:offset + size]):
+                text = match.group()[:-1]
+                if text:
+                    strings[addr - base + match.start()] = text.decode("ascii")
+
+        return cls(strings)
+
+    @classmethod
+    def from_table(cls, path):
+        with open(path) as f:
+            return cls({int(k, 16): v for k, v in json.load(f).items()})
+
+    def dump(self, path):
+        with open(path, "w") as f:
+            json.dump({"%06x" % k: self.strings[k] for k in self.offsets}, f, indent=0)
+
+    def get(self, offset):
+        # An address may point inside a string, e.g. a suffix shared by the linker
+        i = bisect.bisect_right(self.offsets, offset) - 1
+        if i < 0:
+            return None
+        start = self.offsets[i]
+        text = self.strings[start]
+        if offset - start > len(text):
+            return None
+        return text[offset - start:]
+
+
+def to_signed(value, bits):
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def format_message(fmt, words, strings, base):
+    """Expand a C format string with the variable words recorded by the firmware."""
+    words = list(words)
+
+    def take():
+        return words.pop(0) if words else 0
+
+    def take64():
+        low = take()
+        return low | (take() << 32)
+
+    def expand(match):
+        conv = match.group("conv")
+        if conv == "%":
+            return "%"
+
+        spec = "%" + match.group("flags")
+        width, prec = match.group("width"), match.group("prec")
+        if width == "*":
+            width = str(to_signed(take(), 32))
+        spec += width or ""
+        if prec is not None:
+            spec += "." + (str(to_signed(take(), 32)) if prec == "*" else prec)
+
+        length = match.group("len") or ""
+        if conv in "fFeEgGaA":
+            value = struct.unpack("<d", struct.pack("<Q", take64()))[0]
+            return (spec + conv.replace("a", "e").replace("A", "E")) % value
+
+        bits = 64 if length in ("ll", "j") else {"h": 16, "hh": 8}.get(length, 32)
+        value = take64() if bits == 64 else take() & ((1 << bits) - 1)
+
+        if conv == "s":
+            text = strings.get((value - base) & ADDR_MASK) if base <= value <= base + ADDR_MASK else None
+            return (spec + "s") % (text if text is not None else "<0x%08x>" % value)
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        if conv == "n":
+            return ""
+        if conv in "di":
+            return (spec + "d") % to_signed(value, bits)
+        return (spec + conv.replace("u", "d")) % value
+
+    return CONV_RE.sub(expand, fmt)
+
+
+def message_check(token, words):
+    """Check of a message, same as wsfTokenPut()."""
+    check = 0
+    for word in words:
+        check = (((check << 5) | (check >> 27)) & 0xFFFFFFFF) ^ word
+    check ^= token
+    return (check ^ (check >> 16)) & CHECK_MASK
+
+
+def messages(stream):
+    """Yield (token, variable words, bytes skipped before the message)."""
+    data = b""
+    skipped = 0
+    while True:
+        if len(data) >= RECORD_LEN:
+            token, head = struct.unpack_from("<II", data)
+            num_vars = (token >> NUM_VARS_SHIFT) & NUM_VARS_MASK
+            msg_len = RECORD_LEN * (1 + (num_vars + 1) // 2)
+
+            if (head >> SYNC_SHIFT) != SYNC:
+                data = data[1:]
+                skipped += 1
+                continue
+
+            if len(data) >= msg_len:
+                words = struct.unpack_from("<%dI" % (msg_len // 4 - 2), data, RECORD_LEN)[:num_vars]
+                if message_check(token, words) == head & CHECK_MASK:
+                    yield token, words, skipped
+                    data = data[msg_len:]
+                    skipped = 0
+                else:
+                    data = data[1:]
+                    skipped += 1
+                continue
+
+        # A serial device returns what it has received so far
+        chunk = stream.read(RECORD_LEN)
+        if not chunk:
+            return
+        data += chunk
+
+
+def decode(stream, strings, base, out):
+    for token, words, skipped in messages(stream):
+        if skipped:
+            out.write("<%d bytes skipped>\n" % skipped)
+
+        if token & FLAG_FLOW_CTRL:
+            out.write("<messages lost>\n")
+
+        fmt = strings.get(token & ADDR_MASK)
+        if fmt is None:
+            text = "<unknown token 0x%06x> %s" % (token & ADDR_MASK, " ".join("0x%08x" % w for w in words))
+            token |= FLAG_LINE
+        else:
+            text = format_message(fmt, words, strings, base)
+
+        out.write(text + ("\n" if token & FLAG_LINE else ""))
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="capture file or serial device, stdin if none")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--elf", help="ELF of the firmware build")
+    source.add_argument("--table", help="string table saved with --dump-table")
+    parser.add_argument("--dump-table", metavar="FILE", help="save the string table of the ELF and exit")
+    parser.add_argument("--base", type=lambda x: int(x, 0), default=0x10000000,
+                        help="format string base address, WSF_TOKEN_ADDR_BASE")
+    args = parser.parse_args()
+
+    strings = Strings.from_elf(args.elf, args.base) if args.elf else Strings.from_table(args.table)
+
+    if args.dump_table:
+        strings.dump(args.dump_table)
+        return
+
+    if args.input:
+        with open(args.input, "rb", buffering=0) as stream:
+            decode(stream, strings, args.base, sys.stdout)
+    else:
+        decode(sys.stdin.buffer, strings, args.base, sys.stdout)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
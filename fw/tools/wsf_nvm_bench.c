@@ -0,0 +1,416 @@
+/*
+ * Test and time the WSF NVM log of wsf_nvm.c on simulated flash on a PC.
+ *
+ * The PAL NVM is replaced by a RAM image that programs like flash, bits only
+ * go from 1 to 0 until their sector is erased. Power loss is simulated by
+ * stopping the programming after a given number of bytes and mounting the
+ * image again.
+ *
+ *     check     random writes, erases, reclaims and remounts against a
+ *               reference model
+ *     torn      write A, write B, power lost after the header of C: B is read
+ *               back; then power lost at every byte of a write and of a
+ *               reclaim: every ID reads back its old or its new value
+ *     lookup    flash reads and bytes per WsfNvmReadData() over a growing
+ *               number of superseded records
+ *     wear      sector erases of the check run
+ *
+ * Build from the fw directory:
+ *
+ *     W=Libraries/BTLE/wsf
+ *     gcc -O2 -std=gnu99 -I$W/include -I$W/include/util -ILibraries/BTLE \
+ *         tools/wsf_nvm_bench.c $W/sources/port/baremetal/wsf_nvm.c \
+ *         $W/sources/util/crc32.c -o wsf_nvm_bench
+ *
+ *     ./wsf_nvm_bench
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_nvm.h"
+#include "stack/platform/include/pal_nvm.h"
+
+/* Simulated flash */
+#define SIM_SIZE            (PAL_NVM_NUM_SECTORS * PAL_NVM_SECTOR_SIZE)
+
+/* IDs written by the random test, at most WSF_NVM_MAX_IDS */
+#define CHECK_NUM_IDS       12
+
+/* Longest record written */
+#define CHECK_MAX_LEN       300
+
+/* Operations of the random test */
+#define CHECK_OPS           200000
+
+static uint8_t simFlash[SIM_SIZE];
+static PalNvmCback_t simCback;
+static long simBudget = -1;
+static jmp_buf simPowerLoss;
+static uint32_t simReads, simReadBytes;
+static uint32_t simErases[PAL_NVM_NUM_SECTORS];
+
+/* Reference model */
+static uint8_t refData[CHECK_NUM_IDS][CHECK_MAX_LEN];
+static uint16_t refLen[CHECK_NUM_IDS];
+
+/**************************************************************************************************
+  Simulated PAL NVM
+**************************************************************************************************/
+
+void PalNvmInit(PalNvmCback_t actCback)
+{
+  simCback = actCback;
+}
+
+void PalNvmRead(void *pBuf, uint32_t size, uint32_t srcAddr)
+{
+  simReads++;
+  simReadBytes += size;
+
+  if ((srcAddr + size) <= SIM_SIZE)
+  {
+    memcpy(pBuf, &simFlash[srcAddr], size);
+  }
+  else
+  {
+    memset(pBuf, 0xFF, size);
+  }
+}
+
+void PalNvmWrite(void *pBuf, uint32_t size, uint32_t dstAddr)
+{
+  const uint8_t *p = pBuf;
+  uint32_t i;
+
+  if ((dstAddr + size) > SIM_SIZE)
+  {
+    simCback(FALSE);
+    return;
+  }
+
+  for (i = 0; i < size; i++)
+  {
+    if (simBudget == 0)
+    {
+      longjmp(simPowerLoss, 1);
+    }
+    if (simBudget > 0)
+    {
+      simBudget--;
+    }
+    simFlash[dstAddr + i] &= p[i];
+  }
+
+  simCback(TRUE);
+}
+
+void PalNvmEraseSector(uint32_t size, uint32_t startAddr)
+{
+  uint32_t addr;
+
+  if (simBudget == 0)
+  {
+    longjmp(simPowerLoss, 1);
+  }
+
+  for (addr = startAddr; (addr < startAddr + size) && (addr < SIM_SIZE); addr += PAL_NVM_SECTOR_SIZE)
+  {
+    memset(&simFlash[addr], 0xFF, PAL_NVM_SECTOR_SIZE);
+    simErases[addr / PAL_NVM_SECTOR_SIZE]++;
+  }
+
+  simCback(TRUE);
+}
+
+/**************************************************************************************************
+  Tests
+**************************************************************************************************/
+
+static uint32_t benchRand(void)
+{
+  static uint32_t x = 0x9E3779B9;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+static void benchFormat(void)
+{
+  memset(simFlash, 0xFF, sizeof(simFlash));
+  memset(refLen, 0, sizeof(refLen));
+  WsfNvmInit();
+}
+
+/* Every ID reads back its model value, or one of two for an ID caught in a torn write */
+static int benchVerify(int tornId, const uint8_t *pOld, uint16_t oldLen, const uint8_t *pNew,
+                       uint16_t newLen)
+{
+  uint8_t buf[CHECK_MAX_LEN];
+  int errors = 0;
+  int id;
+
+  for (id = 0; id < CHECK_NUM_IDS; id++)
+  {
+    const uint8_t *pRef = refData[id];
+    uint16_t len = refLen[id];
+    bool_t found;
+
+    if (id == tornId)
+    {
+      /* Either value, as long as it is one of them */
+      found = (newLen != 0) && WsfNvmReadData(id + 1, buf, newLen, NULL) &&
+              (memcmp(buf, pNew, newLen) == 0);
+      pRef = pOld;
+      len = oldLen;
+      if (found)
+      {
+        continue;
+      }
+    }
+
+    if (len == 0)
+    {
+      errors += WsfNvmReadData(id + 1, buf, 1, NULL) ? 1 : 0;
+    }
+    else
+    {
+      memset(buf, 0xA5, len);
+      errors += (!WsfNvmReadData(id + 1, buf, len, NULL) || (memcmp(buf, pRef, len) != 0)) ? 1 : 0;
+    }
+  }
+
+  return errors;
+}
+
+static void benchFill(uint8_t *pBuf, uint16_t len)
+{
+  uint16_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    pBuf[i] = (uint8_t)benchRand();
+  }
+}
+
+/* Random operations against the reference model */
+static int benchCheck(void)
+{
+  uint8_t buf[CHECK_MAX_LEN];
+  int errors = 0;
+  uint32_t n;
+
+  benchFormat();
+  memset(simErases, 0, sizeof(simErases));
+
+  for (n = 0; n < CHECK_OPS; n++)
+  {
+    int id = benchRand() % CHECK_NUM_IDS;
+    uint32_t op = benchRand() % 100;
+    uint16_t len;
+
+    if (op < 80)
+    {
+      len = 1 + benchRand() % CHECK_MAX_LEN;
+      benchFill(buf, len);
+      if (WsfNvmWriteData(id + 1, buf, len, NULL))
+      {
+        memcpy(refData[id], buf, len);
+        refLen[id] = len;
+      }
+      else
+      {
+        /* The log is sized for every ID at its longest length */
+        errors++;
+      }
+    }
+    else if (op < 90)
+    {
+      if (WsfNvmEraseData(id + 1, NULL) != (refLen[id] != 0))
+      {
+        errors++;
+      }
+      refLen[id] = 0;
+    }
+    else if (op < 95)
+    {
+      (void)WsfNvmGc();
+    }
+    else
+    {
+      WsfNvmInit();
+    }
+
+    if ((n % 64) == 0)
+    {
+      errors += benchVerify(-1, NULL, 0, NULL, 0);
+    }
+  }
+
+  return errors + benchVerify(-1, NULL, 0, NULL, 0);
+}
+
+/* Write an ID with power lost after a number of programmed bytes, then remount */
+static int benchTornWrite(int id, const uint8_t *pNew, uint16_t newLen, long budget)
+{
+  static uint8_t saved[SIM_SIZE];
+  uint8_t old[CHECK_MAX_LEN];
+  uint16_t oldLen = refLen[id];
+  int errors;
+
+  memcpy(saved, simFlash, sizeof(saved));
+  memcpy(old, refData[id], oldLen);
+
+  simBudget = budget;
+  if (setjmp(simPowerLoss) == 0)
+  {
+    (void)WsfNvmWriteData(id + 1, pNew, newLen, NULL);
+  }
+  simBudget = -1;
+
+  WsfNvmInit();
+  errors = benchVerify(id, old, oldLen, pNew, newLen);
+
+  /* Written on the next boot, the log carries on after the torn record */
+  if (WsfNvmWriteData(id + 1, pNew, newLen, NULL))
+  {
+    memcpy(refData[id], pNew, newLen);
+    refLen[id] = newLen;
+    errors += benchVerify(-1, NULL, 0, NULL, 0);
+    WsfNvmInit();
+    errors += benchVerify(-1, NULL, 0, NULL, 0);
+  }
+  else
+  {
+    errors++;
+  }
+
+  memcpy(simFlash, saved, sizeof(saved));
+  memcpy(refData[id], old, oldLen);
+  refLen[id] = oldLen;
+  WsfNvmInit();
+
+  return errors;
+}
+
+static int benchTorn(void)
+{
+  uint8_t a[32], b[32], c[32], buf[32];
+  uint8_t big[CHECK_MAX_LEN];
+  volatile int errors = 0;
+  long budget;
+  int id;
+
+  benchFormat();
+  memset(a, 'A', sizeof(a));
+  memset(b, 'B', sizeof(b));
+  memset(c, 'C', sizeof(c));
+
+  /* The reported case: A, B, then power lost once C's 16 byte header is programmed */
+  WsfNvmWriteData(1, a, sizeof(a), NULL);
+  WsfNvmWriteData(1, b, sizeof(b), NULL);
+  memcpy(refData[0], b, sizeof(b));
+  refLen[0] = sizeof(b);
+
+  simBudget = 16;
+  if (setjmp(simPowerLoss) == 0)
+  {
+    WsfNvmWriteData(1, c, sizeof(c), NULL);
+  }
+  simBudget = -1;
+  WsfNvmInit();
+
+  if (!WsfNvmReadData(1, buf, sizeof(buf), NULL) || (memcmp(buf, b, sizeof(b)) != 0))
+  {
+    printf("torn: B lost after C's header\n");
+    errors++;
+  }
+
+  /* Power lost at every byte of a write */
+  for (budget = 0; budget <= 16 + (long)sizeof(c); budget++)
+  {
+    errors += benchTornWrite(0, c, sizeof(c), budget);
+  }
+
+  /* Fill the write sector until the next write reclaims, then lose power at every byte of it */
+  for (id = 1; id < CHECK_NUM_IDS; id++)
+  {
+    benchFill(refData[id], CHECK_MAX_LEN);
+    refLen[id] = CHECK_MAX_LEN;
+    WsfNvmWriteData(id + 1, refData[id], CHECK_MAX_LEN, NULL);
+  }
+  for (id = 0; id < 25; id++)
+  {
+    benchFill(refData[1], CHECK_MAX_LEN);
+    WsfNvmWriteData(2, refData[1], CHECK_MAX_LEN, NULL);
+  }
+
+  benchFill(big, CHECK_MAX_LEN);
+  for (budget = 0; budget <= PAL_NVM_SECTOR_SIZE; budget += 7)
+  {
+    errors += benchTornWrite(2, big, CHECK_MAX_LEN, budget);
+  }
+
+  return errors;
+}
+
+/* Flash accesses of a read over a growing number of superseded records */
+static void benchLookup(void)
+{
+  static const uint32_t counts[] = { 10, 100, 1000, 10000 };
+  uint8_t buf[16];
+  uint32_t n = 0;
+  unsigned int i;
+  int id;
+
+  benchFormat();
+
+  for (id = 0; id < 8; id++)
+  {
+    memset(buf, id, sizeof(buf));
+    WsfNvmWriteData(id + 1, buf, sizeof(buf), NULL);
+  }
+
+  printf("%10s %10s %10s\n", "superseded", "reads", "bytes");
+
+  for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+  {
+    for (; n < counts[i]; n++)
+    {
+      memset(buf, n, sizeof(buf));
+      WsfNvmWriteData(1 + n % 8, buf, sizeof(buf), NULL);
+    }
+
+    simReads = simReadBytes = 0;
+    for (id = 0; id < 8; id++)
+    {
+      WsfNvmReadData(id + 1, buf, sizeof(buf), NULL);
+    }
+    printf("%10u %10.1f %10.1f\n", counts[i], simReads / 8.0, simReadBytes / 8.0);
+  }
+}
+
+int main(void)
+{
+  int check = benchCheck();
+  int torn = benchTorn();
+  unsigned int s;
+
+  printf("check: %d errors over %d operations\n", check, CHECK_OPS);
+  printf("torn: %d errors\n", torn);
+
+  printf("wear:");
+  for (s = 0; s < PAL_NVM_NUM_SECTORS; s++)
+  {
+    printf(" %u", simErases[s]);
+  }
+  printf(" sector erases\n");
+
+  benchLookup();
+
+  return (check + torn) != 0;
+}
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Derive a WSF buffer pool descriptor from captured pool statistics.
+
+The firmware prints its pool statistics on connection close:
+
+    WSFBUF pool <len> <num> <max alloc> <fail count> <max request len>
+    WSFBUF hist <class size> <count class 0> <count class 1> ...
+
+Feed one or more captures on stdin or as files.  The pool lengths are chosen to
+minimize the bytes wasted by rounding the observed requests up, the buffer
+counts from the observed high-water marks, then both are fitted to the RAM
+budget.  The result is printed as a mainPoolDesc initializer.
+
+    python3 wsf_pool_tune.py --budget 4096 --pools 6 capture.log
+"""
+
+import argparse
+import math
+import sys
+
+# Bytes of pool bookkeeping per pool, wsfBufPool_t
+POOL_OVERHEAD = 20
+
+# Buffer lengths are rounded up to wsfBufMem_t
+BUF_ALIGN = 8
+
+
+def parse(lines):
+    pools = {}
+    hist = None
+    class_size = None
+
+    for line in lines:
+        fields = line.split()
+        if "WSFBUF" not in fields:
+            continue
+        fields = fields[fields.index("WSFBUF") + 1:]
+
+        if fields[0] == "pool":
+            length, num, max_alloc, fails, max_req = (int(x) for x in fields[1:6])
+            old = pools.get(length, (num, 0, 0, 0))
+            pools[length] = (num, max(old[1], max_alloc), max(old[2], fails), max(old[3], max_req))
+        elif fields[0] == "hist":
+            size = int(fields[1])
+            counts = [int(x) for x in fields[2:]]
+            if class_size not in (None, size) or (hist is not None and len(hist) != len(counts)):
+                sys.exit("captures use different size classes")
+            class_size = size
+            hist = counts if hist is None else [a + b for a, b in zip(hist, counts)]
+
+    if not pools or hist is None:
+        sys.exit("no WSFBUF statistics found")
+
+    return pools, hist, class_size
+
+
+def align(length):
+    return (length + BUF_ALIGN - 1) // BUF_ALIGN * BUF_ALIGN
+
+
+def choose_lengths(hist, class_size, max_req, num_pools):
+    """Pick pool lengths among class upper bounds minimizing total rounding waste."""
+    # Candidate lengths are the upper bounds of the used classes, the last one covers the
+    # longest request seen.
+    bounds = [(i + 1) * class_size for i in range(len(hist))]
+    bounds[-1] = max(bounds[-1], align(max_req))
+    used = [i for i, n in enumerate(hist) if n > 0]
+    if not used:
+        return [bounds[-1]]
+
+    num_pools = min(num_pools, len(used))
+    inf = float("inf")
+
+    def waste(first, last):
+        # Waste when classes used[first..last] share a pool of length bounds[used[last]]
+        top = bounds[used[last]]
+        return sum(hist[used[k]] * (top - (bounds[used[k]] - class_size // 2))
+                   for k in range(first, last + 1))
+
+    n = len(used)
+    cost = [[inf] * (n + 1) for _ in range(num_pools + 1)]
+    back = [[0] * (n + 1) for _ in range(num_pools + 1)]
+    cost[0][0] = 0
+    for p in range(1, num_pools + 1):
+        for end in range(1, n + 1):
+            for start in range(p - 1, end):
+                c = cost[p - 1][start] + waste(start, end - 1)
+                if c < cost[p][end]:
+                    cost[p][end] = c
+                    back[p][end] = start
+
+    lengths = []
+    end = n
+    for p in range(num_pools, 0, -1):
+        lengths.append(bounds[used[end - 1]])
+        end = back[p][end]
+
+    return sorted(align(x) for x in lengths)
+
+
+def pool_of(lengths, size):
+    return next((k for k, x in enumerate(lengths) if x >= size), len(lengths) - 1)
+
+
+def estimate_counts(pools, hist, class_size, max_req, lengths):
+    """Spread the measured high-water marks over the new pools by request share."""
+    old = sorted(pools)
+    sizes = [min((i + 1) * class_size, max_req) for i in range(len(hist))]
+
+    # Requests each old pool served first, by class
+    served = [[] for _ in old]
+    for i, n in enumerate(hist):
+        if n > 0:
+            served[pool_of(old, sizes[i])].append(i)
+
+    demand = [0.0] * len(lengths)
+    for o, classes in enumerate(served):
+        _, max_alloc, fails, _ = pools[old[o]]
+        # A pool that ran dry needed at least one buffer more
+        peak = max_alloc + (1 if fails else 0)
+        total = sum(hist[i] for i in classes)
+        for i in classes:
+            demand[pool_of(lengths, sizes[i])] += peak * hist[i] / total
+
+    return [max(1, math.ceil(d)) for d in demand]
+
+
+def fit_budget(lengths, counts, budget):
+    def size(c):
+        return sum(l * n for l, n in zip(lengths, c)) + POOL_OVERHEAD * len(lengths)
+
+    counts = list(counts)
+    # Trim the pool giving back the most bytes per buffer of headroom lost
+    while size(counts) > budget:
+        candidates = [k for k, n in enumerate(counts) if n > 1]
+        if not candidates:
+            sys.exit("budget too small for one buffer per pool")
+        k = max(candidates, key=lambda k: lengths[k] / counts[k])
+        counts[k] -= 1
+
+    # Spend what is left on the pools with the fewest buffers per request share, smallest first
+    grown = True
+    while grown:
+        grown = False
+        for k in sorted(range(len(lengths)), key=lambda k: (counts[k], lengths[k])):
+            if size(counts) + lengths[k] <= budget:
+                counts[k] += 1
+                grown = True
+                break
+
+    return counts, size(counts)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="*", help="captured logs, stdin if none")
+    parser.add_argument("--budget", type=int, required=True, help="RAM budget for the pools in bytes")
+    parser.add_argument("--pools", type=int, default=6, help="number of pools")
+    args = parser.parse_args()
+
+    lines = []
+    if args.files:
+        for name in args.files:
+            with open(name) as f:
+                lines.extend(f)
+    else:
+        lines = sys.stdin.readlines()
+
+    pools, hist, class_size = parse(lines)
+    max_req = max(v[3] for v in pools.values())
+
+    lengths = choose_lengths(hist, class_size, max_req, args.pools)
+    counts = estimate_counts(pools, hist, class_size, max_req, lengths)
+    counts, used = fit_budget(lengths, counts, args.budget)
+
+    print("// %d requests, %d of %d bytes" % (sum(hist), used, args.budget))
+    print("static wsfBufPoolDesc_t mainPoolDesc[WSF_BUF_POOLS] =")
+    print("{")
+    print(",\n".join("  { %d, %d }" % (l, n) for l, n in zip(lengths, counts)))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()